@@ -44,6 +44,12 @@ extern "C" {
 #include "nvic_table.h"       // NVIC (Interrupt Controller) definitions
 #include "mxc_errors.h"       // Error codes
 #include "i2c.h"              // Include Maxim's I2C header
+#include "stats.h"            // Driver performance counters
+#include "pool.h"             // Transient buffers
+#include "gpio.h"             // BMI160 data ready pin
+#include "sched.h"            // Delays that sleep the core
+#include "coop.h"             // Completion events of asynchronous reads
+#include "osal.h"             // Bus lock under an RTOS
 
 /***** Definitions *****/
 #ifdef BOARD_EVKIT_V1
@@ -56,11 +62,44 @@ extern "C" {
 #define I2C_SDA_PIN 17        // SDA pin number for I2C1
 #endif
 
+#ifdef BOARD_EVKIT_V1
+#define BMI160_INT1_PORT MXC_GPIO2          // BMI160 INT1 (data ready) on the interrupt input pin
+#define BMI160_INT1_PIN MXC_GPIO_PIN_7
+#else
+#define BMI160_INT1_PORT MXC_GPIO0
+#define BMI160_INT1_PIN MXC_GPIO_PIN_2
+#endif
+
+#define I2C_GPIO_PORT MXC_GPIO0   // SCL and SDA are on port 0 on both boards
 #define I2C_FREQ 100000       // I2C frequency set to 100kHz
+#ifndef I2C_RETRIES
+#define I2C_RETRIES 3         // Attempts repeated after a failed one before the error is returned
+#endif
+#ifndef I2C_BACKOFF_US
+#define I2C_BACKOFF_US 100    // Wait before the first retry, doubled before each further one
+#endif
+#define I2C_RECOVER_CLOCKS 9  // SCL pulses that finish any byte a target can be sending
 #define BMI160_CMD_REG 0x7E   //command register for BMI160
 #define BMI160_PMU_STATUS_REG 0x03  // PMU status register for BMI160
 #define BMI160_I2C_ADDR 0x69       //Device Address
+#define BMI160_DATA_REG 0x0C        // GYR_X_L, start of the gyro and accel data (0x0C-0x17)
+#define BMI160_SAMPLE_AXES 6        // Gyro X/Y/Z followed by accel X/Y/Z
+#define BMI160_INT_EN_1_REG 0x51    // Interrupt enable 1, data ready in bit 4
+#define BMI160_INT_OUT_CTRL_REG 0x53    // INT1/INT2 output configuration
+#define BMI160_INT_MAP_1_REG 0x56   // Interrupt mapping 1, data ready to INT1 in bit 7
 
+/**
+ * @brief      Counters of the retry and bus recovery policy.
+ */
+typedef struct {
+    uint32_t retries;           // Attempts repeated after a failure
+    uint32_t nacks;             // Failed attempts the target did not acknowledge
+    uint32_t arb_lost;          // Failed attempts that lost arbitration on an idle bus
+    uint32_t stuck;             // Failed attempts that left SCL or SDA held low
+    uint32_t recoveries;        // Recoveries that freed the bus
+    uint32_t recovery_failures; // Recoveries that could not free it
+    uint32_t recover_cycles;    // Longest recovery, in core cycles
+} i2c_bus_stats_t;
 
 /***** Function Prototypes *****/
 /**
@@ -72,27 +111,71 @@ int i2c_init(void);
 /**
  * @brief      Scan for I2C slave devices on the bus.
  *             Setup the I2C frequency.
- * @return     return 0, If function is successful.
+ * @return     return 0, If function is successful. E_BUSY while an
+ *             asynchronous read is in progress.
 */
 int i2c_scan(void);
+/**
+ * @brief      Frees a bus that a target holds SDA low on, e.g. after it was
+ *             reset in the middle of a byte.
+ *
+ * SCL and SDA are taken over as GPIO. SCL is pulsed up to I2C_RECOVER_CLOCKS
+ * times until the target releases SDA, then a STOP is sent and the pins are
+ * handed back to a re-initialized controller. i2c_write_register() and
+ * i2c_read_register() call it when a failed attempt leaves a line low.
+ *
+ * @return     return 0, If the bus is free. E_COMM_ERR if SCL is held low or
+ *             SDA stays low. E_BUSY while an asynchronous read is in progress.
+*/
+int i2c_recover(void);
+/**
+ * @brief      Reads and optionally clears the retry and recovery counters.
+ * @param      stats    Receives the counters.
+ * @param      clear    Non-zero to reset the counters after reading.
+*/
+void i2c_get_bus_stats(i2c_bus_stats_t *stats, int clear);
 /**
  * @brief      Writes data to a specific register of an I2C slave device.
+ *             A failed write is retried up to I2C_RETRIES times with a
+ *             backoff, recovering the bus first if it is stuck. Under an RTOS
+ *             the calling task holds the bus for the whole write and sleeps
+ *             while the I2C interrupt completes each attempt and through
+ *             the backoff.
  * @param      address	     Address of the slave device.
  * @param      reg_adress    Address of the register to which writing to be done.
  * @param      data	     Pointer to the address of the data to be written in the Register address.
  * @param      length	     Length of the data to be written.
- * @return     return 0, If function is successful.
+ * @return     return 0, If function is successful. E_BUSY while an
+ *             asynchronous read is in progress.
 */
 int i2c_write_register(uint8_t address, uint8_t reg_adress, uint8_t* data, uint8_t length);
 /**
  * @brief      Reads data from the specific register of an I2C slave device.
+ *             Retried like i2c_write_register().
  * @param      address	     Address of the slave device.
  * @param      reg_adress    Address of the register from which reading to be done.
  * @param      buffer	     Pointer to the address of the buffer where reading is to be done.
  * @param      length	     Length of the buffer.
- * @return     return 0, If function is successful.
+ * @return     return 0, If function is successful. E_BUSY while an
+ *             asynchronous read is in progress.
 */
 int i2c_read_register(uint8_t address, uint8_t reg_adress, uint8_t* buffer, uint8_t length);
+/**
+ * @brief      Starts reading from a register of an I2C slave device and returns
+ *             without waiting. The register address write and the read form
+ *             one transaction with a repeated START; the I2C interrupt ends it.
+ *             One read can be in progress at a time. The bus lock is only held
+ *             while the read starts; until it ends the blocking calls above
+ *             return E_BUSY. Not part of the RISC-V image.
+ * @param      address	     Address of the slave device.
+ * @param      reg_adress    Address of the register from which reading to be done.
+ * @param      buffer	     Receives the data, must stay valid until @p done is signalled.
+ * @param      length	     Length of the buffer.
+ * @param      done	     Signalled with the result when the read has ended.
+ * @return     return 0, If the read was started. E_BUSY if a read is in progress.
+*/
+int i2c_read_register_async(uint8_t address, uint8_t reg_adress, uint8_t* buffer, uint8_t length,
+                            coop_event_t *done);
 /**
  * @brief      Structure to hold BMI160 device information.
  *
@@ -170,6 +253,24 @@ int bmi160_softi_reset(void);
  * @return     Returns 0 if the reset was verified successfully, -1 if verification failed.
  */
 int check_bmi160_reset(void);
+/**
+ * @brief      Reads one gyro and accelerometer sample from the BMI160.
+ *
+ * The twelve data registers are read in one burst, so all six axes belong to
+ * the same sample.
+ *
+ * @param[out] sample   Receives gyro X/Y/Z then accel X/Y/Z, raw two's complement.
+ *
+ * @return     Returns 0 if the function is successful, non-zero error code otherwise.
+ */
+int bmi160_read_sample(int16_t sample[BMI160_SAMPLE_AXES]);
+/**
+ * @brief      Routes the BMI160 data ready interrupt to INT1 as an active high
+ *             push-pull output, one pulse per new accelerometer sample.
+ *
+ * @return     Returns 0 if the function is successful, non-zero error code otherwise.
+ */
+int bmi160_enable_data_ready(void);
 #ifdef __cplusplus
 }
 #endif
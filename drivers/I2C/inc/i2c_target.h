@@ -0,0 +1,136 @@
+/**
+ * @file       i2c_target.h
+ * @brief      I2C target mode with a register map.
+ * @details    Serves a virtual register file to a host processor that is the
+ *             bus master. The host writes a register address, then writes or
+ *             reads registers from there on, the address moving on with every
+ *             byte. The application describes the register file as regions of
+ *             its own variables.
+ *
+ *             Reading I2C_TARGET_RESULT_REG streams the last published result
+ *             block instead. Results are double buffered: the application
+ *             fills the back buffer and publishes it in one step, and a read
+ *             that is under way keeps the buffer it started with, so the host
+ *             never sees half of one result and half of the next.
+ *
+ *             Bytes move through the 8-byte FIFOs from the FIFO threshold
+ *             interrupts.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __I2C_TARGET_H__
+#define __I2C_TARGET_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "i2c.h"
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#ifdef BOARD_EVKIT_V1
+#define I2C_TARGET MXC_I2C1           // I2C1 (P0.16, P0.17) faces the host on EVKIT_V1
+#else
+#define I2C_TARGET MXC_I2C0           // I2C0 (P0.10, P0.11) otherwise
+#endif
+
+#ifndef I2C_TARGET_ADDR
+#define I2C_TARGET_ADDR 0x3C          // 7-bit address the host reaches the MAX78000 at
+#endif
+#ifndef I2C_TARGET_RESULT_MAX
+#define I2C_TARGET_RESULT_MAX 256     // Largest result block in bytes
+#endif
+
+#define I2C_TARGET_RESULT_REG 0xF0    // Reading it streams the last published result
+#define I2C_TARGET_RESULT_HEADER 4    // Sequence number and length (little endian) before the block
+#define I2C_TARGET_RX_THRESH 6        // RX FIFO level that raises an interrupt
+#define I2C_TARGET_TX_THRESH 2        // TX FIFO level that raises an interrupt
+
+/**
+ * @brief      Called from the I2C interrupt at the end of a host write that
+ *             changed registers of a region.
+ * @param      reg      First register written in the region.
+ * @param      len      Number of registers written in the region.
+ */
+typedef void (*i2c_target_write_fn_t)(uint8_t reg, uint8_t len);
+
+/**
+ * @brief      Registers backed by application memory. Registers outside every
+ *             region read as 0xFF and ignore writes.
+ */
+typedef struct {
+    uint8_t reg;                    // First register
+    uint8_t len;                    // Number of registers, all below I2C_TARGET_RESULT_REG
+    uint8_t writable;               // Non-zero if the host may write them
+    uint8_t *data;                  // Register values, len bytes
+    i2c_target_write_fn_t written;  // Called after host writes, may be NULL
+} i2c_target_region_t;
+
+/**
+ * @brief      Target mode counters.
+ */
+typedef struct {
+    uint32_t transactions;          // Host transactions that ended
+    uint32_t bytes_read;            // Bytes the host read
+    uint32_t bytes_written;         // Bytes the host wrote, register addresses included
+    uint32_t result_reads;          // Reads of I2C_TARGET_RESULT_REG
+    uint32_t results;               // Results published
+    uint32_t interrupts;            // I2C interrupt events handled
+    uint32_t underflows;            // Bytes the host read before the TX FIFO was refilled
+    uint32_t overflows;             // Bytes the host wrote into a full RX FIFO
+} i2c_target_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Starts answering the host at I2C_TARGET_ADDR on I2C_TARGET.
+ * @param      map      Register regions, must stay valid while the target runs.
+ * @param      count    Number of regions.
+ * @return     E_NO_ERROR, E_BAD_PARAM if regions overlap or reach
+ *             I2C_TARGET_RESULT_REG, or the error of the I2C driver.
+ */
+int i2c_target_init(const i2c_target_region_t *map, unsigned int count);
+/**
+ * @brief      Returns the buffer the next result is built in.
+ *
+ * The buffer is not visible to the host until i2c_target_result_publish().
+ *
+ * @return     I2C_TARGET_RESULT_MAX bytes to fill, or NULL while the host is
+ *             still reading an older result from it; try again later.
+ */
+uint8_t *i2c_target_result_begin(void);
+/**
+ * @brief      Makes the buffer from i2c_target_result_begin() the result the
+ *             host reads next. A read under way finishes with the old result.
+ * @param      len      Bytes of the result.
+ * @return     E_NO_ERROR, E_BAD_PARAM if len exceeds I2C_TARGET_RESULT_MAX,
+ *             E_BAD_STATE without a buffer from i2c_target_result_begin().
+ */
+int i2c_target_result_publish(uint16_t len);
+/**
+ * @brief      Reads and optionally clears the target mode counters.
+ * @param      stats    Receives the counters.
+ * @param      clear    Non-zero to reset the counters after reading.
+ */
+void i2c_target_get_stats(i2c_target_stats_t *stats, int clear);
+
+#endif
@@ -1,20 +1,42 @@
- #include "i2c1.h"             // Include the I2C driver header file
- 
+#include "i2c1.h"             // Include the I2C driver header file
+#include "log.h"              // Deferred logging
+#include "ramfunc.h"          // SRAM placement of the interrupt path
+#include "blackbox.h"         // Crash black box events
+#include "bustrace.h"         // Transaction record for replay
+#include "osal.h"             // Bus lock and completion wait under an RTOS
+
+#ifdef __riscv
+// The RISC-V image (MAILBOX_RISCV) links no scheduler, so its delays spin
+#define sched_delay_ms(ms) MXC_Delay(MXC_DELAY_MSEC(ms))
+#endif
+
+// Held for a whole register access, retries and recovery included, when
+// several tasks share the bus
+static osal_mutex_t i2c_bus_lock;
+
+// Asynchronous read in progress. The blocking calls refuse the bus while one
+// is, as it runs without the bus lock held.
+#ifndef __riscv
+static mxc_i2c_req_t async_req;
+static uint8_t async_reg;
+#endif
+static coop_event_t *volatile async_done;   // NULL when idle
+
 // Initialize the I2C master interface
 int i2c_init(void) {
     int error = MXC_I2C_Init(I2C_MASTER, 1, 0);    // Initialize I2C with the defined master interface
     if (error != E_NO_ERROR) {
-        printf("-->I2C Master Initialization failed, error:%d\n", error); // Print error message if initialization fails
+        LOG_ERROR("I2C Master Initialization failed, error:%d", error); // Log error message if initialization fails
         return 1;
     } else {
-        printf("\n-->I2C Master Initialization Complete\n");
+        LOG_INFO("I2C Master Initialization Complete");
         return 0;
     }
 }
 
 // Scan for I2C slave devices on the bus
 int i2c_scan(void) {
-    printf("-->Scanning started\n");
+    LOG_INFO("I2C scanning started");
     MXC_I2C_SetFrequency(I2C_MASTER, I2C_FREQ);      // Set the I2C frequency
     mxc_i2c_req_t reqMaster;                         // Create an I2C request structure for the scan
     reqMaster.i2c = I2C_MASTER;
@@ -29,15 +51,19 @@ int i2c_scan(void) {
     int found = 0; // Flag to check if any device is found
     // Scan all possible addresses (0 to 127)
     for (uint8_t address = 0; address < 128; address++) {
-        printf(".");
-        fflush(0);
-
         reqMaster.addr = address;
-        if ((MXC_I2C_MasterTransaction(&reqMaster)) == 0) {
-            printf("\nFound slave ID %03d; 0x%02X\n", address, address);
+        osal_mutex_lock(&i2c_bus_lock);            // Per probe, not across the delays
+        if (async_done != NULL) {
+            osal_mutex_unlock(&i2c_bus_lock);
+            return E_BUSY;
+        }
+        int ret = MXC_I2C_MasterTransaction(&reqMaster);
+        osal_mutex_unlock(&i2c_bus_lock);
+        if (ret == 0) {
+            LOG_INFO("Found slave ID %03d; 0x%02X", address, address);
             found = 1; // Set flag to indicate a device is found
         }
-        MXC_Delay(MXC_DELAY_MSEC(200));             // Delay for 200 milliseconds 
+        sched_delay_ms(200);                        // Sleep for 200 milliseconds
     }
        if (found) {
         return 0; // At least one device was found
@@ -47,9 +73,188 @@ int i2c_scan(void) {
 }
 
 
+#define I2C_SCL_MASK (1UL << I2C_SCL_PIN)
+#define I2C_SDA_MASK (1UL << I2C_SDA_PIN)
+#define I2C_HALF_BIT_US (500000 / I2C_FREQ)     // Half an SCL period during recovery
+
+// Retry and recovery counters
+static i2c_bus_stats_t bus_stats;
+
+// Releases bus pins (level 1, the pull-ups take them high) or drives them low
+// as GPIO, then waits half a bit
+static void i2c_pin_set(uint32_t mask, int level) {
+    mxc_gpio_cfg_t cfg;
+    cfg.port = I2C_GPIO_PORT;
+    cfg.mask = mask;
+    cfg.func = level ? MXC_GPIO_FUNC_IN : MXC_GPIO_FUNC_OUT;
+    cfg.pad = MXC_GPIO_PAD_NONE;
+    cfg.vssel = MXC_GPIO_VSSEL_VDDIO;
+    cfg.drvstr = MXC_GPIO_DRVSTR_0;
+    if (!level) {
+        MXC_GPIO_OutClr(I2C_GPIO_PORT, mask);   // Low before the output turns on
+    }
+    MXC_GPIO_Config(&cfg);
+    MXC_Delay(MXC_DELAY_USEC(I2C_HALF_BIT_US));
+}
+
+// Clock a stuck target free and send a STOP, with the bus lock held
+static int i2c_recover_locked(void) {
+    uint32_t start = cycles_now();
+    unsigned int hz = MXC_I2C_GetFrequency(I2C_MASTER);
+    int ret = E_NO_ERROR;
+    int clocks = 0;
+
+    i2c_pin_set(I2C_SCL_MASK | I2C_SDA_MASK, 1);
+    if (MXC_GPIO_InGet(I2C_GPIO_PORT, I2C_SCL_MASK) == 0) {
+        ret = E_COMM_ERR;   // Something holds SCL, pulsing it cannot help
+    } else {
+        // The target shifts out one bit per pulse and lets go of SDA at a 1
+        // bit or at the acknowledge slot, which the master leaves high
+        while (clocks < I2C_RECOVER_CLOCKS && MXC_GPIO_InGet(I2C_GPIO_PORT, I2C_SDA_MASK) == 0) {
+            i2c_pin_set(I2C_SCL_MASK, 0);
+            i2c_pin_set(I2C_SCL_MASK, 1);
+            clocks++;
+        }
+        if (MXC_GPIO_InGet(I2C_GPIO_PORT, I2C_SDA_MASK) == 0) {
+            ret = E_COMM_ERR;
+        } else {
+            // STOP, SDA rising while SCL is high, ends whatever the target thinks is going on
+            i2c_pin_set(I2C_SCL_MASK, 0);
+            i2c_pin_set(I2C_SDA_MASK, 0);
+            i2c_pin_set(I2C_SCL_MASK, 1);
+            i2c_pin_set(I2C_SDA_MASK, 1);
+        }
+    }
+    // The controller gets its pins back, starting again from idle
+    int err = MXC_I2C_Init(I2C_MASTER, 1, 0);
+    if (err == E_NO_ERROR && hz != 0) {
+        MXC_I2C_SetFrequency(I2C_MASTER, hz);
+    } else if (err != E_NO_ERROR) {
+        ret = err;
+    }
+
+    uint32_t cycles = cycles_now() - start;
+    if (cycles > bus_stats.recover_cycles) {
+        bus_stats.recover_cycles = cycles;
+    }
+    if (ret == E_NO_ERROR) {
+        bus_stats.recoveries++;
+        LOG_WARN("I2C bus recovered after %d clocks", clocks);
+    } else {
+        bus_stats.recovery_failures++;
+        LOG_ERROR("I2C bus recovery failed, error: %d", ret);
+    }
+    blackbox_event(BLACKBOX_EV_I2C_RECOVER, ret, cycles);
+    return ret;
+}
+
+int i2c_recover(void) {
+    osal_mutex_lock(&i2c_bus_lock);
+    int ret = (async_done != NULL) ? E_BUSY : i2c_recover_locked();
+    osal_mutex_unlock(&i2c_bus_lock);
+    return ret;
+}
+
+void i2c_get_bus_stats(i2c_bus_stats_t *stats, int clear) {
+    *stats = bus_stats;
+    if (clear) {
+        memset(&bus_stats, 0, sizeof(bus_stats));
+    }
+}
+
+// Decides whether a failed attempt is repeated. Waits the backoff first, so a
+// line another master still drives is not mistaken for a stuck bus, then
+// frees the bus if a line stayed low.
+static int i2c_retry(int err, unsigned int *attempt, stats_op_id_t op) {
+    unsigned int flags0, flags1;
+
+    if (err != E_COMM_ERR || *attempt >= I2C_RETRIES) {
+        return 0;           // Done, out of attempts, or an error retrying cannot fix
+    }
+    blackbox_event(BLACKBOX_EV_I2C_RETRY, err, *attempt);
+#if OSAL_RTOS
+    if (osal_running()) {
+        // Sleep rather than spin, the bus lock stays held but the core goes
+        // to the other tasks; the tick rounds the wait up to a millisecond
+        osal_delay_ms(((I2C_BACKOFF_US << *attempt) + 999) / 1000);
+    } else
+#endif
+    MXC_Delay(MXC_DELAY_USEC(I2C_BACKOFF_US << *attempt));
+    if (MXC_GPIO_InGet(I2C_GPIO_PORT, I2C_SCL_MASK | I2C_SDA_MASK) != (I2C_SCL_MASK | I2C_SDA_MASK)) {
+        bus_stats.stuck++;
+        if (i2c_recover_locked() != E_NO_ERROR) {
+            return 0;
+        }
+    } else {
+        MXC_I2C_GetFlags(I2C_MASTER, &flags0, &flags1);
+        if (flags0 & MXC_F_I2C_INTFL0_ARB_ERR) {
+            bus_stats.arb_lost++;
+        } else {
+            bus_stats.nacks++;
+        }
+    }
+    (*attempt)++;
+    bus_stats.retries++;
+    STATS_RETRY(op);
+    return 1;
+}
+
+#if OSAL_RTOS || !defined(__riscv)
+static RAMFUNC void i2c_async_irq(void) {
+    MXC_I2C_AsyncHandler(I2C_MASTER);
+}
+#endif
+
+#if OSAL_RTOS
+// Completion of the transaction a task waits for; the bus lock makes it one at a time
+static osal_sem_t i2c_wait_done;
+static volatile int i2c_wait_result;
+static int i2c_wait_ready;
+
+static RAMFUNC void i2c_wait_complete(mxc_i2c_req_t *req, int result) {
+    (void)req;
+    i2c_wait_result = result;
+    osal_sem_give_isr(&i2c_wait_done);
+}
+#endif
+
+// One transaction. A task sleeps until the I2C interrupt ends it, leaving the
+// core to the other tasks; without a running scheduler it is polled. The
+// controller ends every transaction, with an error on a stuck bus, so the
+// wait has no timeout.
+static int i2c_transact(mxc_i2c_req_t *req) {
+    MXC_I2C_ClearFlags(I2C_MASTER, 0xFFFFFFFF, 0xFFFFFFFF);
+#if OSAL_RTOS
+    if (osal_running()) {
+        if (!i2c_wait_ready) {
+            osal_sem_init(&i2c_wait_done, 0);
+            i2c_wait_ready = 1;
+        }
+        req->callback = i2c_wait_complete;
+        IRQn_Type irq = MXC_I2C_GET_IRQ(MXC_I2C_GET_IDX(I2C_MASTER));
+        MXC_NVIC_SetVector(irq, i2c_async_irq);
+        NVIC_EnableIRQ(irq);
+        int ret = MXC_I2C_MasterTransactionAsync(req);
+        if (ret == E_NO_ERROR) {
+            osal_sem_take(&i2c_wait_done, OSAL_WAIT_FOREVER);
+            ret = i2c_wait_result;
+        }
+        req->callback = NULL;
+        return ret;
+    }
+#endif
+    return MXC_I2C_MasterTransaction(req);
+}
+
 // Write data to a specific register of an I2C slave device
 int i2c_write_register(uint8_t address, uint8_t reg_address, uint8_t* data, uint8_t length) {
-    uint8_t write_buf[length + 1];          // Buffer to hold register address and data
+    STATS_BEGIN();
+    BUSTRACE_BEGIN();
+    uint8_t *write_buf = pool_alloc(length + 1);    // Register address followed by the data
+    if (write_buf == NULL) {
+        STATS_END(STATS_I2C_WRITE, 0, E_NONE_AVAIL);
+        return E_NONE_AVAIL;
+    }
     write_buf[0] = reg_address;             // First byte is the register address
     
     // Copy data to be written into the buffer
@@ -59,12 +264,9 @@ int i2c_write_register(uint8_t address, uint8_t reg_address, uint8_t* data, uint
         length = 0; // No data to write
     }
     
-    // Print the data being written for debugging
-    printf("Writing to address 0x%02X, register 0x%02X, data: ", address, reg_address);
-    for (int i = 0; i < length; i++) {
-        printf("0x%02X ", data[i]);
-    }
-    printf("\n");
+    // Log the write for debugging, with the first data byte
+    LOG_DEBUG("I2C write address 0x%02X, register 0x%02X, length %u, data[0] 0x%02X",
+              address, reg_address, length, (length > 0) ? data[0] : 0);
     
     // Create an I2C request structure for the write operation
     mxc_i2c_req_t req;
@@ -77,28 +279,47 @@ int i2c_write_register(uint8_t address, uint8_t reg_address, uint8_t* data, uint
     req.restart = 0;
     req.callback = NULL;
 
-    return MXC_I2C_MasterTransaction(&req); // Perform the I2C write transaction
+    unsigned int attempt = 0;
+    int ret;
+    osal_mutex_lock(&i2c_bus_lock);
+    if (async_done != NULL) {
+        ret = E_BUSY;
+    } else {
+        do {
+            ret = i2c_transact(&req); // Perform the I2C write transaction
+        } while (i2c_retry(ret, &attempt, STATS_I2C_WRITE));
+    }
+    osal_mutex_unlock(&i2c_bus_lock);
+    pool_free(write_buf);
+    STATS_END(STATS_I2C_WRITE, length, ret);
+    BUSTRACE_END(BUSTRACE_I2C_WRITE, (address << 8) | reg_address, data, length, ret);
+    return ret;
 }
 
-// Read data from a specific register of an I2C slave device
-int i2c_read_register(uint8_t address, uint8_t reg_address, uint8_t* buffer, uint8_t length) {
-    printf("Setting register address 0x%02X for reading\n", reg_address);
-    
+// One attempt of a register read: the register address write, then the read
+static int i2c_read_once(uint8_t address, uint8_t* reg_address, uint8_t* buffer, uint8_t length) {
     // Create an I2C request structure to set the register address for reading
     mxc_i2c_req_t req;
     req.i2c = I2C_MASTER;
     req.addr = address;
-    req.tx_buf = &reg_address;
+    req.tx_buf = reg_address;
     req.tx_len = 1;
     req.rx_buf = NULL;
     req.rx_len = 0;
     req.restart = 1; // Restart without sending stop condition
     req.callback = NULL;
-    
+
+    if (osal_running()) {
+        // One interrupt driven transaction: the register write, a repeated START, the read
+        req.rx_buf = buffer;
+        req.rx_len = length;
+        req.restart = 0;
+        return i2c_transact(&req);
+    }
+
     // Perform the write transaction to set the register address
-    int ret = MXC_I2C_MasterTransaction(&req);
+    int ret = i2c_transact(&req);
     if (ret != E_NO_ERROR) {
-        printf("I2C write (register address) error: %d\n", ret);
         return ret;
     }
     
@@ -109,21 +330,85 @@ int i2c_read_register(uint8_t address, uint8_t reg_address, uint8_t* buffer, uin
     req.rx_len = length;
     req.restart = 0; // No restart, complete the transaction
 
-    ret = MXC_I2C_MasterTransaction(&req);
+    return i2c_transact(&req);
+}
+
+// Read data from a specific register of an I2C slave device
+int i2c_read_register(uint8_t address, uint8_t reg_address, uint8_t* buffer, uint8_t length) {
+    STATS_BEGIN();
+    BUSTRACE_BEGIN();
+    unsigned int attempt = 0;
+    int ret;
+    osal_mutex_lock(&i2c_bus_lock);
+    if (async_done != NULL) {
+        ret = E_BUSY;
+    } else {
+        do {
+            ret = i2c_read_once(address, &reg_address, buffer, length);
+        } while (i2c_retry(ret, &attempt, STATS_I2C_READ));
+    }
+    osal_mutex_unlock(&i2c_bus_lock);
     if (ret != E_NO_ERROR) {
-        printf("I2C read error: %d\n", ret);
+        LOG_ERROR("I2C read (register address 0x%02X) error: %d after %u attempts",
+                  reg_address, ret, attempt + 1);
+        STATS_END(STATS_I2C_READ, 0, ret);
+        BUSTRACE_END(BUSTRACE_I2C_READ, (address << 8) | reg_address, buffer, length, ret);
         return ret;
     }
-    printf("\n");
-    // Print the data being read for debugging
-    printf("Read from address 0x%02X, register 0x%02X, data: ", address, reg_address);
-    for (int i = 0; i < length; i++) {
-        printf("0x%02X ", buffer[i]);
+    // Log the read for debugging, with the first data byte
+    LOG_DEBUG("I2C read address 0x%02X, register 0x%02X, length %u, data[0] 0x%02X",
+              address, reg_address, length, (length > 0) ? buffer[0] : 0);
+
+    STATS_END(STATS_I2C_READ, length, ret);
+    BUSTRACE_END(BUSTRACE_I2C_READ, (address << 8) | reg_address, buffer, length, ret);
+    return ret;
+}
+#ifndef __riscv              // No cooperative tasks to signal on the RISC-V core
+// Called from the I2C interrupt when the read has ended
+static RAMFUNC void i2c_async_complete(mxc_i2c_req_t *req, int result) {
+    coop_event_t *done = async_done;
+    async_done = NULL;
+    if (result == E_NO_ERROR) {
+        LOG_DEBUG("I2C async read address 0x%02X, register 0x%02X, length %u, data[0] 0x%02X",
+                  req->addr, async_reg, req->rx_len, (req->rx_len > 0) ? req->rx_buf[0] : 0);
+    } else {
+        LOG_ERROR("I2C async read error: %d", result);
     }
-    printf("\n");
+    coop_signal(done, result);
+}
 
+// Start a register read that completes in the I2C interrupt
+int i2c_read_register_async(uint8_t address, uint8_t reg_address, uint8_t* buffer, uint8_t length,
+                            coop_event_t *done) {
+    // Held only while starting, so no blocking access is in the middle of a transaction
+    osal_mutex_lock(&i2c_bus_lock);
+    if (async_done != NULL) {
+        osal_mutex_unlock(&i2c_bus_lock);
+        return E_BUSY;
+    }
+    async_reg = reg_address;
+    async_req.i2c = I2C_MASTER;
+    async_req.addr = address;
+    async_req.tx_buf = &async_reg;
+    async_req.tx_len = 1;
+    async_req.rx_buf = buffer;
+    async_req.rx_len = length;
+    async_req.restart = 0;
+    async_req.callback = i2c_async_complete;
+    async_done = done;
+
+    IRQn_Type irq = MXC_I2C_GET_IRQ(MXC_I2C_GET_IDX(I2C_MASTER));
+    MXC_NVIC_SetVector(irq, i2c_async_irq);
+    NVIC_EnableIRQ(irq);
+    int ret = MXC_I2C_MasterTransactionAsync(&async_req);
+    if (ret != E_NO_ERROR) {
+        async_done = NULL;
+        LOG_ERROR("I2C async read error: %d", ret);
+    }
+    osal_mutex_unlock(&i2c_bus_lock);
     return ret;
 }
+#endif
 //Setting the accelerometer to Normal mode
 int set_accelerometer_normal_mode(struct bmi160_dev *dev)
 {
@@ -170,19 +455,19 @@ int bmi160_softi_reset(void)
 {
     // BMI160 soft reset command
     uint8_t cmd = 0xB6; // Soft reset command for BMI160
-    printf("Writing to address 0x%02X, register 0x%02X, data: 0x%02X\n", BMI160_I2C_ADDR, BMI160_CMD_REG, cmd);
+    LOG_DEBUG("BMI160 soft reset: address 0x%02X, register 0x%02X, data: 0x%02X", BMI160_I2C_ADDR, BMI160_CMD_REG, cmd);
 
     int result = i2c_write_register(BMI160_I2C_ADDR, BMI160_CMD_REG, &cmd, 1);
     if (result != E_NO_ERROR)
     {
-        printf("Failed to perform soft reset, error: %d\n", result);
+        LOG_ERROR("Failed to perform soft reset, error: %d", result);
         return result;
     }
 
     // Delay to allow the reset to complete
-    MXC_Delay(MXC_DELAY_MSEC(100));
+    sched_delay_ms(100);
 
-    printf("Soft reset performed successfully.\n");
+    LOG_INFO("Soft reset performed successfully.");
     return E_NO_ERROR;
 }
 //Checks whether register Reset or Not
@@ -192,19 +477,49 @@ int check_bmi160_reset(void)
     int result = i2c_read_register(BMI160_I2C_ADDR, BMI160_CMD_REG, &reg_value, 1);
     if (result != E_NO_ERROR)
     {
-        printf("Failed to read PMU_STATUS register, error: %d\n", result);
+        LOG_ERROR("Failed to read CMD register, error: %d", result);
         return result;
     }
 
     // Compare with the default value expected after a soft reset
     if (reg_value == 0x00)
     { 
-        printf("Soft reset verified: CMD_Register = 0x%02X\n", reg_value);
+        LOG_INFO("Soft reset verified: CMD_Register = 0x%02X", reg_value);
         return E_NO_ERROR;
     }
     else
     {
-        printf("Soft reset failed or not verified: INT_MAP = 0x%02X\n", reg_value);
+        LOG_WARN("Soft reset failed or not verified: CMD_Register = 0x%02X", reg_value);
         return -1;
     }
 }
+// Burst read of the gyro and accelerometer data registers
+int bmi160_read_sample(int16_t sample[BMI160_SAMPLE_AXES])
+{
+    uint8_t raw[BMI160_SAMPLE_AXES * 2];
+    int result = i2c_read_register(BMI160_I2C_ADDR, BMI160_DATA_REG, raw, sizeof(raw));
+    if (result != E_NO_ERROR) {
+        return result;
+    }
+    // Registers are little endian, LSB first
+    for (int i = 0; i < BMI160_SAMPLE_AXES; i++) {
+        sample[i] = (int16_t)(raw[2 * i] | (raw[2 * i + 1] << 8));
+    }
+    return E_NO_ERROR;
+}
+// Data ready on INT1, active high push-pull
+int bmi160_enable_data_ready(void)
+{
+    uint8_t out_ctrl = 0x0A;    // INT1 output enable, active high
+    uint8_t map = 0x80;         // Data ready to INT1
+    uint8_t enable = 0x10;      // Data ready interrupt enable
+
+    int result = i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_OUT_CTRL_REG, &out_ctrl, 1);
+    if (result == E_NO_ERROR) {
+        result = i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_MAP_1_REG, &map, 1);
+    }
+    if (result == E_NO_ERROR) {
+        result = i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_EN_1_REG, &enable, 1);
+    }
+    return result;
+}
@@ -0,0 +1,285 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "i2c_target.h"
+#include "nvic_table.h"
+#include "mxc_errors.h"
+#include "log.h"
+#include "ramfunc.h"
+
+/***** Definitions *****/
+#if I2C_TARGET_RESULT_MAX > 0xFFFF
+#error "I2C_TARGET_RESULT_MAX must fit the 16-bit length of the result header"
+#endif
+
+#define I2C_TARGET_NONE (-1)    // No result buffer
+
+/***** Globals *****/
+static const i2c_target_region_t *target_map;  // Register regions
+static unsigned int target_regions;            // Number of regions
+static uint8_t target_ptr;                     // Register address of the next byte
+static int target_addressing;                  // Next byte written sets target_ptr
+static uint8_t target_wr_first;                // First register written in the transaction
+static unsigned int target_wr_count;           // Registers written in the transaction
+static unsigned int target_loaded;             // Bytes put in the TX FIFO this transaction
+static int target_reading = I2C_TARGET_NONE;   // Result buffer the host is reading
+static unsigned int target_offset;             // Next byte of that buffer
+static volatile int target_front;              // Last published result buffer
+static int target_back = I2C_TARGET_NONE;      // Buffer handed out by i2c_target_result_begin()
+static uint16_t target_seq;                    // Sequence number of the last result
+static uint8_t target_result[2][I2C_TARGET_RESULT_HEADER + I2C_TARGET_RESULT_MAX];
+static i2c_target_stats_t target_stats;
+
+/***** Functions *****/
+// Returns the region holding a register, NULL if it is not mapped
+static RAMFUNC const i2c_target_region_t *i2c_target_find(uint8_t reg)
+{
+    for (unsigned int i = 0; i < target_regions; i++) {
+        if (reg >= target_map[i].reg && reg - target_map[i].reg < target_map[i].len) {
+            return &target_map[i];
+        }
+    }
+    return NULL;
+}
+/******************************************************************************/
+// Returns the next byte for the host: the result stream or the register file
+static RAMFUNC uint8_t i2c_target_next(void)
+{
+    if (target_reading != I2C_TARGET_NONE) {
+        const uint8_t *buf = target_result[target_reading];
+        unsigned int size = I2C_TARGET_RESULT_HEADER + (buf[2] | (buf[3] << 8));
+        return (target_offset < size) ? buf[target_offset++] : 0xFF;
+    }
+    const i2c_target_region_t *r = i2c_target_find(target_ptr);
+    uint8_t value = (r != NULL) ? r->data[target_ptr - r->reg] : 0xFF;
+    target_ptr++;
+    return value;
+}
+/******************************************************************************/
+// Tops up the TX FIFO
+static RAMFUNC void i2c_target_fill(void)
+{
+    uint8_t chunk[MXC_I2C_FIFO_DEPTH];
+    int space = MXC_I2C_GetTXFIFOAvailable(I2C_TARGET);
+    for (int i = 0; i < space; i++) {
+        chunk[i] = i2c_target_next();
+    }
+    if (space > 0) {
+        target_loaded += MXC_I2C_WriteTXFIFO(I2C_TARGET, chunk, space);
+    }
+}
+/******************************************************************************/
+// Takes the bytes the host wrote: the register address, then register values
+static RAMFUNC void i2c_target_drain(void)
+{
+    uint8_t chunk[MXC_I2C_FIFO_DEPTH];
+    int n = MXC_I2C_ReadRXFIFO(I2C_TARGET, chunk, sizeof(chunk));
+
+    target_stats.bytes_written += n;
+    for (int i = 0; i < n; i++) {
+        if (target_addressing) {
+            target_ptr = chunk[i];
+            target_addressing = 0;
+            continue;
+        }
+        const i2c_target_region_t *r = i2c_target_find(target_ptr);
+        if (r != NULL && r->writable) {
+            r->data[target_ptr - r->reg] = chunk[i];
+            if (target_wr_count == 0) {
+                target_wr_first = target_ptr;
+            }
+            target_wr_count++;
+        }
+        target_ptr++;
+    }
+}
+/******************************************************************************/
+// Tells every region the host wrote to
+static RAMFUNC void i2c_target_notify(void)
+{
+    if (target_wr_count == 0) {
+        return;
+    }
+    unsigned int first = target_wr_first;
+    unsigned int end = first + target_wr_count;
+    for (unsigned int i = 0; i < target_regions; i++) {
+        const i2c_target_region_t *r = &target_map[i];
+        unsigned int lo = (first > r->reg) ? first : r->reg;
+        unsigned int hi = (end < (unsigned int)r->reg + r->len) ? end : (unsigned int)r->reg + r->len;
+        if (r->writable && r->written != NULL && lo < hi) {
+            r->written((uint8_t)lo, (uint8_t)(hi - lo));
+        }
+    }
+    target_wr_count = 0;
+}
+/******************************************************************************/
+// Target events from the I2C interrupt
+static RAMFUNC int i2c_target_event(mxc_i2c_regs_t *i2c, mxc_i2c_slave_event_t event, void *data)
+{
+    (void)i2c;
+    (void)data;
+    target_stats.interrupts++;
+
+    switch (event) {
+    case MXC_I2C_EVT_MASTER_WR:
+        target_addressing = 1;
+        break;
+    case MXC_I2C_EVT_RX_THRESH:
+        i2c_target_drain();
+        break;
+    case MXC_I2C_EVT_MASTER_RD:
+        // A write before the repeated START set the register address
+        i2c_target_drain();
+        i2c_target_notify();
+        target_loaded = 0;
+        if (target_ptr == I2C_TARGET_RESULT_REG) {
+            target_reading = target_front;
+            target_offset = 0;
+            target_stats.result_reads++;
+        }
+        i2c_target_fill();
+        break;
+    case MXC_I2C_EVT_UNDERFLOW:
+        target_stats.underflows++;
+        i2c_target_fill();
+        break;
+    case MXC_I2C_EVT_TX_THRESH:
+        i2c_target_fill();
+        break;
+    case MXC_I2C_EVT_OVERFLOW:
+        target_stats.overflows++;
+        break;
+    case MXC_I2C_EVT_TRANS_COMP: {
+        i2c_target_drain();
+        i2c_target_notify();
+        // Bytes fetched ahead that the host did not read give their registers back
+        unsigned int unread = MXC_I2C_FIFO_DEPTH - MXC_I2C_GetTXFIFOAvailable(I2C_TARGET);
+        MXC_I2C_ClearTXFIFO(I2C_TARGET);
+        if (target_reading == I2C_TARGET_NONE) {
+            target_ptr -= unread;
+        }
+        target_stats.bytes_read += target_loaded - unread;
+        target_loaded = 0;
+        target_reading = I2C_TARGET_NONE;
+        target_stats.transactions++;
+        MXC_I2C_SlaveTransactionAsync(I2C_TARGET, i2c_target_event);
+        break;
+    }
+    }
+    return 0;
+}
+/******************************************************************************/
+static RAMFUNC void i2c_target_irq(void)
+{
+    MXC_I2C_AsyncHandler(I2C_TARGET);
+}
+/******************************************************************************/
+int i2c_target_init(const i2c_target_region_t *map, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++) {
+        if (map[i].data == NULL || map[i].reg + map[i].len > I2C_TARGET_RESULT_REG) {
+            return E_BAD_PARAM;
+        }
+        for (unsigned int j = 0; j < i; j++) {
+            if (map[i].reg < map[j].reg + map[j].len && map[j].reg < map[i].reg + map[i].len) {
+                return E_BAD_PARAM;
+            }
+        }
+    }
+    int err = MXC_I2C_Init(I2C_TARGET, 0, I2C_TARGET_ADDR);
+    if (err != E_NO_ERROR) {
+        LOG_ERROR("I2C target initialization failed, error: %d", err);
+        return err;
+    }
+    MXC_I2C_SetRXThreshold(I2C_TARGET, I2C_TARGET_RX_THRESH);
+    MXC_I2C_SetTXThreshold(I2C_TARGET, I2C_TARGET_TX_THRESH);
+
+    target_map = map;
+    target_regions = count;
+    target_ptr = 0;
+    target_wr_count = 0;
+    target_reading = I2C_TARGET_NONE;
+    target_back = I2C_TARGET_NONE;
+    target_front = 0;
+    target_seq = 0;
+    memset(target_result, 0, sizeof(target_result));    // Empty result 0 until the first publish
+    memset(&target_stats, 0, sizeof(target_stats));
+
+    IRQn_Type irq = MXC_I2C_GET_IRQ(MXC_I2C_GET_IDX(I2C_TARGET));
+    MXC_NVIC_SetVector(irq, i2c_target_irq);
+    NVIC_EnableIRQ(irq);
+    err = MXC_I2C_SlaveTransactionAsync(I2C_TARGET, i2c_target_event);
+    if (err == E_NO_ERROR) {
+        LOG_INFO("I2C target at address 0x%02X", I2C_TARGET_ADDR);
+    }
+    return err;
+}
+/******************************************************************************/
+uint8_t *i2c_target_result_begin(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    int back = 1 - target_front;
+    if (back == target_reading) {
+        back = I2C_TARGET_NONE;     // The host is still reading an older result from it
+    }
+    target_back = back;
+    __set_PRIMASK(primask);
+    return (back == I2C_TARGET_NONE) ? NULL : &target_result[back][I2C_TARGET_RESULT_HEADER];
+}
+/******************************************************************************/
+int i2c_target_result_publish(uint16_t len)
+{
+    if (len > I2C_TARGET_RESULT_MAX) {
+        return E_BAD_PARAM;
+    }
+    if (target_back == I2C_TARGET_NONE) {
+        return E_BAD_STATE;
+    }
+    uint8_t *buf = target_result[target_back];
+    target_seq++;
+    buf[0] = target_seq & 0xFF;
+    buf[1] = target_seq >> 8;
+    buf[2] = len & 0xFF;
+    buf[3] = len >> 8;
+
+    // Reads that start from now on get the new buffer
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    target_front = target_back;
+    target_back = I2C_TARGET_NONE;
+    target_stats.results++;
+    __set_PRIMASK(primask);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void i2c_target_get_stats(i2c_target_stats_t *stats, int clear)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = target_stats;
+    if (clear) {
+        memset(&target_stats, 0, sizeof(target_stats));
+    }
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file       spi1.h
+ * @brief      SPI master driver.
+ * @details    Drives SPI1 as a master for devices that each have their own
+ *             slave select, clock mode and SCK frequency. Transfers are full
+ *             duplex and move by CPU (spi_transfer) or DMA (spi_transfer_dma).
+ *             A transaction list runs several slave select framed transfers,
+ *             possibly to different devices, from one call: each DMA
+ *             completion interrupt starts the next transfer, so the caller is
+ *             not involved until the whole list has ended. SPI0 carries the
+ *             QSPI flash, see qspi_flash.h.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __SPI1_H__
+#define __SPI1_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+#include "mxc_device.h"
+#include "mxc_errors.h"
+#include "nvic_table.h"
+#include "spi.h"
+#include "dma.h"
+#include "stats.h"
+#include "coop.h"
+
+/***** Definitions *****/
+#define SPI_MASTER MXC_SPI1         // SPI0 is taken by the QSPI flash
+#define SPI_SS_COUNT 3              // Slave select outputs driven by the controller
+
+#ifndef SPI_FREQ
+#define SPI_FREQ 1000000            // SCK frequency after spi_init(), in Hz
+#endif
+
+/**
+ * @brief      Device on the bus. Passed by pointer to every transfer; the
+ *             controller is reconfigured when the clock or mode changes.
+ */
+typedef struct {
+    int ss;                     // Slave select index, below SPI_SS_COUNT
+    mxc_spi_mode_t mode;        // Clock polarity and phase
+    unsigned int hz;            // SCK frequency
+} spi_device_t;
+
+/**
+ * @brief      One slave select framed transfer of a transaction list.
+ */
+typedef struct {
+    const spi_device_t *dev;    // Device selected for the transfer
+    const uint8_t *tx;          // Bytes sent, NULL to send 0xFF
+    uint8_t *rx;                // Receives the bytes clocked in, NULL to drop them
+    uint32_t len;               // Bytes in each direction
+    uint8_t cs_hold;            // Keep the slave select asserted into the next
+                                // transfer, which must be for the same device
+} spi_xfer_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes SPI1 as master at SPI_FREQ, mode 0, and installs the
+ *             DMA interrupt handlers.
+ * @return     E_NO_ERROR or an SPI error.
+ */
+int spi_init(void);
+/**
+ * @brief      Runs one full duplex transfer, the CPU moving the data.
+ * @param      dev      Device to select.
+ * @param      tx       Bytes sent, NULL to send 0xFF.
+ * @param      rx       Receives the bytes clocked in, NULL to drop them.
+ * @param      len      Bytes in each direction.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_BUSY while another transfer runs, or
+ *             an SPI error.
+ */
+int spi_transfer(const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+/**
+ * @brief      Runs one full duplex transfer, DMA moving the data. Blocks until
+ *             the transfer is complete.
+ * @param      dev      Device to select.
+ * @param      tx       Bytes sent, NULL to send 0xFF.
+ * @param      rx       Receives the bytes clocked in, NULL to drop them.
+ * @param      len      Bytes in each direction.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_BUSY while another transfer runs, or
+ *             an SPI error.
+ */
+int spi_transfer_dma(const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len);
+/**
+ * @brief      Runs a transaction list and blocks until it has ended.
+ *
+ * The transfers run in order, each by DMA and framed by its device's slave
+ * select unless cs_hold joins it to the next one. The first failed transfer
+ * ends the list.
+ *
+ * @param      list     Transfers.
+ * @param      count    Number of transfers, at least one.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_BUSY while another transfer runs, or
+ *             the SPI error of the failed transfer.
+ */
+int spi_run(const spi_xfer_t *list, unsigned int count);
+/**
+ * @brief      Starts a transaction list, see spi_run(), and returns without
+ *             waiting. One list can run at a time.
+ * @param      list     Transfers, must stay valid until @p done is signalled.
+ * @param      count    Number of transfers, at least one.
+ * @param      done     Signalled with the result when the list has ended, or NULL.
+ * @return     E_NO_ERROR if the list was started, E_BAD_PARAM, E_BUSY while
+ *             another transfer runs, or an SPI error.
+ */
+int spi_run_async(const spi_xfer_t *list, unsigned int count, coop_event_t *done);
+/**
+ * @brief      Returns non-zero while a transfer or transaction list runs.
+ */
+int spi_busy(void);
+
+#endif
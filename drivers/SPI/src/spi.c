@@ -0,0 +1,254 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "spi1.h"
+#include "log.h"
+#include "ramfunc.h"
+#include "blackbox.h"
+
+/***** Globals *****/
+static unsigned int spi_hz;                     // SCK frequency the controller runs at
+static mxc_spi_mode_t spi_mode;                 // Mode the controller runs in
+static mxc_spi_req_t spi_req;                   // Request of the running list transfer
+static const spi_xfer_t *volatile spi_list;     // Running list transfer, NULL when idle
+static unsigned int spi_list_left;              // Transfers after the running one
+static coop_event_t *spi_list_done;             // Signalled when the list has ended
+static volatile int spi_list_result;            // Result of the last list
+
+/***** Functions *****/
+// Services the DMA channels the SPI driver acquires for a transfer
+static RAMFUNC void spi_dma_irq(void)
+{
+    MXC_DMA_Handler();
+}
+/******************************************************************************/
+// Switches the controller to the clock and mode of a device
+static RAMFUNC int spi_configure(const spi_device_t *dev)
+{
+    int err;
+    if (dev->hz != spi_hz) {
+        if ((err = MXC_SPI_SetFrequency(SPI_MASTER, dev->hz)) != E_NO_ERROR) {
+            return err;
+        }
+        spi_hz = dev->hz;
+    }
+    if (dev->mode != spi_mode) {
+        if ((err = MXC_SPI_SetMode(SPI_MASTER, dev->mode)) != E_NO_ERROR) {
+            return err;
+        }
+        spi_mode = dev->mode;
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Fills a request for one transfer
+static RAMFUNC void spi_fill_req(mxc_spi_req_t *req, const spi_xfer_t *x)
+{
+    req->spi = SPI_MASTER;
+    req->ssIdx = x->dev->ss;
+    req->ssDeassert = !x->cs_hold;
+    req->txData = (uint8_t *)x->tx;
+    req->txLen = (x->tx != NULL) ? x->len : 0;
+    req->rxData = x->rx;
+    req->rxLen = (x->rx != NULL) ? x->len : 0;
+    req->txCnt = 0;
+    req->rxCnt = 0;
+    req->completeCB = NULL;
+}
+/******************************************************************************/
+// Checks a list: every transfer moves data and a held slave select stays on
+// one device and does not outlive the list
+static int spi_list_ok(const spi_xfer_t *list, unsigned int count)
+{
+    if (list == NULL || count == 0) {
+        return 0;
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        const spi_xfer_t *x = &list[i];
+        if (x->dev == NULL || x->dev->ss < 0 || x->dev->ss >= SPI_SS_COUNT || x->len == 0 ||
+            (x->tx == NULL && x->rx == NULL)) {
+            return 0;
+        }
+        if (x->cs_hold && (i == count - 1 || list[i + 1].dev != x->dev)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+/******************************************************************************/
+static RAMFUNC void spi_list_complete(void *req, int result);
+
+// Starts the DMA transfer of the running list entry
+static RAMFUNC int spi_list_start(void)
+{
+    const spi_xfer_t *x = spi_list;
+    int err = spi_configure(x->dev);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    spi_fill_req(&spi_req, x);
+    spi_req.completeCB = spi_list_complete;
+    return MXC_SPI_MasterTransactionDMA(&spi_req);
+}
+/******************************************************************************/
+static RAMFUNC void spi_list_end(int result)
+{
+    coop_event_t *done = spi_list_done;
+    spi_list_result = result;
+    spi_list = NULL;
+    if (done != NULL) {
+        coop_signal(done, result);
+    }
+}
+/******************************************************************************/
+// Called from the DMA interrupt when a transfer has ended, starts the next one
+static RAMFUNC void spi_list_complete(void *req, int result)
+{
+    (void)req;
+    if (result == E_NO_ERROR && spi_list_left > 0) {
+        spi_list_left--;
+        spi_list = spi_list + 1;
+        if ((result = spi_list_start()) == E_NO_ERROR) {
+            return;
+        }
+    }
+    if (result != E_NO_ERROR) {
+        LOG_ERROR("SPI list transfer to slave select %d failed, error:%d", spi_list->dev->ss, result);
+        blackbox_event(BLACKBOX_EV_SPI_ERROR, spi_list->dev->ss, result);
+    }
+    spi_list_end(result);
+}
+/******************************************************************************/
+int spi_init(void)
+{
+    int err;
+    if ((err = MXC_SPI_Init(SPI_MASTER, 1, 0, SPI_SS_COUNT, 0, SPI_FREQ)) != E_NO_ERROR) {
+        LOG_ERROR("SPI init failed, error:%d", err);
+        return err;
+    }
+    MXC_SPI_SetDataSize(SPI_MASTER, 8);
+    MXC_SPI_SetWidth(SPI_MASTER, SPI_WIDTH_STANDARD);
+    MXC_SPI_SetMode(SPI_MASTER, SPI_MODE_0);
+    spi_hz = SPI_FREQ;
+    spi_mode = SPI_MODE_0;
+    spi_list = NULL;
+
+    // The SDK takes any free channels for a transfer
+    MXC_NVIC_SetVector(DMA0_IRQn, spi_dma_irq);
+    MXC_NVIC_SetVector(DMA1_IRQn, spi_dma_irq);
+    MXC_NVIC_SetVector(DMA2_IRQn, spi_dma_irq);
+    MXC_NVIC_SetVector(DMA3_IRQn, spi_dma_irq);
+    NVIC_EnableIRQ(DMA0_IRQn);
+    NVIC_EnableIRQ(DMA1_IRQn);
+    NVIC_EnableIRQ(DMA2_IRQn);
+    NVIC_EnableIRQ(DMA3_IRQn);
+
+    LOG_INFO("SPI master ready at %u Hz", MXC_SPI_GetFrequency(SPI_MASTER));
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int spi_transfer(const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+    STATS_BEGIN();
+    spi_xfer_t x = { dev, tx, rx, len, 0 };
+    if (!spi_list_ok(&x, 1)) {
+        STATS_END(STATS_SPI_XFER, 0, E_BAD_PARAM);
+        return E_BAD_PARAM;
+    }
+    // Claim the bus like spi_run_async(), spi_busy() reads 1 until the end
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (spi_list != NULL) {
+        __set_PRIMASK(primask);
+        STATS_END(STATS_SPI_XFER, 0, E_BUSY);
+        return E_BUSY;
+    }
+    spi_list = &x;
+    __set_PRIMASK(primask);
+    int err = spi_configure(dev);
+    if (err == E_NO_ERROR) {
+        mxc_spi_req_t req;
+        spi_fill_req(&req, &x);
+        err = MXC_SPI_MasterTransaction(&req);
+    }
+    spi_list = NULL;
+    if (err != E_NO_ERROR) {
+        blackbox_event(BLACKBOX_EV_SPI_ERROR, dev->ss, err);
+    }
+    STATS_END(STATS_SPI_XFER, len, err);
+    return err;
+}
+/******************************************************************************/
+int spi_transfer_dma(const spi_device_t *dev, const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+    spi_xfer_t x = { dev, tx, rx, len, 0 };
+    return spi_run(&x, 1);
+}
+/******************************************************************************/
+int spi_run(const spi_xfer_t *list, unsigned int count)
+{
+    STATS_BEGIN();
+    int err = spi_run_async(list, count, NULL);
+    if (err != E_NO_ERROR) {
+        STATS_END(STATS_SPI_XFER, 0, err);     // Refused or failed to start
+        return err;
+    }
+    while (spi_list != NULL) {}
+    err = spi_list_result;
+
+    uint32_t bytes = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        bytes += list[i].len;
+    }
+    STATS_END(STATS_SPI_XFER, bytes, err);
+    return err;
+}
+/******************************************************************************/
+int spi_run_async(const spi_xfer_t *list, unsigned int count, coop_event_t *done)
+{
+    if (!spi_list_ok(list, count)) {
+        return E_BAD_PARAM;
+    }
+    // Check and claim in one step, a task or interrupt may start a list too
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (spi_list != NULL) {
+        __set_PRIMASK(primask);
+        return E_BUSY;
+    }
+    spi_list = list;
+    __set_PRIMASK(primask);
+    spi_list_left = count - 1;
+    spi_list_done = done;
+    int err = spi_list_start();
+    if (err != E_NO_ERROR) {
+        LOG_ERROR("SPI list start failed, error:%d", err);
+        blackbox_event(BLACKBOX_EV_SPI_ERROR, list->dev->ss, err);
+        spi_list = NULL;
+    }
+    return err;
+}
+/******************************************************************************/
+int spi_busy(void)
+{
+    return spi_list != NULL;
+}
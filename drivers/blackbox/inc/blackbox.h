@@ -0,0 +1,182 @@
+/**
+ * @file       blackbox.h
+ * @brief      Crash black box.
+ * @details    Drivers record events in a RAM ring that is always on and is
+ *             left alone by the startup code (no-init SRAM, see blackbox.ld), so
+ *             it also survives a warm reset. Appending an event reserves a
+ *             slot with one atomic increment of the head and fills it in
+ *             place; no lock is taken, so interrupts can record too.
+ *
+ *             On a fault, blackbox_dump() saves the ring with the fault
+ *             registers to the FLASH_BLACKBOX_BASE page. It only uses the
+ *             flash controller calls under Flash_PageErase() and
+ *             Flash_Write(): no allocation, no interrupts, no logging.
+ *             HardFault_Handler is installed here; a watchdog early warning
+ *             interrupt calls blackbox_dump(BLACKBOX_CAUSE_WATCHDOG, NULL).
+ *             tools/blackbox_decode.py prints a dump read back from flash.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BLACKBOX_H__
+#define __BLACKBOX_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "cycles.h"
+#include "flash_layout.h"
+
+/***** Definitions *****/
+#ifndef BLACKBOX_ENABLE
+#define BLACKBOX_ENABLE 1               // 0 compiles every blackbox_event() out
+#endif
+
+#ifndef BLACKBOX_SIZE
+#define BLACKBOX_SIZE 4096              // Ring size in bytes, power of two
+#endif
+
+#define BLACKBOX_ENTRIES (BLACKBOX_SIZE / sizeof(blackbox_entry_t))
+#define BLACKBOX_MAGIC 0x31584242UL     // "BBX1", ring and dump header
+#define BLACKBOX_DUMP_HEADER 48         // Bytes before the entries of a dump
+
+#if (BLACKBOX_SIZE & (BLACKBOX_SIZE - 1)) != 0 || BLACKBOX_SIZE < 16
+#error "BLACKBOX_SIZE must be a power of two"
+#endif
+#if BLACKBOX_SIZE + BLACKBOX_DUMP_HEADER > FLASH_BLACKBOX_SIZE
+#error "BLACKBOX_SIZE does not fit the crash dump page"
+#endif
+
+#ifdef HOST_SIM
+#define BLACKBOX_NOINIT
+#else
+#define BLACKBOX_NOINIT __attribute__((section(".blackbox.noinit")))
+#endif
+
+/**
+ * @brief      Event IDs. Keep tools/blackbox_decode.py in step.
+ */
+typedef enum {
+    BLACKBOX_EV_BOOT = 1,           // a: 1 if the ring survived a reset
+    BLACKBOX_EV_FLASH_ERASE,        // a: address, b: result
+    BLACKBOX_EV_FLASH_WRITE,        // a: address, b: length
+    BLACKBOX_EV_FLASH_ERROR,        // a: address, b: error
+    BLACKBOX_EV_I2C_RETRY,          // a: error, b: attempt
+    BLACKBOX_EV_I2C_RECOVER,        // a: result, b: cycles
+    BLACKBOX_EV_SPI_ERROR,          // a: slave select, b: error
+    BLACKBOX_EV_USER = 0x100        // First ID for application events
+} blackbox_event_t;
+
+/**
+ * @brief      Reason for a dump.
+ */
+typedef enum {
+    BLACKBOX_CAUSE_HARDFAULT = 1,
+    BLACKBOX_CAUSE_WATCHDOG,
+    BLACKBOX_CAUSE_RESET,           // Ring found after a reset that skipped the dump
+    BLACKBOX_CAUSE_REQUEST          // Asked for by the application
+} blackbox_cause_t;
+
+/**
+ * @brief      One ring entry, a 128-bit flash line in a dump.
+ */
+typedef struct {
+    uint32_t timestamp;             // DWT cycle count
+    uint32_t id;                    // Event in bits 15:0, bits 15:0 of its sequence number above
+    uint32_t a;                     // Event arguments
+    uint32_t b;
+} blackbox_entry_t;
+
+/**
+ * @brief      Header of a dump, followed by count entries, oldest first.
+ */
+typedef struct {
+    uint32_t magic;                 // BLACKBOX_MAGIC, programmed last
+    uint32_t cause;                 // blackbox_cause_t
+    uint32_t head;                  // Events recorded since the ring was cleared
+    uint32_t count;                 // Entries saved
+    uint32_t timestamp;             // DWT cycle count at the dump
+    uint32_t pc;                    // Stacked by the fault, 0 without a frame
+    uint32_t lr;
+    uint32_t psr;
+    uint32_t cfsr;                  // Fault status registers, 0 on the host
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+} blackbox_dump_t;
+
+extern blackbox_entry_t blackbox_ring[BLACKBOX_ENTRIES];
+extern uint32_t blackbox_head;
+extern uint32_t blackbox_booted;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Records an event. Safe from interrupts; a few dozen cycles.
+ * @param      id       blackbox_event_t.
+ * @param      a        First argument.
+ * @param      b        Second argument.
+ */
+static inline void blackbox_event(uint32_t id, uint32_t a, uint32_t b)
+{
+#if BLACKBOX_ENABLE
+    uint32_t seq = __atomic_fetch_add(&blackbox_head, 1, __ATOMIC_RELAXED);
+    blackbox_entry_t *e = &blackbox_ring[seq & (BLACKBOX_ENTRIES - 1)];
+    e->timestamp = cycles_now();
+    e->a = a;
+    e->b = b;
+    e->id = (seq << 16) | (id & 0xFFFF);    // Last, so a torn entry keeps an old sequence
+#else
+    (void)id;
+    (void)a;
+    (void)b;
+#endif
+}
+/**
+ * @brief      Keeps the ring if it survived a reset, clears it otherwise, and
+ *             records BLACKBOX_EV_BOOT. Call early in main(). The first call
+ *             after a reset saves a surviving ring with BLACKBOX_CAUSE_RESET
+ *             unless the page already holds a dump.
+ * @return     1 if the ring survived, 0 if it was cleared.
+ */
+int blackbox_init(void);
+/**
+ * @brief      Saves the ring to the crash dump page. Runs with interrupts
+ *             disabled and without allocating, so it can be called from a
+ *             fault handler.
+ * @param      cause    blackbox_cause_t.
+ * @param      frame    Exception frame (r0-r3, r12, lr, pc, psr) of the
+ *                      faulting code, or NULL.
+ * @return     E_NO_ERROR or a flash error.
+ */
+int blackbox_dump(uint32_t cause, const uint32_t *frame);
+/**
+ * @brief      Returns the dump in flash, or NULL if the page holds none.
+ *             The entries follow the header.
+ */
+const blackbox_dump_t *blackbox_saved(void);
+/**
+ * @brief      Erases the crash dump page.
+ * @return     E_NO_ERROR or a flash error.
+ */
+int blackbox_clear(void);
+
+#endif
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "blackbox.h"
+#include "flash.h"
+#include "mxc_errors.h"
+#include "ramfunc.h"
+
+/***** Globals *****/
+BLACKBOX_NOINIT blackbox_entry_t blackbox_ring[BLACKBOX_ENTRIES] __attribute__((aligned(16)));
+BLACKBOX_NOINIT uint32_t blackbox_head;         // Events recorded, the next slot is head % entries
+static BLACKBOX_NOINIT uint32_t blackbox_magic; // BLACKBOX_MAGIC once the ring is valid
+uint32_t blackbox_booted;                       // Set by blackbox_init(), cleared by each reset
+
+/***** Functions *****/
+int blackbox_init(void)
+{
+    int survived = (blackbox_magic == BLACKBOX_MAGIC);
+    if (!survived) {
+        memset(blackbox_ring, 0, sizeof(blackbox_ring));
+        blackbox_head = 0;
+        blackbox_magic = BLACKBOX_MAGIC;
+    } else if (!blackbox_booted && blackbox_head != 0 && blackbox_saved() == NULL) {
+        // A reset that skipped the dump (reset pin, watchdog without the
+        // early warning, software reset): keep the events that led up to it
+        blackbox_dump(BLACKBOX_CAUSE_RESET, NULL);
+    }
+    blackbox_booted = 1;
+    blackbox_event(BLACKBOX_EV_BOOT, survived, 0);
+    return survived;
+}
+/******************************************************************************/
+RAMFUNC int blackbox_dump(uint32_t cause, const uint32_t *frame)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t head = blackbox_head;
+    uint32_t count = (head < BLACKBOX_ENTRIES) ? head : BLACKBOX_ENTRIES;
+    union {
+        blackbox_dump_t dump;
+        uint32_t line[BLACKBOX_DUMP_HEADER / 16][4];
+    } hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.dump.magic = BLACKBOX_MAGIC;
+    hdr.dump.cause = cause;
+    hdr.dump.head = head;
+    hdr.dump.count = count;
+    hdr.dump.timestamp = cycles_now();
+    if (frame != NULL) {
+        hdr.dump.lr = frame[5];
+        hdr.dump.pc = frame[6];
+        hdr.dump.psr = frame[7];
+    }
+#ifndef HOST_SIM
+    hdr.dump.cfsr = SCB->CFSR;
+    hdr.dump.hfsr = SCB->HFSR;
+    hdr.dump.mmfar = SCB->MMFAR;
+    hdr.dump.bfar = SCB->BFAR;
+#endif
+
+    // The calls under Flash_PageErase() and Flash_Write(), nothing that
+    // allocates, logs or waits for an interrupt
+    int err = MXC_FLC_RevA_PageErase((mxc_flc_reva_regs_t *)MXC_FLC0, FLASH_BLACKBOX_BASE);
+    uint32_t addr = FLASH_BLACKBOX_BASE + BLACKBOX_DUMP_HEADER;
+    for (uint32_t i = 0; i < count && err == E_NO_ERROR; i++) {
+        blackbox_entry_t e = blackbox_ring[(head - count + i) & (BLACKBOX_ENTRIES - 1)];
+        err = MXC_FLC_Write128(addr, (uint32_t *)&e);
+        addr += sizeof(e);
+    }
+    // The line holding the magic goes last, so a dump cut short reads as none
+    for (int i = BLACKBOX_DUMP_HEADER / 16 - 1; i >= 0 && err == E_NO_ERROR; i--) {
+        err = MXC_FLC_Write128(FLASH_BLACKBOX_BASE + i * 16, hdr.line[i]);
+    }
+    MXC_FLC_AI87_Flash_Operation();
+
+    __set_PRIMASK(primask);
+    return err;
+}
+/******************************************************************************/
+const blackbox_dump_t *blackbox_saved(void)
+{
+    const blackbox_dump_t *d = (const blackbox_dump_t *)FLASH_BLACKBOX_BASE;
+    if (d->magic != BLACKBOX_MAGIC || d->count > BLACKBOX_ENTRIES) {
+        return NULL;
+    }
+    return d;
+}
+/******************************************************************************/
+int blackbox_clear(void)
+{
+    return Flash_PageErase(FLASH_BLACKBOX_BASE);
+}
+#ifndef HOST_SIM
+/******************************************************************************/
+// Saves the ring of a faulting system and restarts it
+void __attribute__((used, noreturn)) blackbox_fault(const uint32_t *frame)
+{
+    blackbox_dump(BLACKBOX_CAUSE_HARDFAULT, frame);
+    NVIC_SystemReset();
+}
+/******************************************************************************/
+// Replaces the startup code's endless loop. Passes the exception frame from
+// the stack the faulting code was using.
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile("tst lr, #4      \n"
+                   "ite eq          \n"
+                   "mrseq r0, msp   \n"
+                   "mrsne r0, psp   \n"
+                   "b blackbox_fault\n");
+}
+#endif
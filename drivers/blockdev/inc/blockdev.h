@@ -0,0 +1,140 @@
+/**
+ * @file       blockdev.h
+ * @brief      Block device interface over the internal and external flash.
+ * @details    A block device is a byte addressed region of a flash with a
+ *             read, program and erase granularity. Storage code written
+ *             against blockdev_t runs unchanged on the internal flash
+ *             controller or the external QSPI flash.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BLOCKDEV_H__
+#define __BLOCKDEV_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_errors.h"
+#include "flash_layout.h"
+
+/***** Definitions *****/
+#ifndef BLOCKDEV_QSPI_SIZE
+#define BLOCKDEV_QSPI_SIZE 0x1000000UL  // Bytes of external flash from address 0
+#endif
+
+typedef struct blockdev blockdev_t;
+
+/**
+ * @brief      Backend operations. Addresses are device addresses and have been
+ *             range and alignment checked by the blockdev_*() wrappers.
+ */
+typedef struct {
+    int (*init)(const blockdev_t *bd);
+    int (*read)(const blockdev_t *bd, uint32_t addr, uint8_t *data, uint32_t len);
+    int (*program)(const blockdev_t *bd, uint32_t addr, const uint8_t *data, uint32_t len);
+    int (*erase)(const blockdev_t *bd, uint32_t addr, uint32_t len);
+    int (*sync)(const blockdev_t *bd);
+} blockdev_ops_t;
+
+/**
+ * @brief      Size and granularity of a block device, in bytes.
+ */
+typedef struct {
+    uint32_t size;              // Total size
+    uint32_t read_size;         // Reads are multiples of this
+    uint32_t prog_size;         // Programs are aligned multiples of this
+    uint32_t erase_size;        // Erases are aligned multiples of this
+} blockdev_geometry_t;
+
+/**
+ * @brief      A block device: a region of one flash and its backend.
+ */
+struct blockdev {
+    const char *name;               // Short name for reports, e.g. "flc"
+    const blockdev_ops_t *ops;      // Backend
+    uint32_t base;                  // Device address of offset 0
+    blockdev_geometry_t geometry;
+};
+
+extern const blockdev_t blockdev_flc;   // Storage region of the internal flash, see flash_layout.h
+extern const blockdev_t blockdev_qspi;  // First BLOCKDEV_QSPI_SIZE bytes of the IS25LP128
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes the flash behind a block device.
+ * @param      bd   Block device.
+ * @return     E_NO_ERROR or a backend error.
+ */
+int blockdev_init(const blockdev_t *bd);
+/**
+ * @brief      Returns the size and granularity of a block device.
+ * @param      bd   Block device.
+ * @param      geo  Receives the geometry.
+ */
+void blockdev_geometry(const blockdev_t *bd, blockdev_geometry_t *geo);
+/**
+ * @brief      Reads from a block device.
+ * @param      bd       Block device.
+ * @param      offset   Offset into the device, a multiple of read_size.
+ * @param      data     Output buffer.
+ * @param      len      Number of bytes, a multiple of read_size.
+ * @return     E_NO_ERROR, E_BAD_PARAM or a backend error.
+ */
+int blockdev_read(const blockdev_t *bd, uint32_t offset, uint8_t *data, uint32_t len);
+/**
+ * @brief      Programs erased bytes of a block device.
+ * @param      bd       Block device.
+ * @param      offset   Offset into the device, a multiple of prog_size.
+ * @param      data     Data to program.
+ * @param      len      Number of bytes, a multiple of prog_size.
+ * @return     E_NO_ERROR, E_BAD_PARAM or a backend error.
+ */
+int blockdev_program(const blockdev_t *bd, uint32_t offset, const uint8_t *data, uint32_t len);
+/**
+ * @brief      Erases blocks of a block device.
+ * @param      bd       Block device.
+ * @param      offset   Offset into the device, a multiple of erase_size.
+ * @param      len      Number of bytes, a multiple of erase_size.
+ * @return     E_NO_ERROR, E_BAD_PARAM or a backend error.
+ */
+int blockdev_erase(const blockdev_t *bd, uint32_t offset, uint32_t len);
+/**
+ * @brief      Waits until every program and erase has reached the flash.
+ * @param      bd       Block device.
+ * @return     E_NO_ERROR or a backend error.
+ */
+int blockdev_sync(const blockdev_t *bd);
+
+#ifdef LIB_LITTLEFS
+#include "lfs.h"
+/**
+ * @brief      Fills the block device part of a littlefs configuration: the
+ *             context, the four callbacks, the sizes and the block count.
+ *             Cache, lookahead and wear leveling settings are left to the caller.
+ * @param      bd       Block device, one littlefs block per erase block.
+ * @param      cfg      Configuration to fill.
+ */
+void blockdev_lfs_config(const blockdev_t *bd, struct lfs_config *cfg);
+#endif
+
+#endif
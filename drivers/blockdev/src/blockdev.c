@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "blockdev.h"
+
+/***** Functions *****/
+// Checks that [offset, offset + len) lies inside the device and both ends
+// are multiples of unit
+static int blockdev_check(const blockdev_t *bd, uint32_t offset, uint32_t len, uint32_t unit)
+{
+    if (len > bd->geometry.size || offset > bd->geometry.size - len) {
+        return E_BAD_PARAM;
+    }
+    if (offset % unit != 0 || len % unit != 0) {
+        return E_BAD_PARAM;
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int blockdev_init(const blockdev_t *bd)
+{
+    return bd->ops->init(bd);
+}
+/******************************************************************************/
+void blockdev_geometry(const blockdev_t *bd, blockdev_geometry_t *geo)
+{
+    *geo = bd->geometry;
+}
+/******************************************************************************/
+int blockdev_read(const blockdev_t *bd, uint32_t offset, uint8_t *data, uint32_t len)
+{
+    int err = blockdev_check(bd, offset, len, bd->geometry.read_size);
+    if (err != E_NO_ERROR || len == 0) {
+        return err;
+    }
+    return bd->ops->read(bd, bd->base + offset, data, len);
+}
+/******************************************************************************/
+int blockdev_program(const blockdev_t *bd, uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    int err = blockdev_check(bd, offset, len, bd->geometry.prog_size);
+    if (err != E_NO_ERROR || len == 0) {
+        return err;
+    }
+    return bd->ops->program(bd, bd->base + offset, data, len);
+}
+/******************************************************************************/
+int blockdev_erase(const blockdev_t *bd, uint32_t offset, uint32_t len)
+{
+    int err = blockdev_check(bd, offset, len, bd->geometry.erase_size);
+    if (err != E_NO_ERROR || len == 0) {
+        return err;
+    }
+    return bd->ops->erase(bd, bd->base + offset, len);
+}
+/******************************************************************************/
+int blockdev_sync(const blockdev_t *bd)
+{
+    return bd->ops->sync(bd);
+}
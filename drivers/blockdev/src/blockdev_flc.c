@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "blockdev.h"
+#include "flash.h"
+
+/***** Definitions *****/
+#define BLOCKDEV_FLC_LINE 16        // The controller programs 128-bit lines
+
+/***** Functions *****/
+static int blockdev_flc_init(const blockdev_t *bd)
+{
+    (void)bd;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+static int blockdev_flc_read(const blockdev_t *bd, uint32_t addr, uint8_t *data, uint32_t len)
+{
+    (void)bd;
+    Flash_ReadLock();
+    MXC_FLC_Com_Read(addr, data, len);     // The array is memory mapped
+    Flash_ReadUnlock();
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+static int blockdev_flc_program(const blockdev_t *bd, uint32_t addr, const uint8_t *data,
+                                uint32_t len)
+{
+    (void)bd;
+    return Flash_WriteBuffer(addr, data, len);
+}
+/******************************************************************************/
+static int blockdev_flc_erase(const blockdev_t *bd, uint32_t addr, uint32_t len)
+{
+    (void)bd;
+    for (uint32_t page = 0; page < len; page += MXC_FLASH_PAGE_SIZE) {
+        int err = Flash_PageErase(addr + page);
+        if (err != E_NO_ERROR) {
+            return err;
+        }
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Programs and erases complete before the FLC calls return
+static int blockdev_flc_sync(const blockdev_t *bd)
+{
+    (void)bd;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+static const blockdev_ops_t blockdev_flc_ops = {
+    .init = blockdev_flc_init,
+    .read = blockdev_flc_read,
+    .program = blockdev_flc_program,
+    .erase = blockdev_flc_erase,
+    .sync = blockdev_flc_sync,
+};
+
+const blockdev_t blockdev_flc = {
+    .name = "flc",
+    .ops = &blockdev_flc_ops,
+    .base = FLASH_STORAGE_BASE,
+    .geometry = {
+        .size = FLASH_STORAGE_SIZE,
+        .read_size = 1,
+        .prog_size = BLOCKDEV_FLC_LINE,
+        .erase_size = MXC_FLASH_PAGE_SIZE,
+    },
+};
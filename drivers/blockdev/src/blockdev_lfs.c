@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "blockdev.h"
+
+#ifdef LIB_LITTLEFS
+
+/***** Functions *****/
+static int blockdev_lfs_err(int err)
+{
+    return (err == E_NO_ERROR) ? LFS_ERR_OK : LFS_ERR_IO;
+}
+/******************************************************************************/
+static int blockdev_lfs_read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
+                             void *buffer, lfs_size_t size)
+{
+    const blockdev_t *bd = c->context;
+    return blockdev_lfs_err(blockdev_read(bd, block * c->block_size + off, buffer, size));
+}
+/******************************************************************************/
+static int blockdev_lfs_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
+                             const void *buffer, lfs_size_t size)
+{
+    const blockdev_t *bd = c->context;
+    return blockdev_lfs_err(blockdev_program(bd, block * c->block_size + off, buffer, size));
+}
+/******************************************************************************/
+static int blockdev_lfs_erase(const struct lfs_config *c, lfs_block_t block)
+{
+    const blockdev_t *bd = c->context;
+    return blockdev_lfs_err(blockdev_erase(bd, block * c->block_size, c->block_size));
+}
+/******************************************************************************/
+static int blockdev_lfs_sync(const struct lfs_config *c)
+{
+    return blockdev_lfs_err(blockdev_sync(c->context));
+}
+/******************************************************************************/
+void blockdev_lfs_config(const blockdev_t *bd, struct lfs_config *cfg)
+{
+    cfg->context = (void *)bd;
+    cfg->read = blockdev_lfs_read;
+    cfg->prog = blockdev_lfs_prog;
+    cfg->erase = blockdev_lfs_erase;
+    cfg->sync = blockdev_lfs_sync;
+    cfg->read_size = bd->geometry.read_size;
+    cfg->prog_size = bd->geometry.prog_size;
+    cfg->block_size = bd->geometry.erase_size;
+    cfg->block_count = bd->geometry.size / bd->geometry.erase_size;
+}
+
+#endif
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "blockdev.h"
+#include "qspi_flash.h"
+#include "qspi_cache.h"
+
+/***** Definitions *****/
+#if (BLOCKDEV_QSPI_SIZE % QSPI_SECTOR_SIZE) != 0 || BLOCKDEV_QSPI_SIZE > QSPI_FLASH_SIZE
+#error "BLOCKDEV_QSPI_SIZE must be a multiple of the sector size that fits the flash"
+#endif
+
+/***** Functions *****/
+static int blockdev_qspi_init(const blockdev_t *bd)
+{
+    (void)bd;
+    int err = qspi_init();
+    if (err == E_NO_ERROR) {
+        qspi_cache_init();
+    }
+    return err;
+}
+/******************************************************************************/
+// Goes through the read cache, so reads of metadata written a moment ago hit
+static int blockdev_qspi_read(const blockdev_t *bd, uint32_t addr, uint8_t *data, uint32_t len)
+{
+    (void)bd;
+    return qspi_cache_read(addr, data, len);
+}
+/******************************************************************************/
+static int blockdev_qspi_program(const blockdev_t *bd, uint32_t addr, const uint8_t *data,
+                                 uint32_t len)
+{
+    (void)bd;
+    return qspi_cache_program(addr, data, len);
+}
+/******************************************************************************/
+static int blockdev_qspi_erase(const blockdev_t *bd, uint32_t addr, uint32_t len)
+{
+    (void)bd;
+    return qspi_cache_erase(addr, len);
+}
+/******************************************************************************/
+// qspi_program() and qspi_erase() wait for the flash to go idle
+static int blockdev_qspi_sync(const blockdev_t *bd)
+{
+    (void)bd;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+static const blockdev_ops_t blockdev_qspi_ops = {
+    .init = blockdev_qspi_init,
+    .read = blockdev_qspi_read,
+    .program = blockdev_qspi_program,
+    .erase = blockdev_qspi_erase,
+    .sync = blockdev_qspi_sync,
+};
+
+const blockdev_t blockdev_qspi = {
+    .name = "qspi",
+    .ops = &blockdev_qspi_ops,
+    .base = 0,
+    .geometry = {
+        .size = BLOCKDEV_QSPI_SIZE,
+        .read_size = 1,
+        .prog_size = 1,
+        .erase_size = QSPI_SECTOR_SIZE,
+    },
+};
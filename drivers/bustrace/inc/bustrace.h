@@ -0,0 +1,150 @@
+/**
+ * @file       bustrace.h
+ * @brief      Record of I2C and flash transactions.
+ * @details    Between bustrace_start() and bustrace_stop() the I2C and flash
+ *             drivers append every transaction to a caller supplied buffer:
+ *             its operation, I2C address and register or flash address,
+ *             result, duration and the idle time before it, followed by the
+ *             bytes written or read. A trace captured on a board is replayed
+ *             against the simulator's bus and flash models by sim_replay(),
+ *             which turns a field session into a repeatable benchmark.
+ *
+ *             Trace layout, little endian: a bustrace_header_t, then records
+ *             of a bustrace_rec_t and its payload padded to 4 bytes.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BUSTRACE_H__
+#define __BUSTRACE_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "cycles.h"
+
+/***** Definitions *****/
+#ifndef BUSTRACE_ENABLE
+#define BUSTRACE_ENABLE 1               // 0 compiles every driver hook out
+#endif
+
+#define BUSTRACE_MAGIC 0x31525442UL     // "BTR1"
+#define BUSTRACE_PAYLOAD_MAX 256        // Largest payload kept, longer writes are cut
+
+/**
+ * @brief      Traced operations. Payload bytes follow the I2C records and
+ *             flash writes; flash reads and erases carry none.
+ */
+typedef enum {
+    BUSTRACE_I2C_WRITE = 1,         // target: address << 8 | register
+    BUSTRACE_I2C_READ,              // target: address << 8 | register
+    BUSTRACE_FLASH_READ,            // target: flash address, len: bytes read
+    BUSTRACE_FLASH_WRITE,           // target: flash address
+    BUSTRACE_FLASH_ERASE,           // target: page address
+    BUSTRACE_OP_COUNT
+} bustrace_op_t;
+
+/**
+ * @brief      Start of a trace.
+ */
+typedef struct {
+    uint32_t magic;                 // BUSTRACE_MAGIC
+    uint32_t clock_hz;              // Core clock the cycle counts are in
+    uint32_t records;               // Records that follow
+    uint32_t dropped;               // Records that did not fit the buffer
+} bustrace_header_t;
+
+/**
+ * @brief      One transaction.
+ */
+typedef struct {
+    uint8_t op;                     // bustrace_op_t
+    int8_t result;                  // Driver result, E_NO_ERROR or an error
+    uint16_t len;                   // Bytes moved
+    uint32_t target;                // See bustrace_op_t
+    uint32_t gap;                   // Cycles since the end of the previous record
+    uint32_t cycles;                // Duration, retries included
+} bustrace_rec_t;
+
+#if BUSTRACE_ENABLE
+/**
+ * @brief      Takes the start time of a traced operation.
+ */
+#define BUSTRACE_BEGIN() const uint32_t bustrace_start = cycles_now()
+/**
+ * @brief      Records an operation started with BUSTRACE_BEGIN() if a trace
+ *             is running.
+ */
+#define BUSTRACE_END(op, target, data, len, err) \
+    bustrace_record((op), (target), (data), (len), (err), bustrace_start)
+#else
+#define BUSTRACE_BEGIN()
+#define BUSTRACE_END(op, target, data, len, err) ((void)(len))
+#endif
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Starts recording, discarding any trace in progress.
+ * @param      buf      Trace buffer, 4-byte aligned.
+ * @param      size     Buffer size in bytes.
+ * @return     E_NO_ERROR, or E_BAD_PARAM if the buffer cannot hold a header.
+ */
+int bustrace_start(uint8_t *buf, uint32_t size);
+/**
+ * @brief      Stops recording and completes the header.
+ * @return     Bytes of the trace, 0 if none was running.
+ */
+uint32_t bustrace_stop(void);
+/**
+ * @brief      Appends a record. Called by BUSTRACE_END(); does nothing if no
+ *             trace is running. Records that do not fit are counted as dropped.
+ * @param      op       bustrace_op_t.
+ * @param      target   See bustrace_op_t.
+ * @param      data     Payload, NULL for none.
+ * @param      len      Bytes moved.
+ * @param      err      Result of the operation.
+ * @param      start    cycles_now() when the operation began.
+ */
+void bustrace_record(uint8_t op, uint32_t target, const void *data, uint32_t len, int err,
+                     uint32_t start);
+/**
+ * @brief      Walks the records of a trace.
+ * @param      trace    Trace, starting with its header.
+ * @param      size     Bytes of the trace.
+ * @param      pos      Offset of the next record, 0 to start. Advanced past
+ *                      the record returned.
+ * @return     The next record, its payload follows it, or NULL at the end or
+ *             at a malformed record.
+ */
+const bustrace_rec_t *bustrace_next(const uint8_t *trace, uint32_t size, uint32_t *pos);
+/**
+ * @brief      Returns the bytes of payload stored after a record.
+ */
+static inline uint32_t bustrace_payload_len(const bustrace_rec_t *rec)
+{
+    if (rec->op == BUSTRACE_FLASH_READ || rec->op == BUSTRACE_FLASH_ERASE) {
+        return 0;
+    }
+    return (rec->len < BUSTRACE_PAYLOAD_MAX) ? rec->len : BUSTRACE_PAYLOAD_MAX;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "bustrace.h"
+#include "mxc_device.h"
+#include "mxc_errors.h"
+#include "ramfunc.h"
+
+/***** Globals *****/
+static uint8_t *bustrace_buf;           // NULL when no trace is running
+static uint32_t bustrace_size;
+static uint32_t bustrace_used;          // Bytes written, header included
+static uint32_t bustrace_last;          // End of the previous record in cycles
+
+/***** Functions *****/
+int bustrace_start(uint8_t *buf, uint32_t size)
+{
+    if (buf == NULL || size < sizeof(bustrace_header_t)) {
+        return E_BAD_PARAM;
+    }
+    bustrace_header_t *hdr = (bustrace_header_t *)buf;
+    hdr->magic = BUSTRACE_MAGIC;
+    hdr->clock_hz = SystemCoreClock;
+    hdr->records = 0;
+    hdr->dropped = 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bustrace_size = size;
+    bustrace_used = sizeof(*hdr);
+    bustrace_last = cycles_now();
+    bustrace_buf = buf;
+    __set_PRIMASK(primask);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t bustrace_stop(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t used = (bustrace_buf != NULL) ? bustrace_used : 0;
+    bustrace_buf = NULL;
+    __set_PRIMASK(primask);
+    return used;
+}
+/******************************************************************************/
+RAMFUNC void bustrace_record(uint8_t op, uint32_t target, const void *data, uint32_t len, int err,
+                     uint32_t start)
+{
+    if (bustrace_buf == NULL) {
+        return;
+    }
+    uint32_t end = cycles_now();
+    bustrace_rec_t rec = { op, (int8_t)err, (uint16_t)((len < UINT16_MAX) ? len : UINT16_MAX),
+                           target, start - bustrace_last, end - start };
+    uint32_t payload = (data != NULL) ? bustrace_payload_len(&rec) : 0;
+    uint32_t need = sizeof(rec) + ((payload + 3) & ~3UL);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (bustrace_buf != NULL) {
+        bustrace_header_t *hdr = (bustrace_header_t *)bustrace_buf;
+        if (payload != bustrace_payload_len(&rec) || bustrace_size - bustrace_used < need) {
+            hdr->dropped++;     // A record without its payload would replay wrong
+        } else {
+            uint8_t *p = bustrace_buf + bustrace_used;
+            memcpy(p, &rec, sizeof(rec));
+            memcpy(p + sizeof(rec), data, payload);
+            memset(p + sizeof(rec) + payload, 0, need - sizeof(rec) - payload);
+            bustrace_used += need;
+            hdr->records++;
+        }
+        bustrace_last = end;
+    }
+    __set_PRIMASK(primask);
+}
+/******************************************************************************/
+const bustrace_rec_t *bustrace_next(const uint8_t *trace, uint32_t size, uint32_t *pos)
+{
+    const bustrace_header_t *hdr = (const bustrace_header_t *)trace;
+    if (size < sizeof(*hdr) || hdr->magic != BUSTRACE_MAGIC) {
+        return NULL;
+    }
+    if (*pos < sizeof(*hdr)) {
+        *pos = sizeof(*hdr);
+    }
+    if (size - *pos < sizeof(bustrace_rec_t)) {
+        return NULL;
+    }
+    const bustrace_rec_t *rec = (const bustrace_rec_t *)(trace + *pos);
+    uint32_t need = sizeof(*rec) + ((bustrace_payload_len(rec) + 3) & ~3UL);
+    if (rec->op == 0 || rec->op >= BUSTRACE_OP_COUNT || size - *pos < need) {
+        return NULL;
+    }
+    *pos += need;
+    return rec;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file       coop.h
+ * @brief      Cooperative tasks.
+ * @details    Stackless tasks in the protothread style: a task is a function
+ *             that returns whenever it has to wait and resumes at the same
+ *             place on its next call. Tasks wait for events signalled by
+ *             interrupt handlers (I2C completion, GPIO edges), for timers or
+ *             for any condition, and run as work items of the scheduler in
+ *             sched.h, so the core sleeps while every task waits.
+ *
+ *             Locals of a task function do not survive a wait; keep state in
+ *             the context passed to coop_start(). Only one wait per source line.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __COOP_H__
+#define __COOP_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+#include "gpio.h"
+#include "sched.h"
+
+/***** Definitions *****/
+#define COOP_READY 0                // Task yielded and wants to run again
+#define COOP_WAITING 1              // Task waits for an event or condition
+#define COOP_DONE 2                 // Task function returned from its end
+
+/**
+ * @brief      Event a task can wait for. Signals are counted, so none is
+ *             lost while the task is busy elsewhere.
+ */
+typedef struct {
+    volatile uint32_t count;    // Signals not yet taken
+    volatile int result;        // Result given with the last signal
+} coop_event_t;
+
+typedef struct coop_task coop_task_t;
+
+/**
+ * @brief      Task function. Its body sits between COOP_BEGIN() and COOP_END().
+ * @return     COOP_READY, COOP_WAITING or COOP_DONE, returned by the macros.
+ */
+typedef int (*coop_fn_t)(coop_task_t *t);
+
+/**
+ * @brief      Task. Owned by the caller and linked into the task list by coop_start().
+ */
+struct coop_task {
+    coop_fn_t fn;
+    void *ctx;                  // State kept across waits
+    unsigned int lc;            // Line to resume at, 0 to start from the top
+    int state;                  // COOP_READY, COOP_WAITING or COOP_DONE
+    sched_timer_t timer;        // Timer of COOP_SLEEP()
+    coop_event_t wake;          // Signalled by the timer
+    uint32_t resumes;           // Times the function was called
+    uint32_t cycles;            // Core cycles spent in the function
+    coop_task_t *next;          // Next task in the list
+};
+
+/**
+ * @brief      Counters of the task list.
+ */
+typedef struct {
+    uint32_t passes;            // Passes over the task list
+    uint32_t resumes;           // Task function calls
+    uint32_t cycles;            // Core cycles spent in passes, tasks included
+} coop_stats_t;
+
+#define COOP_BEGIN(t) \
+    switch ((t)->lc) { \
+    case 0:
+
+#define COOP_END(t) \
+    } \
+    (t)->lc = 0; \
+    return COOP_DONE
+
+// Returns until cond is true, evaluating it again on every pass
+#define COOP_WAIT_UNTIL(t, cond) \
+    do { \
+        (t)->lc = __LINE__; \
+    case __LINE__: \
+        if (!(cond)) { \
+            return COOP_WAITING; \
+        } \
+    } while (0)
+
+// Lets the other tasks run, then continues
+#define COOP_YIELD(t) \
+    do { \
+        (t)->lc = __LINE__; \
+        return COOP_READY; \
+    case __LINE__:; \
+    } while (0)
+
+// Waits for a signal of ev; the result it carried is in (ev)->result
+#define COOP_WAIT(t, ev) COOP_WAIT_UNTIL(t, coop_event_take(ev))
+
+// Waits for the given number of scheduler ticks
+#define COOP_SLEEP(t, ticks) \
+    do { \
+        coop_sleep(t, ticks); \
+        COOP_WAIT(t, &(t)->wake); \
+    } while (0)
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Empties the task list. Call after sched_init(), which drops
+ *             queued passes.
+ */
+void coop_init(void);
+/**
+ * @brief      Adds a task to the list and runs it from the top on the next pass.
+ * @param      t        Task.
+ * @param      fn       Task function.
+ * @param      ctx      State of the task, available as t->ctx.
+ */
+void coop_start(coop_task_t *t, coop_fn_t fn, void *ctx);
+/**
+ * @brief      Removes a task from the list.
+ * @param      t        Task.
+ */
+void coop_stop(coop_task_t *t);
+/**
+ * @brief      Clears an event.
+ * @param      ev       Event.
+ */
+void coop_event_init(coop_event_t *ev);
+/**
+ * @brief      Signals an event and schedules a pass over the tasks. Safe to
+ *             call from interrupt handlers.
+ * @param      ev       Event.
+ * @param      result   Result for the waiting task, e.g. a driver error code.
+ */
+void coop_signal(coop_event_t *ev, int result);
+/**
+ * @brief      Takes one signal of an event.
+ * @param      ev       Event.
+ * @return     1 if a signal was taken, 0 if there was none.
+ */
+int coop_event_take(coop_event_t *ev);
+/**
+ * @brief      Signals an event on every rising edge of an input pin, see
+ *             sched_gpio_event().
+ * @param      port     GPIO port.
+ * @param      mask     Pin.
+ * @param      ev       Event to signal.
+ * @return     Returns 0 if the operation is successful, otherwise an error code.
+ */
+int coop_gpio_event(mxc_gpio_regs_t *port, uint32_t mask, coop_event_t *ev);
+/**
+ * @brief      Starts the timer of COOP_SLEEP().
+ * @param      t        Task.
+ * @param      ticks    Scheduler ticks until t->wake is signalled.
+ */
+void coop_sleep(coop_task_t *t, uint32_t ticks);
+/**
+ * @brief      Copies the counters.
+ * @param      stats    Receives the counters.
+ * @param      reset    Non-zero to restart the counters, of the tasks too.
+ */
+void coop_get_stats(coop_stats_t *stats, int reset);
+
+#endif
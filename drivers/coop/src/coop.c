@@ -0,0 +1,174 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "coop.h"
+#include "cycles.h"
+#include "mxc_errors.h"
+#include "ramfunc.h"
+
+/***** Globals *****/
+static coop_task_t *coop_tasks;         // Started tasks
+static volatile int coop_queued;        // A pass is queued with the scheduler
+static coop_stats_t coop_stats;
+
+/***** Functions *****/
+void coop_init(void)
+{
+    coop_tasks = NULL;
+    coop_queued = 0;
+    memset(&coop_stats, 0, sizeof(coop_stats));
+}
+/******************************************************************************/
+// Calls every task that has not finished. Waiting tasks check their condition
+// again, which is cheaper than tracking what each one waits for.
+static void coop_pass(void *arg)
+{
+    int again = 0;
+    uint32_t start = cycles_now();
+    (void)arg;
+
+    coop_queued = 0;    // Signals from here on need another pass
+    for (coop_task_t *t = coop_tasks; t != NULL; t = t->next) {
+        if (t->state == COOP_DONE) {
+            continue;
+        }
+        uint32_t begin = cycles_now();
+        t->state = t->fn(t);
+        t->cycles += cycles_now() - begin;
+        t->resumes++;
+        coop_stats.resumes++;
+        if (t->state == COOP_READY) {
+            again = 1;
+        }
+    }
+    coop_stats.passes++;
+    coop_stats.cycles += cycles_now() - start;
+    if (again) {
+        coop_signal(NULL, 0);
+    }
+}
+/******************************************************************************/
+void coop_start(coop_task_t *t, coop_fn_t fn, void *ctx)
+{
+    coop_stop(t);
+    t->fn = fn;
+    t->ctx = ctx;
+    t->lc = 0;
+    t->state = COOP_READY;
+    t->resumes = 0;
+    t->cycles = 0;
+    coop_event_init(&t->wake);
+    memset(&t->timer, 0, sizeof(t->timer));
+
+    // Append, so tasks run in the order they were started
+    coop_task_t **p = &coop_tasks;
+    while (*p != NULL) {
+        p = &(*p)->next;
+    }
+    t->next = NULL;
+    *p = t;
+    coop_signal(NULL, 0);
+}
+/******************************************************************************/
+void coop_stop(coop_task_t *t)
+{
+    for (coop_task_t **p = &coop_tasks; *p != NULL; p = &(*p)->next) {
+        if (*p == t) {
+            *p = t->next;
+            sched_timer_stop(&t->timer);
+            break;
+        }
+    }
+}
+/******************************************************************************/
+void coop_event_init(coop_event_t *ev)
+{
+    ev->count = 0;
+    ev->result = 0;
+}
+/******************************************************************************/
+RAMFUNC void coop_signal(coop_event_t *ev, int result)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (ev != NULL) {
+        ev->result = result;
+        ev->count++;
+    }
+    // At most one pass waits, so the reserved slot is free when the queue is full
+    if (!coop_queued && sched_post_reserved(coop_pass, NULL) == E_NO_ERROR) {
+        coop_queued = 1;
+    }
+    __set_PRIMASK(primask);
+}
+/******************************************************************************/
+int coop_event_take(coop_event_t *ev)
+{
+    int taken = 0;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (ev->count > 0) {
+        ev->count--;
+        taken = 1;
+    }
+    __set_PRIMASK(primask);
+    return taken;
+}
+/******************************************************************************/
+// Work item queued by the pin interrupt
+static RAMFUNC void coop_gpio_signal(void *arg)
+{
+    coop_signal(arg, E_NO_ERROR);
+}
+/******************************************************************************/
+int coop_gpio_event(mxc_gpio_regs_t *port, uint32_t mask, coop_event_t *ev)
+{
+    return sched_gpio_event(port, mask, coop_gpio_signal, ev);
+}
+/******************************************************************************/
+// Timer of COOP_SLEEP()
+static void coop_wake(void *arg)
+{
+    coop_task_t *t = arg;
+    coop_signal(&t->wake, E_NO_ERROR);
+}
+/******************************************************************************/
+void coop_sleep(coop_task_t *t, uint32_t ticks)
+{
+    coop_event_init(&t->wake);
+    sched_timer_start(&t->timer, ticks, 0, coop_wake, t);
+}
+/******************************************************************************/
+void coop_get_stats(coop_stats_t *stats, int reset)
+{
+    if (stats != NULL) {
+        *stats = coop_stats;
+    }
+    if (reset) {
+        memset(&coop_stats, 0, sizeof(coop_stats));
+        for (coop_task_t *t = coop_tasks; t != NULL; t = t->next) {
+            t->resumes = 0;
+            t->cycles = 0;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file       crc32.h
+ * @brief      CRC-32 checksum.
+ * @details    CRC-32 as used by zlib, Ethernet and PNG (reflected, polynomial
+ *             0x04C11DB7, initial value and final XOR 0xFFFFFFFF). The
+ *             checksum of "123456789" is 0xCBF43926. Internal flash regions
+ *             are checksummed by the CRC peripheral, fed by DMA straight from
+ *             the memory mapped array; the host build and a peripheral that
+ *             fails its self-check use the table driven software CRC.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+#include "mxc_device.h"
+#include "mxc_errors.h"
+
+/***** Definitions *****/
+#define CRC32_CHECK 0xCBF43926UL    // crc32(0, "123456789", 9)
+#define CRC32_POLY 0xEDB88320UL     // Reflected polynomial
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Updates a CRC-32 with more data.
+ *
+ * Start with crc 0 and pass the previous result to continue, so a stream
+ * can be checksummed in pieces: crc32(crc32(0, a, n), b, m) is the CRC of
+ * a followed by b.
+ *
+ * @param      crc      CRC of the data so far, 0 for none.
+ * @param      data     Next bytes.
+ * @param      len      Number of bytes.
+ * @return     CRC of all data so far.
+ */
+uint32_t crc32(uint32_t crc, const void *data, size_t len);
+/**
+ * @brief      Enables the CRC peripheral and checks it computes CRC32_CHECK.
+ *             Until it passes, and on the host, crc32_flash() uses software.
+ * @return     E_NO_ERROR. A failed self-check is logged, not returned.
+ */
+int crc32_init(void);
+/**
+ * @brief      Returns non-zero if crc32_flash() uses the CRC peripheral.
+ */
+int crc32_hw_enabled(void);
+/**
+ * @brief      Updates a CRC-32 with a range of the internal flash.
+ * @param      addr     First byte, any alignment.
+ * @param      len      Number of bytes.
+ * @param      crc      CRC so far (0 for none) on entry, updated CRC on return.
+ * @return     E_NO_ERROR, E_BAD_PARAM if the range leaves the flash array, or
+ *             a DMA error.
+ */
+int crc32_flash(uint32_t addr, uint32_t len, uint32_t *crc);
+
+#endif
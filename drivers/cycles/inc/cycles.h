@@ -0,0 +1,76 @@
+/**
+ * @file       cycles.h
+ * @brief      Core cycle counter.
+ * @details    Thin wrapper around the Cortex-M4 DWT cycle counter used for
+ *             timing test cases and driver operations.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __CYCLES_H__
+#define __CYCLES_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Function Prototypes *****/
+#ifdef __riscv
+// The RISC-V image (MAILBOX_RISCV) has no DWT: the counter reads 0 there
+static inline void cycles_init(void)
+{
+}
+static inline uint32_t cycles_now(void)
+{
+    return 0;
+}
+#else
+/**
+ * @brief      Enables the DWT cycle counter. Safe to call more than once.
+ */
+static inline void cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;    // Enable the trace block
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;               // Start the cycle counter
+}
+/**
+ * @brief      Reads the free running cycle counter.
+ * @return     Current core cycle count. Wraps every 2^32 cycles, so always
+ *             take differences with unsigned arithmetic.
+ */
+static inline uint32_t cycles_now(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+/**
+ * @brief      Converts a cycle count to microseconds at the current core clock.
+ * @param      cycles   Number of core cycles.
+ * @return     Elapsed time in microseconds.
+ */
+static inline uint32_t cycles_to_us(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000);
+}
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file       dsp.h
+ * @brief      Fixed-point preprocessing of IMU frames.
+ * @details    Batch kernels that work on interleaved 6-axis frames of Q15
+ *             samples (gyro X/Y/Z, accel X/Y/Z, as read from the BMI160):
+ *             offset and scale, biquad and one-pole low-pass filters, and
+ *             decimation. On cores with the DSP extension the Q15 kernels
+ *             process two axes per instruction with the dual 16-bit SIMD
+ *             instructions; elsewhere, including the host build, a C version
+ *             with identical results is used.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __DSP_H__
+#define __DSP_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#ifdef LIB_CMSIS_DSP
+#include "arm_math.h"               // q15_t and q31_t, shared with CMSIS-DSP
+#endif
+
+/***** Definitions *****/
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define DSP_SIMD 1                  // Dual 16-bit SIMD instructions available
+#else
+#define DSP_SIMD 0
+#endif
+
+#define DSP_AXES 6                  // Samples per frame
+
+#ifndef LIB_CMSIS_DSP
+typedef int16_t q15_t;              // Signed fraction, 1.15
+typedef int32_t q31_t;              // Signed fraction, 1.31
+#endif
+
+/**
+ * @brief      Per-axis calibration: out = (in - offset) * scale * 2^shift.
+ */
+typedef struct {
+    q15_t offset[DSP_AXES];     // Bias removed first, saturating
+    q15_t scale[DSP_AXES];      // Gain in Q15
+    uint8_t shift;              // Extra left shift of the gain, 0 to 15
+} dsp_cal_t;
+
+/**
+ * @brief      Second order IIR filter per axis, direct form I. Coefficients are
+ *             Q14 so that |a1| up to 2 fits; the state holds the last two
+ *             inputs and outputs of each axis packed in one word each. The
+ *             bits dropped from each output are added to the next one (error
+ *             feedback), so a constant input is reached without a dead band.
+ */
+typedef struct {
+    int16_t b0, b1, b2;         // Feed-forward coefficients, Q14
+    int16_t a1, a2;             // Feedback coefficients, Q14, as in y = ... - a1 y1 - a2 y2
+    uint32_t x[DSP_AXES];       // x[n-1] in bits 15:0, x[n-2] in bits 31:16
+    uint32_t y[DSP_AXES];       // y[n-1] in bits 15:0, y[n-2] in bits 31:16
+    uint16_t err[DSP_AXES];     // Bits of the last output below Q15
+} dsp_biquad_t;
+
+/**
+ * @brief      One-pole low-pass per axis with Q31 state, for cutoffs far below
+ *             the sample rate where a Q15 state would stop short of the input.
+ */
+typedef struct {
+    q31_t alpha;                // Smoothing factor in Q31
+    q31_t y[DSP_AXES];          // Filter output in Q31
+} dsp_lowpass_t;
+
+/**
+ * @brief      Averages every @p factor frames into one.
+ */
+typedef struct {
+    uint32_t factor;            // Input frames per output frame
+    uint32_t count;             // Frames summed so far
+    int32_t inv;                // 2^16 / factor
+    int32_t sum[DSP_AXES];      // Running sums
+} dsp_decimator_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Removes the bias of every axis and scales it, saturating.
+ * @param      in       Input frames. Word aligned on cores with SIMD.
+ * @param      out      Output frames, may be the same as @p in.
+ * @param      frames   Number of frames.
+ * @param      cal      Calibration.
+ */
+void dsp_scale_offset_q15(const q15_t *in, q15_t *out, uint32_t frames, const dsp_cal_t *cal);
+/**
+ * @brief      Designs a Butterworth (Q = 1/sqrt(2)) low-pass biquad and clears
+ *             its state. The coefficients are rounded so that the DC gain is
+ *             exactly 1.
+ * @param      f        Filter.
+ * @param      cutoff_hz    Cutoff frequency.
+ * @param      rate_hz      Sample rate.
+ * @return     Returns 0 if the operation is successful, E_BAD_PARAM if the
+ *             cutoff is not below half the sample rate.
+ */
+int dsp_biquad_lowpass(dsp_biquad_t *f, uint32_t cutoff_hz, uint32_t rate_hz);
+/**
+ * @brief      Runs a biquad over every axis.
+ * @param      f        Filter, its state carries over to the next call.
+ * @param      in       Input frames.
+ * @param      out      Output frames, may be the same as @p in.
+ * @param      frames   Number of frames.
+ */
+void dsp_biquad_q15(dsp_biquad_t *f, const q15_t *in, q15_t *out, uint32_t frames);
+/**
+ * @brief      Sets the cutoff of a one-pole low-pass and clears its state.
+ * @param      f        Filter.
+ * @param      cutoff_hz    Cutoff frequency.
+ * @param      rate_hz      Sample rate.
+ * @return     Returns 0 if the operation is successful, E_BAD_PARAM if the
+ *             cutoff is not below half the sample rate.
+ */
+int dsp_lowpass_init(dsp_lowpass_t *f, uint32_t cutoff_hz, uint32_t rate_hz);
+/**
+ * @brief      Runs a one-pole low-pass over every axis.
+ * @param      f        Filter, its state carries over to the next call.
+ * @param      in       Input frames.
+ * @param      out      Output frames, may be the same as @p in.
+ * @param      frames   Number of frames.
+ */
+void dsp_lowpass_q31(dsp_lowpass_t *f, const q15_t *in, q15_t *out, uint32_t frames);
+/**
+ * @brief      Sets the decimation factor and clears the running sums.
+ * @param      d        Decimator.
+ * @param      factor   Input frames per output frame, 1 to 65536.
+ * @return     Returns 0 if the operation is successful, E_BAD_PARAM otherwise.
+ */
+int dsp_decimate_init(dsp_decimator_t *d, uint32_t factor);
+/**
+ * @brief      Averages groups of frames. A group may span calls.
+ * @param      d        Decimator.
+ * @param      in       Input frames.
+ * @param      out      Output frames, room for frames / factor + 1. May be
+ *                      the same as @p in.
+ * @param      frames   Number of input frames.
+ * @return     Number of output frames written.
+ */
+uint32_t dsp_decimate_q15(dsp_decimator_t *d, const q15_t *in, q15_t *out, uint32_t frames);
+
+#endif
@@ -0,0 +1,206 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <math.h>
+#include <string.h>
+#include "dsp.h"
+#include "mxc_device.h"
+#include "mxc_errors.h"
+
+/***** Definitions *****/
+#define DSP_PI 3.14159265358979f
+#define DSP_Q14_ONE 16384
+
+/***** Functions *****/
+// Saturates to the Q15 range
+static inline q15_t dsp_sat_q15(int32_t value)
+{
+    return (q15_t)((value > 32767) ? 32767 : (value < -32768) ? -32768 : value);
+}
+#if DSP_SIMD
+/******************************************************************************/
+// Reads two adjacent Q15 samples as one word, low address in bits 15:0
+static inline uint32_t dsp_read_q15x2(const q15_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+/******************************************************************************/
+static inline void dsp_write_q15x2(q15_t *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+#endif
+/******************************************************************************/
+void dsp_scale_offset_q15(const q15_t *in, q15_t *out, uint32_t frames, const dsp_cal_t *cal)
+{
+    const int rshift = 15 - cal->shift;
+#if DSP_SIMD
+    uint32_t offset[DSP_AXES / 2], scale[DSP_AXES / 2];
+    for (int p = 0; p < DSP_AXES / 2; p++) {
+        offset[p] = dsp_read_q15x2(&cal->offset[2 * p]);
+        scale[p] = dsp_read_q15x2(&cal->scale[2 * p]);
+    }
+    // Two axes per word: saturating subtract of both, then one multiply each
+    for (uint32_t n = 0; n < frames * (DSP_AXES / 2); n++) {
+        int p = n % (DSP_AXES / 2);
+        uint32_t d = __QSUB16(dsp_read_q15x2(&in[2 * n]), offset[p]);
+        int32_t lo = __SSAT(__SMULBB(d, scale[p]) >> rshift, 16);
+        int32_t hi = __SSAT(__SMULTT(d, scale[p]) >> rshift, 16);
+        dsp_write_q15x2(&out[2 * n], __PKHBT(lo, hi, 16));
+    }
+#else
+    for (uint32_t n = 0; n < frames * DSP_AXES; n++) {
+        int c = n % DSP_AXES;
+        int32_t d = dsp_sat_q15((int32_t)in[n] - cal->offset[c]);
+        out[n] = dsp_sat_q15((d * cal->scale[c]) >> rshift);
+    }
+#endif
+}
+/******************************************************************************/
+int dsp_biquad_lowpass(dsp_biquad_t *f, uint32_t cutoff_hz, uint32_t rate_hz)
+{
+    if (cutoff_hz == 0 || 2 * cutoff_hz >= rate_hz) {
+        return E_BAD_PARAM;
+    }
+    // Low-pass from the Audio EQ Cookbook, Q = 1/sqrt(2)
+    float w0 = 2.0f * DSP_PI * (float)cutoff_hz / (float)rate_hz;
+    float alpha = sinf(w0) / (2.0f * 0.70710678f);
+    float cosw = cosf(w0);
+    float a0 = 1.0f + alpha;
+
+    f->b0 = (int16_t)lroundf((1.0f - cosw) / 2.0f / a0 * DSP_Q14_ONE);
+    f->b2 = f->b0;
+    int32_t a1 = lroundf(-2.0f * cosw / a0 * DSP_Q14_ONE);
+    f->a1 = (int16_t)((a1 < -32767) ? -32767 : a1);    // -a1 must fit in 16 bits
+    f->a2 = (int16_t)lroundf((1.0f - alpha) / a0 * DSP_Q14_ONE);
+    // b1 takes the rounding error, so b0 + b1 + b2 = 1 + a1 + a2 (unit DC gain)
+    f->b1 = (int16_t)(DSP_Q14_ONE + f->a1 + f->a2 - 2 * f->b0);
+    memset(f->x, 0, sizeof(f->x));
+    memset(f->y, 0, sizeof(f->y));
+    memset(f->err, 0, sizeof(f->err));
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void dsp_biquad_q15(dsp_biquad_t *f, const q15_t *in, q15_t *out, uint32_t frames)
+{
+#if DSP_SIMD
+    // Five products per output in three dual multiply-accumulates:
+    // (x0, x1).(b0, b1) + (x2, y1).(b2, -a1) + (y2, 0).(-a2, 0)
+    const uint32_t c01 = (uint16_t)f->b0 | ((uint32_t)(uint16_t)f->b1 << 16);
+    const uint32_t c2a1 = (uint16_t)f->b2 | ((uint32_t)(uint16_t)-f->a1 << 16);
+    const uint32_t ca2 = (uint16_t)-f->a2;
+
+    for (uint32_t n = 0; n < frames * DSP_AXES; n++) {
+        int c = n % DSP_AXES;
+        uint32_t x01 = __PKHBT(in[n], f->x[c], 16);
+        int64_t acc = (int64_t)__SMLALD(x01, c01, f->err[c]);
+        acc = (int64_t)__SMLALD(__PKHBT(f->x[c] >> 16, f->y[c], 16), c2a1, (uint64_t)acc);
+        acc = (int64_t)__SMLALD(f->y[c] >> 16, ca2, (uint64_t)acc);
+        int32_t y0 = __SSAT((int32_t)(acc >> 14), 16);
+        f->err[c] = (uint16_t)(acc & 0x3FFF);
+        f->x[c] = x01;
+        f->y[c] = __PKHBT(y0, f->y[c], 16);
+        out[n] = (q15_t)y0;
+    }
+#else
+    for (uint32_t n = 0; n < frames * DSP_AXES; n++) {
+        int c = n % DSP_AXES;
+        int16_t x0 = in[n];
+        int16_t x1 = (int16_t)f->x[c], x2 = (int16_t)(f->x[c] >> 16);
+        int16_t y1 = (int16_t)f->y[c], y2 = (int16_t)(f->y[c] >> 16);
+        int64_t acc = f->err[c] + (int32_t)f->b0 * x0 + (int32_t)f->b1 * x1 +
+                      (int32_t)f->b2 * x2 - (int32_t)f->a1 * y1 - (int32_t)f->a2 * y2;
+        q15_t y0 = dsp_sat_q15((int32_t)(acc >> 14));
+        f->err[c] = (uint16_t)(acc & 0x3FFF);
+        f->x[c] = (uint16_t)x0 | ((uint32_t)(uint16_t)x1 << 16);
+        f->y[c] = (uint16_t)y0 | ((uint32_t)(uint16_t)y1 << 16);
+        out[n] = y0;
+    }
+#endif
+}
+/******************************************************************************/
+int dsp_lowpass_init(dsp_lowpass_t *f, uint32_t cutoff_hz, uint32_t rate_hz)
+{
+    if (cutoff_hz == 0 || 2 * cutoff_hz >= rate_hz) {
+        return E_BAD_PARAM;
+    }
+    double alpha = 1.0 - exp(-2.0 * DSP_PI * (double)cutoff_hz / (double)rate_hz);
+    f->alpha = (q31_t)llround(alpha * 2147483647.0);
+    memset(f->y, 0, sizeof(f->y));
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void dsp_lowpass_q31(dsp_lowpass_t *f, const q15_t *in, q15_t *out, uint32_t frames)
+{
+    // 32 x 32 bit products have no SIMD form, this relies on SMULL
+    for (uint32_t n = 0; n < frames * DSP_AXES; n++) {
+        int c = n % DSP_AXES;
+        int64_t diff = ((int64_t)in[n] << 16) - f->y[c];
+        f->y[c] += (q31_t)((diff * f->alpha) >> 31);
+        out[n] = dsp_sat_q15((f->y[c] >> 16) + ((f->y[c] >> 15) & 1));
+    }
+}
+/******************************************************************************/
+int dsp_decimate_init(dsp_decimator_t *d, uint32_t factor)
+{
+    if (factor == 0 || factor > 65536) {
+        return E_BAD_PARAM;
+    }
+    d->factor = factor;
+    d->count = 0;
+    d->inv = (int32_t)((65536 + factor / 2) / factor);
+    memset(d->sum, 0, sizeof(d->sum));
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t dsp_decimate_q15(dsp_decimator_t *d, const q15_t *in, q15_t *out, uint32_t frames)
+{
+    uint32_t produced = 0;
+
+    for (uint32_t n = 0; n < frames; n++, in += DSP_AXES) {
+#if DSP_SIMD
+        // Dual multiply-accumulate against 1 picks one half of the word
+        for (int c = 0; c < DSP_AXES; c += 2) {
+            uint32_t w = dsp_read_q15x2(&in[c]);
+            d->sum[c] = __SMLAD(w, 0x00000001, d->sum[c]);
+            d->sum[c + 1] = __SMLAD(w, 0x00010000, d->sum[c + 1]);
+        }
+#else
+        for (int c = 0; c < DSP_AXES; c++) {
+            d->sum[c] += in[c];
+        }
+#endif
+        if (++d->count < d->factor) {
+            continue;
+        }
+        for (int c = 0; c < DSP_AXES; c++) {
+            out[c] = dsp_sat_q15((int32_t)(((int64_t)d->sum[c] * d->inv + 0x8000) >> 16));
+            d->sum[c] = 0;
+        }
+        d->count = 0;
+        out += DSP_AXES;
+        produced++;
+    }
+    return produced;
+}
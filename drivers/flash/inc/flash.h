@@ -37,15 +37,61 @@
 #include "flc_reva_regs.h"
 #include "max78000.h"
 #include "mxc_errors.h"
+#include "stats.h"
+#include "pool.h"
+#include "osal.h"
+
+/***** Definitions *****/
+#define FLASH_STEP_BYTES 16	// Largest write done by one Flash_WriteStep(), one 128-bit line
+
+/**
+ * @brief      Flash write done in steps, so a cooperative task can let others
+ *             run between program operations. See Flash_WriteStep().
+ */
+typedef struct {
+	uint32_t address;	// Next address to program
+	const uint8_t *data;	// Next bytes to program
+	uint32_t left;		// Bytes still to program
+} flash_job_t;
 
 /***** Function Prototypes *****/
 /**
- * @brief      Reads data from the flash memory.
+ * @brief      Reads data from the flash memory into a pool block.
  * @param      address  Address in the flash memory from where the data has to be read.
- * @param      len      Length of data to be read.
- * @return     Pointer to the data read from flash memory.
+ * @param      len      Length of data to be read, at most POOL_LARGE_SIZE (512
+ *                      bytes by default); use Flash_ReadInto() for longer reads.
+ * @return     Pointer to the data read from flash memory, in reverse byte
+ *             order, or NULL if @p len is larger than POOL_LARGE_SIZE or no
+ *             pool block is free. Release it with pool_free().
  */
 uint8_t* Flash_Read(int address, int len);
+/**
+ * @brief      Reads data from the flash memory into a buffer of the caller,
+ *             in the same reverse byte order as Flash_Read(). Any length.
+ * @param      address  Address in the flash memory from where the data has to be read.
+ * @param      buffer   Receives @p len bytes.
+ * @param      len      Length of data to be read.
+ * @return     Returns 0 if the operation is successful, E_BAD_PARAM if
+ *             @p buffer is NULL or @p len is negative.
+ */
+int Flash_ReadInto(int address, uint8_t *buffer, int len);
+/**
+ * @brief      Takes the read side of the flash lock, for code that reads the
+ *             memory mapped array directly rather than through Flash_Read().
+ *             Erases and writes from other tasks wait until Flash_ReadUnlock().
+ *             No Flash_ erase or write may be called while it is held. A no-op
+ *             without a running scheduler.
+ */
+#if OSAL_RTOS
+void Flash_ReadLock(void);
+/**
+ * @brief      Releases the read side taken by Flash_ReadLock().
+ */
+void Flash_ReadUnlock(void);
+#else
+static inline void Flash_ReadLock(void) {}
+static inline void Flash_ReadUnlock(void) {}
+#endif
 
 void MXC_FLC_Com_Read(int address,void *buffer,int len);
 
@@ -59,14 +105,17 @@ int MXC_FLC_RevA_MassErase(mxc_flc_reva_regs_t *flc);
 
 int MXC_FLC_RevA_PageErase(mxc_flc_reva_regs_t *flc, uint32_t addr);
 /**
- * @brief      Performs a total erase operation on the flash memory.
+ * @brief      Performs a total erase operation on the flash memory. The boot
+ *             stage page goes too, so the device does not start again until
+ *             the boot stage is programmed with the debugger.
  * @return     Returns 0 if successful, otherwise returns an error code.
  */
 int Flash_TotalErase();
 /**
  * @brief      Erases a specific page in the flash memory.
  * @param      address  Address of the page to be erased.
- * @return     Returns 0 if successful, otherwise returns an error code.
+ * @return     Returns 0 if successful, E_BAD_PARAM for the boot stage page
+ *             (FLASH_BOOT_BASE), otherwise returns an error code.
  */
 int Flash_PageErase(uint32_t address);
 /**
@@ -90,5 +139,33 @@ int MXC_FLC_Write128(uint32_t address, uint32_t *data);
  * @return     Returns 0 if successful, otherwise returns an error code.
  */
 int Flash_Write(uint32_t address, uint64_t *buffer);
+/**
+ * @brief      Writes a byte buffer to the flash memory. The address and length
+ *             need no alignment; the target bytes must be erased.
+ * @param      address  Address in the flash memory where the data is to be written.
+ * @param      data     Pointer to the data to be written.
+ * @param      len      Number of bytes to write.
+ * @return     Returns 0 if successful, E_BAD_PARAM if the bytes reach into the
+ *             boot stage page, otherwise returns an error code.
+ */
+int Flash_WriteBuffer(uint32_t address, const uint8_t *data, uint32_t len);
+/**
+ * @brief      Sets up a write to be done with Flash_WriteStep(). Nothing is
+ *             programmed yet.
+ * @param      job      Write to set up.
+ * @param      address  Address in the flash memory where the data is to be written.
+ * @param      data     Pointer to the data, must stay valid until the write is done.
+ * @param      len      Number of bytes to write.
+ */
+void Flash_WriteStart(flash_job_t *job, uint32_t address, const uint8_t *data, uint32_t len);
+/**
+ * @brief      Programs the next part of a write, up to the end of the current
+ *             128-bit flash line. The core stalls while the line programs, as
+ *             in Flash_WriteBuffer(); the gain is that other work can run
+ *             between the steps.
+ * @param      job      Write set up by Flash_WriteStart().
+ * @return     Number of bytes left, 0 when the write is done, or a negative error code.
+ */
+int Flash_WriteStep(flash_job_t *job);
 
 #endif
@@ -0,0 +1,76 @@
+/**
+ * @file       flash_layout.h
+ * @brief      Internal flash region map.
+ * @details    Splits the 512 KB main flash array into the boot stage page,
+ *             the running application, the staging region a firmware update
+ *             is written to, the update journal, the IMU session log, the
+ *             crash dump page of the black box, the storage handed to
+ *             blockdev_flc and a scratch page for the test cases. Every
+ *             region is a whole number of 8 KB pages.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __FLASH_LAYOUT_H__
+#define __FLASH_LAYOUT_H__
+
+/***** Includes *****/
+#include "max78000.h"
+
+/***** Definitions *****/
+#ifndef FLASH_APP_SIZE
+#define FLASH_APP_SIZE 0x30000          // Largest application image, 192 KB
+#endif
+
+#ifndef FLASH_STORAGE_SIZE
+#define FLASH_STORAGE_SIZE 0xE000       // Storage before the scratch page, 56 KB
+#endif
+
+#ifndef FLASH_LOG_SIZE
+#define FLASH_LOG_SIZE 0xA000           // IMU session log after the journal, 40 KB
+#endif
+
+#define FLASH_BOOT_BASE MXC_FLASH_MEM_BASE
+#define FLASH_BOOT_SIZE MXC_FLASH_PAGE_SIZE     // Boot stage, drivers/update/boot
+#define FLASH_APP_BASE (FLASH_BOOT_BASE + FLASH_BOOT_SIZE)
+#define FLASH_STAGING_BASE (FLASH_APP_BASE + FLASH_APP_SIZE)
+#define FLASH_STAGING_SIZE FLASH_APP_SIZE
+#define FLASH_JOURNAL_BASE (FLASH_STAGING_BASE + FLASH_STAGING_SIZE)
+#define FLASH_JOURNAL_SIZE MXC_FLASH_PAGE_SIZE
+#define FLASH_LOG_BASE (FLASH_JOURNAL_BASE + FLASH_JOURNAL_SIZE)
+#define FLASH_BLACKBOX_BASE (FLASH_LOG_BASE + FLASH_LOG_SIZE)
+#define FLASH_BLACKBOX_SIZE MXC_FLASH_PAGE_SIZE
+#define FLASH_SCRATCH_BASE (MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE - MXC_FLASH_PAGE_SIZE)
+#define FLASH_SCRATCH_SIZE MXC_FLASH_PAGE_SIZE  // Last page, erased and programmed by the test cases
+#define FLASH_STORAGE_BASE (FLASH_SCRATCH_BASE - FLASH_STORAGE_SIZE)
+
+#if (FLASH_APP_SIZE % MXC_FLASH_PAGE_SIZE) != 0 || (FLASH_STORAGE_SIZE % MXC_FLASH_PAGE_SIZE) != 0 || \
+    (FLASH_LOG_SIZE % MXC_FLASH_PAGE_SIZE) != 0
+#error "Flash regions must be whole pages"
+#endif
+
+#if FLASH_BLACKBOX_BASE + FLASH_BLACKBOX_SIZE > FLASH_STORAGE_BASE
+#error "Flash regions overlap, reduce FLASH_APP_SIZE, FLASH_LOG_SIZE or FLASH_STORAGE_SIZE"
+#endif
+
+#endif
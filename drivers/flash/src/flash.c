@@ -21,10 +21,23 @@
 
 /***** Includes *****/
 #include "flash.h"
+#include "flash_layout.h"
+#include "ramfunc.h"
+#include "blackbox.h"
+#include "bustrace.h"
+#include "osal.h"
 
+/***** Globals *****/
+// Reads share the array, erases and writes have it alone; a read during a
+// program operation would see half written data
+static osal_rwlock_t flash_lock;
+
+// Only the debugger writes the boot stage page, an update cannot replace it
+#define FLASH_IN_BOOT(address, len) \
+	((address) < FLASH_BOOT_BASE + FLASH_BOOT_SIZE && (address) + (len) > FLASH_BOOT_BASE)
 
 /**********************************************************************************/
-void MXC_FLC_AI87_Flash_Operation(void)
+RAMFUNC void MXC_FLC_AI87_Flash_Operation(void)
 {
     /* Flush all instruction caches */
     MXC_GCR->sysctrl |= MXC_F_GCR_SYSCTRL_ICC0_FLUSH;
@@ -41,7 +54,7 @@ void MXC_FLC_AI87_Flash_Operation(void)
     line = *line_addr;
 }
 /**********************************************************************************/
-int MXC_FLC_AI87_GetByAddress(mxc_flc_regs_t **flc, uint32_t addr)
+RAMFUNC int MXC_FLC_AI87_GetByAddress(mxc_flc_regs_t **flc, uint32_t addr)
 {
     if ((addr >= MXC_FLASH_MEM_BASE) && (addr < (MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE))) {
         *flc = MXC_FLC0;
@@ -54,7 +67,7 @@ int MXC_FLC_AI87_GetByAddress(mxc_flc_regs_t **flc, uint32_t addr)
     return E_NO_ERROR;
 }
 /**********************************************************************************/
-int MXC_FLC_AI87_GetPhysicalAddress(uint32_t addr, uint32_t *result)
+RAMFUNC int MXC_FLC_AI87_GetPhysicalAddress(uint32_t addr, uint32_t *result)
 {
     if ((addr >= MXC_FLASH_MEM_BASE) && (addr < (MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE))) {
         *result = addr - MXC_FLASH_MEM_BASE;
@@ -68,12 +81,11 @@ int MXC_FLC_AI87_GetPhysicalAddress(uint32_t addr, uint32_t *result)
 
 }
 /**********************************************************************************/
-uint8_t* Flash_Read(int address, int len) {
-    uint8_t *buffer = malloc(len * sizeof(uint8_t));	// Allocate memory for the buffer to store the data read from flash
-    if(buffer == NULL) {
-        return NULL;
-    }
+// Copies len bytes from the array into buffer, last byte first
+static void flash_read_reversed(int address, uint8_t *buffer, int len) {
+    osal_read_lock(&flash_lock);
     MXC_FLC_Com_Read(address, buffer, len);		// Read the data from the flash memory into the buffer
+    osal_read_unlock(&flash_lock);
 
     for(int i=0; i < len / 2; i++)
     {
@@ -81,26 +93,71 @@ uint8_t* Flash_Read(int address, int len) {
 	    buffer[i] = buffer[len - i - 1];
 	    buffer[len - i - 1] = temp;
     }
+}
+/**********************************************************************************/
+uint8_t* Flash_Read(int address, int len) {
+    STATS_BEGIN();
+    BUSTRACE_BEGIN();
+    uint8_t *buffer = pool_alloc(len);	// Take a pool block for the data read from flash
+    if(buffer == NULL) {
+        STATS_END(STATS_FLASH_READ, 0, E_NONE_AVAIL);
+        return NULL;
+    }
+    flash_read_reversed(address, buffer, len);
+    STATS_END(STATS_FLASH_READ, len, E_NO_ERROR);
+    BUSTRACE_END(BUSTRACE_FLASH_READ, address, NULL, len, E_NO_ERROR);
     return buffer;	// Return the pointer to the buffer containing the data
 }
 /**********************************************************************************/
+int Flash_ReadInto(int address, uint8_t *buffer, int len) {
+    if(buffer == NULL || len < 0) {
+        return E_BAD_PARAM;
+    }
+    STATS_BEGIN();
+    BUSTRACE_BEGIN();
+    flash_read_reversed(address, buffer, len);
+    STATS_END(STATS_FLASH_READ, len, E_NO_ERROR);
+    BUSTRACE_END(BUSTRACE_FLASH_READ, address, NULL, len, E_NO_ERROR);
+    return E_NO_ERROR;
+}
+#if OSAL_RTOS
+/**********************************************************************************/
+void Flash_ReadLock(void)
+{
+    osal_read_lock(&flash_lock);
+}
+/**********************************************************************************/
+void Flash_ReadUnlock(void)
+{
+    osal_read_unlock(&flash_lock);
+}
+#endif
+/**********************************************************************************/
 int Flash_TotalErase()
 {
 	int err, i;
 	mxc_flc_regs_t *flc;	// Pointer to flash controller registers
+	osal_write_lock(&flash_lock);
 	for(i = 0; i < MXC_FLC_INSTANCES; i++)
 	{
+		STATS_BEGIN();
 		flc = MXC_FLC_GET_FLC(i);
 		err = MXC_FLC_RevA_MassErase((mxc_flc_reva_regs_t *)flc);	// Perform a mass erase operation on the current flash controller
+		for (uint32_t page = 0; page < MXC_FLASH_MEM_SIZE; page += MXC_FLASH_PAGE_SIZE) {
+			STATS_PAGE_ERASE(MXC_FLASH_MEM_BASE + page);	// Every page wears
+		}
+		STATS_END(STATS_FLASH_ERASE, 0, err);
 		if (err != E_NO_ERROR) {
+			osal_write_unlock(&flash_lock);
 			return err;
 		}
 		MXC_FLC_AI87_Flash_Operation();		// Performing additional flash operations to flush the cache
 	}
+	osal_write_unlock(&flash_lock);
 	return 0;	// Return 0 if all operations were successful	
 }
 /**********************************************************************************/
-int Flash_PageErase(uint32_t address)
+RAMFUNC int Flash_PageErase(uint32_t address)
 {
 	int err;
 	uint32_t addr;
@@ -113,25 +170,44 @@ int Flash_PageErase(uint32_t address)
 	if ((err = MXC_FLC_AI87_GetPhysicalAddress(address, &addr)) < E_NO_ERROR) {
         return err;
 	}
+	if (FLASH_IN_BOOT(address, 1)) {
+		return E_BAD_PARAM;
+	}
+	STATS_BEGIN();
+	BUSTRACE_BEGIN();
+	osal_write_lock(&flash_lock);
 	err = MXC_FLC_RevA_PageErase((mxc_flc_reva_regs_t *)flc, address);	// Perform a page erase operation on the flash memory
 	MXC_FLC_AI87_Flash_Operation();	// Flush the cache
+	osal_write_unlock(&flash_lock);
+	STATS_PAGE_ERASE(address);
+	STATS_END(STATS_FLASH_ERASE, 0, err);
+	blackbox_event(BLACKBOX_EV_FLASH_ERASE, address, err);
+	BUSTRACE_END(BUSTRACE_FLASH_ERASE, address, NULL, 0, err);
 
-	return 0;	// Return 0 if all operations were successful
+	return err;	// Return the result of the erase
 }
 /**********************************************************************************/
-int Flash_Write(uint32_t address, uint64_t *buffer)
+// Records a write in the black box, the error in place of the length if it failed
+static inline void flash_trace_write(uint32_t address, uint32_t length, int err)
 {
-	size_t size = 0;
-	while(buffer[size]!=0)	// Calculate the size of the buffer
-	{
-		size++;
+	if (err != E_NO_ERROR) {
+		blackbox_event(BLACKBOX_EV_FLASH_ERROR, address, err);
+	} else {
+		blackbox_event(BLACKBOX_EV_FLASH_WRITE, address, length);
 	}
-	uint32_t length=(size-1) * sizeof(uint64_t);	// Calculate the length of data to be written in bytes
+}
+/**********************************************************************************/
+// Programs length bytes at address, using 128-bit writes where the alignment allows
+static RAMFUNC int flash_write_bytes(uint32_t address, const uint8_t *buffer8, uint32_t length)
+{
     	int err;
 	uint32_t bytes_written;
 	uint32_t current_data_32;
 	uint8_t *current_data = (uint8_t *)&current_data_32;
-	uint8_t *buffer8 = (uint8_t *)buffer;
+
+	if (FLASH_IN_BOOT(address, length)) {
+		return E_BAD_PARAM;
+	}
 
 	// Align the address to a word boundary and read/write if we have to
 	if (address & 0x3) {
@@ -139,7 +215,7 @@ int Flash_Write(uint32_t address, uint64_t *buffer)
         bytes_written = 4 - (address & 0x3);
 
         // Save the data currently in the flash
-        memcpy(current_data, (void *)(address & (~0x3)), 4);
+        memcpy(current_data, (void *)(uintptr_t)(address & (~0x3)), 4);
 
         // Modify current_data to insert the data from buffer
         memcpy(&current_data[4 - bytes_written], buffer8, bytes_written);
@@ -190,7 +266,7 @@ int Flash_Write(uint32_t address, uint64_t *buffer)
 	// Write any remaining bytes to the flash memory
      	if (length > 0) {
         	// Save the data currently in the flash
-         	memcpy(current_data, (void *)(address), 4);
+         	memcpy(current_data, (void *)(uintptr_t)(address), 4);
 
          	// Modify current_data to insert the data from buffer
          	memcpy(current_data, buffer8, length);
@@ -202,3 +278,70 @@ int Flash_Write(uint32_t address, uint64_t *buffer)
 
      	return E_NO_ERROR;	// Return 0 if the operation was successful
 }
+/**********************************************************************************/
+RAMFUNC int Flash_Write(uint32_t address, uint64_t *buffer)
+{
+	STATS_BEGIN();
+	BUSTRACE_BEGIN();
+	size_t size = 0;
+	while(buffer[size]!=0)	// Calculate the size of the buffer
+	{
+		size++;
+	}
+	uint32_t length=(size-1) * sizeof(uint64_t);	// Calculate the length of data to be written in bytes
+
+	osal_write_lock(&flash_lock);
+	int err = flash_write_bytes(address, (const uint8_t *)buffer, length);
+	osal_write_unlock(&flash_lock);
+	STATS_END(STATS_FLASH_WRITE, length, err);
+	flash_trace_write(address, length, err);
+	BUSTRACE_END(BUSTRACE_FLASH_WRITE, address, buffer, length, err);
+	return err;
+}
+/**********************************************************************************/
+RAMFUNC int Flash_WriteBuffer(uint32_t address, const uint8_t *data, uint32_t len)
+{
+	STATS_BEGIN();
+	BUSTRACE_BEGIN();
+	osal_write_lock(&flash_lock);
+	int err = flash_write_bytes(address, data, len);
+	osal_write_unlock(&flash_lock);
+	STATS_END(STATS_FLASH_WRITE, len, err);
+	flash_trace_write(address, len, err);
+	BUSTRACE_END(BUSTRACE_FLASH_WRITE, address, data, len, err);
+	return err;
+}
+/**********************************************************************************/
+void Flash_WriteStart(flash_job_t *job, uint32_t address, const uint8_t *data, uint32_t len)
+{
+	job->address = address;
+	job->data = data;
+	job->left = len;
+}
+/**********************************************************************************/
+RAMFUNC int Flash_WriteStep(flash_job_t *job)
+{
+	if (job->left == 0) {
+		return 0;
+	}
+	// Up to the next line boundary, so one step is at most one program operation per word
+	uint32_t len = FLASH_STEP_BYTES - (job->address & (FLASH_STEP_BYTES - 1));
+	if (len > job->left) {
+		len = job->left;
+	}
+	STATS_BEGIN();
+	BUSTRACE_BEGIN();
+	osal_write_lock(&flash_lock);
+	int err = flash_write_bytes(job->address, job->data, len);
+	osal_write_unlock(&flash_lock);
+	STATS_END(STATS_FLASH_WRITE, len, err);
+	flash_trace_write(job->address, len, err);
+	BUSTRACE_END(BUSTRACE_FLASH_WRITE, job->address, job->data, len, err);
+	if (err != E_NO_ERROR) {
+		return err;
+	}
+	job->address += len;
+	job->data += len;
+	job->left -= len;
+	return (int)job->left;
+}
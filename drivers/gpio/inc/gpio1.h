@@ -31,12 +31,15 @@
 
 /***** Includes *****/
 #include <stdint.h>
+#include <stdio.h>
 #include "mxc_device.h"
 #include "mxc_delay.h"
 #include "nvic_table.h"
 #include "pb.h"
 #include "board.h"
 #include "gpio.h"
+#include "stats.h"
+#include "osal.h"
 
 /***** Definitions *****/
 #ifdef BOARD_EVKIT_V1
@@ -80,7 +83,7 @@ int gpio_set(uint8_t port_num, uint8_t pin_num, uint8_t value);
  * @brief      Read the data from the gpio pin.
  * @param      port_num	Port number of the gpio on which the data has to read.
  * @param      pin_num	Pin number of the gpio on which the data has to read.
- * @return     returns the data read on gpio pin.
+ * @return     returns the data read on gpio pin, 0 for an invalid port.
 */
 uint32_t gpio_get(uint8_t port_num, uint8_t pin_num);
 #endif
@@ -21,6 +21,8 @@
 
 /***** Includes *****/
 #include "gpio1.h"
+#include "log.h"
+#include "ramfunc.h"
 
 /***** Functions *****/
 /**
@@ -30,9 +32,9 @@
  * @param value The value to set the pin to (0 for low, 1 for high).
  * @return 0 if successful, 1 if an invalid port number is specified.
  */
-int gpio_set(uint8_t port_num, uint8_t pin_num, uint8_t value)	// Function to set the state of a GPIO pin
+RAMFUNC int gpio_set(uint8_t port_num, uint8_t pin_num, uint8_t value)	// Function to set the state of a GPIO pin
 {
-	
+    STATS_BEGIN();
     mxc_gpio_cfg_t gpio;	// GPIO configuration structure
     
     switch(port_num)	// Select the GPIO port based on port_num
@@ -70,25 +72,34 @@ int gpio_set(uint8_t port_num, uint8_t pin_num, uint8_t value)	// Function to se
 	    gpio.drvstr = MXC_GPIO_DRVSTR_0;
 	    break;
 	default:
-	    printf("\nInvalid PORT");	// Print an error message for an invalid port
+	    LOG_ERROR("Invalid PORT %u", port_num);	// Log an error message for an invalid port
+	    STATS_END(STATS_GPIO_SET, 0, 1);
 	    return 1;		// Return an error code
     }
+    // Config rewrites whole port registers; tasks and interrupt handlers share them
+    OSAL_CRITICAL_ENTER();
     MXC_GPIO_Config(&gpio);	// Configure the GPIO with the settings specified in gpio
     if(value == 1)		// Check if the value to set is high (1)
     {
 	    MXC_GPIO_OutSet(gpio.port, gpio.mask);	// Set the GPIO pin
-	    return 0;		// Return success code
     }
     else if (value == 0)	// Check if the value to set is high (0)
     {
 	    MXC_GPIO_OutClr(gpio.port, gpio.mask);	// Clear the GPIO pin
-	    return 0;		// Return success code
     }
+    OSAL_CRITICAL_EXIT();
+    if(value > 1)
+    {
+	STATS_END(STATS_GPIO_SET, 0, 1);
 	return 1;		// Return error code if value is not 0 or 1 
+    }
+    STATS_END(STATS_GPIO_SET, 0, 0);
+    return 0;		// Return success code
 }
 /**********************************************************************************/
-uint32_t gpio_get(uint8_t port_num, uint8_t pin_num)	// Function to get the state of a GPIO pin
+RAMFUNC uint32_t gpio_get(uint8_t port_num, uint8_t pin_num)	// Function to get the state of a GPIO pin
 {
+	STATS_BEGIN();
 	mxc_gpio_cfg_t gpio;	// GPIO configuration structure
 
 	switch(port_num)	// Select the GPIO port based on port_num
@@ -126,11 +137,16 @@ uint32_t gpio_get(uint8_t port_num, uint8_t pin_num)	// Function to get the stat
 		    gpio.drvstr = MXC_GPIO_DRVSTR_0;
 		    break;
 		default:
-		    printf("\nInvalid PORT");	// Print an error message for an invalid port
-		    break;    
+		    LOG_ERROR("Invalid PORT %u", port_num);	// Log an error message for an invalid port
+		    STATS_END(STATS_GPIO_GET, 0, 1);
+		    return 0;		// No pin to read, report low
 	}
+	OSAL_CRITICAL_ENTER();
 	MXC_GPIO_Config(&gpio);	// Configure the GPIO with the settings specified in gpio
-	return (MXC_GPIO_InGet(gpio.port, gpio.mask) >> pin_num);	// Read and return the state of the pin
+	uint32_t level = MXC_GPIO_InGet(gpio.port, gpio.mask) >> pin_num;	// Read the state of the pin
+	OSAL_CRITICAL_EXIT();
+	STATS_END(STATS_GPIO_GET, 0, 0);
+	return level;
 
 }
 
@@ -0,0 +1,148 @@
+/**
+ * @file       imu_log.h
+ * @brief      IMU session log in internal flash.
+ * @details    Packs timestamped BMI160 frames into variable length records,
+ *             delta encoded against the previous frame, and collects them in
+ *             a RAM page that is programmed in 128-bit lines once full. An
+ *             index page holds the time span and CRC of every log page, so a
+ *             reader finds any point of a session with a binary search.
+ *
+ *             The log uses FLASH_LOG_SIZE bytes at FLASH_LOG_BASE (see
+ *             flash_layout.h): one index page followed by the log pages.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __IMU_LOG_H__
+#define __IMU_LOG_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "imu_window.h"
+#include "flash_layout.h"
+
+/***** Definitions *****/
+#ifndef IMU_LOG_PAGE_SIZE
+#define IMU_LOG_PAGE_SIZE 512       // Bytes per log page, a multiple of 16 that divides the flash page
+#endif
+
+#define IMU_LOG_RECORD_MAX 23       // Longest record: 5 byte time step, 6 x 3 byte axis deltas
+#define IMU_LOG_FRAME_BYTES 16      // Unencoded frame: 32-bit time and six 16-bit axes
+#define IMU_LOG_PAGES ((FLASH_LOG_SIZE - MXC_FLASH_PAGE_SIZE) / IMU_LOG_PAGE_SIZE)
+
+/**
+ * @brief      One timestamped sample.
+ */
+typedef struct {
+    uint32_t t;                         // Time in microseconds, increasing within a session
+    int16_t axis[IMU_CHANNELS];         // Gyro X/Y/Z then accel X/Y/Z, raw
+} imu_log_frame_t;
+
+/**
+ * @brief      Index entry of one log page, one 128-bit flash line. All ones
+ *             while the page is unwritten; a count of 0 marks a page whose
+ *             write failed, which readers skip.
+ */
+typedef struct {
+    uint32_t t_first;           // Time of the first record
+    uint32_t t_last;            // Time of the last record
+    uint16_t count;             // Records in the page
+    uint16_t bytes;             // Encoded bytes in the page
+    uint32_t crc;               // CRC-32 of those bytes
+} imu_log_index_t;
+
+/**
+ * @brief      Position of a reader in the log.
+ */
+typedef struct {
+    uint32_t page;              // Log page being read
+    uint32_t record;            // Records already read from it
+    uint32_t offset;            // Offset of the next record in the page
+    uint32_t dt;                // Time step of the last frame
+    imu_log_frame_t prev;       // Last frame read
+    imu_log_index_t entry;      // Index entry of the page
+    int pending;                // prev was found by imu_log_seek() and not yet returned
+} imu_log_reader_t;
+
+/**
+ * @brief      Logger counters.
+ */
+typedef struct {
+    uint32_t records;           // Frames appended
+    uint32_t pages;             // Log pages programmed
+    uint32_t raw_bytes;         // Size of the appended frames unencoded
+    uint32_t flash_bytes;       // Bytes programmed, padding and index entries included
+    uint32_t dropped;           // Frames refused because the log was full
+    uint32_t write_cycles;      // Core cycles spent programming pages
+} imu_log_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Erases the log region and starts a new session.
+ * @return     Returns 0 if the operation is successful, otherwise the flash error.
+ */
+int imu_log_start(void);
+/**
+ * @brief      Adds a frame to the RAM page, programming the page first when
+ *             the record does not fit. Only a page write touches the flash.
+ *             If that write fails, the page's frames are dropped and counted
+ *             and logging goes on in the next page.
+ * @param      frame    Frame to add.
+ * @return     Returns 0 if the operation is successful, E_OVERFLOW if the log
+ *             is full, otherwise the flash error.
+ */
+int imu_log_append(const imu_log_frame_t *frame);
+/**
+ * @brief      Programs the partly filled RAM page, e.g. at the end of a session.
+ * @return     Returns 0 if the operation is successful, otherwise the flash error.
+ */
+int imu_log_flush(void);
+/**
+ * @brief      Counts the log pages in flash.
+ * @return     Number of indexed log pages, spoilt ones included.
+ */
+uint32_t imu_log_pages(void);
+/**
+ * @brief      Places a reader before the first frame at or after a time.
+ * @param      r        Reader.
+ * @param      t        Time to seek to; 0 starts at the beginning of the log.
+ * @return     Returns 0 if the operation is successful, E_NONE_AVAIL if no
+ *             frame is that late, E_BAD_STATE if a page fails its CRC check.
+ */
+int imu_log_seek(imu_log_reader_t *r, uint32_t t);
+/**
+ * @brief      Reads the next frame.
+ * @param      r        Reader placed by imu_log_seek().
+ * @param      frame    Receives the frame.
+ * @return     1 if a frame was read, 0 at the end of the log, E_BAD_STATE if
+ *             a page fails its CRC check or does not decode.
+ */
+int imu_log_read(imu_log_reader_t *r, imu_log_frame_t *frame);
+/**
+ * @brief      Copies the logger counters.
+ * @param      stats    Receives the counters.
+ * @param      reset    Non-zero to clear the counters after copying.
+ */
+void imu_log_get_stats(imu_log_stats_t *stats, int reset);
+
+#endif
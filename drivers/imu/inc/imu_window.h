@@ -0,0 +1,137 @@
+/**
+ * @file       imu_window.h
+ * @brief      BMI160 sample windows for the CNN accelerator.
+ * @details    Collects gyro and accelerometer samples into sliding windows
+ *             that are quantised to int8 while they are stored, in the
+ *             channel-major layout the accelerator loads 1D inputs in. Two
+ *             window buffers alternate so acquisition keeps filling one while
+ *             inference reads the other.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __IMU_WINDOW_H__
+#define __IMU_WINDOW_H__
+
+/***** Includes *****/
+#include <stdint.h>
+
+/***** Definitions *****/
+#ifndef IMU_WINDOW_LEN
+#define IMU_WINDOW_LEN 128          // Samples per window
+#endif
+#ifndef IMU_WINDOW_STRIDE
+#define IMU_WINDOW_STRIDE 64        // New samples between windows, at most IMU_WINDOW_LEN
+#endif
+#ifndef IMU_GYR_SHIFT
+#define IMU_GYR_SHIFT 8             // Raw gyro value >> shift gives the int8 input
+#endif
+#ifndef IMU_ACC_SHIFT
+#define IMU_ACC_SHIFT 8             // Raw accelerometer value >> shift gives the int8 input
+#endif
+
+#define IMU_CHANNELS 6              // Gyro X/Y/Z, accel X/Y/Z
+
+/**
+ * @brief      One window of quantised samples, channel-major: each channel's
+ *             IMU_WINDOW_LEN samples are contiguous, oldest first.
+ */
+typedef struct {
+    int8_t data[IMU_CHANNELS][IMU_WINDOW_LEN];
+} imu_window_t;
+
+/**
+ * @brief      Inference stage. Called by imu_window_poll() with a complete
+ *             window, which stays unchanged until the function returns.
+ * @param      win      Window to run inference on.
+ * @param      seq      Window number, counting from 0 after imu_window_init().
+ * @param      ctx      Pointer passed to imu_window_init().
+ */
+typedef void (*imu_infer_fn_t)(const imu_window_t *win, uint32_t seq, void *ctx);
+
+/**
+ * @brief      Pipeline counters.
+ */
+typedef struct {
+    uint32_t samples;           // Samples stored
+    uint32_t errors;            // Failed sensor reads
+    uint32_t windows;           // Windows handed to inference
+    uint32_t dropped;           // Windows completed while inference still held the other buffer
+    uint32_t latency_max;       // Most cycles from the last sample of a window to the end of inference
+    uint64_t latency_total;     // Sum of those cycles over all inferred windows
+} imu_window_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Converts a raw sensor value to the accelerator's int8 input:
+ *             rounds off @p shift bits and saturates.
+ * @param      raw      Raw two's complement value.
+ * @param      shift    Bits to drop.
+ * @return     Quantised value, -128 to 127.
+ */
+static inline int8_t imu_quantize(int16_t raw, unsigned int shift)
+{
+    int32_t value = raw;
+    if (shift > 0) {
+        value = (value + (1 << (shift - 1))) >> shift;
+    }
+    return (int8_t)((value > 127) ? 127 : (value < -128) ? -128 : value);
+}
+/**
+ * @brief      Resets the pipeline and sets the inference stage.
+ * @param      fn       Inference stage.
+ * @param      ctx      Passed to every call of @p fn.
+ */
+void imu_window_init(imu_infer_fn_t fn, void *ctx);
+/**
+ * @brief      Stores one sample in the window being filled.
+ *
+ * When the window is complete it is handed to inference and filling goes on
+ * in the other buffer, starting with the last IMU_WINDOW_LEN - IMU_WINDOW_STRIDE
+ * samples. If inference still holds the other buffer the window is dropped
+ * and slid in place instead, so this never waits. Safe to call from the
+ * sample timer or data-ready interrupt while imu_window_poll() runs in thread
+ * mode.
+ *
+ * @param      sample   Gyro X/Y/Z then accel X/Y/Z, raw.
+ */
+void imu_window_push(const int16_t sample[IMU_CHANNELS]);
+/**
+ * @brief      Reads one sample from the BMI160 and stores it.
+ * @return     Returns 0 if the operation is successful, otherwise the I2C error.
+ */
+int imu_window_acquire(void);
+/**
+ * @brief      Runs the inference stage on the completed window, if there is
+ *             one, then gives its buffer back to acquisition.
+ * @return     1 if inference ran, 0 if no window was waiting.
+ */
+int imu_window_poll(void);
+/**
+ * @brief      Copies the pipeline counters.
+ * @param      stats    Receives the counters.
+ * @param      reset    Non-zero to clear the counters after copying.
+ */
+void imu_window_get_stats(imu_window_stats_t *stats, int reset);
+
+#endif
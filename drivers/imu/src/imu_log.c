@@ -0,0 +1,366 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "imu_log.h"
+#include "flash.h"
+#include "crc32.h"
+#include "cycles.h"
+#include "mxc_errors.h"
+
+/***** Definitions *****/
+#if (IMU_LOG_PAGE_SIZE % 16) != 0 || (MXC_FLASH_PAGE_SIZE % IMU_LOG_PAGE_SIZE) != 0
+#error "IMU_LOG_PAGE_SIZE must be a multiple of 16 that divides the flash page"
+#endif
+
+#if FLASH_LOG_SIZE < 2 * MXC_FLASH_PAGE_SIZE
+#error "FLASH_LOG_SIZE must hold the index page and at least one flash page of log"
+#endif
+
+#define IMU_LOG_INDEX ((const imu_log_index_t *)FLASH_LOG_BASE)    // Read through the memory map
+#define IMU_LOG_DATA_BASE (FLASH_LOG_BASE + MXC_FLASH_PAGE_SIZE)
+#define IMU_LOG_UNUSED 0xFFFF       // Count of an unwritten index entry
+#define IMU_LOG_SPOILT 0            // Count of a page whose write failed, skipped by readers
+
+/**
+ * @brief      Frame the next record is encoded against.
+ */
+typedef struct {
+    uint32_t t;                 // Time of the previous frame
+    uint32_t dt;                // Time step to the previous frame
+    int16_t axis[IMU_CHANNELS];
+} imu_log_state_t;
+
+/***** Globals *****/
+static uint8_t imu_log_buf[IMU_LOG_PAGE_SIZE];  // Page being filled
+static imu_log_index_t imu_log_entry;           // Its index entry, count 0 while empty
+static imu_log_state_t imu_log_state;           // Last frame appended
+static uint32_t imu_log_next;                   // Number of the page being filled
+static uint32_t imu_log_indexed;                // Index entries programmed, in order from the first
+static imu_log_stats_t imu_log_stats;
+
+/***** Functions *****/
+// Maps signed to unsigned so small magnitudes of either sign encode short
+static inline uint32_t imu_log_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+/******************************************************************************/
+static inline int32_t imu_log_unzigzag(uint32_t u)
+{
+    return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+/******************************************************************************/
+// Writes v as a varint, 7 bits per byte with the top bit set on all but the last
+static uint8_t *imu_log_put(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+/******************************************************************************/
+// Reads a varint, NULL if it runs past end or is longer than 5 bytes
+static const uint8_t *imu_log_get(const uint8_t *p, const uint8_t *end, uint32_t *v)
+{
+    uint32_t value = 0;
+    for (unsigned int shift = 0; shift < 35; shift += 7) {
+        if (p >= end) {
+            return NULL;
+        }
+        uint8_t b = *p++;
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = value;
+            return p;
+        }
+    }
+    return NULL;
+}
+/******************************************************************************/
+// Encodes a frame against s and moves s on to it. The time is stored as the
+// change of the time step, which is 0 at a steady sample rate, the axes as
+// the change from the previous frame.
+static uint32_t imu_log_encode(uint8_t *out, imu_log_state_t *s, const imu_log_frame_t *f)
+{
+    uint8_t *p = out;
+    uint32_t dt = f->t - s->t;
+
+    p = imu_log_put(p, imu_log_zigzag((int32_t)(dt - s->dt)));
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        p = imu_log_put(p, imu_log_zigzag((int32_t)f->axis[c] - s->axis[c]));
+        s->axis[c] = f->axis[c];
+    }
+    s->t = f->t;
+    s->dt = dt;
+    return (uint32_t)(p - out);
+}
+/******************************************************************************/
+// Starting state of a page: the first record is encoded against its own time
+// and zero axes, so every page decodes on its own
+static void imu_log_page_state(imu_log_state_t *s, uint32_t t_first)
+{
+    memset(s, 0, sizeof(*s));
+    s->t = t_first;
+}
+/******************************************************************************/
+// Programs index entry n
+static int imu_log_write_entry(uint32_t n, const imu_log_index_t *entry)
+{
+    return Flash_WriteBuffer(FLASH_LOG_BASE + n * sizeof(imu_log_index_t),
+                             (const uint8_t *)entry, sizeof(*entry));
+}
+/******************************************************************************/
+// Marks the unindexed pages before page n spoilt, so readers step over them
+// instead of stopping. The times keep the index sorted for imu_log_seek().
+static void imu_log_mark_spoilt(uint32_t n, uint32_t t_first, uint32_t t_last)
+{
+    imu_log_index_t spoilt;
+
+    memset(&spoilt, 0xFF, sizeof(spoilt));      // CRC left erased
+    spoilt.t_first = t_first;
+    spoilt.t_last = t_last;
+    spoilt.count = IMU_LOG_SPOILT;
+    spoilt.bytes = 0;
+    while (imu_log_indexed < n && imu_log_write_entry(imu_log_indexed, &spoilt) == E_NO_ERROR) {
+        imu_log_indexed++;
+        imu_log_stats.flash_bytes += sizeof(spoilt);
+    }
+}
+/******************************************************************************/
+// Programs the filled page and then its index entry, so an entry only ever
+// describes complete data. A page that fails is marked spoilt, right away or,
+// if the flash refuses that too, before the next page is indexed.
+static int imu_log_write_page(void)
+{
+    uint32_t start = cycles_now();
+    uint32_t len = (imu_log_entry.bytes + 15) & ~15UL;   // Whole 128-bit lines
+    int err = E_BAD_STATE;
+
+    memset(&imu_log_buf[imu_log_entry.bytes], 0xFF, len - imu_log_entry.bytes);
+    imu_log_entry.crc = crc32(0, imu_log_buf, imu_log_entry.bytes);
+    imu_log_mark_spoilt(imu_log_next, imu_log_entry.t_first, imu_log_entry.t_first);
+    if (imu_log_indexed == imu_log_next) {      // Else this page becomes a hole as well
+        err = Flash_WriteBuffer(IMU_LOG_DATA_BASE + imu_log_next * IMU_LOG_PAGE_SIZE,
+                                imu_log_buf, len);
+        if (err == E_NO_ERROR) {
+            err = imu_log_write_entry(imu_log_next, &imu_log_entry);
+        }
+    }
+    if (err == E_NO_ERROR) {
+        imu_log_indexed++;
+        imu_log_stats.pages++;
+        imu_log_stats.flash_bytes += len + sizeof(imu_log_index_t);
+    } else {
+        imu_log_stats.dropped += imu_log_entry.count;   // The page is spoilt, move past it
+        imu_log_mark_spoilt(imu_log_next + 1, imu_log_entry.t_first, imu_log_entry.t_last);
+    }
+    imu_log_stats.write_cycles += cycles_now() - start;
+    imu_log_next++;
+    memset(&imu_log_entry, 0, sizeof(imu_log_entry));
+    return err;
+}
+/******************************************************************************/
+int imu_log_start(void)
+{
+    for (uint32_t addr = FLASH_LOG_BASE; addr < FLASH_LOG_BASE + FLASH_LOG_SIZE;
+         addr += MXC_FLASH_PAGE_SIZE) {
+        int err = Flash_PageErase(addr);
+        if (err != E_NO_ERROR) {
+            return err;
+        }
+    }
+    memset(&imu_log_entry, 0, sizeof(imu_log_entry));
+    memset(&imu_log_stats, 0, sizeof(imu_log_stats));
+    imu_log_next = 0;
+    imu_log_indexed = 0;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int imu_log_append(const imu_log_frame_t *frame)
+{
+    uint8_t rec[IMU_LOG_RECORD_MAX];
+    imu_log_state_t s = imu_log_state;
+    uint32_t len = 0;
+
+    if (imu_log_entry.count > 0) {
+        len = imu_log_encode(rec, &s, frame);
+        if (imu_log_entry.bytes + len > IMU_LOG_PAGE_SIZE ||
+            imu_log_entry.count == IMU_LOG_UNUSED - 1) {
+            int err = imu_log_write_page();
+            if (err != E_NO_ERROR) {
+                imu_log_stats.dropped++;
+                return err;
+            }
+        }
+    }
+    if (imu_log_entry.count == 0) {
+        if (imu_log_next >= IMU_LOG_PAGES) {
+            imu_log_stats.dropped++;
+            return E_OVERFLOW;
+        }
+        imu_log_page_state(&s, frame->t);
+        imu_log_entry.t_first = frame->t;
+        len = imu_log_encode(rec, &s, frame);
+    }
+    memcpy(&imu_log_buf[imu_log_entry.bytes], rec, len);
+    imu_log_entry.bytes += len;
+    imu_log_entry.count++;
+    imu_log_entry.t_last = frame->t;
+    imu_log_state = s;
+    imu_log_stats.records++;
+    imu_log_stats.raw_bytes += IMU_LOG_FRAME_BYTES;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int imu_log_flush(void)
+{
+    return (imu_log_entry.count > 0) ? imu_log_write_page() : E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t imu_log_pages(void)
+{
+    uint32_t n = 0;
+    Flash_ReadLock();
+    while (n < IMU_LOG_PAGES && IMU_LOG_INDEX[n].count != IMU_LOG_UNUSED) {
+        n++;
+    }
+    Flash_ReadUnlock();
+    return n;
+}
+/******************************************************************************/
+// Moves the reader to the start of the first good log page from n on after
+// checking its CRC
+static int imu_log_load(imu_log_reader_t *r, uint32_t n)
+{
+    Flash_ReadLock();
+    while (n < IMU_LOG_PAGES && IMU_LOG_INDEX[n].count == IMU_LOG_SPOILT) {
+        n++;
+    }
+    if (n >= IMU_LOG_PAGES) {
+        Flash_ReadUnlock();
+        return E_NONE_AVAIL;
+    }
+    imu_log_index_t entry = IMU_LOG_INDEX[n];
+    const uint8_t *data = (const uint8_t *)(IMU_LOG_DATA_BASE + n * IMU_LOG_PAGE_SIZE);
+    int err = E_NO_ERROR;
+    if (entry.count == IMU_LOG_UNUSED) {
+        err = E_NONE_AVAIL;
+    } else if (entry.bytes > IMU_LOG_PAGE_SIZE || crc32(0, data, entry.bytes) != entry.crc) {
+        err = E_BAD_STATE;
+    }
+    Flash_ReadUnlock();
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    memset(r, 0, sizeof(*r));
+    r->entry = entry;
+    r->page = n;
+    r->prev.t = entry.t_first;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int imu_log_read(imu_log_reader_t *r, imu_log_frame_t *frame)
+{
+    if (r->pending) {
+        r->pending = 0;
+        *frame = r->prev;
+        return 1;
+    }
+    if (r->record >= r->entry.count) {
+        int err = imu_log_load(r, r->page + 1);
+        if (err != E_NO_ERROR) {
+            return (err == E_NONE_AVAIL) ? 0 : err;
+        }
+    }
+
+    const uint8_t *page = (const uint8_t *)(IMU_LOG_DATA_BASE + r->page * IMU_LOG_PAGE_SIZE);
+    const uint8_t *end = page + r->entry.bytes;
+    const uint8_t *p = page + r->offset;
+    uint32_t v[1 + IMU_CHANNELS];
+
+    Flash_ReadLock();
+    for (int i = 0; i < 1 + IMU_CHANNELS && p != NULL; i++) {
+        p = imu_log_get(p, end, &v[i]);
+    }
+    Flash_ReadUnlock();
+    if (p == NULL) {
+        return E_BAD_STATE;
+    }
+    r->dt += (uint32_t)imu_log_unzigzag(v[0]);
+    r->prev.t += r->dt;
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        r->prev.axis[c] = (int16_t)(r->prev.axis[c] + imu_log_unzigzag(v[1 + c]));
+    }
+    r->offset = (uint32_t)(p - page);
+    r->record++;
+    *frame = r->prev;
+    return 1;
+}
+/******************************************************************************/
+int imu_log_seek(imu_log_reader_t *r, uint32_t t)
+{
+    uint32_t n = imu_log_pages();
+    uint32_t lo = 0;
+    uint32_t hi = n;
+
+    // First page that starts after t; the frame is in the page before it,
+    // or at the start of it when t falls in the gap between two pages
+    Flash_ReadLock();
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (IMU_LOG_INDEX[mid].t_first <= t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    uint32_t page = (lo > 0) ? lo - 1 : 0;
+    if (page < n && IMU_LOG_INDEX[page].t_last < t) {
+        page++;
+    }
+    Flash_ReadUnlock();
+    int err = imu_log_load(r, page);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+
+    imu_log_frame_t frame;
+    do {
+        int got = imu_log_read(r, &frame);
+        if (got <= 0) {
+            return (got == 0) ? E_NONE_AVAIL : got;
+        }
+    } while (frame.t < t);
+    r->pending = 1;     // Returned by the next imu_log_read()
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void imu_log_get_stats(imu_log_stats_t *stats, int reset)
+{
+    *stats = imu_log_stats;
+    if (reset) {
+        memset(&imu_log_stats, 0, sizeof(imu_log_stats));
+    }
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "imu_window.h"
+#include "i2c1.h"
+#include "cycles.h"
+
+/***** Definitions *****/
+#if IMU_WINDOW_STRIDE < 1 || IMU_WINDOW_STRIDE > IMU_WINDOW_LEN
+#error "IMU_WINDOW_STRIDE must be between 1 and IMU_WINDOW_LEN"
+#endif
+
+#define IMU_OVERLAP (IMU_WINDOW_LEN - IMU_WINDOW_STRIDE)    // Samples shared by consecutive windows
+#define IMU_NONE (-1)                                       // No window waiting for inference
+
+/***** Globals *****/
+static imu_window_t imu_buf[2];             // Filled and inferred in turn
+static uint32_t imu_fill;                   // Buffer acquisition writes to
+static uint32_t imu_pos;                    // Samples in the fill buffer
+static uint32_t imu_seq;                    // Number of the window being filled
+static volatile int imu_ready = IMU_NONE;   // Buffer waiting for or in inference
+static uint32_t imu_ready_seq;              // Number of that window
+static uint32_t imu_ready_cycles;           // Cycle count when it was completed
+static imu_infer_fn_t imu_infer;
+static void *imu_ctx;
+static imu_window_stats_t imu_stats;
+
+/***** Functions *****/
+void imu_window_init(imu_infer_fn_t fn, void *ctx)
+{
+    imu_infer = fn;
+    imu_ctx = ctx;
+    imu_fill = 0;
+    imu_pos = 0;
+    imu_seq = 0;
+    imu_ready = IMU_NONE;
+    memset(&imu_stats, 0, sizeof(imu_stats));
+    cycles_init();
+}
+/******************************************************************************/
+// Copies the newest IMU_OVERLAP samples of every channel to the start of dst
+static void imu_window_slide(imu_window_t *dst, const imu_window_t *src)
+{
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        memmove(dst->data[c], &src->data[c][IMU_WINDOW_STRIDE], IMU_OVERLAP);
+    }
+}
+/******************************************************************************/
+void imu_window_push(const int16_t sample[IMU_CHANNELS])
+{
+    imu_window_t *win = &imu_buf[imu_fill];
+
+    // Quantise straight into the accelerator layout, no staging copy
+    for (int c = 0; c < 3; c++) {
+        win->data[c][imu_pos] = imu_quantize(sample[c], IMU_GYR_SHIFT);
+        win->data[c + 3][imu_pos] = imu_quantize(sample[c + 3], IMU_ACC_SHIFT);
+    }
+    imu_stats.samples++;
+    if (++imu_pos < IMU_WINDOW_LEN) {
+        return;
+    }
+
+    imu_pos = IMU_OVERLAP;
+    if (imu_ready != IMU_NONE) {
+        // Inference is still busy with the other buffer: drop this window
+        imu_window_slide(win, win);
+        imu_stats.dropped++;
+        imu_seq++;
+        return;
+    }
+    uint32_t next = imu_fill ^ 1;
+    imu_window_slide(&imu_buf[next], win);
+    imu_ready_seq = imu_seq++;
+    imu_ready_cycles = cycles_now();
+    imu_stats.windows++;
+    imu_ready = (int)imu_fill;      // Publish last, the buffer is complete
+    imu_fill = next;
+}
+/******************************************************************************/
+int imu_window_acquire(void)
+{
+    int16_t sample[BMI160_SAMPLE_AXES];
+    int result = bmi160_read_sample(sample);
+    if (result != E_NO_ERROR) {
+        imu_stats.errors++;
+        return result;
+    }
+    imu_window_push(sample);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int imu_window_poll(void)
+{
+    int ready = imu_ready;
+    if (ready == IMU_NONE) {
+        return 0;
+    }
+    if (imu_infer != NULL) {
+        imu_infer(&imu_buf[ready], imu_ready_seq, imu_ctx);
+    }
+    uint32_t latency = cycles_now() - imu_ready_cycles;
+    if (latency > imu_stats.latency_max) {
+        imu_stats.latency_max = latency;
+    }
+    imu_stats.latency_total += latency;
+    imu_ready = IMU_NONE;           // Hand the buffer back to acquisition
+    return 1;
+}
+/******************************************************************************/
+void imu_window_get_stats(imu_window_stats_t *stats, int reset)
+{
+    *stats = imu_stats;
+    if (reset) {
+        memset(&imu_stats, 0, sizeof(imu_stats));
+    }
+}
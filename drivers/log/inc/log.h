@@ -0,0 +1,155 @@
+/**
+ * @file       log.h
+ * @brief      Deferred binary logging.
+ * @details    Log sites store a format string ID and their raw arguments in a
+ *             RAM ring buffer instead of formatting text. log_drain() streams
+ *             the binary records out from a low priority context, and the host
+ *             decoder (tools/log_decode.py) turns them back into text using
+ *             the format strings kept in the ELF file.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __LOG_H__
+#define __LOG_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+
+/***** Definitions *****/
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG     // Sites above this level compile to nothing
+#endif
+
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 1024          // Ring buffer size in bytes, power of two
+#endif
+
+#ifndef LOG_DRAIN_MS
+#define LOG_DRAIN_MS 100              // Period of the drain timer main() starts
+#endif
+
+#define LOG_MAX_ARGS 8                // Maximum number of arguments per site
+#define LOG_SYNC 0xA5                 // First byte of every record
+#define LOG_HEADER_SIZE 12            // Bytes before the arguments
+#define LOG_ID_DROPPED 0              // Format ID of the "records dropped" record
+
+/*
+ * Record layout, little endian:
+ *   uint8_t  sync          LOG_SYNC
+ *   uint8_t  level_nargs   level in bits 7:4, argument count in bits 3:0
+ *   uint16_t seq           sequence number, increments per record
+ *   uint32_t fmt_id        format string ID, offset + 1 into the log_fmt section
+ *   uint32_t timestamp     DWT cycle count when the record was written
+ *   uint32_t args[nargs]   raw arguments
+ */
+
+/* Format strings live in their own section. The target link step marks it
+ * as not allocated (drivers/log/log.ld), so the strings stay in the ELF file
+ * for the decoder but take no space in the flash image. */
+#define LOG_FMT_SECTION __attribute__((section("log_fmt")))
+
+#define LOG_NARGS(...) LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#ifdef __riscv
+// The RISC-V image (MAILBOX_RISCV) links no log ring: its sites compile out
+#define LOG_RECORD(level, fmt, ...) ((void)0)
+#else
+/**
+ * @brief      Writes one log record. Arguments must be integers; every argument
+ *             is stored as a uint32_t and strings (%s) are not supported.
+ */
+#define LOG_RECORD(level, fmt, ...)                                                   \
+    do {                                                                              \
+        if ((level) <= LOG_LEVEL) {                                                   \
+            static const char log_fmt_str[] LOG_FMT_SECTION = fmt;                    \
+            const uint32_t log_args[LOG_NARGS(__VA_ARGS__) + 1] = { 0, ##__VA_ARGS__ }; \
+            log_write((level), log_fmt_str, LOG_NARGS(__VA_ARGS__), &log_args[1]);    \
+        }                                                                             \
+    } while (0)
+#endif
+
+#define LOG_ERROR(fmt, ...) LOG_RECORD(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...) LOG_RECORD(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...) LOG_RECORD(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_RECORD(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief      Receives drained log bytes, e.g. to send them over a UART.
+ * @param      data   Bytes to send.
+ * @param      len    Number of bytes.
+ */
+typedef void (*log_sink_t)(const uint8_t *data, size_t len);
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes the ring buffer and selects where drained bytes go.
+ * @param      sink   Output function, NULL selects the console UART.
+ */
+void log_init(log_sink_t sink);
+/**
+ * @brief      Changes where drained bytes go without touching buffered records.
+ * @param      sink   New output function, NULL selects the console UART.
+ * @return     The previous output function.
+ */
+log_sink_t log_set_sink(log_sink_t sink);
+/**
+ * @brief      Stores one record in the ring buffer. Called by the LOG_* macros.
+ *
+ * Safe to call from interrupts. If the record does not fit it is dropped and
+ * counted; the next record that fits is preceded by a "records dropped" record.
+ *
+ * @param      level  Log level.
+ * @param      fmt    Format string in the log_fmt section.
+ * @param      nargs  Number of arguments.
+ * @param      args   Arguments.
+ */
+void log_write(uint8_t level, const char *fmt, uint32_t nargs, const uint32_t *args);
+/**
+ * @brief      Streams buffered records to the sink. Call from the idle loop or
+ *             a low priority task; main() runs it from a scheduler timer every
+ *             LOG_DRAIN_MS. While the test cases run, the runner drains only
+ *             between cases, so the records of one case must fit in
+ *             LOG_BUFFER_SIZE; the rest are dropped and counted.
+ * @return     Number of bytes sent.
+ */
+size_t log_drain(void);
+/**
+ * @brief      Returns the number of records dropped because the buffer was full.
+ */
+uint32_t log_dropped(void);
+/**
+ * @brief      Returns the format string of an ID. Only meaningful in builds that
+ *             keep the log_fmt section loaded, such as the host simulator.
+ * @param      fmt_id   Format string ID from a record.
+ */
+const char *log_fmt_string(uint32_t fmt_id);
+
+#endif
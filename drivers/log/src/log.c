@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "log.h"
+#include "cycles.h"
+#include "board.h"
+#include "mxc_device.h"
+#include "uart.h"
+
+/***** Definitions *****/
+#if (LOG_BUFFER_SIZE & (LOG_BUFFER_SIZE - 1)) != 0
+#error "LOG_BUFFER_SIZE must be a power of two"
+#endif
+
+#define LOG_MASK (LOG_BUFFER_SIZE - 1)
+
+/***** Globals *****/
+extern const char __start_log_fmt[];   // Start of the format strings, see log.ld
+
+static uint8_t log_buffer[LOG_BUFFER_SIZE];
+static volatile uint32_t log_head = 0;      // Write index, only moved by log_write()
+static volatile uint32_t log_tail = 0;      // Read index, only moved by log_drain()
+static uint32_t log_dropped_count = 0;      // Records lost since the last drop record
+static uint32_t log_dropped_total = 0;      // Records lost since log_init()
+static uint16_t log_seq = 0;
+static log_sink_t log_sink = NULL;
+
+/***** Functions *****/
+// Default sink: raw bytes on the console UART
+static void log_uart_sink(const uint8_t *data, size_t len)
+{
+    int n = (int)len;
+    MXC_UART_Write(MXC_UART_GET_UART(CONSOLE_UART), (uint8_t *)data, &n);
+}
+/**********************************************************************************/
+void log_init(log_sink_t sink)
+{
+    cycles_init();      // Timestamps come from the cycle counter
+    log_head = 0;
+    log_tail = 0;
+    log_dropped_count = 0;
+    log_dropped_total = 0;
+    log_seq = 0;
+    log_sink = (sink != NULL) ? sink : log_uart_sink;
+}
+/**********************************************************************************/
+log_sink_t log_set_sink(log_sink_t sink)
+{
+    log_sink_t old = log_sink;
+    log_sink = (sink != NULL) ? sink : log_uart_sink;
+    return old;
+}
+/**********************************************************************************/
+// Copies len bytes into the ring at index pos, wrapping at the end
+static void log_copy_in(uint32_t pos, const void *src, uint32_t len)
+{
+    uint32_t off = pos & LOG_MASK;
+    uint32_t first = LOG_BUFFER_SIZE - off;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&log_buffer[off], src, first);
+    memcpy(&log_buffer[0], (const uint8_t *)src + first, len - first);
+}
+/**********************************************************************************/
+// Appends one record, caller holds interrupts off. Returns 0 if it did not fit.
+static int log_put(uint8_t level, uint32_t fmt_id, uint32_t nargs, const uint32_t *args)
+{
+    uint32_t len = LOG_HEADER_SIZE + nargs * sizeof(uint32_t);
+    uint32_t head = log_head;
+    if (LOG_BUFFER_SIZE - (head - log_tail) < len) {
+        return 0;
+    }
+
+    uint8_t header[LOG_HEADER_SIZE];
+    uint32_t ts = cycles_now();
+    header[0] = LOG_SYNC;
+    header[1] = (uint8_t)((level << 4) | nargs);
+    header[2] = (uint8_t)log_seq;
+    header[3] = (uint8_t)(log_seq >> 8);
+    memcpy(&header[4], &fmt_id, sizeof(fmt_id));
+    memcpy(&header[8], &ts, sizeof(ts));
+
+    log_copy_in(head, header, LOG_HEADER_SIZE);
+    log_copy_in(head + LOG_HEADER_SIZE, args, nargs * sizeof(uint32_t));
+    log_seq++;
+    log_head = head + len;
+    return 1;
+}
+/**********************************************************************************/
+void log_write(uint8_t level, const char *fmt, uint32_t nargs, const uint32_t *args)
+{
+    uint32_t fmt_id = (uint32_t)(fmt - __start_log_fmt) + 1;
+    if (nargs > LOG_MAX_ARGS) {
+        nargs = LOG_MAX_ARGS;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    // Report earlier losses first so the decoder knows where the gap is
+    if (log_dropped_count != 0 &&
+        log_put(LOG_LEVEL_WARN, LOG_ID_DROPPED, 1, &log_dropped_count)) {
+        log_dropped_count = 0;
+    }
+    if (log_dropped_count != 0 || !log_put(level, fmt_id, nargs, args)) {
+        log_dropped_count++;
+        log_dropped_total++;
+    }
+    __set_PRIMASK(primask);
+}
+/**********************************************************************************/
+size_t log_drain(void)
+{
+    size_t sent = 0;
+    if (log_sink == NULL) {
+        return 0;
+    }
+    // Only this function moves the tail, so the bytes up to the head can be
+    // handed to the sink without holding interrupts off
+    uint32_t head = log_head;
+    while (log_tail != head) {
+        uint32_t off = log_tail & LOG_MASK;
+        uint32_t len = head - log_tail;
+        if (len > LOG_BUFFER_SIZE - off) {
+            len = LOG_BUFFER_SIZE - off;   // Up to the end of the buffer first
+        }
+        log_sink(&log_buffer[off], len);
+        log_tail += len;
+        sent += len;
+    }
+    return sent;
+}
+/**********************************************************************************/
+uint32_t log_dropped(void)
+{
+    return log_dropped_total;
+}
+/**********************************************************************************/
+const char *log_fmt_string(uint32_t fmt_id)
+{
+    if (fmt_id == LOG_ID_DROPPED) {
+        return "<%u log records dropped>";
+    }
+    return __start_log_fmt + fmt_id - 1;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file       mailbox.h
+ * @brief      Shared SRAM mailbox between the RISC-V and Arm cores.
+ * @details    A lock-free single-producer, single-consumer ring of fixed
+ *             32-byte frames. The producer (the RISC-V core running the
+ *             sensor acquisition loop) only writes head and the frames, the
+ *             consumer (the Arm core) only writes tail, and each index sits
+ *             on its own line so neither core's stores land on the other's.
+ *             The producer rings a doorbell interrupt only when the consumer
+ *             may have found the ring empty and gone to sleep, so a busy
+ *             consumer is not interrupted for every frame.
+ *
+ *             On the target the Arm core starts the RISC-V core with
+ *             mailbox_start_riscv(), which passes the ring's address in a
+ *             SEMA mail register; the doorbell is the SEMA CM4 interrupt.
+ *             In the simulator the two sides are host threads and the
+ *             doorbell is whatever mailbox_set_doorbell() installs.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __MAILBOX_H__
+#define __MAILBOX_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_errors.h"
+
+/***** Definitions *****/
+#ifndef MAILBOX_RISCV
+#define MAILBOX_RISCV 0                 // 1 runs the acquisition loop on the RISC-V core
+#endif
+
+#ifndef MAILBOX_SLOTS
+#define MAILBOX_SLOTS 32                // Frames in the ring, a power of two
+#endif
+
+#ifndef MAILBOX_ACQ_PERIOD_US
+#define MAILBOX_ACQ_PERIOD_US 10000     // Sample period of mailbox_acq_run()
+#endif
+
+#ifdef HOST_SIM
+#define MAILBOX_LINE 64                 // Host cache line
+#else
+#define MAILBOX_LINE 32                 // Line of the SRAM and cache controllers
+#endif
+
+#define MAILBOX_FRAME_SIZE 32           // Bytes per frame
+#define MAILBOX_PAYLOAD (MAILBOX_FRAME_SIZE - 12)
+#define MAILBOX_MAGIC 0x4D424F58UL      // "MBOX", set by mailbox_init()
+
+/**
+ * @brief      What a frame carries.
+ */
+typedef enum {
+    MAILBOX_FRAME_NONE = 0,
+    MAILBOX_FRAME_IMU,              // mailbox_imu_t: one BMI160 sample
+} mailbox_frame_type_t;
+
+/**
+ * @brief      One frame of the ring.
+ */
+typedef struct {
+    uint32_t seq;                   // Producer's frame number, gaps show drops
+    uint32_t stamp;                 // Producer's cycle count when the data was taken
+    uint16_t type;                  // mailbox_frame_type_t
+    uint16_t len;                   // Bytes of data used
+    uint8_t data[MAILBOX_PAYLOAD];
+} mailbox_frame_t;
+
+/**
+ * @brief      Data of a MAILBOX_FRAME_IMU frame.
+ */
+typedef struct {
+    int16_t sample[6];              // Gyro X/Y/Z then accel X/Y/Z, as bmi160_read_sample()
+    int32_t result;                 // Error of the read, the sample is zero if it failed
+} mailbox_imu_t;
+
+/**
+ * @brief      The ring. Lives in SRAM both cores can reach.
+ */
+typedef struct {
+    // Producer line
+    volatile uint32_t head __attribute__((aligned(MAILBOX_LINE)));  // Frames pushed
+    volatile uint32_t dropped;      // Frames lost to a full ring
+    volatile uint32_t doorbells;    // Doorbells rung
+    // Consumer line
+    volatile uint32_t tail __attribute__((aligned(MAILBOX_LINE)));  // Frames popped
+    volatile uint32_t magic;        // MAILBOX_MAGIC once initialised
+    mailbox_frame_t slot[MAILBOX_SLOTS] __attribute__((aligned(MAILBOX_LINE)));
+} mailbox_t;
+
+/**
+ * @brief      Counters of a ring.
+ */
+typedef struct {
+    uint32_t pushed;                // Frames the producer added
+    uint32_t popped;                // Frames the consumer took
+    uint32_t dropped;               // Frames lost to a full ring
+    uint32_t doorbells;             // Doorbells rung
+} mailbox_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Empties a ring. Called by the consumer before the producer starts.
+ * @param      mb   Ring.
+ */
+void mailbox_init(mailbox_t *mb);
+/**
+ * @brief      Installs the producer's doorbell. Each core has its own.
+ * @param      ring Called after a push the consumer may be sleeping
+ *                  through, NULL for none.
+ */
+void mailbox_set_doorbell(void (*ring)(void));
+/**
+ * @brief      Adds a frame. Producer side only.
+ * @param      mb       Ring.
+ * @param      frame    Frame, copied into the ring.
+ * @return     E_NO_ERROR, or E_BUSY if the ring is full and the frame was dropped.
+ */
+int mailbox_push(mailbox_t *mb, const mailbox_frame_t *frame);
+/**
+ * @brief      Takes the oldest frame. Consumer side only.
+ * @param      mb       Ring.
+ * @param      frame    Receives the frame.
+ * @return     E_NO_ERROR, or E_NONE_AVAIL if the ring is empty.
+ */
+int mailbox_pop(mailbox_t *mb, mailbox_frame_t *frame);
+/**
+ * @brief      Returns the number of frames waiting. Exact only on the consumer side.
+ * @param      mb   Ring.
+ */
+uint32_t mailbox_count(const mailbox_t *mb);
+/**
+ * @brief      Reads the counters of a ring.
+ * @param      mb       Ring.
+ * @param      stats    Receives the counters.
+ */
+void mailbox_get_stats(const mailbox_t *mb, mailbox_stats_t *stats);
+/**
+ * @brief      Reads one BMI160 sample and pushes it as a MAILBOX_FRAME_IMU frame.
+ * @param      mb   Ring.
+ * @param      seq  Frame number.
+ * @return     Result of mailbox_push(); a failed read is still pushed.
+ */
+int mailbox_acq_frame(mailbox_t *mb, uint32_t seq);
+/**
+ * @brief      Acquisition loop of the producer core: one sample every
+ *             MAILBOX_ACQ_PERIOD_US.
+ * @param      mb       Ring.
+ * @param      frames   Frames to acquire, 0 to run forever.
+ */
+void mailbox_acq_run(mailbox_t *mb, uint32_t frames);
+/**
+ * @brief      Feeds the waiting IMU frames to imu_window_push(). Consumer
+ *             side, in place of calling imu_window_acquire() per sample.
+ * @param      mb   Ring.
+ * @return     Number of samples pushed.
+ */
+int mailbox_acq_drain(mailbox_t *mb);
+#ifndef HOST_SIM
+/**
+ * @brief      Arm side: empties the ring, hands its address to the RISC-V
+ *             core, enables the doorbell interrupt and starts the core.
+ * @param      mb       Ring.
+ * @param      doorbell Handler of the doorbell interrupt, must call
+ *                      mailbox_doorbell_ack().
+ */
+void mailbox_start_riscv(mailbox_t *mb, void (*doorbell)(void));
+/**
+ * @brief      Arm side: clears the doorbell interrupt.
+ */
+void mailbox_doorbell_ack(void);
+/**
+ * @brief      RISC-V side: returns the ring the Arm core passed.
+ */
+mailbox_t *mailbox_shared(void);
+/**
+ * @brief      RISC-V side: raises the doorbell interrupt on the Arm core.
+ */
+void mailbox_ring_arm(void);
+#endif
+
+#endif
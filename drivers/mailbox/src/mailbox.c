@@ -0,0 +1,138 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stddef.h>
+#include "mailbox.h"
+#ifndef HOST_SIM
+#include "mxc_device.h"
+#include "mxc_sys.h"
+#include "nvic_table.h"
+#endif
+
+/***** Definitions *****/
+#ifndef MAILBOX_ARM_IRQn
+#define MAILBOX_ARM_IRQn RISCV_IRQn     // SEMA irq0, the RISC-V core's interrupt to the Arm core
+#endif
+
+_Static_assert(sizeof(mailbox_frame_t) == MAILBOX_FRAME_SIZE, "mailbox frame is not 32 bytes");
+_Static_assert(sizeof(mailbox_imu_t) <= MAILBOX_PAYLOAD, "IMU frame does not fit the payload");
+_Static_assert((MAILBOX_SLOTS & (MAILBOX_SLOTS - 1)) == 0, "MAILBOX_SLOTS must be a power of two");
+
+/***** Globals *****/
+static void (*mailbox_doorbell)(void);      // This core's doorbell, not shared
+
+/***** Functions *****/
+void mailbox_init(mailbox_t *mb)
+{
+    mb->head = 0;
+    mb->dropped = 0;
+    mb->doorbells = 0;
+    mb->tail = 0;
+    mb->magic = MAILBOX_MAGIC;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);    // Empty before the other core looks
+}
+/******************************************************************************/
+void mailbox_set_doorbell(void (*ring)(void))
+{
+    mailbox_doorbell = ring;
+}
+/******************************************************************************/
+int mailbox_push(mailbox_t *mb, const mailbox_frame_t *frame)
+{
+    uint32_t head = mb->head;       // Only this side writes it
+    uint32_t tail = __atomic_load_n(&mb->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= MAILBOX_SLOTS) {
+        mb->dropped++;
+        return E_BUSY;
+    }
+    mb->slot[head & (MAILBOX_SLOTS - 1)] = *frame;
+    __atomic_store_n(&mb->head, head + 1, __ATOMIC_RELEASE);  // Publish after the frame
+
+    // Paired with the fence in mailbox_pop(): either the consumer sees the new
+    // head, or this sees that it took every earlier frame and may be asleep
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&mb->tail, __ATOMIC_RELAXED) == head && mailbox_doorbell != NULL) {
+        mb->doorbells++;
+        mailbox_doorbell();
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int mailbox_pop(mailbox_t *mb, mailbox_frame_t *frame)
+{
+    uint32_t tail = mb->tail;       // Only this side writes it
+    uint32_t head = __atomic_load_n(&mb->head, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        // Empty is only final once the last tail store is ordered before the
+        // head load, see mailbox_push(); the fence is off the busy path
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        head = __atomic_load_n(&mb->head, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            return E_NONE_AVAIL;
+        }
+    }
+    *frame = mb->slot[tail & (MAILBOX_SLOTS - 1)];
+    __atomic_store_n(&mb->tail, tail + 1, __ATOMIC_RELEASE);  // Slot free after the copy
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t mailbox_count(const mailbox_t *mb)
+{
+    return __atomic_load_n(&mb->head, __ATOMIC_ACQUIRE) - mb->tail;
+}
+/******************************************************************************/
+void mailbox_get_stats(const mailbox_t *mb, mailbox_stats_t *stats)
+{
+    stats->pushed = mb->head;
+    stats->popped = mb->tail;
+    stats->dropped = mb->dropped;
+    stats->doorbells = mb->doorbells;
+}
+#ifndef HOST_SIM
+#ifndef __riscv
+/******************************************************************************/
+void mailbox_start_riscv(mailbox_t *mb, void (*doorbell)(void))
+{
+    mailbox_init(mb);
+    MXC_SEMA->mail1 = (uint32_t)(uintptr_t)mb;     // Read by mailbox_shared()
+    MXC_SEMA->irq0 = MXC_F_SEMA_IRQ0_EN;
+    MXC_NVIC_SetVector(MAILBOX_ARM_IRQn, doorbell);
+    NVIC_EnableIRQ(MAILBOX_ARM_IRQn);
+    MXC_SYS_RISCVRun();
+}
+/******************************************************************************/
+void mailbox_doorbell_ack(void)
+{
+    MXC_SEMA->irq0 = MXC_F_SEMA_IRQ0_EN;
+}
+#endif
+/******************************************************************************/
+mailbox_t *mailbox_shared(void)
+{
+    return (mailbox_t *)(uintptr_t)MXC_SEMA->mail1;
+}
+/******************************************************************************/
+void mailbox_ring_arm(void)
+{
+    MXC_SEMA->irq0 = MXC_F_SEMA_IRQ0_EN | MXC_F_SEMA_IRQ0_CM4_IRQ;
+}
+#endif
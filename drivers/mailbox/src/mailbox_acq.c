@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "mailbox.h"
+#include "i2c1.h"
+#include "imu_window.h"
+#ifndef __riscv
+#include "cycles.h"
+#endif
+
+_Static_assert(BMI160_SAMPLE_AXES == 6 && IMU_CHANNELS == 6, "mailbox_imu_t holds six axes");
+
+/***** Functions *****/
+int mailbox_acq_frame(mailbox_t *mb, uint32_t seq)
+{
+    mailbox_frame_t frame;
+    mailbox_imu_t imu;
+
+    memset(&imu, 0, sizeof(imu));
+    imu.result = bmi160_read_sample(imu.sample);
+    frame.seq = seq;
+#ifdef __riscv
+    frame.stamp = 0;            // No DWT on the RISC-V core
+#else
+    frame.stamp = cycles_now();
+#endif
+    frame.type = MAILBOX_FRAME_IMU;
+    frame.len = sizeof(imu);
+    memcpy(frame.data, &imu, sizeof(imu));
+    return mailbox_push(mb, &frame);
+}
+/******************************************************************************/
+void mailbox_acq_run(mailbox_t *mb, uint32_t frames)
+{
+    for (uint32_t seq = 0; frames == 0 || seq < frames; seq++) {
+        mailbox_acq_frame(mb, seq);
+        MXC_Delay(MXC_DELAY_USEC(MAILBOX_ACQ_PERIOD_US));
+    }
+}
+#ifndef __riscv
+/******************************************************************************/
+int mailbox_acq_drain(mailbox_t *mb)
+{
+    mailbox_frame_t frame;
+    mailbox_imu_t imu;
+    int pushed = 0;
+
+    while (mailbox_pop(mb, &frame) == E_NO_ERROR) {
+        if (frame.type != MAILBOX_FRAME_IMU) {
+            continue;
+        }
+        memcpy(&imu, frame.data, sizeof(imu));
+        if (imu.result != E_NO_ERROR) {
+            continue;           // A failed read carries no sample
+        }
+        imu_window_push(imu.sample);
+        pushed++;
+    }
+    return pushed;
+}
+#endif
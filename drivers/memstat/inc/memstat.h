@@ -0,0 +1,146 @@
+/**
+ * @file       memstat.h
+ * @brief      Stack and allocation high-water marks.
+ * @details    memstat_stack_paint() fills the unused part of the main stack
+ *             with a pattern early in main(); memstat_stack() later finds the
+ *             deepest word that was overwritten. Every pool_alloc() call site,
+ *             and with MEMSTAT_HEAP every malloc() caller, is counted with its
+ *             allocations, failures, live blocks and their high-water mark.
+ *             memstat_report() prints both, to size the stack, the pools and
+ *             the heap from measured data. Build with MEMSTAT_ENABLE=0 to
+ *             remove the accounting.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __MEMSTAT_H__
+#define __MEMSTAT_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+
+/***** Definitions *****/
+#ifndef MEMSTAT_ENABLE
+#define MEMSTAT_ENABLE 1                // 0 compiles the accounting out
+#endif
+
+#ifndef MEMSTAT_HEAP
+#define MEMSTAT_HEAP 0                  // 1 when linked with --wrap=malloc,--wrap=free
+#endif
+
+#ifndef MEMSTAT_SITES
+#define MEMSTAT_SITES 32                // Call sites counted, later ones are lumped together
+#endif
+
+#ifndef MEMSTAT_LIVE
+#define MEMSTAT_LIVE 64                 // Live allocations whose site is remembered
+#endif
+
+#define MEMSTAT_PAINT 0xA5A5A5A5UL      // Pattern of the unused stack
+#define MEMSTAT_STACK_MARGIN 256        // Bytes below the caller left unpainted
+#ifdef HOST_SIM
+#define MEMSTAT_HOST_STACK 65536        // Bytes painted below the caller on the host
+#endif
+
+/**
+ * @brief      Allocator of a call site.
+ */
+typedef enum {
+    MEMSTAT_POOL = 0,               // pool_alloc(), the site is a file and line
+    MEMSTAT_HEAP_ALLOC              // malloc(), the site is the caller's address
+} memstat_kind_t;
+
+/**
+ * @brief      Allocations made from one call site.
+ */
+typedef struct {
+    const char *file;               // Source file, NULL for a heap site
+    const void *pc;                 // Return address of a heap site
+    uint32_t line;                  // Source line
+    uint32_t kind;                  // memstat_kind_t
+    uint32_t allocs;                // Successful allocations
+    uint32_t failures;              // Allocations that returned NULL
+    uint32_t live;                  // Blocks not freed yet
+    uint32_t high_water;            // Most blocks live at once
+    uint32_t largest;               // Largest request in bytes
+    uint32_t bytes_live;            // Bytes requested by the live blocks
+    uint32_t bytes_high_water;      // Most bytes live at once
+} memstat_site_t;
+
+/**
+ * @brief      Stack usage.
+ */
+typedef struct {
+    uint32_t size;                  // Bytes from the stack limit to the top, 0 if never painted
+    uint32_t used;                  // Deepest the stack has grown, in bytes from the top
+} memstat_stack_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Paints the stack below the caller, leaving MEMSTAT_STACK_MARGIN
+ *             bytes, so memstat_stack() can find the high-water mark. Call
+ *             first thing in main(). On the host the MEMSTAT_HOST_STACK bytes
+ *             below the caller stand in for the stack.
+ */
+void memstat_stack_paint(void);
+/**
+ * @brief      Measures the stack high-water mark since memstat_stack_paint().
+ * @param      stack    Receives the stack size and the bytes used.
+ */
+void memstat_stack(memstat_stack_t *stack);
+/**
+ * @brief      Counts an allocation. Called by the allocators.
+ * @param      kind     memstat_kind_t.
+ * @param      ptr      Block returned, NULL if the allocation failed.
+ * @param      size     Bytes requested.
+ * @param      file     Source file of a pool site.
+ * @param      line     Source line of a pool site.
+ * @param      pc       Caller address of a heap site.
+ */
+void memstat_alloc(memstat_kind_t kind, const void *ptr, size_t size, const char *file,
+                   uint32_t line, const void *pc);
+/**
+ * @brief      Counts a release. Blocks allocated before the accounting saw
+ *             them are ignored.
+ * @param      ptr      Block released.
+ */
+void memstat_free(const void *ptr);
+/**
+ * @brief      Copies the call site counters.
+ * @param      sites    Receives up to max sites.
+ * @param      max      Entries in sites.
+ * @return     Number of sites seen.
+ */
+int memstat_sites(memstat_site_t *sites, int max);
+/**
+ * @brief      Restarts the site counters. Live blocks keep being tracked.
+ */
+void memstat_reset(void);
+/**
+ * @brief      Prints the stack high-water mark, the pool classes and the call
+ *             sites.
+ */
+void memstat_report(void);
+
+#endif
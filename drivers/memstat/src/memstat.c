@@ -0,0 +1,274 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "memstat.h"
+#include "pool.h"
+#include "mxc_device.h"
+
+/***** Definitions *****/
+/**
+ * @brief      A live block and the site it came from.
+ */
+typedef struct {
+    const void *ptr;                // NULL for a free entry
+    uint32_t site;                  // Index in memstat_site
+    uint32_t size;                  // Bytes requested
+} memstat_live_t;
+
+/***** Globals *****/
+#if MEMSTAT_ENABLE
+static memstat_site_t memstat_site[MEMSTAT_SITES];
+static int memstat_nsites;
+static memstat_live_t memstat_live[MEMSTAT_LIVE];
+#endif
+static uint32_t *memstat_limit;     // Lowest painted word, NULL until painted
+static uint32_t *memstat_top;       // End of the stack
+
+#ifndef HOST_SIM
+extern uint32_t __StackTop[];       // From the MaximSDK linker script
+extern uint32_t __StackLimit[];
+#endif
+
+/***** Functions *****/
+void __attribute__((noinline)) memstat_stack_paint(void)
+{
+    uint32_t *sp = (uint32_t *)__builtin_frame_address(0);
+#ifdef HOST_SIM
+    memstat_top = sp;
+    memstat_limit = sp - MEMSTAT_HOST_STACK / sizeof(uint32_t);
+#else
+    memstat_top = __StackTop;
+    memstat_limit = __StackLimit;
+#endif
+    // Word by word, a call to memset would run on the words being painted
+    volatile uint32_t *p = memstat_limit;
+    while (p < sp - MEMSTAT_STACK_MARGIN / sizeof(uint32_t)) {
+        *p++ = MEMSTAT_PAINT;
+    }
+}
+/******************************************************************************/
+void memstat_stack(memstat_stack_t *stack)
+{
+    stack->size = 0;
+    stack->used = 0;
+    if (memstat_limit == NULL) {
+        return;
+    }
+    const volatile uint32_t *p = memstat_limit;
+    while (p < memstat_top && *p == MEMSTAT_PAINT) {
+        p++;
+    }
+    stack->size = (uint32_t)((memstat_top - memstat_limit) * sizeof(uint32_t));
+    stack->used = (uint32_t)((memstat_top - (const uint32_t *)p) * sizeof(uint32_t));
+}
+#if MEMSTAT_ENABLE
+/******************************************************************************/
+// Returns the index of a call site, adding it if it is new. The last entry
+// collects the sites that found the table full.
+static int memstat_find(memstat_kind_t kind, const char *file, uint32_t line, const void *pc)
+{
+    for (int i = 0; i < memstat_nsites; i++) {
+        memstat_site_t *s = &memstat_site[i];
+        if (s->kind == kind && s->file == file && s->line == line && s->pc == pc) {
+            return i;
+        }
+    }
+    if (memstat_nsites >= MEMSTAT_SITES - 1) {
+        if (memstat_nsites == MEMSTAT_SITES - 1) {
+            memstat_site_t *s = &memstat_site[memstat_nsites++];
+            memset(s, 0, sizeof(*s));
+            s->file = "(other sites)";
+        }
+        return MEMSTAT_SITES - 1;
+    }
+    memstat_site_t *s = &memstat_site[memstat_nsites];
+    memset(s, 0, sizeof(*s));
+    s->kind = kind;
+    s->file = file;
+    s->line = line;
+    s->pc = pc;
+    return memstat_nsites++;
+}
+#endif
+/******************************************************************************/
+void memstat_alloc(memstat_kind_t kind, const void *ptr, size_t size, const char *file,
+                   uint32_t line, const void *pc)
+{
+#if MEMSTAT_ENABLE
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    int idx = memstat_find(kind, file, line, pc);
+    memstat_site_t *s = &memstat_site[idx];
+    if (size > s->largest) {
+        s->largest = size;
+    }
+    if (ptr == NULL) {
+        s->failures++;
+    } else {
+        s->allocs++;
+        // A block the live table has no room for is counted but never released
+        for (int i = 0; i < MEMSTAT_LIVE; i++) {
+            if (memstat_live[i].ptr == NULL) {
+                memstat_live[i].ptr = ptr;
+                memstat_live[i].site = idx;
+                memstat_live[i].size = size;
+                s->live++;
+                s->bytes_live += size;
+                break;
+            }
+        }
+        if (s->live > s->high_water) {
+            s->high_water = s->live;
+        }
+        if (s->bytes_live > s->bytes_high_water) {
+            s->bytes_high_water = s->bytes_live;
+        }
+    }
+
+    __set_PRIMASK(primask);
+#else
+    (void)kind;
+    (void)ptr;
+    (void)size;
+    (void)file;
+    (void)line;
+    (void)pc;
+#endif
+}
+/******************************************************************************/
+void memstat_free(const void *ptr)
+{
+#if MEMSTAT_ENABLE
+    if (ptr == NULL) {
+        return;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (int i = 0; i < MEMSTAT_LIVE; i++) {
+        if (memstat_live[i].ptr == ptr) {
+            memstat_site_t *s = &memstat_site[memstat_live[i].site];
+            s->live--;
+            s->bytes_live -= memstat_live[i].size;
+            memstat_live[i].ptr = NULL;
+            break;
+        }
+    }
+
+    __set_PRIMASK(primask);
+#else
+    (void)ptr;
+#endif
+}
+/******************************************************************************/
+int memstat_sites(memstat_site_t *sites, int max)
+{
+#if MEMSTAT_ENABLE
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    int n = memstat_nsites;
+    memcpy(sites, memstat_site, ((n < max) ? n : max) * sizeof(*sites));
+    __set_PRIMASK(primask);
+    return n;
+#else
+    (void)sites;
+    (void)max;
+    return 0;
+#endif
+}
+/******************************************************************************/
+void memstat_reset(void)
+{
+#if MEMSTAT_ENABLE
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (int i = 0; i < memstat_nsites; i++) {
+        memstat_site_t *s = &memstat_site[i];
+        s->allocs = 0;
+        s->failures = 0;
+        s->largest = 0;
+        s->high_water = s->live;
+        s->bytes_high_water = s->bytes_live;
+    }
+    __set_PRIMASK(primask);
+#endif
+}
+/******************************************************************************/
+void memstat_report(void)
+{
+    memstat_stack_t stack;
+    memstat_stack(&stack);
+    if (stack.size != 0) {
+        printf("memstat: stack %u of %u bytes used\n", (unsigned)stack.used, (unsigned)stack.size);
+    }
+    for (int i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_stats_t ps;
+        pool_get_stats(i, &ps, 0);
+        printf("memstat: pool %u B x %u, peak %u, %u failed\n", (unsigned)ps.size,
+               (unsigned)ps.count, (unsigned)ps.high_water, (unsigned)ps.failures);
+    }
+#if MEMSTAT_ENABLE
+    static memstat_site_t sites[MEMSTAT_SITES];
+    int n = memstat_sites(sites, MEMSTAT_SITES);
+    printf("  %-32s %8s %6s %5s %5s %8s %10s\n", "site", "allocs", "failed", "live", "peak",
+           "largest", "peak bytes");
+    for (int i = 0; i < n && i < MEMSTAT_SITES; i++) {
+        const memstat_site_t *s = &sites[i];
+        char where[48];
+        const char *base = (s->file != NULL) ? strrchr(s->file, '/') : NULL;
+        if (s->kind == MEMSTAT_HEAP_ALLOC && s->file == NULL) {
+            snprintf(where, sizeof(where), "malloc from %p", s->pc);
+        } else if (s->line == 0) {
+            snprintf(where, sizeof(where), "%s", s->file);
+        } else {
+            snprintf(where, sizeof(where), "%s:%u", (base != NULL) ? base + 1 : s->file,
+                     (unsigned)s->line);
+        }
+        printf("  %-32s %8u %6u %5u %5u %8u %10u\n", where, (unsigned)s->allocs,
+               (unsigned)s->failures, (unsigned)s->live, (unsigned)s->high_water,
+               (unsigned)s->largest, (unsigned)s->bytes_high_water);
+    }
+#endif
+}
+#if MEMSTAT_HEAP
+/******************************************************************************/
+// Linked with --wrap=malloc,--wrap=free, every malloc() and free() of the
+// application comes here first
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size)
+{
+    void *ptr = __real_malloc(size);
+    memstat_alloc(MEMSTAT_HEAP_ALLOC, ptr, size, NULL, 0, __builtin_return_address(0));
+    return ptr;
+}
+/******************************************************************************/
+void __wrap_free(void *ptr)
+{
+    memstat_free(ptr);
+    __real_free(ptr);
+}
+#endif
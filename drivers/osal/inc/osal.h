@@ -0,0 +1,225 @@
+/**
+ * @file       osal.h
+ * @brief      RTOS primitives for the drivers.
+ * @details    Mutexes, counting semaphores, a reader/writer lock and tasks
+ *             behind one small interface, so the I2C, flash and GPIO drivers
+ *             can be shared by several tasks. With OSAL_RTOS = 1 the calls
+ *             map to FreeRTOS on the target (LIB_FREERTOS = 1) and to a
+ *             pthread model of a single core in the simulator; with
+ *             OSAL_RTOS = 0 they compile to nothing and the drivers keep
+ *             their bare-metal behaviour.
+ *
+ *             Locks only act in task context once the scheduler runs, see
+ *             osal_running(); before that, and in interrupt handlers, the
+ *             drivers run as they do without an RTOS. A zero-initialised
+ *             mutex or rwlock is ready to use; semaphores need osal_sem_init().
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __OSAL_H__
+#define __OSAL_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+#include "mxc_errors.h"
+#if OSAL_RTOS && !defined(HOST_SIM)
+#include "FreeRTOS.h"
+#include "semphr.h"
+#endif
+
+/***** Definitions *****/
+#ifndef OSAL_RTOS
+#define OSAL_RTOS 0                     // 1 to build the drivers for an RTOS
+#endif
+
+#ifndef OSAL_MAX_TASKS
+#define OSAL_MAX_TASKS 8                // Tasks osal_task_create() can start
+#endif
+
+#ifndef OSAL_TASK_STACK
+#define OSAL_TASK_STACK 512             // FreeRTOS stack of a task, in words
+#endif
+
+#ifndef OSAL_TASK_PRIORITY
+#define OSAL_TASK_PRIORITY 1            // FreeRTOS priority of a task
+#endif
+
+#define OSAL_WAIT_FOREVER UINT32_MAX    // osal_sem_take() timeout that never expires
+
+#if OSAL_RTOS && !defined(HOST_SIM)
+typedef struct {
+    SemaphoreHandle_t handle;       // NULL until first used
+    StaticSemaphore_t storage;
+} osal_mutex_t;
+
+typedef struct {
+    SemaphoreHandle_t handle;
+    StaticSemaphore_t storage;
+} osal_sem_t;
+#else
+typedef struct {
+    volatile uint32_t locked;       // 1 while a task holds it
+} osal_mutex_t;
+
+typedef struct {
+    volatile uint32_t count;        // Gives not taken yet
+} osal_sem_t;
+#endif
+
+/**
+ * @brief      Lock shared by any number of readers or one writer. Writers
+ *             wait for the readers inside to leave and keep new ones out.
+ */
+typedef struct {
+    osal_mutex_t gate;              // Held by the writer, briefly by readers
+    osal_sem_t drained;             // Given by the last reader to a waiting writer
+    volatile uint32_t readers;      // Readers inside
+    volatile uint32_t writer_waiting;
+    uint32_t ready;                 // drained is initialised
+} osal_rwlock_t;
+
+typedef void (*osal_task_fn_t)(void *arg);
+
+/**
+ * @brief      Masks interrupts around a short read-modify-write that tasks
+ *             and interrupt handlers share. Nothing without OSAL_RTOS.
+ */
+#if OSAL_RTOS
+#define OSAL_CRITICAL_ENTER()                               \
+    uint32_t osal_primask_ = __get_PRIMASK();               \
+    __disable_irq()
+#define OSAL_CRITICAL_EXIT() __set_PRIMASK(osal_primask_)
+#else
+#define OSAL_CRITICAL_ENTER() do {} while (0)
+#define OSAL_CRITICAL_EXIT() do {} while (0)
+#endif
+
+/***** Function Prototypes *****/
+#if OSAL_RTOS
+/**
+ * @brief      Checks if the caller is a task of a running scheduler.
+ * @return     1 in task context, 0 before the scheduler starts and in
+ *             interrupt handlers.
+ */
+int osal_running(void);
+/**
+ * @brief      Takes a mutex, waiting as long as another task holds it.
+ *             Does nothing unless osal_running().
+ * @param      m    Mutex, zero-initialised before first use.
+ */
+void osal_mutex_lock(osal_mutex_t *m);
+/**
+ * @brief      Releases a mutex taken by osal_mutex_lock().
+ * @param      m    Mutex.
+ */
+void osal_mutex_unlock(osal_mutex_t *m);
+/**
+ * @brief      Initialises a counting semaphore.
+ * @param      s        Semaphore.
+ * @param      initial  Initial count.
+ */
+void osal_sem_init(osal_sem_t *s, uint32_t initial);
+/**
+ * @brief      Takes a semaphore, blocking the task until it is given.
+ * @param      s            Semaphore.
+ * @param      timeout_ms   Longest wait, OSAL_WAIT_FOREVER for no limit.
+ * @return     E_NO_ERROR once taken, E_TIME_OUT if the wait expired.
+ */
+int osal_sem_take(osal_sem_t *s, uint32_t timeout_ms);
+/**
+ * @brief      Gives a semaphore from a task.
+ * @param      s    Semaphore.
+ */
+void osal_sem_give(osal_sem_t *s);
+/**
+ * @brief      Gives a semaphore from an interrupt handler, switching to the
+ *             woken task on return if it outranks the interrupted one.
+ * @param      s    Semaphore.
+ */
+void osal_sem_give_isr(osal_sem_t *s);
+/**
+ * @brief      Enters as a reader: waits while a writer holds the lock.
+ *             Does nothing unless osal_running().
+ * @param      rw   Lock, zero-initialised before first use.
+ */
+void osal_read_lock(osal_rwlock_t *rw);
+/**
+ * @brief      Leaves as a reader.
+ * @param      rw   Lock.
+ */
+void osal_read_unlock(osal_rwlock_t *rw);
+/**
+ * @brief      Enters as the writer: waits for the other writer and for the
+ *             readers inside. Does nothing unless osal_running().
+ * @param      rw   Lock.
+ */
+void osal_write_lock(osal_rwlock_t *rw);
+/**
+ * @brief      Leaves as the writer.
+ * @param      rw   Lock.
+ */
+void osal_write_unlock(osal_rwlock_t *rw);
+/**
+ * @brief      Creates a task that runs fn(arg) once osal_start() is called.
+ *             The task ends when fn returns.
+ * @param      fn   Task function.
+ * @param      arg  Passed to fn.
+ * @param      name Task name for the debugger.
+ * @return     E_NO_ERROR, or E_NONE_AVAIL if OSAL_MAX_TASKS are running.
+ */
+int osal_task_create(osal_task_fn_t fn, void *arg, const char *name);
+/**
+ * @brief      Starts the scheduler. Does not return on the target; in the
+ *             simulator it returns once every task has ended.
+ */
+void osal_start(void);
+/**
+ * @brief      Lets the other ready tasks run.
+ */
+void osal_yield(void);
+/**
+ * @brief      Blocks the task for a time.
+ * @param      ms   Milliseconds to wait.
+ */
+void osal_delay_ms(uint32_t ms);
+#else
+static inline int osal_running(void) { return 0; }
+static inline void osal_mutex_lock(osal_mutex_t *m) { (void)m; }
+static inline void osal_mutex_unlock(osal_mutex_t *m) { (void)m; }
+static inline void osal_sem_init(osal_sem_t *s, uint32_t initial) { s->count = initial; }
+static inline int osal_sem_take(osal_sem_t *s, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    return (s->count > 0 && s->count--) ? E_NO_ERROR : E_TIME_OUT;
+}
+static inline void osal_sem_give(osal_sem_t *s) { s->count++; }
+static inline void osal_sem_give_isr(osal_sem_t *s) { s->count++; }
+static inline void osal_read_lock(osal_rwlock_t *rw) { (void)rw; }
+static inline void osal_read_unlock(osal_rwlock_t *rw) { (void)rw; }
+static inline void osal_write_lock(osal_rwlock_t *rw) { (void)rw; }
+static inline void osal_write_unlock(osal_rwlock_t *rw) { (void)rw; }
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "osal.h"
+
+#if OSAL_RTOS
+
+/***** Functions *****/
+void osal_read_lock(osal_rwlock_t *rw)
+{
+    if (!osal_running()) {
+        return;
+    }
+    // Through the gate, so a writer holding it keeps new readers out
+    osal_mutex_lock(&rw->gate);
+    OSAL_CRITICAL_ENTER();
+    rw->readers++;
+    OSAL_CRITICAL_EXIT();
+    osal_mutex_unlock(&rw->gate);
+}
+/******************************************************************************/
+void osal_read_unlock(osal_rwlock_t *rw)
+{
+    if (!osal_running()) {
+        return;
+    }
+    int last = 0;
+    OSAL_CRITICAL_ENTER();
+    rw->readers--;
+    if (rw->readers == 0 && rw->writer_waiting) {
+        rw->writer_waiting = 0;
+        last = 1;
+    }
+    OSAL_CRITICAL_EXIT();
+    if (last) {
+        osal_sem_give(&rw->drained);
+    }
+}
+/******************************************************************************/
+void osal_write_lock(osal_rwlock_t *rw)
+{
+    if (!osal_running()) {
+        return;
+    }
+    osal_mutex_lock(&rw->gate);
+    if (!rw->ready) {
+        osal_sem_init(&rw->drained, 0);     // Only the gate holder gets here
+        rw->ready = 1;
+    }
+    // Wait for the readers that were inside before the gate closed
+    int wait;
+    OSAL_CRITICAL_ENTER();
+    wait = (rw->readers != 0);
+    rw->writer_waiting = wait;
+    OSAL_CRITICAL_EXIT();
+    if (wait) {
+        osal_sem_take(&rw->drained, OSAL_WAIT_FOREVER);
+    }
+}
+/******************************************************************************/
+void osal_write_unlock(osal_rwlock_t *rw)
+{
+    if (!osal_running()) {
+        return;
+    }
+    osal_mutex_unlock(&rw->gate);
+}
+
+#endif
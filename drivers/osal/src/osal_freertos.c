@@ -0,0 +1,130 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "osal.h"
+
+#if OSAL_RTOS && !defined(HOST_SIM)
+#include "task.h"
+
+/***** Globals *****/
+// Function and argument of each created task, FreeRTOS tasks must not return
+typedef struct {
+    osal_task_fn_t fn;
+    void *arg;
+} osal_task_t;
+
+static osal_task_t osal_tasks[OSAL_MAX_TASKS];
+static uint32_t osal_task_count;
+
+/***** Functions *****/
+int osal_running(void)
+{
+    return __get_IPSR() == 0 && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+/******************************************************************************/
+void osal_mutex_lock(osal_mutex_t *m)
+{
+    if (!osal_running()) {
+        return;
+    }
+    if (m->handle == NULL) {
+        // First use, two tasks may race here
+        taskENTER_CRITICAL();
+        if (m->handle == NULL) {
+            m->handle = xSemaphoreCreateMutexStatic(&m->storage);
+        }
+        taskEXIT_CRITICAL();
+    }
+    xSemaphoreTake(m->handle, portMAX_DELAY);
+}
+/******************************************************************************/
+void osal_mutex_unlock(osal_mutex_t *m)
+{
+    // The lock may have been taken before the scheduler started, in which case
+    // the mutex was never created and there is nothing to give back
+    if (!osal_running() || m->handle == NULL) {
+        return;
+    }
+    xSemaphoreGive(m->handle);
+}
+/******************************************************************************/
+void osal_sem_init(osal_sem_t *s, uint32_t initial)
+{
+    s->handle = xSemaphoreCreateCountingStatic(UINT16_MAX, initial, &s->storage);
+}
+/******************************************************************************/
+int osal_sem_take(osal_sem_t *s, uint32_t timeout_ms)
+{
+    TickType_t ticks = (timeout_ms == OSAL_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return (xSemaphoreTake(s->handle, ticks) == pdTRUE) ? E_NO_ERROR : E_TIME_OUT;
+}
+/******************************************************************************/
+void osal_sem_give(osal_sem_t *s)
+{
+    xSemaphoreGive(s->handle);
+}
+/******************************************************************************/
+void osal_sem_give_isr(osal_sem_t *s)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(s->handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+/******************************************************************************/
+static void osal_task_entry(void *arg)
+{
+    osal_task_t *t = arg;
+    t->fn(t->arg);
+    vTaskDelete(NULL);
+}
+/******************************************************************************/
+int osal_task_create(osal_task_fn_t fn, void *arg, const char *name)
+{
+    if (osal_task_count >= OSAL_MAX_TASKS) {
+        return E_NONE_AVAIL;
+    }
+    osal_task_t *t = &osal_tasks[osal_task_count];
+    t->fn = fn;
+    t->arg = arg;
+    if (xTaskCreate(osal_task_entry, name, OSAL_TASK_STACK, t, OSAL_TASK_PRIORITY, NULL) != pdPASS) {
+        return E_NONE_AVAIL;
+    }
+    osal_task_count++;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void osal_start(void)
+{
+    vTaskStartScheduler();      // Only returns if the idle task could not be created
+}
+/******************************************************************************/
+void osal_yield(void)
+{
+    taskYIELD();
+}
+/******************************************************************************/
+void osal_delay_ms(uint32_t ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file       pool.h
+ * @brief      Fixed block memory pools.
+ * @details    Static pools of equal sized blocks in a few size classes for
+ *             transient driver buffers. Allocation takes the smallest class
+ *             that fits and both allocation and release are O(1), with no
+ *             fragmentation. Sizes and block counts are set in project.mk.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __POOL_H__
+#define __POOL_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+#include "memstat.h"
+
+/***** Definitions *****/
+#ifndef POOL_SMALL_SIZE
+#define POOL_SMALL_SIZE 32          // Block size of the small class, multiple of 8
+#endif
+#ifndef POOL_SMALL_COUNT
+#define POOL_SMALL_COUNT 16
+#endif
+#ifndef POOL_MEDIUM_SIZE
+#define POOL_MEDIUM_SIZE 128
+#endif
+#ifndef POOL_MEDIUM_COUNT
+#define POOL_MEDIUM_COUNT 8
+#endif
+#ifndef POOL_LARGE_SIZE
+#define POOL_LARGE_SIZE 512         // Largest block pool_alloc() can return
+#endif
+#ifndef POOL_LARGE_COUNT
+#define POOL_LARGE_COUNT 4
+#endif
+
+#define POOL_CLASS_COUNT 3
+
+/**
+ * @brief      Usage of one size class.
+ */
+typedef struct {
+    uint32_t size;              // Block size
+    uint32_t count;             // Blocks in the class
+    uint32_t in_use;            // Blocks allocated now
+    uint32_t high_water;        // Most blocks ever allocated at once
+    uint32_t allocs;            // Successful allocations
+    uint32_t failures;          // Requests that found the class empty
+} pool_stats_t;
+
+/**
+ * @brief      Allocates a block from the smallest class that fits and has a
+ *             free block. Safe to call from interrupt handlers.
+ * @param      size     Bytes needed.
+ * @return     Block aligned to 8 bytes, or NULL if size exceeds
+ *             POOL_LARGE_SIZE or every class that fits is exhausted.
+ */
+#if MEMSTAT_ENABLE
+#define pool_alloc(size) pool_alloc_at((size), __FILE__, __LINE__)
+#else
+#define pool_alloc(size) pool_alloc_at((size), NULL, 0)
+#endif
+
+/***** Function Prototypes *****/
+/**
+ * @brief      pool_alloc() with the call site counted by drivers/memstat.
+ * @param      size     Bytes needed.
+ * @param      file     Source file of the caller.
+ * @param      line     Source line of the caller.
+ * @return     See pool_alloc().
+ */
+void *pool_alloc_at(size_t size, const char *file, uint32_t line);
+/**
+ * @brief      Returns a block to its pool.
+ * @param      ptr      Block from pool_alloc(), or NULL.
+ */
+void pool_free(void *ptr);
+/**
+ * @brief      Copies the usage of one size class.
+ * @param      cls      Class index, 0 (small) to POOL_CLASS_COUNT - 1 (large).
+ * @param      stats    Receives the usage.
+ * @param      reset    Non-zero to restart the high-water mark and counters
+ *                      from the current usage.
+ */
+void pool_get_stats(int cls, pool_stats_t *stats, int reset);
+
+#endif
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "pool.h"
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#if (POOL_SMALL_SIZE % 8) != 0 || (POOL_MEDIUM_SIZE % 8) != 0 || (POOL_LARGE_SIZE % 8) != 0
+#error "Pool block sizes must be multiples of 8"
+#endif
+
+#if POOL_SMALL_SIZE >= POOL_MEDIUM_SIZE || POOL_MEDIUM_SIZE >= POOL_LARGE_SIZE
+#error "Pool block sizes must increase from small to large"
+#endif
+
+#ifdef __riscv
+// The RISC-V image (MAILBOX_RISCV) has no PRIMASK: mask with mstatus.MIE
+#define POOL_MIE 0x8
+static inline uint32_t pool_irq_save(void)
+{
+    uint32_t mstatus;
+    __asm volatile("csrrci %0, mstatus, %1" : "=r"(mstatus) : "i"(POOL_MIE) : "memory");
+    return mstatus & POOL_MIE;
+}
+static inline void pool_irq_restore(uint32_t mie)
+{
+    __asm volatile("csrs mstatus, %0" : : "r"(mie) : "memory");
+}
+#else
+static inline uint32_t pool_irq_save(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+static inline void pool_irq_restore(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+#endif
+
+/**
+ * @brief      One size class. Blocks never handed out are taken in address
+ *             order, released blocks are kept on a free list threaded
+ *             through their first word.
+ */
+typedef struct {
+    uint8_t *base;              // First block
+    uint32_t size;              // Block size
+    uint32_t count;             // Number of blocks
+    uint32_t fresh;             // Blocks taken from the array so far
+    void *free;                 // Released blocks
+    pool_stats_t stats;
+} pool_class_t;
+
+/***** Globals *****/
+static uint64_t pool_small[POOL_SMALL_COUNT * POOL_SMALL_SIZE / 8];
+static uint64_t pool_medium[POOL_MEDIUM_COUNT * POOL_MEDIUM_SIZE / 8];
+static uint64_t pool_large[POOL_LARGE_COUNT * POOL_LARGE_SIZE / 8];
+
+static pool_class_t pool_classes[POOL_CLASS_COUNT] = {
+    { (uint8_t *)pool_small, POOL_SMALL_SIZE, POOL_SMALL_COUNT, 0, NULL,
+      { POOL_SMALL_SIZE, POOL_SMALL_COUNT, 0, 0, 0, 0 } },
+    { (uint8_t *)pool_medium, POOL_MEDIUM_SIZE, POOL_MEDIUM_COUNT, 0, NULL,
+      { POOL_MEDIUM_SIZE, POOL_MEDIUM_COUNT, 0, 0, 0, 0 } },
+    { (uint8_t *)pool_large, POOL_LARGE_SIZE, POOL_LARGE_COUNT, 0, NULL,
+      { POOL_LARGE_SIZE, POOL_LARGE_COUNT, 0, 0, 0, 0 } },
+};
+
+/***** Functions *****/
+void *pool_alloc_at(size_t size, const char *file, uint32_t line)
+{
+    void *block = NULL;
+    uint32_t primask = pool_irq_save();
+
+    // A full class spills into the next larger one
+    for (int i = 0; i < POOL_CLASS_COUNT && block == NULL; i++) {
+        pool_class_t *cls = &pool_classes[i];
+        if (size > cls->size) {
+            continue;
+        }
+        if (cls->free != NULL) {
+            block = cls->free;
+            cls->free = *(void **)block;
+        } else if (cls->fresh < cls->count) {
+            block = cls->base + cls->fresh++ * cls->size;
+        } else {
+            cls->stats.failures++;
+            continue;
+        }
+        cls->stats.allocs++;
+        if (++cls->stats.in_use > cls->stats.high_water) {
+            cls->stats.high_water = cls->stats.in_use;
+        }
+    }
+#if MEMSTAT_ENABLE
+    memstat_alloc(MEMSTAT_POOL, block, size, file, line, NULL);
+#endif
+
+    pool_irq_restore(primask);
+    return block;
+}
+/******************************************************************************/
+void pool_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    uint32_t primask = pool_irq_save();
+
+    for (int i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_class_t *cls = &pool_classes[i];
+        if ((uint8_t *)ptr >= cls->base && (uint8_t *)ptr < cls->base + cls->count * cls->size) {
+            *(void **)ptr = cls->free;
+            cls->free = ptr;
+            cls->stats.in_use--;
+#if MEMSTAT_ENABLE
+            memstat_free(ptr);
+#endif
+            break;
+        }
+    }
+
+    pool_irq_restore(primask);
+}
+/******************************************************************************/
+void pool_get_stats(int cls, pool_stats_t *stats, int reset)
+{
+    if (cls < 0 || cls >= POOL_CLASS_COUNT) {
+        return;
+    }
+    uint32_t primask = pool_irq_save();
+
+    pool_stats_t *s = &pool_classes[cls].stats;
+    *stats = *s;
+    if (reset) {
+        s->high_water = s->in_use;
+        s->allocs = 0;
+        s->failures = 0;
+    }
+
+    pool_irq_restore(primask);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file       qspi_cache.h
+ * @brief      Read cache for the external QSPI flash.
+ * @details    Set associative RAM cache of flash lines in front of
+ *             qspi_read(). A miss that continues a sequential stream also
+ *             fetches the following lines in the same read instruction.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __QSPI_CACHE_H__
+#define __QSPI_CACHE_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "qspi_flash.h"
+
+/***** Definitions *****/
+#ifndef QSPI_CACHE_SETS
+#define QSPI_CACHE_SETS 32              // Number of sets, power of two
+#endif
+
+#ifndef QSPI_CACHE_WAYS
+#define QSPI_CACHE_WAYS 4               // Lines per set
+#endif
+
+#ifndef QSPI_CACHE_LINE_SIZE
+#define QSPI_CACHE_LINE_SIZE 64         // Bytes per line, power of two
+#endif
+
+#ifndef QSPI_CACHE_READAHEAD
+#define QSPI_CACHE_READAHEAD 4          // Lines fetched ahead of a sequential stream, 0 disables
+#endif
+
+#define QSPI_CACHE_SIZE (QSPI_CACHE_SETS * QSPI_CACHE_WAYS * QSPI_CACHE_LINE_SIZE)
+
+/**
+ * @brief      Cache counters, in lines.
+ */
+typedef struct {
+    uint32_t hits;              // Lines found in the cache
+    uint32_t misses;            // Lines fetched on demand
+    uint32_t readahead;         // Lines fetched ahead of a sequential stream
+    uint32_t evictions;         // Valid lines replaced
+} qspi_cache_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Empties the cache and clears the counters. Call after qspi_init().
+ */
+void qspi_cache_init(void);
+/**
+ * @brief      Reads through the cache.
+ * @param      addr     Flash address.
+ * @param      data     Output buffer.
+ * @param      len      Number of bytes.
+ * @return     E_NO_ERROR, E_BAD_PARAM or an SPI error.
+ */
+int qspi_cache_read(uint32_t addr, uint8_t *data, uint32_t len);
+/**
+ * @brief      Programs with qspi_program() and drops the cached lines it touches.
+ * @param      addr     Flash address.
+ * @param      data     Data to program.
+ * @param      len      Number of bytes.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_TIME_OUT or an SPI error.
+ */
+int qspi_cache_program(uint32_t addr, const uint8_t *data, uint32_t len);
+/**
+ * @brief      Erases with qspi_erase_range() and drops the cached lines it touches.
+ * @param      addr     Flash address, aligned to QSPI_SECTOR_SIZE.
+ * @param      len      Number of bytes, a multiple of QSPI_SECTOR_SIZE.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_TIME_OUT or an SPI error.
+ */
+int qspi_cache_erase(uint32_t addr, uint32_t len);
+/**
+ * @brief      Drops the cached lines of a range. Needed after writing the
+ *             flash without going through the cache.
+ * @param      addr     Flash address.
+ * @param      len      Number of bytes.
+ */
+void qspi_cache_invalidate(uint32_t addr, uint32_t len);
+/**
+ * @brief      Copies the counters.
+ * @param      stats    Receives the counters.
+ * @param      reset    Non-zero to clear the counters after copying.
+ */
+void qspi_cache_get_stats(qspi_cache_stats_t *stats, int reset);
+
+#endif
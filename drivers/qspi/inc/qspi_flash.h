@@ -0,0 +1,176 @@
+/**
+ * @file       qspi_flash.h
+ * @brief      IS25LP128 serial flash driver.
+ * @details    Drives the 16 MB IS25LP128 on the EvKit over the quad capable
+ *             SPI0: JEDEC ID probe, quad output fast reads (6Bh) by PIO or
+ *             DMA, quad page program and 4/32/64 KB erase with status
+ *             polling. The MAX78000 cannot map an SPI flash into its address
+ *             space, so every access goes through these functions.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __QSPI_FLASH_H__
+#define __QSPI_FLASH_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+#include "mxc_device.h"
+#include "mxc_delay.h"
+#include "mxc_errors.h"
+#include "nvic_table.h"
+#include "spi.h"
+#include "dma.h"
+#include "stats.h"
+
+/***** Definitions *****/
+#define QSPI_SPI MXC_SPI0           // Quad capable SPI, SDIO0-3 on P0.5, P0.6, P0.8, P0.9
+#define QSPI_SS 0                   // Slave select of the flash
+
+#ifndef QSPI_FREQ
+#define QSPI_FREQ 25000000          // SCK frequency in Hz
+#endif
+
+#define QSPI_FLASH_SIZE 0x1000000UL // 128 Mbit
+#define QSPI_PAGE_SIZE 256          // Program granularity
+#define QSPI_SECTOR_SIZE 0x1000     // 4 KB erase
+#define QSPI_BLOCK32_SIZE 0x8000    // 32 KB erase
+#define QSPI_BLOCK64_SIZE 0x10000   // 64 KB erase
+#define QSPI_DMA_CHUNK 0x8000       // Largest single DMA read
+
+/* JEDEC ID: manufacturer, memory type, capacity */
+#define QSPI_JEDEC_ID 0x9D6018UL
+
+/* Instructions */
+#define QSPI_CMD_WRSR 0x01          // Write status register
+#define QSPI_CMD_RDSR 0x05          // Read status register
+#define QSPI_CMD_WREN 0x06          // Write enable
+#define QSPI_CMD_SER 0x20           // Sector erase, 4 KB
+#define QSPI_CMD_PPQ 0x32           // Quad input page program
+#define QSPI_CMD_BER32 0x52         // Block erase, 32 KB
+#define QSPI_CMD_FRQO 0x6B          // Fast read quad output, 8 dummy clocks
+#define QSPI_CMD_RDJDID 0x9F        // Read JEDEC ID
+#define QSPI_CMD_BER64 0xD8         // Block erase, 64 KB
+
+/* Status register */
+#define QSPI_SR_WIP 0x01            // Write in progress
+#define QSPI_SR_WEL 0x02            // Write enable latch
+#define QSPI_SR_QE 0x40             // Quad enable
+
+/* Maximum operation times (IS25LP128 datasheet) and status poll intervals */
+#define QSPI_PROG_TIMEOUT_US 800            // tPP max
+#define QSPI_PROG_POLL_US 20
+#define QSPI_SECTOR_TIMEOUT_US 300000       // 4 KB erase max
+#define QSPI_BLOCK32_TIMEOUT_US 500000      // 32 KB erase max
+#define QSPI_BLOCK64_TIMEOUT_US 1000000     // 64 KB erase max
+#define QSPI_ERASE_POLL_US 1000
+#define QSPI_SR_TIMEOUT_US 15000            // tW max
+
+/**
+ * @brief      Destination of one part of a scattered read, see qspi_readv().
+ */
+typedef struct {
+    uint8_t *data;              // Buffer
+    uint32_t len;               // Bytes read into the buffer
+} qspi_iovec_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes SPI0, checks the JEDEC ID and enables the quad lines
+ *             of the flash.
+ * @return     E_NO_ERROR, E_NO_DEVICE if the ID does not match, or an SPI error.
+ */
+int qspi_init(void);
+/**
+ * @brief      Reads the JEDEC ID.
+ * @param      id   Receives manufacturer, memory type and capacity, e.g. 0x9D6018.
+ * @return     E_NO_ERROR or an SPI error.
+ */
+int qspi_read_id(uint32_t *id);
+/**
+ * @brief      Reads the status register.
+ * @param      status   Receives the status byte.
+ * @return     E_NO_ERROR or an SPI error.
+ */
+int qspi_read_status(uint8_t *status);
+/**
+ * @brief      Polls the status register until the running program or erase ends.
+ * @param      timeout_us   Longest time to wait.
+ * @param      poll_us      Time between polls.
+ * @return     E_NO_ERROR, E_TIME_OUT or an SPI error.
+ */
+int qspi_wait_ready(uint32_t timeout_us, uint32_t poll_us);
+/**
+ * @brief      Reads with the quad output fast read instruction, the CPU moving the data.
+ * @param      addr     Flash address.
+ * @param      data     Output buffer.
+ * @param      len      Number of bytes.
+ * @return     E_NO_ERROR, E_BAD_PARAM or an SPI error.
+ */
+int qspi_read(uint32_t addr, uint8_t *data, uint32_t len);
+/**
+ * @brief      Reads with the quad output fast read instruction, DMA moving the
+ *             data. Blocks until the transfer is complete. Large reads are
+ *             split into QSPI_DMA_CHUNK transfers.
+ * @param      addr     Flash address.
+ * @param      data     Output buffer.
+ * @param      len      Number of bytes.
+ * @return     E_NO_ERROR, E_BAD_PARAM or an SPI error.
+ */
+int qspi_read_dma(uint32_t addr, uint8_t *data, uint32_t len);
+/**
+ * @brief      Reads consecutive flash bytes into several buffers with a single
+ *             quad output fast read, paying the instruction, address and dummy
+ *             clocks once.
+ * @param      addr     Flash address of the first byte.
+ * @param      iov      Buffers, filled in order.
+ * @param      count    Number of buffers, at least one.
+ * @return     E_NO_ERROR, E_BAD_PARAM or an SPI error.
+ */
+int qspi_readv(uint32_t addr, const qspi_iovec_t *iov, uint32_t count);
+/**
+ * @brief      Programs data with quad input page program, one page at a time,
+ *             waiting for each page to finish. The target must be erased.
+ * @param      addr     Flash address, any alignment.
+ * @param      data     Data to program.
+ * @param      len      Number of bytes.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_TIME_OUT or an SPI error.
+ */
+int qspi_program(uint32_t addr, const uint8_t *data, uint32_t len);
+/**
+ * @brief      Erases one sector or block and waits for the erase to finish.
+ * @param      addr     Flash address, aligned to size.
+ * @param      size     QSPI_SECTOR_SIZE, QSPI_BLOCK32_SIZE or QSPI_BLOCK64_SIZE.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_TIME_OUT or an SPI error.
+ */
+int qspi_erase(uint32_t addr, uint32_t size);
+/**
+ * @brief      Erases a range with the largest erase that fits at each step.
+ * @param      addr     Flash address, aligned to QSPI_SECTOR_SIZE.
+ * @param      len      Number of bytes, a multiple of QSPI_SECTOR_SIZE.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_TIME_OUT or an SPI error.
+ */
+int qspi_erase_range(uint32_t addr, uint32_t len);
+
+#endif
@@ -0,0 +1,207 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "qspi_cache.h"
+
+/***** Definitions *****/
+#if (QSPI_CACHE_SETS & (QSPI_CACHE_SETS - 1)) != 0
+#error "QSPI_CACHE_SETS must be a power of two"
+#endif
+
+#if (QSPI_CACHE_LINE_SIZE & (QSPI_CACHE_LINE_SIZE - 1)) != 0
+#error "QSPI_CACHE_LINE_SIZE must be a power of two"
+#endif
+
+// Read-ahead lines land in consecutive sets, so a stream never evicts itself
+#if QSPI_CACHE_READAHEAD >= QSPI_CACHE_SETS
+#error "QSPI_CACHE_READAHEAD must be smaller than QSPI_CACHE_SETS"
+#endif
+
+#define QSPI_CACHE_INVALID 0xFFFFFFFFUL     // Tag of an empty way
+#define QSPI_CACHE_LINES (QSPI_FLASH_SIZE / QSPI_CACHE_LINE_SIZE)
+
+/***** Globals *****/
+static uint8_t cache_data[QSPI_CACHE_SETS][QSPI_CACHE_WAYS][QSPI_CACHE_LINE_SIZE];
+static uint32_t cache_tag[QSPI_CACHE_SETS][QSPI_CACHE_WAYS];   // Line number held by each way
+static uint32_t cache_used[QSPI_CACHE_SETS][QSPI_CACHE_WAYS];  // cache_clock at the last use
+static uint32_t cache_clock = 0;                    // Advances on every line access
+static uint32_t cache_last_line = QSPI_CACHE_INVALID;  // Last line accessed, for stream detection
+static qspi_cache_stats_t cache_stats;
+
+/***** Functions *****/
+void qspi_cache_init(void)
+{
+    qspi_cache_invalidate(0, QSPI_FLASH_SIZE);
+    cache_clock = 0;
+    cache_last_line = QSPI_CACHE_INVALID;
+    memset(&cache_stats, 0, sizeof(cache_stats));
+}
+/******************************************************************************/
+// Returns the way holding a line, or -1 if the line is not cached
+static int qspi_cache_find(uint32_t line)
+{
+    uint32_t set = line & (QSPI_CACHE_SETS - 1);
+    for (int way = 0; way < QSPI_CACHE_WAYS; way++) {
+        if (cache_tag[set][way] == line) {
+            return way;
+        }
+    }
+    return -1;
+}
+/******************************************************************************/
+// Returns the cached copy of a line and marks it used, or NULL on a miss
+static uint8_t *qspi_cache_lookup(uint32_t line)
+{
+    int way = qspi_cache_find(line);
+    if (way < 0) {
+        return NULL;
+    }
+    uint32_t set = line & (QSPI_CACHE_SETS - 1);
+    cache_used[set][way] = ++cache_clock;
+    return cache_data[set][way];
+}
+/******************************************************************************/
+// Picks the way of the set to refill: an empty way, else the least recently used
+static int qspi_cache_victim(uint32_t set)
+{
+    int victim = 0;
+    for (int way = 0; way < QSPI_CACHE_WAYS; way++) {
+        if (cache_tag[set][way] == QSPI_CACHE_INVALID) {
+            return way;
+        }
+        if (cache_used[set][way] < cache_used[set][victim]) {
+            victim = way;
+        }
+    }
+    cache_stats.evictions++;
+    return victim;
+}
+/******************************************************************************/
+// Fetches a missed line. When the miss continues a sequential stream the next
+// uncached lines are fetched in the same read.
+static int qspi_cache_fill(uint32_t line, uint8_t **buf)
+{
+    qspi_iovec_t iov[1 + QSPI_CACHE_READAHEAD];
+    uint32_t *tags[1 + QSPI_CACHE_READAHEAD];
+    uint32_t count = 1;
+
+    if (cache_last_line != QSPI_CACHE_INVALID && line == cache_last_line + 1) {
+        while (count <= QSPI_CACHE_READAHEAD && line + count < QSPI_CACHE_LINES &&
+               qspi_cache_find(line + count) < 0) {
+            count++;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t set = (line + i) & (QSPI_CACHE_SETS - 1);
+        int way = qspi_cache_victim(set);
+        cache_tag[set][way] = line + i;
+        cache_used[set][way] = ++cache_clock;
+        tags[i] = &cache_tag[set][way];
+        iov[i].data = cache_data[set][way];
+        iov[i].len = QSPI_CACHE_LINE_SIZE;
+    }
+
+    int err = qspi_readv(line * QSPI_CACHE_LINE_SIZE, iov, count);
+    if (err != E_NO_ERROR) {
+        for (uint32_t i = 0; i < count; i++) {
+            *tags[i] = QSPI_CACHE_INVALID;
+        }
+        return err;
+    }
+    cache_stats.misses++;
+    cache_stats.readahead += count - 1;
+    *buf = iov[0].data;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int qspi_cache_read(uint32_t addr, uint8_t *data, uint32_t len)
+{
+    if (len > QSPI_FLASH_SIZE || addr > QSPI_FLASH_SIZE - len) {
+        return E_BAD_PARAM;
+    }
+    while (len > 0) {
+        uint32_t line = addr / QSPI_CACHE_LINE_SIZE;
+        uint32_t offset = addr & (QSPI_CACHE_LINE_SIZE - 1);
+        uint32_t n = QSPI_CACHE_LINE_SIZE - offset;
+        if (n > len) {
+            n = len;
+        }
+
+        uint8_t *buf = qspi_cache_lookup(line);
+        if (buf != NULL) {
+            cache_stats.hits++;
+        } else {
+            int err = qspi_cache_fill(line, &buf);
+            if (err != E_NO_ERROR) {
+                return err;
+            }
+        }
+        cache_last_line = line;
+
+        memcpy(data, buf + offset, n);
+        addr += n;
+        data += n;
+        len -= n;
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int qspi_cache_program(uint32_t addr, const uint8_t *data, uint32_t len)
+{
+    int err = qspi_program(addr, data, len);
+    qspi_cache_invalidate(addr, len);
+    return err;
+}
+/******************************************************************************/
+int qspi_cache_erase(uint32_t addr, uint32_t len)
+{
+    int err = qspi_erase_range(addr, len);
+    qspi_cache_invalidate(addr, len);
+    return err;
+}
+/******************************************************************************/
+void qspi_cache_invalidate(uint32_t addr, uint32_t len)
+{
+    if (len == 0) {
+        return;
+    }
+    uint32_t first = addr / QSPI_CACHE_LINE_SIZE;
+    uint32_t last = (addr + len - 1) / QSPI_CACHE_LINE_SIZE;
+
+    for (int set = 0; set < QSPI_CACHE_SETS; set++) {
+        for (int way = 0; way < QSPI_CACHE_WAYS; way++) {
+            if (cache_tag[set][way] >= first && cache_tag[set][way] <= last) {
+                cache_tag[set][way] = QSPI_CACHE_INVALID;
+            }
+        }
+    }
+}
+/******************************************************************************/
+void qspi_cache_get_stats(qspi_cache_stats_t *stats, int reset)
+{
+    *stats = cache_stats;
+    if (reset) {
+        memset(&cache_stats, 0, sizeof(cache_stats));
+    }
+}
@@ -0,0 +1,356 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "qspi_flash.h"
+#include "log.h"
+
+/***** Globals *****/
+static volatile int qspi_dma_busy = 0;      // A DMA read is running
+static volatile int qspi_dma_result = 0;    // Result passed to the completion callback
+
+/***** Functions *****/
+// Services the DMA channels the SPI driver acquires for a transfer
+static void qspi_dma_irq(void)
+{
+    MXC_DMA_Handler();
+}
+/******************************************************************************/
+static void qspi_dma_done(void *req, int result)
+{
+    (void)req;
+    qspi_dma_result = result;
+    qspi_dma_busy = 0;
+}
+/******************************************************************************/
+// Runs one transaction at the current width. The slave select stays asserted
+// when more phases of the same instruction follow.
+static int qspi_xfer(const uint8_t *tx, uint32_t tx_len, uint8_t *rx, uint32_t rx_len, int last)
+{
+    mxc_spi_req_t req;
+    req.spi = QSPI_SPI;
+    req.ssIdx = QSPI_SS;
+    req.ssDeassert = last;
+    req.txData = (uint8_t *)tx;
+    req.txLen = tx_len;
+    req.rxData = rx;
+    req.rxLen = rx_len;
+    req.txCnt = 0;
+    req.rxCnt = 0;
+    req.completeCB = NULL;
+    return MXC_SPI_MasterTransaction(&req);
+}
+/******************************************************************************/
+// Sends an instruction followed by a 24-bit address
+static int qspi_cmd_addr(uint8_t cmd, uint32_t addr, int last)
+{
+    uint8_t hdr[4] = { cmd, (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr };
+    return qspi_xfer(hdr, sizeof(hdr), NULL, 0, last);
+}
+/******************************************************************************/
+static int qspi_write_enable(void)
+{
+    uint8_t cmd = QSPI_CMD_WREN;
+    return qspi_xfer(&cmd, 1, NULL, 0, 1);
+}
+/******************************************************************************/
+// Checks that [addr, addr + len) lies inside the array
+static int qspi_range_ok(uint32_t addr, uint32_t len)
+{
+    return len <= QSPI_FLASH_SIZE && addr <= QSPI_FLASH_SIZE - len;
+}
+/******************************************************************************/
+int qspi_init(void)
+{
+    int err;
+    uint32_t id;
+    uint8_t status;
+
+    if ((err = MXC_SPI_Init(QSPI_SPI, 1, 1, 1, 0, QSPI_FREQ)) != E_NO_ERROR) {
+        LOG_ERROR("QSPI init failed, error:%d", err);
+        return err;
+    }
+    MXC_SPI_SetDataSize(QSPI_SPI, 8);
+    MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_STANDARD);
+    MXC_SPI_SetMode(QSPI_SPI, SPI_MODE_0);
+
+    MXC_NVIC_SetVector(DMA0_IRQn, qspi_dma_irq);
+    MXC_NVIC_SetVector(DMA1_IRQn, qspi_dma_irq);
+    NVIC_EnableIRQ(DMA0_IRQn);
+    NVIC_EnableIRQ(DMA1_IRQn);
+
+    if ((err = qspi_read_id(&id)) != E_NO_ERROR) {
+        return err;
+    }
+    if (id != QSPI_JEDEC_ID) {
+        LOG_ERROR("QSPI flash ID 0x%06X, expected 0x%06X", id, QSPI_JEDEC_ID);
+        return E_NO_DEVICE;
+    }
+
+    // IO2 and IO3 only carry data once QE is set, it is non-volatile
+    if ((err = qspi_read_status(&status)) != E_NO_ERROR) {
+        return err;
+    }
+    if (!(status & QSPI_SR_QE)) {
+        uint8_t wrsr[2] = { QSPI_CMD_WRSR, (uint8_t)(status | QSPI_SR_QE) };
+        if ((err = qspi_write_enable()) != E_NO_ERROR ||
+            (err = qspi_xfer(wrsr, sizeof(wrsr), NULL, 0, 1)) != E_NO_ERROR ||
+            (err = qspi_wait_ready(QSPI_SR_TIMEOUT_US, QSPI_ERASE_POLL_US)) != E_NO_ERROR ||
+            (err = qspi_read_status(&status)) != E_NO_ERROR) {
+            return err;
+        }
+        if (!(status & QSPI_SR_QE)) {
+            LOG_ERROR("QSPI quad enable failed, status 0x%02X", status);
+            return E_BAD_STATE;
+        }
+    }
+    LOG_INFO("QSPI flash 0x%06X ready at %u Hz", id, MXC_SPI_GetFrequency(QSPI_SPI));
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int qspi_read_id(uint32_t *id)
+{
+    uint8_t tx[1] = { QSPI_CMD_RDJDID };
+    uint8_t rx[4];
+    int err = qspi_xfer(tx, sizeof(tx), rx, sizeof(rx), 1);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    *id = ((uint32_t)rx[1] << 16) | ((uint32_t)rx[2] << 8) | rx[3];
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int qspi_read_status(uint8_t *status)
+{
+    uint8_t tx[1] = { QSPI_CMD_RDSR };
+    uint8_t rx[2];
+    int err = qspi_xfer(tx, sizeof(tx), rx, sizeof(rx), 1);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    *status = rx[1];
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int qspi_wait_ready(uint32_t timeout_us, uint32_t poll_us)
+{
+    uint8_t status;
+    for (uint32_t waited = 0;; waited += poll_us) {
+        int err = qspi_read_status(&status);
+        if (err != E_NO_ERROR) {
+            return err;
+        }
+        if (!(status & QSPI_SR_WIP)) {
+            return E_NO_ERROR;
+        }
+        if (waited >= timeout_us) {
+            LOG_ERROR("QSPI busy for more than %u us", timeout_us);
+            return E_TIME_OUT;
+        }
+        MXC_Delay(poll_us);
+    }
+}
+/******************************************************************************/
+// Starts a quad output fast read: instruction, address and 8 dummy clocks on
+// one line, then switches to four lines for the data
+static int qspi_read_start(uint32_t addr)
+{
+    uint8_t hdr[5] = { QSPI_CMD_FRQO, (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr,
+                       0 };
+    int err = qspi_xfer(hdr, sizeof(hdr), NULL, 0, 0);
+    if (err == E_NO_ERROR) {
+        MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_QUAD);
+    }
+    return err;
+}
+/******************************************************************************/
+static int qspi_quad_read(uint32_t addr, uint8_t *data, uint32_t len, int dma)
+{
+    int err = qspi_read_start(addr);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+
+    if (!dma) {
+        err = qspi_xfer(NULL, 0, data, len, 1);
+    } else {
+        mxc_spi_req_t req;
+        req.spi = QSPI_SPI;
+        req.ssIdx = QSPI_SS;
+        req.ssDeassert = 1;
+        req.txData = NULL;
+        req.txLen = 0;
+        req.rxData = data;
+        req.rxLen = len;
+        req.txCnt = 0;
+        req.rxCnt = 0;
+        req.completeCB = qspi_dma_done;
+
+        qspi_dma_busy = 1;
+        err = MXC_SPI_MasterTransactionDMA(&req);
+        if (err == E_NO_ERROR) {
+            while (qspi_dma_busy) {}
+            err = qspi_dma_result;
+        }
+    }
+    MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_STANDARD);
+    return err;
+}
+/******************************************************************************/
+int qspi_read(uint32_t addr, uint8_t *data, uint32_t len)
+{
+    STATS_BEGIN();
+    if (!qspi_range_ok(addr, len)) {
+        return E_BAD_PARAM;
+    }
+    int err = qspi_quad_read(addr, data, len, 0);
+    STATS_END(STATS_QSPI_READ, len, err);
+    return err;
+}
+/******************************************************************************/
+int qspi_read_dma(uint32_t addr, uint8_t *data, uint32_t len)
+{
+    STATS_BEGIN();
+    if (!qspi_range_ok(addr, len)) {
+        return E_BAD_PARAM;
+    }
+    int err = E_NO_ERROR;
+    for (uint32_t done = 0; done < len && err == E_NO_ERROR;) {
+        uint32_t n = (len - done < QSPI_DMA_CHUNK) ? len - done : QSPI_DMA_CHUNK;
+        err = qspi_quad_read(addr + done, data + done, n, 1);
+        done += n;
+    }
+    STATS_END(STATS_QSPI_READ, len, err);
+    return err;
+}
+/******************************************************************************/
+int qspi_readv(uint32_t addr, const qspi_iovec_t *iov, uint32_t count)
+{
+    STATS_BEGIN();
+    uint32_t len = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        len += iov[i].len;
+    }
+    if (count == 0 || !qspi_range_ok(addr, len)) {
+        return E_BAD_PARAM;
+    }
+    // One instruction, the data phase is split between the buffers
+    int err = qspi_read_start(addr);
+    if (err == E_NO_ERROR) {
+        for (uint32_t i = 0; i < count && err == E_NO_ERROR; i++) {
+            err = qspi_xfer(NULL, 0, iov[i].data, iov[i].len, i == count - 1);
+        }
+        MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_STANDARD);
+    }
+    STATS_END(STATS_QSPI_READ, len, err);
+    return err;
+}
+/******************************************************************************/
+int qspi_program(uint32_t addr, const uint8_t *data, uint32_t len)
+{
+    STATS_BEGIN();
+    if (!qspi_range_ok(addr, len)) {
+        return E_BAD_PARAM;
+    }
+    const uint32_t total = len;
+    int err = E_NO_ERROR;
+    while (len > 0 && err == E_NO_ERROR) {
+        // A page program wraps inside the page, so stop at the page boundary
+        uint32_t n = QSPI_PAGE_SIZE - (addr & (QSPI_PAGE_SIZE - 1));
+        if (n > len) {
+            n = len;
+        }
+        if ((err = qspi_write_enable()) != E_NO_ERROR ||
+            (err = qspi_cmd_addr(QSPI_CMD_PPQ, addr, 0)) != E_NO_ERROR) {
+            break;
+        }
+        MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_QUAD);
+        err = qspi_xfer(data, n, NULL, 0, 1);
+        MXC_SPI_SetWidth(QSPI_SPI, SPI_WIDTH_STANDARD);
+        if (err == E_NO_ERROR) {
+            err = qspi_wait_ready(QSPI_PROG_TIMEOUT_US, QSPI_PROG_POLL_US);
+        }
+        addr += n;
+        data += n;
+        len -= n;
+    }
+    STATS_END(STATS_QSPI_PROGRAM, total, err);
+    return err;
+}
+/******************************************************************************/
+int qspi_erase(uint32_t addr, uint32_t size)
+{
+    STATS_BEGIN();
+    uint8_t cmd;
+    uint32_t timeout_us;
+
+    switch (size) {
+    case QSPI_SECTOR_SIZE:
+        cmd = QSPI_CMD_SER;
+        timeout_us = QSPI_SECTOR_TIMEOUT_US;
+        break;
+    case QSPI_BLOCK32_SIZE:
+        cmd = QSPI_CMD_BER32;
+        timeout_us = QSPI_BLOCK32_TIMEOUT_US;
+        break;
+    case QSPI_BLOCK64_SIZE:
+        cmd = QSPI_CMD_BER64;
+        timeout_us = QSPI_BLOCK64_TIMEOUT_US;
+        break;
+    default:
+        return E_BAD_PARAM;
+    }
+    if ((addr & (size - 1)) != 0 || !qspi_range_ok(addr, size)) {
+        return E_BAD_PARAM;
+    }
+
+    int err = qspi_write_enable();
+    if (err == E_NO_ERROR) {
+        err = qspi_cmd_addr(cmd, addr, 1);
+    }
+    if (err == E_NO_ERROR) {
+        err = qspi_wait_ready(timeout_us, QSPI_ERASE_POLL_US);
+    }
+    STATS_END(STATS_QSPI_ERASE, 0, err);
+    return err;
+}
+/******************************************************************************/
+int qspi_erase_range(uint32_t addr, uint32_t len)
+{
+    if ((addr | len) & (QSPI_SECTOR_SIZE - 1) || !qspi_range_ok(addr, len)) {
+        return E_BAD_PARAM;
+    }
+    while (len > 0) {
+        uint32_t size = QSPI_SECTOR_SIZE;
+        if ((addr & (QSPI_BLOCK64_SIZE - 1)) == 0 && len >= QSPI_BLOCK64_SIZE) {
+            size = QSPI_BLOCK64_SIZE;
+        } else if ((addr & (QSPI_BLOCK32_SIZE - 1)) == 0 && len >= QSPI_BLOCK32_SIZE) {
+            size = QSPI_BLOCK32_SIZE;
+        }
+        int err = qspi_erase(addr, size);
+        if (err != E_NO_ERROR) {
+            return err;
+        }
+        addr += size;
+        len -= size;
+    }
+    return E_NO_ERROR;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file       ramfunc.h
+ * @brief      Code placement in SRAM.
+ * @details    RAMFUNC puts a function in the .ramfunc section, which
+ *             ramfunc.ld links to run from SRAM with its image stored in
+ *             flash. ramfunc_init() copies the image at startup, before any
+ *             RAMFUNC function runs.
+ *
+ *             It is used for the FLC program and erase core, which would
+ *             otherwise stall fetching its own code while the flash is busy
+ *             and refill the instruction cache after every operation, for the
+ *             driver interrupt handlers and for the GPIO set and get calls.
+ *             The helpers a RAMFUNC function calls (locks, counters, black
+ *             box, bus trace, memset()) stay in flash, so they must only run
+ *             while the flash controller is idle.
+ *             Build with RAMFUNC_ENABLE=0 to keep all of it in flash, e.g. to
+ *             compare the benchmarks. The boot stage copy, update_boot(),
+ *             does not depend on the switch: it must run from RAM and uses
+ *             the SDK's .flashprog.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __RAMFUNC_H__
+#define __RAMFUNC_H__
+
+/***** Includes *****/
+#include <stdint.h>
+
+/***** Definitions *****/
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE 1              // 0 leaves RAMFUNC functions in flash
+#endif
+
+#if RAMFUNC_ENABLE && !defined(HOST_SIM)
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Copies the RAMFUNC code to SRAM. Call first thing in main().
+ */
+void ramfunc_init(void);
+/**
+ * @brief      Returns the bytes of code that run from SRAM, 0 if RAMFUNC is
+ *             disabled or on the host.
+ */
+uint32_t ramfunc_size(void);
+
+#endif
@@ -0,0 +1,51 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "ramfunc.h"
+#include "mxc_device.h"
+
+/***** Globals *****/
+#if RAMFUNC_ENABLE && !defined(HOST_SIM)
+extern uint8_t __ramfunc_start[];   // Run address of .ramfunc in SRAM, see ramfunc.ld
+extern uint8_t __ramfunc_end[];
+extern uint8_t __ramfunc_load[];    // Load address of its image in flash
+#endif
+
+/***** Functions *****/
+void ramfunc_init(void)
+{
+#if RAMFUNC_ENABLE && !defined(HOST_SIM)
+    memcpy(__ramfunc_start, __ramfunc_load, (size_t)(__ramfunc_end - __ramfunc_start));
+    __DSB();
+    __ISB();    // Fetch the copied code, not stale prefetched words
+#endif
+}
+/******************************************************************************/
+uint32_t ramfunc_size(void)
+{
+#if RAMFUNC_ENABLE && !defined(HOST_SIM)
+    return (uint32_t)(__ramfunc_end - __ramfunc_start);
+#else
+    return 0;
+#endif
+}
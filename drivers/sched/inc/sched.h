@@ -0,0 +1,175 @@
+/**
+ * @file       sched.h
+ * @brief      Tickless low-power scheduler.
+ * @details    Runs work items queued by interrupt handlers and software
+ *             timers, and sleeps the core in between. There is no periodic
+ *             tick: the wakeup timer runs freely from the 32.768 kHz clock
+ *             and its compare interrupt is armed for the next timer only, so
+ *             the core wakes for timers, for GPIO events such as the BMI160
+ *             data ready line, and for nothing else. With SCHED_STATS the
+ *             scheduler counts wakeups and sleep time to give the duty cycle.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+#include "gpio.h"
+
+/***** Definitions *****/
+#ifndef SCHED_STATS
+#define SCHED_STATS 1               // Count wakeups and sleep time
+#endif
+#ifndef SCHED_QUEUE_LEN
+#define SCHED_QUEUE_LEN 16          // Work items that can wait, power of two
+#endif
+#ifndef SCHED_GPIO_EVENTS
+#define SCHED_GPIO_EVENTS 4         // Pins sched_gpio_event() can watch
+#endif
+
+#define SCHED_TICK_HZ 32768         // Scheduler time base, the wakeup timer clock
+#define SCHED_MS(ms) ((uint32_t)(((uint64_t)(ms) * SCHED_TICK_HZ + 999) / 1000))   // ms to ticks, rounded up
+#define SCHED_MIN_SLEEP 2           // Shorter waits are spent awake, the compare could be missed
+
+/**
+ * @brief      Work item or timer function.
+ * @param      arg      Pointer given when the work was queued or the timer started.
+ */
+typedef void (*sched_fn_t)(void *arg);
+
+/**
+ * @brief      Software timer. Owned by the caller and linked into the
+ *             scheduler while running.
+ */
+typedef struct sched_timer {
+    sched_fn_t fn;              // Called from sched_run_once() when due
+    void *arg;
+    uint32_t due;               // Tick of the next expiry
+    uint32_t period;            // Ticks between expiries, 0 for one shot
+    int active;                 // Started and not yet expired or stopped
+    struct sched_timer *next;   // Next running timer
+} sched_timer_t;
+
+/**
+ * @brief      Scheduler counters.
+ */
+typedef struct {
+    uint32_t elapsed;           // Ticks since the counters were reset
+    uint32_t asleep;            // Ticks spent sleeping
+    uint32_t wakeups;           // Sleeps ended by an interrupt
+    uint32_t work;              // Work items run
+    uint32_t timers;            // Timer expiries handled
+    uint32_t overruns;          // Work items refused because the queue was full
+} sched_stats_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Starts the wakeup timer as the time base and empties the work
+ *             queue and timer list.
+ * @return     Returns 0 if the operation is successful.
+ */
+int sched_init(void);
+/**
+ * @brief      Returns the current time in ticks of SCHED_TICK_HZ. Wraps every
+ *             36 hours; compare times by their signed difference.
+ */
+uint32_t sched_now(void);
+/**
+ * @brief      Queues a work item. Safe to call from interrupt handlers.
+ * @param      fn       Function to run from sched_run_once().
+ * @param      arg      Passed to @p fn.
+ * @return     Returns 0 if the operation is successful, E_OVERFLOW if the queue is full.
+ */
+int sched_post(sched_fn_t fn, void *arg);
+/**
+ * @brief      Queues a work item like sched_post(), falling back to a slot
+ *             kept outside the queue when it is full. For a poster that never
+ *             has more than one item waiting, such as the coop pass, so other
+ *             work cannot crowd it out. Safe to call from interrupt handlers.
+ * @param      fn       Function to run from sched_run_once().
+ * @param      arg      Passed to @p fn.
+ * @return     Returns 0 if the operation is successful, E_BUSY if the queue
+ *             is full and the extra slot is taken.
+ */
+int sched_post_reserved(sched_fn_t fn, void *arg);
+/**
+ * @brief      Starts or restarts a timer.
+ * @param      t        Timer.
+ * @param      delay    Ticks until the first expiry.
+ * @param      period   Ticks between later expiries, 0 for one shot.
+ * @param      fn       Function to call on expiry.
+ * @param      arg      Passed to @p fn.
+ */
+void sched_timer_start(sched_timer_t *t, uint32_t delay, uint32_t period, sched_fn_t fn,
+                       void *arg);
+/**
+ * @brief      Stops a timer. Stopping a timer that is not running does nothing.
+ * @param      t        Timer.
+ */
+void sched_timer_stop(sched_timer_t *t);
+/**
+ * @brief      Queues a work item on every rising edge of an input pin and lets
+ *             the pin wake the core.
+ * @param      port     GPIO port.
+ * @param      mask     Pin.
+ * @param      fn       Work item to queue.
+ * @param      arg      Passed to @p fn.
+ * @return     Returns 0 if the operation is successful, E_NONE_AVAIL if
+ *             SCHED_GPIO_EVENTS pins are watched already.
+ */
+int sched_gpio_event(mxc_gpio_regs_t *port, uint32_t mask, sched_fn_t fn, void *arg);
+/**
+ * @brief      Runs the timers that are due and every queued work item.
+ * @return     Number of timer expiries and work items handled.
+ */
+int sched_run_once(void);
+/**
+ * @brief      Sleeps until the next timer or interrupt, unless work is
+ *             already waiting. Interrupt handlers run before it returns.
+ *             From an OSAL_RTOS task it blocks the task for a tick instead.
+ */
+void sched_idle(void);
+/**
+ * @brief      Runs work and sleeps in between, forever.
+ */
+void sched_run(void);
+/**
+ * @brief      Waits, sleeping the core instead of spinning. Work items and
+ *             timers do not run meanwhile, interrupt handlers do. Falls back
+ *             to MXC_Delay() before sched_init(), and blocks only the
+ *             calling task in osal_delay_ms() from an OSAL_RTOS task.
+ * @param      ms       Milliseconds to wait.
+ */
+void sched_delay_ms(uint32_t ms);
+/**
+ * @brief      Copies the counters. All zero when SCHED_STATS is 0.
+ * @param      stats    Receives the counters.
+ * @param      reset    Non-zero to restart the counters.
+ */
+void sched_get_stats(sched_stats_t *stats, int reset);
+
+#endif
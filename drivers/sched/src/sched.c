@@ -0,0 +1,381 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "sched.h"
+#include "mxc_delay.h"
+#include "mxc_errors.h"
+#include "nvic_table.h"
+#include "wut.h"
+#include "lp.h"
+#include "ramfunc.h"
+#include "osal.h"
+
+/***** Definitions *****/
+#if (SCHED_QUEUE_LEN & (SCHED_QUEUE_LEN - 1)) != 0
+#error "SCHED_QUEUE_LEN must be a power of two"
+#endif
+
+#define SCHED_GPIO_PORTS 3          // Ports with a GPIO interrupt
+
+/**
+ * @brief      Queued work item.
+ */
+typedef struct {
+    sched_fn_t fn;
+    void *arg;
+} sched_work_t;
+
+/**
+ * @brief      Pin watched by sched_gpio_event().
+ */
+typedef struct {
+    sched_fn_t fn;              // Work item queued on a rising edge
+    void *arg;
+    mxc_gpio_regs_t *port;
+    uint32_t mask;
+} sched_gpio_t;
+
+/***** Globals *****/
+static sched_work_t sched_queue[SCHED_QUEUE_LEN];
+static volatile uint32_t sched_head;    // Next item to run
+static volatile uint32_t sched_tail;    // Next free slot
+static sched_work_t sched_reserved;     // Slot of sched_post_reserved(), fn NULL when free
+static sched_timer_t *sched_timers;     // Running timers
+static sched_gpio_t sched_gpio[SCHED_GPIO_EVENTS];
+static int sched_gpio_count;
+static int sched_ready;                 // sched_init() has run
+#if SCHED_STATS
+static sched_stats_t sched_stats;
+static uint32_t sched_stats_start;      // Tick the counters were reset at
+#endif
+
+/***** Functions *****/
+// The compare match only has to wake the core, timers run in thread mode
+static RAMFUNC void sched_wut_irq(void)
+{
+    MXC_WUT_IntClear();
+}
+/******************************************************************************/
+static RAMFUNC void sched_gpio0_irq(void)
+{
+    MXC_GPIO_Handler(0);
+}
+/******************************************************************************/
+static RAMFUNC void sched_gpio1_irq(void)
+{
+    MXC_GPIO_Handler(1);
+}
+/******************************************************************************/
+static RAMFUNC void sched_gpio2_irq(void)
+{
+    MXC_GPIO_Handler(2);
+}
+/******************************************************************************/
+int sched_init(void)
+{
+    mxc_wut_cfg_t cfg = { MXC_WUT_MODE_COMPARE, 0xFFFFFFFF };
+
+    // Free running: the count is the time base, the compare the next wakeup
+    MXC_WUT_Init(MXC_WUT_PRES_1);
+    MXC_WUT_Config(&cfg);
+    MXC_WUT_Enable();
+    MXC_NVIC_SetVector(WUT_IRQn, sched_wut_irq);
+    NVIC_EnableIRQ(WUT_IRQn);
+    MXC_LP_EnableWUTAlarmWakeup();
+
+    for (int i = 0; i < sched_gpio_count; i++) {
+        MXC_GPIO_DisableInt(sched_gpio[i].port, sched_gpio[i].mask);
+    }
+    sched_gpio_count = 0;
+    sched_head = 0;
+    sched_tail = 0;
+    sched_reserved.fn = NULL;
+    sched_timers = NULL;
+    sched_ready = 1;
+    sched_get_stats(NULL, 1);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t sched_now(void)
+{
+    return MXC_WUT_GetCount();
+}
+/******************************************************************************/
+RAMFUNC int sched_post(sched_fn_t fn, void *arg)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (sched_tail - sched_head >= SCHED_QUEUE_LEN) {
+#if SCHED_STATS
+        sched_stats.overruns++;
+#endif
+        __set_PRIMASK(primask);
+        return E_OVERFLOW;
+    }
+    sched_queue[sched_tail & (SCHED_QUEUE_LEN - 1)].fn = fn;
+    sched_queue[sched_tail & (SCHED_QUEUE_LEN - 1)].arg = arg;
+    sched_tail++;
+    __set_PRIMASK(primask);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+RAMFUNC int sched_post_reserved(sched_fn_t fn, void *arg)
+{
+    int err = E_NO_ERROR;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (sched_tail - sched_head < SCHED_QUEUE_LEN) {
+        sched_queue[sched_tail & (SCHED_QUEUE_LEN - 1)].fn = fn;
+        sched_queue[sched_tail & (SCHED_QUEUE_LEN - 1)].arg = arg;
+        sched_tail++;
+    } else if (sched_reserved.fn == NULL) {
+        sched_reserved.fn = fn;
+        sched_reserved.arg = arg;
+    } else {
+        err = E_BUSY;
+    }
+    __set_PRIMASK(primask);
+    return err;
+}
+/******************************************************************************/
+void sched_timer_stop(sched_timer_t *t)
+{
+    for (sched_timer_t **p = &sched_timers; *p != NULL; p = &(*p)->next) {
+        if (*p == t) {
+            *p = t->next;
+            break;
+        }
+    }
+    t->active = 0;
+}
+/******************************************************************************/
+void sched_timer_start(sched_timer_t *t, uint32_t delay, uint32_t period, sched_fn_t fn,
+                       void *arg)
+{
+    sched_timer_stop(t);
+    t->fn = fn;
+    t->arg = arg;
+    t->due = sched_now() + delay;
+    t->period = period;
+    t->active = 1;
+    t->next = sched_timers;
+    sched_timers = t;
+}
+/******************************************************************************/
+// Queues the work item of a watched pin, from the GPIO interrupt
+static RAMFUNC void sched_gpio_isr(void *cbdata)
+{
+    sched_gpio_t *ev = cbdata;
+    sched_post(ev->fn, ev->arg);
+}
+/******************************************************************************/
+int sched_gpio_event(mxc_gpio_regs_t *port, uint32_t mask, sched_fn_t fn, void *arg)
+{
+    static void (*const irqs[SCHED_GPIO_PORTS])(void) = { sched_gpio0_irq, sched_gpio1_irq,
+                                                           sched_gpio2_irq };
+    int idx = MXC_GPIO_GET_IDX(port);
+    if (idx < 0 || idx >= SCHED_GPIO_PORTS) {
+        return E_BAD_PARAM;
+    }
+    if (sched_gpio_count >= SCHED_GPIO_EVENTS) {
+        return E_NONE_AVAIL;
+    }
+    sched_gpio_t *ev = &sched_gpio[sched_gpio_count++];
+    ev->fn = fn;
+    ev->arg = arg;
+    ev->port = port;
+    ev->mask = mask;
+
+    mxc_gpio_cfg_t cfg = { port, mask, MXC_GPIO_FUNC_IN, MXC_GPIO_PAD_NONE, MXC_GPIO_VSSEL_VDDIO,
+                           MXC_GPIO_DRVSTR_0 };
+    MXC_GPIO_Config(&cfg);
+    MXC_GPIO_RegisterCallback(&cfg, sched_gpio_isr, ev);
+    MXC_GPIO_IntConfig(&cfg, MXC_GPIO_INT_RISING);
+    MXC_GPIO_ClearFlags(port, mask);
+    MXC_GPIO_EnableInt(port, mask);
+    MXC_NVIC_SetVector(MXC_GPIO_GET_IRQ(idx), irqs[idx]);
+    NVIC_EnableIRQ(MXC_GPIO_GET_IRQ(idx));
+    MXC_LP_EnableGPIOWakeup(&cfg);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int sched_run_once(void)
+{
+    int handled = 0;
+    uint32_t now = sched_now();
+
+    for (sched_timer_t *t = sched_timers, *next; t != NULL; t = next) {
+        next = t->next;
+        if (!t->active || (int32_t)(now - t->due) < 0) {
+            continue;
+        }
+        if (t->period != 0) {
+            t->due += t->period;
+            if ((int32_t)(now - t->due) >= 0) {
+                t->due = now + t->period;   // Fell behind: skip the missed expiries
+            }
+        } else {
+            sched_timer_stop(t);
+        }
+        t->fn(t->arg);
+        handled++;
+#if SCHED_STATS
+        sched_stats.timers++;
+#endif
+    }
+
+    for (;;) {
+        __disable_irq();
+        if (sched_head == sched_tail) {
+            __enable_irq();
+            break;
+        }
+        sched_work_t work = sched_queue[sched_head & (SCHED_QUEUE_LEN - 1)];
+        sched_head++;
+        __enable_irq();
+        work.fn(work.arg);
+        handled++;
+#if SCHED_STATS
+        sched_stats.work++;
+#endif
+    }
+
+    // Posted while the queue was full, so after everything queued before it
+    __disable_irq();
+    sched_work_t work = sched_reserved;
+    sched_reserved.fn = NULL;
+    __enable_irq();
+    if (work.fn != NULL) {
+        work.fn(work.arg);
+        handled++;
+#if SCHED_STATS
+        sched_stats.work++;
+#endif
+    }
+    return handled;
+}
+/******************************************************************************/
+// Sleeps until an interrupt. Called with interrupts masked; WFI still wakes
+// on a pending one, whose handler runs once the caller unmasks.
+static void sched_sleep(void)
+{
+#if SCHED_STATS
+    uint32_t start = sched_now();
+    MXC_LP_EnterSleepMode();
+    sched_stats.asleep += sched_now() - start;
+    sched_stats.wakeups++;
+#else
+    MXC_LP_EnterSleepMode();
+#endif
+}
+/******************************************************************************/
+void sched_idle(void)
+{
+#if OSAL_RTOS
+    if (osal_running()) {
+        // WFI with interrupts masked would stop the other tasks too; give
+        // them the core for a tick and let the RTOS idle task sleep it
+        osal_delay_ms(1);
+        return;
+    }
+#endif
+    __disable_irq();
+    if (sched_head != sched_tail || sched_reserved.fn != NULL) {
+        __enable_irq();
+        return;
+    }
+    uint32_t now = sched_now();
+    sched_timer_t *first = NULL;
+    for (sched_timer_t *t = sched_timers; t != NULL; t = t->next) {
+        if (first == NULL || (int32_t)(t->due - first->due) < 0) {
+            first = t;
+        }
+    }
+    if (first != NULL) {
+        if ((int32_t)(first->due - now) < SCHED_MIN_SLEEP) {
+            __enable_irq();
+            return;
+        }
+        MXC_WUT_SetCompare(first->due);
+    } else {
+        MXC_WUT_SetCompare(now - 1);    // No timer: next match a full wrap away
+    }
+    sched_sleep();
+    __enable_irq();
+}
+/******************************************************************************/
+void sched_run(void)
+{
+    for (;;) {
+        sched_run_once();
+        sched_idle();
+    }
+}
+/******************************************************************************/
+void sched_delay_ms(uint32_t ms)
+{
+    if (!sched_ready) {
+        MXC_Delay(MXC_DELAY_MSEC(ms));
+        return;
+    }
+#if OSAL_RTOS
+    if (osal_running()) {
+        osal_delay_ms(ms);      // Block this task only, the others keep running
+        return;
+    }
+#endif
+    uint32_t due = sched_now() + SCHED_MS(ms);
+    for (;;) {
+        __disable_irq();
+        int32_t wait = (int32_t)(due - sched_now());
+        if (wait <= 0) {
+            __enable_irq();
+            break;
+        }
+        if (wait >= SCHED_MIN_SLEEP) {
+            MXC_WUT_SetCompare(due);
+            sched_sleep();
+        }
+        __enable_irq();     // Run the handler that woke us, then check again
+    }
+}
+/******************************************************************************/
+void sched_get_stats(sched_stats_t *stats, int reset)
+{
+#if SCHED_STATS
+    uint32_t now = sched_now();
+    if (stats != NULL) {
+        *stats = sched_stats;
+        stats->elapsed = now - sched_stats_start;
+    }
+    if (reset) {
+        memset(&sched_stats, 0, sizeof(sched_stats));
+        sched_stats_start = now;
+    }
+#else
+    (void)reset;
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+    }
+#endif
+}
@@ -0,0 +1,179 @@
+/**
+ * @file       stats.h
+ * @brief      Driver performance counters.
+ * @details    The flash, I2C and GPIO drivers count their operations, bytes,
+ *             errors, retries and cycles spent, and the flash driver counts
+ *             erases per page. stats_snapshot() copies the counters and
+ *             stats_pack() turns a snapshot into a compact binary record for
+ *             telemetry. Build with STATS_ENABLE=0 to remove every counter.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __STATS_H__
+#define __STATS_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+#include "mxc_device.h"
+#include "cycles.h"
+
+/***** Definitions *****/
+#ifndef STATS_ENABLE
+#define STATS_ENABLE 1                // 0 compiles every counter out of the drivers
+#endif
+
+#define STATS_FLASH_PAGES (MXC_FLASH_MEM_SIZE / MXC_FLASH_PAGE_SIZE)
+#define STATS_RECORD_MAGIC 0x53       // 'S', first byte of a packed record
+#define STATS_RECORD_VERSION 1
+#define STATS_OP_RECORD_SIZE 24       // Packed bytes per operation
+#define STATS_HEADER_SIZE 8           // Packed bytes before the operations
+#define STATS_RECORD_SIZE \
+    (STATS_HEADER_SIZE + STATS_OP_COUNT * STATS_OP_RECORD_SIZE + STATS_FLASH_PAGES * 2)
+
+/*
+ * Packed record layout, little endian:
+ *   uint8_t  magic         STATS_RECORD_MAGIC
+ *   uint8_t  version       STATS_RECORD_VERSION
+ *   uint8_t  nops          number of operation entries
+ *   uint8_t  npages        number of page erase counters
+ *   uint32_t timestamp     DWT cycle count when the snapshot was taken
+ *   nops times:
+ *     uint32_t count       operations
+ *     uint32_t bytes       bytes moved
+ *     uint16_t errors      operations that failed
+ *     uint16_t retries     retried operations
+ *     uint32_t max_cycles  longest operation
+ *     uint64_t cycles      total cycles
+ *   npages times:
+ *     uint16_t erases      erase count of the page
+ */
+
+/**
+ * @brief      Instrumented driver operations.
+ */
+typedef enum {
+    STATS_FLASH_READ = 0,
+    STATS_FLASH_WRITE,
+    STATS_FLASH_ERASE,
+    STATS_I2C_WRITE,
+    STATS_I2C_READ,
+    STATS_GPIO_SET,
+    STATS_GPIO_GET,
+    STATS_QSPI_READ,
+    STATS_QSPI_PROGRAM,
+    STATS_QSPI_ERASE,
+    STATS_SPI_XFER,
+    STATS_OP_COUNT
+} stats_op_id_t;
+
+/**
+ * @brief      Counters of one operation.
+ */
+typedef struct {
+    uint32_t count;         // Number of operations
+    uint32_t bytes;         // Bytes moved
+    uint16_t errors;        // Operations that returned an error, saturates
+    uint16_t retries;       // Operations that were retried, saturates
+    uint32_t max_cycles;    // Longest operation
+    uint64_t cycles;        // Total cycles spent
+} stats_op_t;
+
+/**
+ * @brief      All driver counters.
+ */
+typedef struct {
+    uint32_t timestamp;                         // Cycle count when the snapshot was taken
+    stats_op_t op[STATS_OP_COUNT];              // Indexed by stats_op_id_t
+    uint16_t page_erases[STATS_FLASH_PAGES];    // Erases per main flash page, saturates
+} stats_t;
+
+#if STATS_ENABLE
+/**
+ * @brief      Starts timing an operation. Place at the top of the function.
+ */
+#define STATS_BEGIN() const uint32_t stats_start = cycles_now()
+/**
+ * @brief      Counts a finished operation started with STATS_BEGIN().
+ * @param      id     Operation, stats_op_id_t.
+ * @param      bytes  Bytes moved.
+ * @param      err    Result of the operation, non-zero counts as an error.
+ */
+#define STATS_END(id, bytes, err) stats_record((id), (bytes), (err), cycles_now() - stats_start)
+/**
+ * @brief      Counts a retry of an operation.
+ */
+#define STATS_RETRY(id) stats_retry(id)
+/**
+ * @brief      Counts an erase of the flash page holding an address.
+ */
+#define STATS_PAGE_ERASE(addr) stats_page_erase(addr)
+#else
+#define STATS_BEGIN()
+#define STATS_END(id, bytes, err) ((void)(bytes))
+#define STATS_RETRY(id) ((void)0)
+#define STATS_PAGE_ERASE(addr) ((void)0)
+#endif
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Adds one operation to the counters. Called by STATS_END().
+ * @param      id       Operation.
+ * @param      bytes    Bytes moved.
+ * @param      err      Result of the operation, non-zero counts as an error.
+ * @param      cycles   Cycles the operation took.
+ */
+void stats_record(stats_op_id_t id, uint32_t bytes, int err, uint32_t cycles);
+/**
+ * @brief      Counts a retry of an operation. Called by STATS_RETRY().
+ * @param      id       Operation.
+ */
+void stats_retry(stats_op_id_t id);
+/**
+ * @brief      Counts an erase of the main flash page holding an address.
+ * @param      addr     Bus address in the page. Addresses outside the main
+ *                      array are ignored.
+ */
+void stats_page_erase(uint32_t addr);
+/**
+ * @brief      Copies every counter at one point in time.
+ * @param      snap     Receives the counters.
+ * @param      reset    Non-zero to clear the counters after copying them.
+ */
+void stats_snapshot(stats_t *snap, int reset);
+/**
+ * @brief      Clears every counter.
+ */
+void stats_reset(void);
+/**
+ * @brief      Packs a snapshot into the binary record described above.
+ * @param      snap     Snapshot to pack.
+ * @param      buf      Output buffer.
+ * @param      len      Size of the output buffer.
+ * @return     Number of bytes written, STATS_RECORD_SIZE, or 0 if the buffer
+ *             is too small.
+ */
+size_t stats_pack(const stats_t *snap, uint8_t *buf, size_t len);
+
+#endif
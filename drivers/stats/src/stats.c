@@ -0,0 +1,119 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "stats.h"
+
+/***** Globals *****/
+static stats_t stats;   // Live counters, timestamp is set by stats_snapshot()
+
+/***** Functions *****/
+// Adds one to a 16-bit counter without wrapping
+static inline void stats_inc16(uint16_t *counter)
+{
+    if (*counter != UINT16_MAX) {
+        (*counter)++;
+    }
+}
+/******************************************************************************/
+void stats_record(stats_op_id_t id, uint32_t bytes, int err, uint32_t cycles)
+{
+    stats_op_t *op = &stats.op[id];
+    op->count++;
+    op->bytes += bytes;
+    op->cycles += cycles;
+    if (cycles > op->max_cycles) {
+        op->max_cycles = cycles;
+    }
+    if (err != 0) {
+        stats_inc16(&op->errors);
+    }
+}
+/******************************************************************************/
+void stats_retry(stats_op_id_t id)
+{
+    stats_inc16(&stats.op[id].retries);
+}
+/******************************************************************************/
+void stats_page_erase(uint32_t addr)
+{
+    if (addr >= MXC_FLASH_MEM_BASE && addr < MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE) {
+        stats_inc16(&stats.page_erases[(addr - MXC_FLASH_MEM_BASE) / MXC_FLASH_PAGE_SIZE]);
+    }
+}
+/******************************************************************************/
+void stats_snapshot(stats_t *snap, int reset)
+{
+    // Copy with interrupts off so the snapshot is consistent
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memcpy(snap, &stats, sizeof(stats_t));
+    snap->timestamp = cycles_now();
+    if (reset) {
+        memset(&stats, 0, sizeof(stats_t));
+    }
+    __set_PRIMASK(primask);
+}
+/******************************************************************************/
+void stats_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(&stats, 0, sizeof(stats_t));
+    __set_PRIMASK(primask);
+}
+/******************************************************************************/
+// Stores a value of size bytes little endian and returns the next position
+static uint8_t *stats_put(uint8_t *p, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++) {
+        *p++ = (uint8_t)(value >> (8 * i));
+    }
+    return p;
+}
+/******************************************************************************/
+size_t stats_pack(const stats_t *snap, uint8_t *buf, size_t len)
+{
+    if (len < STATS_RECORD_SIZE) {
+        return 0;
+    }
+    uint8_t *p = buf;
+    *p++ = STATS_RECORD_MAGIC;
+    *p++ = STATS_RECORD_VERSION;
+    *p++ = STATS_OP_COUNT;
+    *p++ = STATS_FLASH_PAGES;
+    p = stats_put(p, snap->timestamp, 4);
+
+    for (int i = 0; i < STATS_OP_COUNT; i++) {
+        const stats_op_t *op = &snap->op[i];
+        p = stats_put(p, op->count, 4);
+        p = stats_put(p, op->bytes, 4);
+        p = stats_put(p, op->errors, 2);
+        p = stats_put(p, op->retries, 2);
+        p = stats_put(p, op->max_cycles, 4);
+        p = stats_put(p, op->cycles, 8);
+    }
+    for (int i = 0; i < STATS_FLASH_PAGES; i++) {
+        p = stats_put(p, snap->page_erases[i], 2);
+    }
+    return (size_t)(p - buf);
+}
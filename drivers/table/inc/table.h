@@ -0,0 +1,96 @@
+/**
+ * @file       table.h
+ * @brief      Constant lookup tables with a minimal perfect hash.
+ * @details    tools/table_gen.py turns a JSON spec into a table of fixed size
+ *             records and a small displacement array, both const and so
+ *             linked into flash, and a header with a typed lookup function.
+ *             table_lookup() reads them in place: the key's hash picks a
+ *             displacement, the displaced hash picks the one record that can
+ *             hold the key, and a compare of the stored key tells a hit from
+ *             a miss. Records are a power of two in size and aligned to it,
+ *             so one of up to 16 bytes sits in a single flash line.
+ *
+ *             The build generates a table for every tables/<name>.json of a
+ *             driver or test module into build/tables, see the Makefile.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __TABLE_H__
+#define __TABLE_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+
+/***** Definitions *****/
+/**
+ * @brief      Generated table. Every record starts with its uint32_t key,
+ *             the value follows at offset 4.
+ */
+typedef struct {
+    uint32_t seed;              // Hash seed the generator settled on
+    uint32_t count;             // Records, one per slot
+    uint32_t buckets;           // Displacement entries
+    uint32_t record_size;       // Bytes per record, a power of two
+    const uint16_t *disp;       // Displacement of each bucket
+    const void *records;        // Records in slot order
+} table_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      MurmurHash3 finalizer, the hash of the tables.
+ */
+static inline uint32_t table_hash(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+/**
+ * @brief      Maps a hash to [0, n) with a multiply instead of a division.
+ */
+static inline uint32_t table_reduce(uint32_t h, uint32_t n)
+{
+    return (uint32_t)(((uint64_t)h * n) >> 32);
+}
+/**
+ * @brief      Looks up a key.
+ * @param      t        Table, e.g. &<name>_table from the generated header.
+ * @param      key      Key.
+ * @return     The value of the key's record, NULL if the table does not hold
+ *             the key. The lookup reads under Flash_ReadLock(); a caller
+ *             that reads the value while other tasks erase or write the
+ *             flash takes the lock around that read as well.
+ */
+const void *table_lookup(const table_t *t, uint32_t key);
+/**
+ * @brief      Returns the key of a string, the FNV-1a hash the generator uses
+ *             for string keys.
+ */
+uint32_t table_key_str(const char *s);
+
+#endif
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "table.h"
+#include "flash.h"
+
+/***** Functions *****/
+const void *table_lookup(const table_t *t, uint32_t key)
+{
+    if (t->count == 0) {
+        return NULL;
+    }
+    uint32_t h = table_hash(key ^ t->seed);
+    Flash_ReadLock();
+    uint32_t d = t->disp[table_reduce(h, t->buckets)];
+    uint32_t slot = table_reduce(table_hash(h ^ d), t->count);
+    const uint32_t *record =
+        (const uint32_t *)((const uint8_t *)t->records + slot * t->record_size);
+    uint32_t stored = *record;
+    Flash_ReadUnlock();
+    return (stored == key) ? record + 1 : NULL;
+}
+/******************************************************************************/
+uint32_t table_key_str(const char *s)
+{
+    uint32_t h = 0x811C9DC5UL;
+    while (*s != '\0') {
+        h = (h ^ (uint8_t)*s++) * 0x01000193UL;
+    }
+    return h;
+}
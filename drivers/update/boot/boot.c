@@ -0,0 +1,88 @@
+/**
+ * @file        boot.c
+ * @brief       Boot stage
+ * @details	Runs from the first flash page at every reset. Copies an
+ *		update the application asked to install over the application,
+ *		continuing a copy a reset cut off, then starts the application
+ *		linked at FLASH_APP_BASE. Build with "make BOOT=1", see project.mk.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdint.h>
+#include "update.h"
+#include "flc.h"
+#include "icc.h"
+
+/***** Definitions *****/
+// The first two words of a vector table
+typedef struct {
+	uint32_t sp;			// Initial stack pointer
+	void (*reset)(void);		// Reset handler
+} boot_vectors_t;
+
+#define BOOT_APP ((const boot_vectors_t *)FLASH_APP_BASE)
+
+/***** Functions *****/
+// An erased or half programmed application fails this, a real one passes
+static int boot_app_valid(void)
+{
+	uint32_t sp = BOOT_APP->sp;
+	uint32_t pc = (uint32_t)(uintptr_t)BOOT_APP->reset;
+
+	return sp > MXC_SRAM_MEM_BASE && sp <= MXC_SRAM_MEM_BASE + MXC_SRAM_MEM_SIZE &&
+	       pc >= FLASH_APP_BASE && pc < FLASH_APP_BASE + FLASH_APP_SIZE;
+}
+/******************************************************************************/
+// Enters the application as the core would out of reset. The boot stage
+// enables no interrupt, so none can arrive before the application sets up
+// its own vector table.
+static void boot_start_app(void)
+{
+	void (*reset)(void) = BOOT_APP->reset;
+
+	SCB->VTOR = FLASH_APP_BASE;
+	__set_MSP(BOOT_APP->sp);
+	__DSB();
+	__ISB();
+	reset();
+}
+/******************************************************************************/
+int main(void)
+{
+	// A copy that fails is tried again from the start of the boot stage
+	// rather than starting a half written application
+	if (update_boot() != E_NO_ERROR) {
+		NVIC_SystemReset();
+	}
+	MXC_FLC_BlockPageWrite(FLASH_BOOT_BASE);	//No erase or write until the next reset
+	MXC_ICC_Flush();				//Drop lines cached from the old image
+
+	if (!boot_app_valid()) {
+		while (1) {
+			__WFI();			//Nothing to start, the debugger programs one
+		}
+	}
+	boot_start_app();
+	return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file       update.h
+ * @brief      Firmware update pipeline.
+ * @details    Streams a new application image into the staging region of
+ *             the internal flash, checksumming every 128-bit line as it is
+ *             programmed. A journal page records the image and its progress,
+ *             so a download cut off by a reset resumes where it stopped.
+ *
+ *             The verified image is copied over the application by the boot
+ *             stage (drivers/update/boot), which has the first flash page to
+ *             itself and runs before the application at every reset. A reset
+ *             in the middle of the copy restarts the boot stage, which
+ *             continues the copy from the journal.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __UPDATE_H__
+#define __UPDATE_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include "flash.h"
+#include "flash_layout.h"
+#include "crc32.h"
+
+/***** Definitions *****/
+#define UPDATE_LINE 16                  // Bytes programmed at a time, one flash line
+
+#ifndef UPDATE_CHECKPOINT
+#define UPDATE_CHECKPOINT 1024          // Bytes between journal checkpoints, divides a page
+#endif
+
+/* Journal records, one flash line each, appended in order to the journal page */
+#define UPDATE_REC_IMAGE 0x48445055UL       // "UPDH": image size, image CRC
+#define UPDATE_REC_CHECKPOINT 0x43445055UL  // "UPDC": bytes staged, CRC of those bytes
+#define UPDATE_REC_VERIFIED 0x56445055UL    // "UPDV": image size, image CRC
+#define UPDATE_REC_INSTALL 0x49445055UL     // "UPDI": image size, image CRC, copy requested
+#define UPDATE_REC_SWAPPED 0x53445055UL     // "UPDS": application pages replaced so far
+
+#define UPDATE_ERASED 0xFFFFFFFFUL
+
+/* The boot stage copy must not fetch code from the flash it erases; the SDK
+ * linker script copies .flashprog to RAM with the flash controller functions. */
+#ifdef HOST_SIM
+#define UPDATE_RAMFUNC
+#else
+#define UPDATE_RAMFUNC __attribute__((section(".flashprog"), noinline))
+#endif
+
+/**
+ * @brief      One journal record. The check word is ~(magic ^ arg0 ^ arg1), so
+ *             a record torn by a power loss is ignored.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t arg0;
+    uint32_t arg1;
+    uint32_t check;
+} update_record_t;
+
+/**
+ * @brief      What the journal records, see update_journal_scan().
+ */
+typedef struct {
+    uint32_t size;              // Image size, 0 without an image record
+    uint32_t crc;               // Image CRC
+    uint32_t offset;            // Bytes staged at the last checkpoint
+    uint32_t running;           // CRC of those bytes
+    uint32_t want;              // Offset to look up a checkpoint CRC for
+    uint32_t want_crc;          // CRC at want
+    int want_found;             // Non-zero if a checkpoint at want exists
+    int verified;               // Non-zero if the image was verified
+    int install;                // Non-zero if the copy was requested
+    uint32_t swapped;           // Application pages replaced
+    uint32_t next;              // Address of the first blank journal line
+} update_journal_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Starts or resumes the download of an image.
+ *
+ * If the journal describes the same image (size and CRC), the download
+ * resumes at the last checkpoint whose following bytes are still erased,
+ * otherwise at the start of that page, which is erased again. Any other
+ * journal content is discarded and the staging pages the image needs are
+ * erased.
+ *
+ * @param      size     Image size in bytes, at most FLASH_STAGING_SIZE.
+ * @param      crc      CRC-32 of the whole image, see crc32().
+ * @param      offset   Receives the image offset the sender must continue from.
+ * @return     E_NO_ERROR, E_BAD_PARAM, E_BUSY while an interrupted copy over
+ *             the application is unfinished, or a flash error.
+ */
+int update_begin(uint32_t size, uint32_t crc, uint32_t *offset);
+/**
+ * @brief      Programs the next bytes of the image and adds them to the CRC.
+ *             Every line is compared with the flash after programming.
+ * @param      data     Image bytes following the ones already written.
+ * @param      len      Number of bytes, any length.
+ * @return     E_NO_ERROR, E_BAD_STATE if no download is running, E_OVERFLOW
+ *             past the image end, E_FAIL if a line reads back wrong, or a
+ *             flash error.
+ */
+int update_write(const uint8_t *data, uint32_t len);
+/**
+ * @brief      Programs the last partial line, compares the CRC with the one
+ *             given to update_begin() and marks the image verified.
+ * @return     E_NO_ERROR, E_UNDERFLOW if bytes are missing, E_BAD_STATE if
+ *             the CRC does not match (the download is dropped), or a flash error.
+ */
+int update_finish(void);
+/**
+ * @brief      Drops the download or verified image by erasing the journal.
+ * @return     E_NO_ERROR or a flash error.
+ */
+int update_abort(void);
+/**
+ * @brief      Returns non-zero if a verified image waits to be copied.
+ */
+int update_pending(void);
+/**
+ * @brief      Installs the verified image. Checks the staging copy against
+ *             the image CRC (crc32_flash()), records the install request in
+ *             the journal and resets into the boot stage, which copies the
+ *             image over the application with update_boot() and starts it.
+ *             An image that no longer matches is dropped.
+ *
+ * On the host there is no reset: update_boot() runs in its place and its
+ * result is returned.
+ *
+ * @return     E_BAD_STATE if no verified image is pending or it fails the
+ *             check, or a flash error. Does not return on the target otherwise.
+ */
+int update_swap(void);
+/**
+ * @brief      Copies an image update_swap() asked to install over the
+ *             application, one page at a time with a journal record per
+ *             page, then erases the journal.
+ *
+ * Called by the boot stage at every reset, before the application starts. A
+ * copy a reset cut off continues with the first page not yet recorded. Runs
+ * with interrupts masked and calls nothing but the SDK flash controller
+ * functions.
+ *
+ * @return     E_NO_ERROR if no install was requested or the copy finished,
+ *             or a flash error.
+ */
+int update_boot(void);
+/**
+ * @brief      Reads the journal. The first blank line ends it; records
+ *             failing their check word are skipped.
+ * @param      j        Receives the journal state. Set want first to look up
+ *                      the checkpoint at that image offset.
+ */
+void update_journal_scan(update_journal_t *j);
+/**
+ * @brief      Appends a record to the journal.
+ * @param      next     Address of the first blank journal line, advanced past
+ *                      the record even if programming it failed.
+ * @return     E_NO_ERROR, E_OVERFLOW if the journal page is full, or a flash error.
+ */
+int update_journal_append(uint32_t *next, uint32_t magic, uint32_t arg0, uint32_t arg1);
+
+#endif
@@ -0,0 +1,265 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "update.h"
+
+/***** Definitions *****/
+#if (MXC_FLASH_PAGE_SIZE % UPDATE_CHECKPOINT) != 0 || (UPDATE_CHECKPOINT % UPDATE_LINE) != 0
+#error "UPDATE_CHECKPOINT must divide the page size and be a multiple of the line size"
+#endif
+
+/***** Globals *****/
+static struct {
+    int active;                 // A download is running
+    uint32_t size;              // Image size
+    uint32_t crc;               // Expected image CRC
+    uint32_t offset;            // Bytes programmed to staging
+    uint32_t running;           // CRC of the programmed bytes
+    uint32_t journal;           // Address of the next journal record
+    uint32_t fill;              // Bytes waiting in line
+    uint8_t line[UPDATE_LINE];  // Partial line
+} update;
+
+/***** Functions *****/
+// Reads the journal with erases and writes from other tasks held off
+static void update_scan(update_journal_t *j)
+{
+    Flash_ReadLock();
+    update_journal_scan(j);
+    Flash_ReadUnlock();
+}
+/******************************************************************************/
+// Checks that len bytes at addr are erased
+static int update_erased(uint32_t addr, uint32_t len)
+{
+    const uint32_t *word = (const uint32_t *)(uintptr_t)addr;
+    int erased = 1;
+
+    Flash_ReadLock();
+    for (uint32_t i = 0; i < len / sizeof(uint32_t) && erased; i++) {
+        erased = (word[i] == UPDATE_ERASED);
+    }
+    Flash_ReadUnlock();
+    return erased;
+}
+/******************************************************************************/
+// Picks the resume point of a download the journal describes. A checkpoint is
+// only good if the bytes after it are still erased, otherwise the page it
+// lies in is erased and restarted.
+static int update_resume(update_journal_t *j)
+{
+    uint32_t page = j->offset - j->offset % MXC_FLASH_PAGE_SIZE;
+    uint32_t end = page + MXC_FLASH_PAGE_SIZE;
+
+    if (j->offset >= j->size || update_erased(FLASH_STAGING_BASE + j->offset, end - j->offset)) {
+        return E_NO_ERROR;
+    }
+    j->want = page;
+    update_scan(j);
+    if (!j->want_found) {
+        return E_BAD_STATE;
+    }
+    j->offset = page;
+    j->running = j->want_crc;
+    return Flash_PageErase(FLASH_STAGING_BASE + page);
+}
+/******************************************************************************/
+int update_begin(uint32_t size, uint32_t crc, uint32_t *offset)
+{
+    update_journal_t j;
+    int err;
+
+    if (size == 0 || size > FLASH_STAGING_SIZE) {
+        return E_BAD_PARAM;
+    }
+    update.active = 0;
+    j.want = 0;
+    update_scan(&j);
+    if (j.install) {
+        return E_BUSY;      // Waiting for the boot stage to copy it over the application
+    }
+
+    if (j.size == size && j.crc == crc) {
+        if (j.verified) {
+            j.offset = size;
+            j.running = crc;
+        } else if ((err = update_resume(&j)) != E_NO_ERROR) {
+            return err;
+        }
+    } else {
+        // A different image: start from scratch
+        if ((err = Flash_PageErase(FLASH_JOURNAL_BASE)) != E_NO_ERROR) {
+            return err;
+        }
+        for (uint32_t page = 0; page < size; page += MXC_FLASH_PAGE_SIZE) {
+            if ((err = Flash_PageErase(FLASH_STAGING_BASE + page)) != E_NO_ERROR) {
+                return err;
+            }
+        }
+        j.next = FLASH_JOURNAL_BASE;
+        if ((err = update_journal_append(&j.next, UPDATE_REC_IMAGE, size, crc)) != E_NO_ERROR) {
+            return err;
+        }
+        j.offset = 0;
+        j.running = 0;
+    }
+
+    update.size = size;
+    update.crc = crc;
+    update.offset = j.offset;
+    update.running = j.running;
+    update.journal = j.next;
+    update.fill = 0;
+    update.active = 1;
+    *offset = (j.offset < size) ? j.offset : size;   // The last line may be padded
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Programs the buffered line, checks it and folds count bytes of it into the CRC
+static int update_flush(uint32_t count)
+{
+    uint32_t addr = FLASH_STAGING_BASE + update.offset;
+    int err = Flash_WriteBuffer(addr, update.line, UPDATE_LINE);
+    if (err != E_NO_ERROR) {
+        return err;
+    }
+    Flash_ReadLock();
+    err = memcmp((const void *)(uintptr_t)addr, update.line, UPDATE_LINE);
+    Flash_ReadUnlock();
+    if (err != 0) {
+        return E_FAIL;
+    }
+    update.running = crc32(update.running, update.line, count);
+    update.offset += UPDATE_LINE;
+    update.fill = 0;
+
+    if (update.offset % UPDATE_CHECKPOINT == 0) {
+        return update_journal_append(&update.journal, UPDATE_REC_CHECKPOINT, update.offset,
+                             update.running);
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int update_write(const uint8_t *data, uint32_t len)
+{
+    if (!update.active) {
+        return E_BAD_STATE;
+    }
+    uint32_t done = update.offset + update.fill;
+    if (done > update.size || len > update.size - done) {
+        return E_OVERFLOW;
+    }
+    while (len > 0) {
+        uint32_t n = UPDATE_LINE - update.fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(update.line + update.fill, data, n);
+        update.fill += n;
+        data += n;
+        len -= n;
+        if (update.fill == UPDATE_LINE) {
+            int err = update_flush(UPDATE_LINE);
+            if (err != E_NO_ERROR) {
+                update.active = 0;
+                return err;
+            }
+        }
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int update_finish(void)
+{
+    int err;
+
+    if (!update.active) {
+        return E_BAD_STATE;
+    }
+    if (update.offset + update.fill < update.size) {
+        return E_UNDERFLOW;
+    }
+    if (update.fill != 0) {
+        uint32_t count = update.fill;
+        memset(update.line + count, 0xFF, UPDATE_LINE - count);
+        if ((err = update_flush(count)) != E_NO_ERROR) {
+            update.active = 0;
+            return err;
+        }
+    }
+    update.active = 0;
+
+    if (update.running != update.crc) {
+        update_abort();
+        return E_BAD_STATE;
+    }
+    return update_journal_append(&update.journal, UPDATE_REC_VERIFIED, update.size, update.crc);
+}
+/******************************************************************************/
+int update_abort(void)
+{
+    update.active = 0;
+    return Flash_PageErase(FLASH_JOURNAL_BASE);
+}
+/******************************************************************************/
+int update_pending(void)
+{
+    update_journal_t j;
+    j.want = 0;
+    update_scan(&j);
+    return j.verified;
+}
+/******************************************************************************/
+int update_swap(void)
+{
+    update_journal_t j;
+    int err;
+
+    j.want = 0;
+    update_scan(&j);
+    if (!j.verified) {
+        return E_BAD_STATE;
+    }
+    // The staging copy is what the boot stage installs, so check it has not
+    // decayed since the download
+    uint32_t crc = 0;
+    if (!j.install) {
+        if ((err = crc32_flash(FLASH_STAGING_BASE, j.size, &crc)) != E_NO_ERROR) {
+            return err;
+        }
+        if (crc != j.crc) {
+            update_abort();
+            return E_BAD_STATE;
+        }
+        if ((err = update_journal_append(&j.next, UPDATE_REC_INSTALL, j.size, j.crc)) !=
+            E_NO_ERROR) {
+            return err;
+        }
+    }
+#ifdef HOST_SIM
+    return update_boot();   // What the boot stage does after the reset
+#else
+    NVIC_SystemReset();     // The boot stage copies the image and starts it
+    return E_NO_ERROR;
+#endif
+}
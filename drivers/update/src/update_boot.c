@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/*
+ * The journal and the copy over the application. Linked into the application
+ * and into the boot stage, so it calls nothing but the SDK flash controller
+ * functions.
+ */
+
+/***** Includes *****/
+#include "update.h"
+
+/***** Definitions *****/
+// Image, checkpoints, verified mark, install request and one record per
+// copied page must fit
+#if (3 + FLASH_STAGING_SIZE / UPDATE_CHECKPOINT + FLASH_APP_SIZE / MXC_FLASH_PAGE_SIZE) * \
+        UPDATE_LINE > FLASH_JOURNAL_SIZE
+#error "UPDATE_CHECKPOINT is too small for the journal page"
+#endif
+
+/***** Functions *****/
+// Records are appended in order, so the first blank line ends the journal;
+// lines failing the check word were torn and are skipped.
+UPDATE_RAMFUNC void update_journal_scan(update_journal_t *j)
+{
+    j->size = 0;
+    j->crc = 0;
+    j->offset = 0;
+    j->running = 0;
+    j->want_crc = 0;
+    j->want_found = (j->want == 0);
+    j->verified = 0;
+    j->install = 0;
+    j->swapped = 0;
+
+    uint32_t addr;
+    for (addr = FLASH_JOURNAL_BASE; addr < FLASH_JOURNAL_BASE + FLASH_JOURNAL_SIZE;
+         addr += UPDATE_LINE) {
+        const volatile uint32_t *rec = (const volatile uint32_t *)(uintptr_t)addr;
+        uint32_t magic = rec[0], arg0 = rec[1], arg1 = rec[2], check = rec[3];
+
+        if ((magic & arg0 & arg1 & check) == UPDATE_ERASED) {
+            break;
+        }
+        if (check != ~(magic ^ arg0 ^ arg1)) {
+            continue;
+        }
+        if (magic == UPDATE_REC_IMAGE && j->size == 0) {
+            j->size = arg0;
+            j->crc = arg1;
+        } else if (magic == UPDATE_REC_CHECKPOINT && j->size != 0) {
+            j->offset = arg0;
+            j->running = arg1;
+            if (arg0 == j->want) {
+                j->want_crc = arg1;
+                j->want_found = 1;
+            }
+        } else if (magic == UPDATE_REC_VERIFIED && j->size == arg0 && j->crc == arg1) {
+            j->verified = 1;
+        } else if (magic == UPDATE_REC_INSTALL && j->verified) {
+            j->install = 1;
+        } else if (magic == UPDATE_REC_SWAPPED && j->install) {
+            j->swapped = arg0;
+        }
+    }
+    j->next = addr;
+}
+/******************************************************************************/
+UPDATE_RAMFUNC int update_journal_append(uint32_t *next, uint32_t magic, uint32_t arg0,
+                                         uint32_t arg1)
+{
+    uint32_t rec[4] = { magic, arg0, arg1, ~(magic ^ arg0 ^ arg1) };
+
+    if (*next >= FLASH_JOURNAL_BASE + FLASH_JOURNAL_SIZE) {
+        return E_OVERFLOW;
+    }
+    int err = MXC_FLC_Write128(*next, rec);
+    *next += UPDATE_LINE;   // A torn record stays behind and is skipped
+    return err;
+}
+/******************************************************************************/
+// The staging copy was checked by update_swap() before it asked for the
+// install, and the copy leaves it alone, so a resumed copy needs no check
+UPDATE_RAMFUNC int update_boot(void)
+{
+    update_journal_t j;
+    int err = E_NO_ERROR;
+
+    j.want = 0;
+    update_journal_scan(&j);
+    if (!j.install) {
+        return E_NO_ERROR;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t pages = (j.size + MXC_FLASH_PAGE_SIZE - 1) / MXC_FLASH_PAGE_SIZE;
+    for (uint32_t page = j.swapped; page < pages && err == E_NO_ERROR; page++) {
+        uint32_t dst = FLASH_APP_BASE + page * MXC_FLASH_PAGE_SIZE;
+        uint32_t src = FLASH_STAGING_BASE + page * MXC_FLASH_PAGE_SIZE;
+
+        err = MXC_FLC_RevA_PageErase((mxc_flc_reva_regs_t *)MXC_FLC0, dst);
+        for (uint32_t off = 0; off < MXC_FLASH_PAGE_SIZE && err == E_NO_ERROR;
+             off += UPDATE_LINE) {
+            const volatile uint32_t *from = (const volatile uint32_t *)(uintptr_t)(src + off);
+            uint32_t line[4] = { from[0], from[1], from[2], from[3] };
+            if ((line[0] & line[1] & line[2] & line[3]) != UPDATE_ERASED) {
+                err = MXC_FLC_Write128(dst + off, line);
+            }
+        }
+        if (err == E_NO_ERROR) {
+            err = update_journal_append(&j.next, UPDATE_REC_SWAPPED, page + 1, 0);
+        }
+    }
+    if (err == E_NO_ERROR) {
+        err = MXC_FLC_RevA_PageErase((mxc_flc_reva_regs_t *)MXC_FLC0, FLASH_JOURNAL_BASE);
+    }
+    __set_PRIMASK(primask);
+    return err;
+}
@@ -1,7 +1,7 @@
 /**
  * @file        main.c
  * @brief       Testing the drivers Example
- * @details	Testing the drivers by calling test functions
+ * @details	Testing the drivers by running the registered test cases
  */
 
 /******************************************************************************
@@ -29,14 +29,117 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
-#include "gpio_test.h"
-#include "flash_test.h"
-#include "i2c_test.h"
+#include "test_runner.h"
+#include "log.h"
+#include "update.h"
+#include "ramfunc.h"
+#include "blackbox.h"
+#include "memstat.h"
+#include "mailbox.h"
+#include "i2c1.h"
+#include "imu_window.h"
+#include "sched.h"
+#include "osal.h"
+
+/***** Definitions *****/
+#ifndef TEST_FILTER
+// Every module but blockdev and qspi, whose cases erase the storage region and the external flash
+#define TEST_FILTER "gpio,flash,i2c,spi,imu,mailbox,crc,table,log,stats,blackbox,bustrace,sched,coop,osal,pool,dsp,memstat,update"
+#endif
+
+#ifndef TEST_REPEAT
+#define TEST_REPEAT 1		// Run each test case once
+#endif
+
+#if MAILBOX_RISCV
+#ifdef __riscv
+int main(void)
+{
+	i2c_init();				//The BMI160 bus belongs to this core now
+	mailbox_set_doorbell(mailbox_ring_arm);
+	mailbox_acq_run(mailbox_shared(), 0);	//Sample forever, the Arm core drains the frames
+	return 0;
+}
+#else
+static mailbox_t mailbox_ring;			//Frames from the RISC-V core
+
+static void mailbox_infer(const imu_window_t *win, uint32_t seq, void *ctx)
+{
+	(void)ctx;
+	//The CNN model plugs in here, for now report the window
+	LOG_INFO("IMU window %u, gyro X %d accel Z %d", seq, win->data[0][IMU_WINDOW_LEN - 1],
+		 win->data[5][IMU_WINDOW_LEN - 1]);
+}
+
+static void mailbox_drain(void *arg)
+{
+	(void)arg;
+	mailbox_acq_drain(&mailbox_ring);	//Into the IMU windows
+	imu_window_poll();			//Hand a completed window to inference, freeing its buffer
+}
+
+static void mailbox_doorbell_irq(void)
+{
+	mailbox_doorbell_ack();
+	//The doorbell only rings again once the ring is empty, so the drain must not be lost
+	sched_post_reserved(mailbox_drain, NULL);
+}
+#endif
+#endif
+
+#if !(MAILBOX_RISCV && defined(__riscv))
+static sched_timer_t log_timer;			//Streams the log ring out while idle
+
+static void log_drain_work(void *arg)
+{
+	(void)arg;
+	log_drain();
+#if MAILBOX_RISCV
+	mailbox_drain(NULL);			//In case the doorbell work was refused, with the extra slot taken too
+#endif
+}
+#endif
+
+#if !(MAILBOX_RISCV && defined(__riscv))
+static void main_run(void *arg)
+{
+	(void)arg;
+	test_run(TEST_FILTER, TEST_REPEAT);	//Run the test cases TEST_FILTER selects, see project.mk
+	log_drain();
+	memstat_report();			//Stack, pool and heap high-water marks of the run
+	sched_init();				//Drop the timers the test cases left behind
+	sched_timer_start(&log_timer, SCHED_MS(LOG_DRAIN_MS), SCHED_MS(LOG_DRAIN_MS),
+			  log_drain_work, NULL);
+#if MAILBOX_RISCV
+	imu_window_init(mailbox_infer, NULL);	//Fresh windows, whatever the test cases left
+	mailbox_start_riscv(&mailbox_ring, mailbox_doorbell_irq);	//BMI160 acquisition moves to the RISC-V core, drained from sched_run()
+#endif
+	sched_run();				//Run queued work and sleep in between, never returns
+}
 
 int main(void)
 {
-	test_gpio();	//Function to test GPIO drivers
-	test_flash();	//Function to test Flash drivers
-	test_i2c();    //Function to test I2c drivers
+	memstat_stack_paint();			//Mark the unused stack for the high-water mark
+	ramfunc_init();				//Copy the SRAM resident code before it runs
+	blackbox_init();			//Keep the event ring of the last run if it survived
+	log_init(NULL);				//Binary log records go to the console UART
+	if (blackbox_saved() != NULL) {
+		LOG_WARN("Crash dump in flash, cause %d", blackbox_saved()->cause);	//Read with tools/blackbox_decode.py
+	}
+	crc32_init();				//Hardware CRC for the image check
+	sched_init();				//Wakeup timer time base, sched_delay_ms() sleeps from here on
+	if (update_pending()) {
+		update_swap();			//Install a downloaded image, resets into the boot stage
+	}
+#if OSAL_RTOS
+	//The test cases and the scheduler loop run as a task, so the drivers
+	//take their locks and sleep on their semaphores instead of polling
+	if (osal_task_create(main_run, NULL, "main") == E_NO_ERROR) {
+		osal_start();			//Never returns unless the idle task cannot be created
+	}
+	LOG_ERROR("RTOS did not start, running bare-metal");
+#endif
+	main_run(NULL);				//Never returns
 	return 0;
 }
+#endif
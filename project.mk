@@ -25,4 +25,224 @@ ifeq ($(BOARD),CAM02_RevA)
 $(error ERR_NOTSUPPORTED: This project is not supported for the CAM02 board)
 endif
 
+# RISC-V image of MAILBOX_RISCV, which the SDK builds from this project with
+# RISCV_CORE=1.  It only samples the BMI160 into the mailbox, so it gets its
+# own source list and the Arm-only driver parts are switched off: the log
+# ring, black box, counters, bus trace, allocation accounting, SRAM copies and
+# the RTOS.  The linker fragments further down are dropped for it as well.
+ifeq ($(RISCV_CORE),1)
+AUTOSEARCH = 0
+SRCS = main.c mailbox.c mailbox_acq.c i2c.c pool.c
+override LIB_FREERTOS = 0
+override STATS_ENABLE = 0
+override BLACKBOX_ENABLE = 0
+override BUSTRACE_ENABLE = 0
+override MEMSTAT_ENABLE = 0
+override RAMFUNC_ENABLE = 0
+endif
+
+# Test runner selection.  TEST_FILTER is a comma separated list of
+# "subsystem.name" patterns (prefix match, '*' wildcard), e.g.
+# TEST_FILTER=i2c or TEST_FILTER=gpio.test_gpio_toggle.  TEST_REPEAT runs
+# every selected case that many times for soak/perf runs.  The default leaves
+# out the blockdev and qspi cases, which erase the storage region and the
+# external flash; add them (or set TEST_FILTER=) on a board with nothing to
+# keep.  The flash cases only touch the scratch page.
+TEST_FILTER ?= gpio,flash,i2c,spi,imu,mailbox,crc,table,log,stats,blackbox,bustrace,sched,coop,osal,pool,dsp,memstat,update
+TEST_REPEAT ?= 1
+PROJ_CFLAGS += -DTEST_FILTER=\"$(TEST_FILTER)\"
+PROJ_CFLAGS += -DTEST_REPEAT=$(TEST_REPEAT)
+
+# Deferred binary logging (drivers/log).  LOG_LEVEL removes log sites above
+# the given level at compile time (0 error, 1 warn, 2 info, 3 debug) and
+# LOG_BUFFER_SIZE sets the RAM ring buffer size in bytes (power of two) and
+# LOG_DRAIN_MS how often main() streams it out once the test cases are done.
+# log.ld keeps the format strings out of the flash image; decode the output
+# with tools/log_decode.py build/$(PROJECT).elf <capture>.
+LOG_LEVEL ?= 3
+LOG_BUFFER_SIZE ?= 1024
+LOG_DRAIN_MS ?= 100
+PROJ_CFLAGS += -DLOG_LEVEL=$(LOG_LEVEL)
+PROJ_CFLAGS += -DLOG_BUFFER_SIZE=$(LOG_BUFFER_SIZE)
+PROJ_CFLAGS += -DLOG_DRAIN_MS=$(LOG_DRAIN_MS)
+PROJ_LDFLAGS += -Wl,-T,$(abspath drivers/log/log.ld)
+
+# SRAM resident code (drivers/ramfunc).  RAMFUNC_ENABLE = 1 runs the flash
+# program/erase path, the driver interrupt handlers and the GPIO set/get calls
+# from SRAM; 0 leaves them in flash for an A/B comparison.  "make" lists the
+# functions moved and their size after linking (make ramfunc-report).
+RAMFUNC_ENABLE ?= 1
+PROJ_CFLAGS += -DRAMFUNC_ENABLE=$(RAMFUNC_ENABLE)
+PROJ_LDFLAGS += -Wl,-T,$(abspath drivers/ramfunc/ramfunc.ld)
+
+# Crash black box (drivers/blackbox).  BLACKBOX_ENABLE = 0 compiles the driver
+# event hooks out.  BLACKBOX_SIZE is the RAM ring size in bytes (a power of
+# two, 16 bytes per event) and must fit the crash dump page with its header.
+# The ring lives in the NOLOAD section added by blackbox.ld.
+BLACKBOX_ENABLE ?= 1
+BLACKBOX_SIZE ?= 4096
+PROJ_CFLAGS += -DBLACKBOX_ENABLE=$(BLACKBOX_ENABLE)
+PROJ_CFLAGS += -DBLACKBOX_SIZE=$(BLACKBOX_SIZE)
+PROJ_LDFLAGS += -Wl,-T,$(abspath drivers/blackbox/blackbox.ld)
+
+# I2C and flash transaction record (drivers/bustrace).  BUSTRACE_ENABLE = 0
+# compiles the driver hooks out; with it on they cost one test while no
+# trace is running.  Recorded traces replay in the simulator (sim_tests -r).
+BUSTRACE_ENABLE ?= 1
+PROJ_CFLAGS += -DBUSTRACE_ENABLE=$(BUSTRACE_ENABLE)
+
+# Stack and allocation high-water marks (drivers/memstat).  MEMSTAT_ENABLE = 1
+# counts every pool_alloc() call site and, through the linker's --wrap, every
+# malloc() caller; main() paints the stack at boot and prints the report.
+# MEMSTAT_ENABLE = 0 leaves the allocators untouched.
+MEMSTAT_ENABLE ?= 1
+PROJ_CFLAGS += -DMEMSTAT_ENABLE=$(MEMSTAT_ENABLE)
+ifeq ($(MEMSTAT_ENABLE),1)
+PROJ_CFLAGS += -DMEMSTAT_HEAP=1
+PROJ_LDFLAGS += -Wl,--wrap=malloc,--wrap=free
+endif
+
+# RTOS primitives for the drivers (drivers/osal).  With LIB_FREERTOS = 1 the
+# I2C bus, flash and GPIO drivers are safe to call from several tasks: each
+# bus has a mutex and transactions sleep on the completion interrupt.  The
+# FreeRTOSConfig.h of the project needs configSUPPORT_STATIC_ALLOCATION.
+# main() then runs the test cases and the scheduler loop in a task, whose
+# stack (OSAL_TASK_STACK, in words) has to hold the deepest test case.
+ifeq ($(LIB_FREERTOS),1)
+PROJ_CFLAGS += -DOSAL_RTOS=1
+OSAL_TASK_STACK ?= 1024
+PROJ_CFLAGS += -DOSAL_TASK_STACK=$(OSAL_TASK_STACK)
+endif
+
+# Inter-core mailbox (drivers/mailbox).  MAILBOX_RISCV = 1 builds the RISC-V
+# image as well and moves BMI160 acquisition to that core: main() starts it
+# once the test cases are done and the frames arrive in a shared SRAM ring,
+# drained into the IMU windows by a work item the doorbell interrupt queues.
+# From then on the Arm core leaves the I2C bus alone.
+MAILBOX_RISCV ?= 0
+PROJ_CFLAGS += -DMAILBOX_RISCV=$(MAILBOX_RISCV)
+ifeq ($(MAILBOX_RISCV),1)
+RISCV_LOAD = 1
+endif
+
+# Driver performance counters (drivers/stats).  STATS_ENABLE=0 removes the
+# counting from the flash, I2C and GPIO drivers; the snapshot API stays.
+STATS_ENABLE ?= 1
+PROJ_CFLAGS += -DSTATS_ENABLE=$(STATS_ENABLE)
+
+# I2C retry policy (drivers/I2C).  A failed register read or write is
+# repeated up to I2C_RETRIES times, waiting I2C_BACKOFF_US microseconds before
+# the first retry and twice as long before each further one.  A stuck bus is
+# clocked free before the retry.
+I2C_RETRIES ?= 3
+I2C_BACKOFF_US ?= 100
+PROJ_CFLAGS += -DI2C_RETRIES=$(I2C_RETRIES)
+PROJ_CFLAGS += -DI2C_BACKOFF_US=$(I2C_BACKOFF_US)
 
+# I2C target mode (drivers/I2C/i2c_target.c): the 7-bit address the host
+# processor reads results from and the largest result block in bytes (two
+# buffers of it are kept in RAM).
+I2C_TARGET_ADDR ?= 0x3C
+I2C_TARGET_RESULT_MAX ?= 256
+PROJ_CFLAGS += -DI2C_TARGET_ADDR=$(I2C_TARGET_ADDR)
+PROJ_CFLAGS += -DI2C_TARGET_RESULT_MAX=$(I2C_TARGET_RESULT_MAX)
+
+# External flash read cache (drivers/qspi/qspi_cache.c).  RAM use is
+# QSPI_CACHE_SETS * QSPI_CACHE_WAYS * QSPI_CACHE_LINE_SIZE bytes; sets and line
+# size are powers of two.  QSPI_CACHE_READAHEAD lines are fetched ahead of a
+# sequential stream (0 disables read-ahead).
+QSPI_CACHE_SETS ?= 32
+QSPI_CACHE_WAYS ?= 4
+QSPI_CACHE_LINE_SIZE ?= 64
+QSPI_CACHE_READAHEAD ?= 4
+PROJ_CFLAGS += -DQSPI_CACHE_SETS=$(QSPI_CACHE_SETS)
+PROJ_CFLAGS += -DQSPI_CACHE_WAYS=$(QSPI_CACHE_WAYS)
+PROJ_CFLAGS += -DQSPI_CACHE_LINE_SIZE=$(QSPI_CACHE_LINE_SIZE)
+PROJ_CFLAGS += -DQSPI_CACHE_READAHEAD=$(QSPI_CACHE_READAHEAD)
+
+# Internal flash layout (drivers/flash/inc/flash_layout.h): the boot stage
+# page, the application, an equally sized update staging region, one journal
+# page, FLASH_LOG_SIZE bytes for the IMU session log, one black box crash
+# dump page, FLASH_STORAGE_SIZE bytes of storage for blockdev_flc and, last,
+# a scratch page the flash test cases erase.  The application image must fit
+# in FLASH_APP_SIZE.
+FLASH_APP_SIZE ?= 0x30000
+FLASH_LOG_SIZE ?= 0xA000
+FLASH_STORAGE_SIZE ?= 0xE000
+PROJ_CFLAGS += -DFLASH_APP_SIZE=$(FLASH_APP_SIZE)
+PROJ_CFLAGS += -DFLASH_LOG_SIZE=$(FLASH_LOG_SIZE)
+PROJ_CFLAGS += -DFLASH_STORAGE_SIZE=$(FLASH_STORAGE_SIZE)
+
+# Boot stage (drivers/update/boot).  The first flash page holds a boot stage
+# that copies an update the application installs over it, finishing a copy
+# a reset cut off, and then starts the application.  app.ld links the
+# application after that page and fails the link if the image outgrows
+# FLASH_APP_SIZE.  Build the boot stage with "make BOOT=1 BUILD_DIR=build/boot"
+# and program it once, next to the application.
+BOOT ?= 0
+ifeq ($(BOOT),1)
+AUTOSEARCH = 0
+VPATH += drivers/update/boot
+SRCS = boot.c update_boot.c
+PROJECT = boot
+LIB_BOARD = 0
+PROJ_LDFLAGS += -Wl,-T,$(abspath drivers/update/boot/boot.ld)
+else
+PROJ_LDFLAGS += -Wl,-T,$(abspath drivers/update/app.ld)
+PROJ_LDFLAGS += -Wl,--defsym,__flash_app_size=$(FLASH_APP_SIZE)
+endif
+
+# Fixed block memory pools (drivers/pool) that replace heap use in the
+# drivers.  Each class holds POOL_*_COUNT blocks of POOL_*_SIZE bytes; sizes
+# are multiples of 8 and grow from small to large.
+POOL_SMALL_SIZE ?= 32
+POOL_SMALL_COUNT ?= 16
+POOL_MEDIUM_SIZE ?= 128
+POOL_MEDIUM_COUNT ?= 8
+POOL_LARGE_SIZE ?= 512
+POOL_LARGE_COUNT ?= 4
+PROJ_CFLAGS += -DPOOL_SMALL_SIZE=$(POOL_SMALL_SIZE)
+PROJ_CFLAGS += -DPOOL_SMALL_COUNT=$(POOL_SMALL_COUNT)
+PROJ_CFLAGS += -DPOOL_MEDIUM_SIZE=$(POOL_MEDIUM_SIZE)
+PROJ_CFLAGS += -DPOOL_MEDIUM_COUNT=$(POOL_MEDIUM_COUNT)
+PROJ_CFLAGS += -DPOOL_LARGE_SIZE=$(POOL_LARGE_SIZE)
+PROJ_CFLAGS += -DPOOL_LARGE_COUNT=$(POOL_LARGE_COUNT)
+
+# BMI160 windows for the CNN accelerator (drivers/imu).  A window holds
+# IMU_WINDOW_LEN samples and a new one starts every IMU_WINDOW_STRIDE samples;
+# raw gyro and accelerometer values are shifted right by IMU_GYR_SHIFT and
+# IMU_ACC_SHIFT bits to give the int8 inputs.
+IMU_WINDOW_LEN ?= 128
+IMU_WINDOW_STRIDE ?= 64
+IMU_GYR_SHIFT ?= 8
+IMU_ACC_SHIFT ?= 8
+PROJ_CFLAGS += -DIMU_WINDOW_LEN=$(IMU_WINDOW_LEN)
+PROJ_CFLAGS += -DIMU_WINDOW_STRIDE=$(IMU_WINDOW_STRIDE)
+PROJ_CFLAGS += -DIMU_GYR_SHIFT=$(IMU_GYR_SHIFT)
+PROJ_CFLAGS += -DIMU_ACC_SHIFT=$(IMU_ACC_SHIFT)
+
+# IMU preprocessing kernels (drivers/dsp).  Set LIB_CMSIS_DSP = 1 to link
+# CMSIS-DSP as well; the kernels then take q15_t/q31_t from arm_math.h, so
+# their buffers pass straight to CMSIS-DSP functions.
+ifeq ($(LIB_CMSIS_DSP),1)
+PROJ_CFLAGS += -DLIB_CMSIS_DSP
+endif
+
+# Tickless scheduler (drivers/sched).  SCHED_STATS = 1 counts wakeups and
+# sleep time for the duty cycle report; SCHED_QUEUE_LEN work items (a power of
+# two) can wait for the main loop.
+SCHED_STATS ?= 1
+SCHED_QUEUE_LEN ?= 16
+PROJ_CFLAGS += -DSCHED_STATS=$(SCHED_STATS)
+PROJ_CFLAGS += -DSCHED_QUEUE_LEN=$(SCHED_QUEUE_LEN)
+
+# Block devices (drivers/blockdev).  Set LIB_LITTLEFS = 1 to build the SDK's
+# littlefs together with the blockdev_lfs_config() adapter.
+ifeq ($(LIB_LITTLEFS),1)
+PROJ_CFLAGS += -DLIB_LITTLEFS
+endif
+
+# The RISC-V image keeps the SDK's own linker script only.
+ifeq ($(RISCV_CORE),1)
+PROJ_LDFLAGS :=
+endif
@@ -0,0 +1,53 @@
+/**
+ * @file       flc_regs.h
+ * @brief      Host simulator stand-in for the flash controller registers.
+ * @details    The flash array itself is modelled in sim/src/sim_flc.c.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _FLC_REGS_H_
+#define _FLC_REGS_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "max78000.h"
+
+/***** Definitions *****/
+typedef struct {
+    __IO uint32_t addr;
+    __IO uint32_t clkdiv;
+    __IO uint32_t ctrl;
+    __I uint32_t rsv_0xc_0x23[6];
+    __IO uint32_t intr;
+    __I uint32_t rsv_0x28_0x2f[2];
+    __IO uint32_t data[4];
+    __O uint32_t actrl;
+} mxc_flc_regs_t;
+
+extern mxc_flc_regs_t sim_flc0;
+#define MXC_FLC0 (&sim_flc0)
+#define MXC_FLC_GET_FLC(i) ((void)(i), MXC_FLC0)
+
+#endif
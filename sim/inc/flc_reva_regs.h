@@ -0,0 +1,39 @@
+/**
+ * @file       flc_reva_regs.h
+ * @brief      Host simulator stand-in for the RevA flash controller registers.
+ * @details    Same layout as mxc_flc_regs_t.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _FLC_REVA_REGS_H_
+#define _FLC_REVA_REGS_H_
+
+/***** Includes *****/
+#include "flc_regs.h"
+
+/***** Definitions *****/
+typedef mxc_flc_regs_t mxc_flc_reva_regs_t;
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file       gpio.h
+ * @brief      Host simulator stand-in for the MSDK GPIO driver.
+ * @details    Pins are modelled as wires: an output drives the wire, an input reads
+ *             the last driven level or its pull when it was never driven.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _GPIO_H_
+#define _GPIO_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#define MXC_GPIO_PIN_0 ((uint32_t)(1UL << 0))
+#define MXC_GPIO_PIN_1 ((uint32_t)(1UL << 1))
+#define MXC_GPIO_PIN_2 ((uint32_t)(1UL << 2))
+#define MXC_GPIO_PIN_3 ((uint32_t)(1UL << 3))
+#define MXC_GPIO_PIN_4 ((uint32_t)(1UL << 4))
+#define MXC_GPIO_PIN_5 ((uint32_t)(1UL << 5))
+#define MXC_GPIO_PIN_6 ((uint32_t)(1UL << 6))
+#define MXC_GPIO_PIN_7 ((uint32_t)(1UL << 7))
+#define MXC_GPIO_PIN_8 ((uint32_t)(1UL << 8))
+#define MXC_GPIO_PIN_9 ((uint32_t)(1UL << 9))
+#define MXC_GPIO_PIN_16 ((uint32_t)(1UL << 16))
+#define MXC_GPIO_PIN_17 ((uint32_t)(1UL << 17))
+#define MXC_GPIO_PIN_30 ((uint32_t)(1UL << 30))
+#define MXC_GPIO_PIN_31 ((uint32_t)(1UL << 31))
+
+#define SIM_GPIO_PORTS 4
+
+typedef struct {
+    __IO uint32_t out;      // Output data
+    __IO uint32_t outen;    // Output enable
+    __IO uint32_t in;       // Level seen on the pins
+    __IO uint32_t pullup;   // Pull up selected
+    __IO uint32_t driven;   // Pins whose wire has been driven at least once
+    __IO uint32_t inten;    // Interrupt enable
+    __IO uint32_t intfl;    // Interrupt flags
+} mxc_gpio_regs_t;
+
+extern mxc_gpio_regs_t sim_gpio_regs[SIM_GPIO_PORTS];
+#define MXC_GPIO0 (&sim_gpio_regs[0])
+#define MXC_GPIO1 (&sim_gpio_regs[1])
+#define MXC_GPIO2 (&sim_gpio_regs[2])
+#define MXC_GPIO3 (&sim_gpio_regs[3])
+#define MXC_GPIO_GET_GPIO(i) (&sim_gpio_regs[i])
+#define MXC_GPIO_GET_IDX(p) ((int)((p) - sim_gpio_regs))
+#define MXC_GPIO_GET_IRQ(i) ((IRQn_Type)(GPIO0_IRQn + (i)))
+
+typedef enum {
+    MXC_GPIO_FUNC_IN,
+    MXC_GPIO_FUNC_OUT,
+    MXC_GPIO_FUNC_ALT1,
+    MXC_GPIO_FUNC_ALT2,
+    MXC_GPIO_FUNC_ALT3,
+    MXC_GPIO_FUNC_ALT4
+} mxc_gpio_func_t;
+
+typedef enum {
+    MXC_GPIO_PAD_NONE,
+    MXC_GPIO_PAD_PULL_UP,
+    MXC_GPIO_PAD_PULL_DOWN,
+    MXC_GPIO_PAD_WEAK_PULL_UP,
+    MXC_GPIO_PAD_WEAK_PULL_DOWN
+} mxc_gpio_pad_t;
+
+typedef enum { MXC_GPIO_VSSEL_VDDIO, MXC_GPIO_VSSEL_VDDIOH } mxc_gpio_vssel_t;
+
+typedef enum {
+    MXC_GPIO_DRVSTR_0,
+    MXC_GPIO_DRVSTR_1,
+    MXC_GPIO_DRVSTR_2,
+    MXC_GPIO_DRVSTR_3
+} mxc_gpio_drvstr_t;
+
+typedef struct {
+    mxc_gpio_regs_t *port;
+    uint32_t mask;
+    mxc_gpio_func_t func;
+    mxc_gpio_pad_t pad;
+    mxc_gpio_vssel_t vssel;
+    mxc_gpio_drvstr_t drvstr;
+} mxc_gpio_cfg_t;
+
+typedef enum {
+    MXC_GPIO_INT_HIGH,
+    MXC_GPIO_INT_RISING,
+    MXC_GPIO_INT_LOW,
+    MXC_GPIO_INT_FALLING,
+    MXC_GPIO_INT_BOTH
+} mxc_gpio_int_pol_t;
+
+typedef void (*mxc_gpio_callback_fn)(void *cbdata);
+
+/***** Function Prototypes *****/
+int MXC_GPIO_Config(const mxc_gpio_cfg_t *cfg);
+uint32_t MXC_GPIO_InGet(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutSet(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutClr(mxc_gpio_regs_t *port, uint32_t mask);
+uint32_t MXC_GPIO_OutGet(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_OutPut(mxc_gpio_regs_t *port, uint32_t mask, uint32_t val);
+void MXC_GPIO_OutToggle(mxc_gpio_regs_t *port, uint32_t mask);
+int MXC_GPIO_IntConfig(const mxc_gpio_cfg_t *cfg, mxc_gpio_int_pol_t pol);
+void MXC_GPIO_EnableInt(mxc_gpio_regs_t *port, uint32_t mask);
+void MXC_GPIO_DisableInt(mxc_gpio_regs_t *port, uint32_t mask);
+uint32_t MXC_GPIO_GetFlags(mxc_gpio_regs_t *port);
+void MXC_GPIO_ClearFlags(mxc_gpio_regs_t *port, uint32_t flags);
+void MXC_GPIO_RegisterCallback(const mxc_gpio_cfg_t *cfg, mxc_gpio_callback_fn callback,
+                               void *cbdata);
+void MXC_GPIO_Handler(unsigned int port);
+
+#endif
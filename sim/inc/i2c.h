@@ -0,0 +1,121 @@
+/**
+ * @file       i2c.h
+ * @brief      Host simulator stand-in for the MSDK I2C driver.
+ * @details    Transactions are routed to device models attached to the simulated bus.
+ *             Asynchronous transactions end with the I2C interrupt once their
+ *             bus time has passed.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _I2C_H_
+#define _I2C_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#define SIM_I2C_INSTANCES 3
+
+typedef struct {
+    __IO uint32_t ctrl;
+    __IO uint32_t status;
+    __IO uint32_t clkhi;
+    __IO uint32_t clklo;
+    __IO uint32_t intfl0;   // Interrupt flags, set by the model at the end of a transaction
+    __IO uint32_t intfl1;
+} mxc_i2c_regs_t;
+
+#define MXC_F_I2C_INTFL0_DONE ((uint32_t)(1UL << 0))
+#define MXC_F_I2C_INTFL0_STOP ((uint32_t)(1UL << 6))
+#define MXC_F_I2C_INTFL0_ADDR_ACK ((uint32_t)(1UL << 7))
+#define MXC_F_I2C_INTFL0_ARB_ERR ((uint32_t)(1UL << 8))
+#define MXC_F_I2C_INTFL0_TO_ERR ((uint32_t)(1UL << 9))
+#define MXC_F_I2C_INTFL0_ADDR_NACK_ERR ((uint32_t)(1UL << 10))
+#define MXC_F_I2C_INTFL0_DATA_ERR ((uint32_t)(1UL << 11))
+
+extern mxc_i2c_regs_t sim_i2c_regs[SIM_I2C_INSTANCES];
+#define MXC_I2C0 (&sim_i2c_regs[0])
+#define MXC_I2C1 (&sim_i2c_regs[1])
+#define MXC_I2C2 (&sim_i2c_regs[2])
+#define MXC_I2C_GET_IDX(p) ((int)((p) - sim_i2c_regs))
+#define MXC_I2C_GET_IRQ(i) \
+    ((IRQn_Type)((i) == 0 ? I2C0_IRQn : (i) == 1 ? I2C1_IRQn : I2C2_IRQn))
+
+#define MXC_I2C_FIFO_DEPTH 8
+
+#define MXC_I2C_STD_MODE 100000
+#define MXC_I2C_FAST_SPEED 400000
+#define MXC_I2C_FASTPLUS_SPEED 1000000
+
+typedef struct _i2c_req_t mxc_i2c_req_t;
+
+typedef void (*mxc_i2c_complete_cb_t)(mxc_i2c_req_t *req, int result);
+
+typedef enum {
+    MXC_I2C_EVT_MASTER_WR,      // A master addressed the target to write
+    MXC_I2C_EVT_MASTER_RD,      // A master addressed the target to read
+    MXC_I2C_EVT_RX_THRESH,      // The RX FIFO reached its threshold
+    MXC_I2C_EVT_TX_THRESH,      // The TX FIFO fell to its threshold
+    MXC_I2C_EVT_TRANS_COMP,     // STOP, the transaction has ended
+    MXC_I2C_EVT_UNDERFLOW,      // The master read from an empty TX FIFO
+    MXC_I2C_EVT_OVERFLOW        // The master wrote to a full RX FIFO
+} mxc_i2c_slave_event_t;
+
+typedef int (*mxc_i2c_slave_handler_t)(mxc_i2c_regs_t *i2c, mxc_i2c_slave_event_t event,
+                                       void *data);
+
+struct _i2c_req_t {
+    mxc_i2c_regs_t *i2c;
+    uint8_t addr;
+    unsigned char *tx_buf;
+    unsigned int tx_len;
+    unsigned char *rx_buf;
+    unsigned int rx_len;
+    int restart;
+    mxc_i2c_complete_cb_t callback;
+};
+
+/***** Function Prototypes *****/
+int MXC_I2C_Init(mxc_i2c_regs_t *i2c, int masterMode, unsigned int slaveAddr);
+int MXC_I2C_Shutdown(mxc_i2c_regs_t *i2c);
+int MXC_I2C_SetFrequency(mxc_i2c_regs_t *i2c, unsigned int hz);
+unsigned int MXC_I2C_GetFrequency(mxc_i2c_regs_t *i2c);
+int MXC_I2C_MasterTransaction(mxc_i2c_req_t *req);
+int MXC_I2C_MasterTransactionAsync(mxc_i2c_req_t *req);
+void MXC_I2C_AsyncHandler(mxc_i2c_regs_t *i2c);
+void MXC_I2C_GetFlags(mxc_i2c_regs_t *i2c, unsigned int *flags0, unsigned int *flags1);
+void MXC_I2C_ClearFlags(mxc_i2c_regs_t *i2c, unsigned int flags0, unsigned int flags1);
+int MXC_I2C_SlaveTransactionAsync(mxc_i2c_regs_t *i2c, mxc_i2c_slave_handler_t callback);
+int MXC_I2C_SetRXThreshold(mxc_i2c_regs_t *i2c, unsigned int numBytes);
+int MXC_I2C_SetTXThreshold(mxc_i2c_regs_t *i2c, unsigned int numBytes);
+int MXC_I2C_ReadRXFIFO(mxc_i2c_regs_t *i2c, volatile unsigned char *bytes, unsigned int len);
+int MXC_I2C_WriteTXFIFO(mxc_i2c_regs_t *i2c, volatile unsigned char *bytes, unsigned int len);
+int MXC_I2C_GetRXFIFOAvailable(mxc_i2c_regs_t *i2c);
+int MXC_I2C_GetTXFIFOAvailable(mxc_i2c_regs_t *i2c);
+void MXC_I2C_ClearRXFIFO(mxc_i2c_regs_t *i2c);
+void MXC_I2C_ClearTXFIFO(mxc_i2c_regs_t *i2c);
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file       max78000.h
+ * @brief      Host simulator stand-in for the MAX78000 device header.
+ * @details    Memory map, peripheral instances and the CMSIS core pieces used by
+ *             the drivers, backed by the models in sim/src.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _MAX78000_H_
+#define _MAX78000_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "sim.h"
+
+/***** Definitions *****/
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+#define __I volatile const
+#define __O volatile
+#define __IO volatile
+
+/* Memory map */
+#define MXC_FLASH_MEM_BASE 0x10000000UL
+#define MXC_FLASH_PAGE_SIZE 0x00002000UL
+#define MXC_FLASH_MEM_SIZE 0x00080000UL
+#define MXC_INFO_MEM_BASE 0x10800000UL
+#define MXC_INFO_MEM_SIZE 0x00004000UL
+#define MXC_FLC_INSTANCES 1
+
+/* Core clock */
+extern uint32_t SystemCoreClock;
+
+/* CMSIS core: DWT cycle counter and debug control */
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+extern CoreDebug_Type sim_core_debug;
+DWT_Type *sim_dwt(void);
+#define DWT (sim_dwt())    // CYCCNT is refreshed from the simulated clock on every access
+#define CoreDebug (&sim_core_debug)
+
+/* CMSIS core: interrupt masking and barriers. The host build is single threaded;
+ * interrupts of the models run when they are unmasked or the core sleeps. */
+extern uint32_t sim_primask;
+static inline void __disable_irq(void) { sim_primask = 1; }
+static inline void __enable_irq(void)
+{
+    sim_primask = 0;
+    sim_irq_dispatch();
+}
+static inline uint32_t __get_PRIMASK(void) { return sim_primask; }
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    sim_primask = primask;
+    if (primask == 0) {
+        sim_irq_dispatch();
+    }
+}
+static inline void __DSB(void) { __sync_synchronize(); }
+static inline void __DMB(void) { __sync_synchronize(); }
+static inline void __ISB(void) { __sync_synchronize(); }
+static inline void __NOP(void) {}
+static inline void __WFI(void) { sim_wfi(); }
+
+/* Interrupt numbers used by the drivers, as on the MAX78000 */
+typedef enum {
+    I2C0_IRQn = 13,
+    GPIO0_IRQn = 24,
+    GPIO1_IRQn = 25,
+    GPIO2_IRQn = 26,
+    DMA0_IRQn = 28,
+    DMA1_IRQn = 29,
+    DMA2_IRQn = 30,
+    DMA3_IRQn = 31,
+    I2C1_IRQn = 36,
+    WUT_IRQn = 53,
+    I2C2_IRQn = 62
+} IRQn_Type;
+
+#define SIM_IRQ_COUNT 64    // Interrupt lines modelled by the simulated NVIC
+
+void NVIC_EnableIRQ(IRQn_Type irqn);
+void NVIC_DisableIRQ(IRQn_Type irqn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn);
+void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+
+/* Global control registers */
+typedef struct {
+    __IO uint32_t sysctrl;
+    __IO uint32_t rst0;
+    __IO uint32_t clkctrl;
+    __IO uint32_t pm;
+} mxc_gcr_regs_t;
+
+#define MXC_F_GCR_SYSCTRL_ICC0_FLUSH (1UL << 6)
+
+mxc_gcr_regs_t *sim_gcr(void);
+#define MXC_GCR (sim_gcr())     // Self clearing bits are cleared on every access
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * @file       mxc_delay.h
+ * @brief      Host simulator stand-in for the MSDK delay functions.
+ * @details    Delays advance the simulated clock instead of spinning.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _MXC_DELAY_H_
+#define _MXC_DELAY_H_
+
+/***** Includes *****/
+#include <stdint.h>
+
+/***** Definitions *****/
+#define MXC_DELAY_SEC(s) (((uint32_t)(s)) * 1000000UL)
+#define MXC_DELAY_MSEC(ms) ((uint32_t)(ms) * 1000UL)
+#define MXC_DELAY_USEC(us) (uint32_t)(us)
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Advances the simulated clock by the given number of microseconds.
+ * @param      us   Delay in microseconds.
+ * @return     E_NO_ERROR.
+ */
+int MXC_Delay(uint32_t us);
+
+#endif
@@ -0,0 +1,407 @@
+/**
+ * @file       sim.h
+ * @brief      Host simulator control interface.
+ * @details    Clock, device attachment and inspection hooks used by the host
+ *             build and by test cases that need to drive the models directly.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef __SIM_H__
+#define __SIM_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+
+/***** Definitions *****/
+#define SIM_CORE_CLOCK 100000000UL  // Simulated core clock, matches the MAX78000 IPO
+
+/* Peripheral timing from the MAX78000 datasheet (Electrical Characteristics,
+ * Flash Memory). I2C transfer time follows from the SCL frequency. */
+#define SIM_FLASH_PROG_NS 42000UL           // tPROG, one program operation at fFLC_CLK = 1 MHz
+#define SIM_FLASH_PAGE_ERASE_NS 20000000UL  // tP_ERASE
+#define SIM_FLASH_MASS_ERASE_NS 20000000UL  // tM_ERASE
+#define SIM_GPIO_ACCESS_NS 20UL             // One APB register access, 2 core cycles
+#define SIM_I2C_OVERHEAD_NS 2000UL          // Controller setup per transaction
+#define SIM_I2C_HOLD_FOREVER UINT32_MAX     // sim_i2c_hold_sda() target that never lets go
+#define SIM_SPI_OVERHEAD_NS 1000UL          // Controller setup per transaction
+
+/* IS25LP128 typical program and erase times (IS25LP128 datasheet, 9.9 and tW) */
+#define SIM_QSPI_PAGE_PROG_NS 200000UL          // tPP
+#define SIM_QSPI_SECTOR_ERASE_NS 70000000UL     // 4 KB sector
+#define SIM_QSPI_BLOCK32_ERASE_NS 100000000UL   // 32 KB block
+#define SIM_QSPI_BLOCK64_ERASE_NS 150000000UL   // 64 KB block
+#define SIM_QSPI_STATUS_WRITE_NS 2000000UL      // tW
+
+/**
+ * @brief      Per-operation latency of the models. Operations advance the
+ *             simulated clock by these amounts instead of spending host time.
+ */
+typedef struct {
+    uint32_t flash_prog_ns;         // One 32-bit or 128-bit program operation
+    uint32_t flash_page_erase_ns;   // Page erase
+    uint32_t flash_mass_erase_ns;   // Mass erase
+    uint32_t gpio_access_ns;        // GPIO register access
+    uint32_t i2c_overhead_ns;       // Per I2C transaction, on top of the bit time
+    uint32_t spi_overhead_ns;       // Per SPI transaction, on top of the clock time
+    uint32_t qspi_page_prog_ns;     // External flash page program
+    uint32_t qspi_sector_erase_ns;  // External flash 4 KB erase
+    uint32_t qspi_block32_erase_ns; // External flash 32 KB erase
+    uint32_t qspi_block64_erase_ns; // External flash 64 KB erase
+    uint32_t qspi_status_write_ns;  // External flash status register write
+} sim_timing_t;
+
+/**
+ * @brief      Faults the I2C bus model can inject.
+ */
+typedef enum {
+    SIM_I2C_FAULT_NONE = 0,
+    SIM_I2C_FAULT_ADDR_NACK,        // Target does not acknowledge its address
+    SIM_I2C_FAULT_DATA_NACK,        // Target NACKs a data byte of the write phase
+    SIM_I2C_FAULT_ARB_LOST,         // Another master wins arbitration mid-transfer
+    SIM_I2C_FAULT_COUNT
+} sim_i2c_fault_t;
+
+/**
+ * @brief      Counters kept by the I2C bus model.
+ */
+typedef struct {
+    uint32_t transactions;          // MXC_I2C_MasterTransaction() calls
+    uint32_t bytes;                 // Data bytes moved, both directions
+    uint32_t faults;                // Transactions failed by fault injection
+    uint64_t busy_ns;               // Simulated time the bus was busy
+} sim_i2c_stats_t;
+
+/**
+ * @brief      Device model attached to the simulated I2C bus.
+ *
+ * write() is called with the bytes of a write phase and read() fills the bytes
+ * of a read phase. Both return 0 to ACK or non-zero to NACK.
+ */
+typedef struct sim_i2c_device {
+    uint8_t addr;                                                       // 7-bit address
+    int (*write)(struct sim_i2c_device *dev, const uint8_t *data, unsigned int len);
+    int (*read)(struct sim_i2c_device *dev, uint8_t *data, unsigned int len);
+    void *ctx;                                                          // Model state
+    struct sim_i2c_device *next;                                        // Next device on the bus
+} sim_i2c_device_t;
+
+/**
+ * @brief      Device model attached to a slave select line of a simulated SPI bus.
+ *
+ * select() is called when the line is asserted, xfer() for every transaction
+ * while it stays asserted and deselect() when it is released. xfer() gets
+ * len bytes to shift out (tx is NULL for a read-only phase) and fills rx if
+ * it is not NULL. width is the mxc_spi_width_t of the transaction.
+ */
+typedef struct sim_spi_device {
+    int ss;                                                             // Slave select index
+    void (*select)(struct sim_spi_device *dev);
+    void (*xfer)(struct sim_spi_device *dev, const uint8_t *tx, uint8_t *rx, unsigned int len,
+                 int width);
+    void (*deselect)(struct sim_spi_device *dev);
+    void *ctx;                                                          // Model state
+    struct sim_spi_device *next;                                        // Next device on the bus
+} sim_spi_device_t;
+
+#define SIM_SPI_LOOPBACK_MAX 4      // Slave selects that can carry a loopback model
+
+/**
+ * @brief      What the SPI loopback model saw on its slave select.
+ */
+typedef struct {
+    uint32_t frames;                // Times the slave select was released
+    uint32_t bytes;                 // Bytes shifted
+    unsigned int hz;                // SCK frequency of the last frame
+    int mode;                       // mxc_spi_mode_t of the last frame
+} sim_spi_loopback_t;
+
+#define SIM_REPLAY_I2C_ADDRS 8     // I2C addresses one replay can stand in for
+#define SIM_REPLAY_OPS 6            // BUSTRACE_OP_COUNT of drivers/bustrace
+
+/**
+ * @brief      Totals of one traced operation in a replay.
+ */
+typedef struct {
+    uint32_t count;                 // Records replayed
+    uint64_t recorded_cycles;       // Their durations in the trace
+    uint64_t replayed_cycles;       // Their durations in the replay
+} sim_replay_op_t;
+
+/**
+ * @brief      Outcome of sim_replay().
+ */
+typedef struct {
+    uint32_t records;               // Records replayed
+    uint32_t mismatches;            // Results or bytes that differ from the trace
+    uint32_t dropped;               // Records the trace lost while recording
+    uint64_t recorded_ns;           // Span of the traced session, idle gaps included
+    uint64_t replayed_ns;           // Simulated span of the replay
+    sim_replay_op_t ops[SIM_REPLAY_OPS];    // Indexed by bustrace_op_t
+} sim_replay_result_t;
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Maps the flash array and attaches the default board devices.
+ *             Must be called before any driver is used.
+ */
+void sim_init(void);
+/**
+ * @brief      Returns the simulated time since sim_init() in nanoseconds:
+ *             host elapsed time plus all time added with sim_clock_advance().
+ */
+uint64_t sim_time_ns(void);
+/**
+ * @brief      Moves the simulated clock forward without spending host time.
+ * @param      ns   Number of nanoseconds to add.
+ */
+void sim_clock_advance(uint64_t ns);
+/**
+ * @brief      Simulates WFI: the clock jumps to the next event that raises an
+ *             enabled interrupt. Returns at once if one is already pending or
+ *             if no event is scheduled.
+ */
+void sim_wfi(void);
+/**
+ * @brief      Raises the interrupts of events that are due and, unless
+ *             PRIMASK is set, runs the handlers of the pending, enabled ones.
+ *             Called when interrupts are unmasked and after WFI.
+ */
+void sim_irq_dispatch(void);
+/**
+ * @brief      Returns the simulated time spent in sim_wfi() since sim_init().
+ */
+uint64_t sim_sleep_ns(void);
+/**
+ * @brief      Attaches a device model to a simulated I2C bus.
+ * @param      idx  I2C instance index (0 to 2).
+ * @param      dev  Device model, must stay valid while attached.
+ */
+void sim_i2c_attach(int idx, sim_i2c_device_t *dev);
+/**
+ * @brief      Removes a device model from a simulated I2C bus. A device
+ *             attached earlier at the same address answers again.
+ * @param      idx  I2C instance index (0 to 2).
+ * @param      dev  Device model attached with sim_i2c_attach().
+ */
+void sim_i2c_detach(int idx, sim_i2c_device_t *dev);
+/**
+ * @brief      Attaches the BMI160 model to a simulated I2C bus.
+ * @param      idx  I2C instance index.
+ * @param      addr 7-bit address of the sensor.
+ */
+void sim_bmi160_attach(int idx, uint8_t addr);
+/**
+ * @brief      Wires the BMI160 model's INT1 output to a GPIO pin. Data ready
+ *             pulses appear there at the accelerometer ODR once INT1 is
+ *             enabled and data ready is mapped to it.
+ * @param      port Port index.
+ * @param      mask Pin.
+ */
+void sim_bmi160_int1(int port, uint32_t mask);
+/**
+ * @brief      Attaches a device model to a simulated SPI bus.
+ * @param      idx  SPI instance index (0 or 1).
+ * @param      dev  Device model, must stay valid while attached.
+ */
+void sim_spi_attach(int idx, sim_spi_device_t *dev);
+/**
+ * @brief      Attaches the IS25LP128 serial flash model to a simulated SPI bus.
+ *             The array starts erased and the status register cleared.
+ * @param      idx  SPI instance index.
+ * @param      ss   Slave select index.
+ */
+void sim_is25lp128_attach(int idx, int ss);
+/**
+ * @brief      Returns the array of the IS25LP128 model for inspection.
+ */
+uint8_t *sim_is25lp128_array(void);
+/**
+ * @brief      Attaches a loopback device, MISO wired to MOSI, to a simulated
+ *             SPI bus. Does nothing if one is already on the slave select.
+ * @param      idx  SPI instance index.
+ * @param      ss   Slave select index, below SIM_SPI_LOOPBACK_MAX.
+ */
+void sim_spi_loopback_attach(int idx, int ss);
+/**
+ * @brief      Returns what the loopback device on a slave select saw.
+ * @param      ss       Slave select index.
+ * @param      stats    Receives the counters.
+ * @param      clear    Non-zero to clear the counters after reading them.
+ */
+void sim_spi_loopback_get(int ss, sim_spi_loopback_t *stats, int clear);
+/**
+ * @brief      Replays a trace recorded by drivers/bustrace through the drivers
+ *             and the simulator's I2C bus and flash models.
+ *
+ * Every record is issued again with the same driver call. For the I2C
+ * addresses in the trace a replay target stands in on the bus: it checks the
+ * bytes written against the trace, returns the recorded bytes for reads, and
+ * NACKs where the recorded transaction failed. Flash operations run against
+ * the flash model, which must hold what the session expects (e.g. start with
+ * sim_flash_reset() for a session that begins with its erases). Writes whose
+ * payload was cut while recording are padded with 0xFF.
+ *
+ * @param      trace    Trace, starting with its bustrace_header_t.
+ * @param      size     Bytes of the trace.
+ * @param      speedup  Divides the recorded idle time between transactions:
+ *                      1 replays at recorded speed, 0 leaves the idle time out.
+ * @param      result   Receives the totals.
+ * @return     E_NO_ERROR, E_BAD_PARAM if the trace is malformed, or E_NO_DEVICE
+ *             if it uses more than SIM_REPLAY_I2C_ADDRS I2C addresses.
+ */
+int sim_replay(const uint8_t *trace, uint32_t size, uint32_t speedup, sim_replay_result_t *result);
+/**
+ * @brief      Prints the recorded and replayed time per operation.
+ * @param      result   Totals from sim_replay().
+ */
+void sim_replay_print(const sim_replay_result_t *result);
+/**
+ * @brief      Log sink that decodes binary log records to text on stdout.
+ * @param      data   Drained log bytes.
+ * @param      len    Number of bytes.
+ */
+void sim_log_text_sink(const uint8_t *data, size_t len);
+/**
+ * @brief      Erases the whole simulated flash array to 0xFF and powers it up.
+ */
+void sim_flash_reset(void);
+/**
+ * @brief      Seeds the random generator used for random fault injection.
+ * @param      seed   Non-zero seed. The same seed gives the same fault sequence.
+ */
+void sim_seed(uint32_t seed);
+/**
+ * @brief      Returns the next value of the simulator's random generator.
+ */
+uint32_t sim_rand(void);
+/**
+ * @brief      Reads the model latencies.
+ * @param      timing   Receives the current latencies.
+ */
+void sim_timing_get(sim_timing_t *timing);
+/**
+ * @brief      Sets the model latencies.
+ * @param      timing   New latencies, NULL restores the datasheet values.
+ */
+void sim_timing_set(const sim_timing_t *timing);
+/**
+ * @brief      Fails the next transactions on an I2C bus.
+ * @param      idx      I2C instance index.
+ * @param      fault    Fault to inject.
+ * @param      count    Number of consecutive transactions to fail.
+ */
+void sim_i2c_inject(int idx, sim_i2c_fault_t fault, uint32_t count);
+/**
+ * @brief      Fails random transactions on an I2C bus.
+ * @param      idx      I2C instance index.
+ * @param      fault    Fault to inject.
+ * @param      ppm      Probability per transaction in parts per million, 0 to stop.
+ */
+void sim_i2c_fault_rate(int idx, sim_i2c_fault_t fault, uint32_t ppm);
+/**
+ * @brief      Reads and optionally clears the counters of an I2C bus.
+ * @param      idx      I2C instance index.
+ * @param      stats    Receives the counters.
+ * @param      clear    Non-zero to reset the counters after reading.
+ */
+void sim_i2c_get_stats(int idx, sim_i2c_stats_t *stats, int clear);
+/**
+ * @brief      Makes the target on an I2C bus hold SDA low, as a target reset
+ *             by a brownout in the middle of sending a byte does. Transactions
+ *             lose arbitration until it lets go.
+ * @param      idx      I2C instance index.
+ * @param      clocks   SCL pulses the target needs to finish its byte and
+ *                      release SDA, SIM_I2C_HOLD_FOREVER to never release it,
+ *                      0 to release it now.
+ */
+void sim_i2c_hold_sda(int idx, uint32_t clocks);
+/**
+ * @brief      Runs a transaction of a master outside the chip against an I2C
+ *             instance in target mode: an optional write phase, then after a
+ *             repeated START an optional read phase, then STOP.
+ *
+ * The target's interrupt events are raised as the bytes move, with the FIFO
+ * thresholds set by the driver. The target stretches SCL while its interrupt
+ * runs; a read from an empty TX FIFO returns 0xFF.
+ *
+ * @param      idx      I2C instance index.
+ * @param      hz       SCL frequency of the master.
+ * @param      addr     7-bit target address.
+ * @param      tx       Bytes to write, NULL for none.
+ * @param      tx_len   Number of bytes to write.
+ * @param      rx       Receives the bytes read, NULL for none.
+ * @param      rx_len   Number of bytes to read.
+ * @return     0 if the target acknowledged every byte, E_COMM_ERR if it did
+ *             not acknowledge its address or a written byte.
+ */
+int sim_i2c_host_transfer(int idx, unsigned int hz, uint8_t addr, const uint8_t *tx,
+                          unsigned int tx_len, uint8_t *rx, unsigned int rx_len);
+/**
+ * @brief      Flips one bit of the flash array, as a retention error would.
+ * @param      addr     Byte address in the flash array.
+ * @param      bit      Bit number, 0 to 7.
+ */
+void sim_flash_flip_bit(uint32_t addr, unsigned int bit);
+/**
+ * @brief      Flips a random bit of the programmed data in random program operations.
+ * @param      ppm      Probability per program operation in parts per million.
+ */
+void sim_flash_bitflip_rate(uint32_t ppm);
+/**
+ * @brief      Arms a power failure during a later flash operation.
+ *
+ * After @p ops more program or erase operations complete, the next one is torn:
+ * only its first @p bytes bytes take effect and the flash loses power. Every
+ * later operation fails with E_BAD_STATE until sim_flash_power_cycle().
+ *
+ * @param      ops      Number of operations that complete normally first.
+ * @param      bytes    Bytes of the torn operation that reach the array.
+ */
+void sim_flash_tear(uint32_t ops, uint32_t bytes);
+/**
+ * @brief      Returns non-zero if an armed power failure has happened.
+ */
+int sim_flash_power_lost(void);
+/**
+ * @brief      Restores power after a torn operation. The array keeps its content.
+ */
+void sim_flash_power_cycle(void);
+/**
+ * @brief      Holds GPIO pins at a level regardless of how they are driven,
+ *             e.g. a shorted line or a target holding SDA low.
+ * @param      port     Port index.
+ * @param      mask     Pins to hold.
+ * @param      level    Level of each held pin.
+ */
+void sim_gpio_stuck(int port, uint32_t mask, uint32_t level);
+/**
+ * @brief      Releases pins held with sim_gpio_stuck().
+ * @param      port     Port index.
+ * @param      mask     Pins to release.
+ */
+void sim_gpio_release(int port, uint32_t mask);
+
+#endif
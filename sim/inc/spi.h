@@ -0,0 +1,100 @@
+/**
+ * @file       spi.h
+ * @brief      Host simulator stand-in for the MSDK SPI driver.
+ * @details    Transactions are routed to the device model attached to the
+ *             selected slave select line of the simulated bus.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+
+/* Define to prevent redundant inclusion */
+#ifndef _SPI_H_
+#define _SPI_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#define SIM_SPI_INSTANCES 2
+#define SIM_SPI_MAX_FREQ 50000000   // PCLK / 2
+
+typedef struct {
+    __IO uint32_t ctrl0;
+    __IO uint32_t ctrl1;
+    __IO uint32_t ctrl2;
+    __IO uint32_t intfl;
+} mxc_spi_regs_t;
+
+extern mxc_spi_regs_t sim_spi_regs[SIM_SPI_INSTANCES];
+#define MXC_SPI0 (&sim_spi_regs[0])     // Quad capable
+#define MXC_SPI1 (&sim_spi_regs[1])
+#define MXC_SPI_GET_IDX(p) ((int)((p) - sim_spi_regs))
+
+typedef enum {
+    SPI_WIDTH_3WIRE,
+    SPI_WIDTH_STANDARD,
+    SPI_WIDTH_DUAL,
+    SPI_WIDTH_QUAD
+} mxc_spi_width_t;
+
+typedef enum {
+    SPI_MODE_0,
+    SPI_MODE_1,
+    SPI_MODE_2,
+    SPI_MODE_3
+} mxc_spi_mode_t;
+
+typedef struct _mxc_spi_req_t mxc_spi_req_t;
+
+typedef void (*spi_complete_cb_t)(void *req, int result);
+
+struct _mxc_spi_req_t {
+    mxc_spi_regs_t *spi;
+    int ssIdx;
+    int ssDeassert;
+    uint8_t *txData;
+    uint8_t *rxData;
+    uint32_t txLen;
+    uint32_t rxLen;
+    uint32_t txCnt;
+    uint32_t rxCnt;
+    spi_complete_cb_t completeCB;
+};
+
+/***** Function Prototypes *****/
+int MXC_SPI_Init(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                 unsigned ssPolarity, unsigned int hz);
+int MXC_SPI_Shutdown(mxc_spi_regs_t *spi);
+int MXC_SPI_SetFrequency(mxc_spi_regs_t *spi, unsigned int hz);
+unsigned int MXC_SPI_GetFrequency(mxc_spi_regs_t *spi);
+int MXC_SPI_SetDataSize(mxc_spi_regs_t *spi, int dataSize);
+int MXC_SPI_SetWidth(mxc_spi_regs_t *spi, mxc_spi_width_t spiWidth);
+mxc_spi_width_t MXC_SPI_GetWidth(mxc_spi_regs_t *spi);
+int MXC_SPI_SetMode(mxc_spi_regs_t *spi, mxc_spi_mode_t spiMode);
+mxc_spi_mode_t MXC_SPI_GetMode(mxc_spi_regs_t *spi);
+int MXC_SPI_MasterTransaction(mxc_spi_req_t *req);
+int MXC_SPI_MasterTransactionDMA(mxc_spi_req_t *req);
+
+#endif
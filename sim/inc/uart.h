@@ -0,0 +1,53 @@
+/**
+ * @file       uart.h
+ * @brief      Host simulator stand-in for the MSDK UART driver.
+ * @details    Bytes written to the console UART go to the host stdout.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef _UART_H_
+#define _UART_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#define SIM_UART_INSTANCES 4
+
+typedef struct {
+    __IO uint32_t ctrl;
+    __IO uint32_t status;
+    __IO uint32_t fifo;
+} mxc_uart_regs_t;
+
+extern mxc_uart_regs_t sim_uart_regs[SIM_UART_INSTANCES];
+#define MXC_UART_GET_UART(i) (&sim_uart_regs[i])
+#define MXC_UART_GET_IDX(p) ((int)((p) - sim_uart_regs))
+
+/***** Function Prototypes *****/
+int MXC_UART_Write(mxc_uart_regs_t *uart, uint8_t *byte, int *len);
+
+#endif
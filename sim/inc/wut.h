@@ -0,0 +1,88 @@
+/**
+ * @file       wut.h
+ * @brief      Host simulator stand-in for the MSDK wakeup timer driver.
+ * @details    The wakeup timer counts the 32.768 kHz clock from the
+ *             simulated time. Only the free running compare mode is modelled:
+ *             the interrupt fires when the count passes the compare value.
+ */
+
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+
+/* Define to prevent redundant inclusion */
+#ifndef _WUT_H_
+#define _WUT_H_
+
+/***** Includes *****/
+#include <stdint.h>
+#include "mxc_device.h"
+
+/***** Definitions *****/
+#define SIM_WUT_CLOCK 32768     // ERTCO frequency
+
+typedef enum {
+    MXC_WUT_PRES_1 = 0,
+    MXC_WUT_PRES_2,
+    MXC_WUT_PRES_4,
+    MXC_WUT_PRES_8,
+    MXC_WUT_PRES_16,
+    MXC_WUT_PRES_32,
+    MXC_WUT_PRES_64,
+    MXC_WUT_PRES_128,
+    MXC_WUT_PRES_256,
+    MXC_WUT_PRES_512,
+    MXC_WUT_PRES_1024,
+    MXC_WUT_PRES_2048,
+    MXC_WUT_PRES_4096
+} mxc_wut_pres_t;
+
+typedef enum {
+    MXC_WUT_MODE_ONESHOT,
+    MXC_WUT_MODE_CONTINUOUS,
+    MXC_WUT_MODE_COUNTER,
+    MXC_WUT_MODE_CAPTURE,
+    MXC_WUT_MODE_COMPARE,
+    MXC_WUT_MODE_GATED,
+    MXC_WUT_MODE_CAPTURE_COMPARE
+} mxc_wut_mode_t;
+
+typedef struct {
+    mxc_wut_mode_t mode;
+    uint32_t cmp_cnt;
+} mxc_wut_cfg_t;
+
+/***** Function Prototypes *****/
+void MXC_WUT_Init(mxc_wut_pres_t pres);
+void MXC_WUT_Shutdown(void);
+void MXC_WUT_Enable(void);
+void MXC_WUT_Disable(void);
+void MXC_WUT_Config(const mxc_wut_cfg_t *cfg);
+uint32_t MXC_WUT_GetCompare(void);
+uint32_t MXC_WUT_GetCount(void);
+void MXC_WUT_IntClear(void);
+uint32_t MXC_WUT_IntStatus(void);
+void MXC_WUT_SetCompare(uint32_t cmp_cnt);
+void MXC_WUT_SetCount(uint32_t cnt);
+
+#endif
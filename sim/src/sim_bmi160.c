@@ -0,0 +1,202 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+#define BMI160_REG_CHIP_ID 0x00
+#define BMI160_REG_PMU_STATUS 0x03
+#define BMI160_REG_DATA_GYR 0x0C
+#define BMI160_REG_DATA_ACC 0x12
+#define BMI160_REG_ACC_CONF 0x40
+#define BMI160_REG_INT_EN_1 0x51
+#define BMI160_REG_INT_OUT_CTRL 0x53
+#define BMI160_REG_INT_MAP_1 0x56
+#define BMI160_REG_CMD 0x7E
+
+#define BMI160_CHIP_ID 0xD1
+#define BMI160_CMD_ACC_NORMAL 0x11
+#define BMI160_CMD_GYR_NORMAL 0x15
+#define BMI160_CMD_SOFTRESET 0xB6
+
+#define BMI160_PMU_ACC_SHIFT 4
+#define BMI160_PMU_GYR_SHIFT 2
+#define BMI160_PMU_NORMAL 0x1
+
+#define BMI160_INT_EN_1_DRDY (1 << 4)
+#define BMI160_INT1_OUTPUT_EN (1 << 3)
+#define BMI160_INT1_LVL (1 << 1)            // Active high
+#define BMI160_INT_MAP_1_INT1_DRDY (1 << 7)
+
+#define BMI160_WAVE_PERIOD 64       // Samples per period of the generated motion
+#define BMI160_WAVE_AMPLITUDE 16000 // Peak raw value of the generated motion
+
+typedef struct {
+    uint8_t regs[128];  // Register file
+    uint8_t ptr;        // Register pointer, auto-increments
+    uint32_t sample;    // Samples produced since reset
+    int int1_port;      // GPIO port INT1 is wired to, -1 if not wired
+    uint32_t int1_mask; // GPIO pin INT1 is wired to
+    uint64_t drdy_ns;   // Time of the last data ready pulse
+} sim_bmi160_t;
+
+/***** Globals *****/
+static sim_bmi160_t sim_bmi160 = { .int1_port = -1 };
+static sim_i2c_device_t sim_bmi160_dev;
+static sim_event_source_t sim_bmi160_drdy;
+
+/***** Functions *****/
+static void sim_bmi160_reset(sim_bmi160_t *s)
+{
+    memset(s->regs, 0, sizeof(s->regs));
+    s->regs[BMI160_REG_CHIP_ID] = BMI160_CHIP_ID;
+    s->regs[BMI160_REG_ACC_CONF] = 0x28;
+    s->sample = 0;
+}
+/******************************************************************************/
+// Stores a raw value in a little endian data register pair
+static void sim_bmi160_set_axis(sim_bmi160_t *s, uint8_t reg, int16_t value)
+{
+    s->regs[reg] = (uint8_t)value;
+    s->regs[reg + 1] = (uint8_t)((uint16_t)value >> 8);
+}
+/******************************************************************************/
+// Latches the next sample into the data registers. Every axis is a triangle
+// wave with its own phase; a sensor that is not in normal mode reads zero.
+static void sim_bmi160_update_data(sim_bmi160_t *s)
+{
+    uint8_t pmu = s->regs[BMI160_REG_PMU_STATUS];
+    for (int axis = 0; axis < 6; axis++) {
+        uint32_t phase = (s->sample + axis * (BMI160_WAVE_PERIOD / 6)) % BMI160_WAVE_PERIOD;
+        int32_t tri = (phase < BMI160_WAVE_PERIOD / 2) ? (int32_t)phase :
+                                                         (int32_t)(BMI160_WAVE_PERIOD - phase);
+        int16_t value = (int16_t)((tri * 4 - BMI160_WAVE_PERIOD) * BMI160_WAVE_AMPLITUDE /
+                                  BMI160_WAVE_PERIOD);
+        int shift = (axis < 3) ? BMI160_PMU_GYR_SHIFT : BMI160_PMU_ACC_SHIFT;
+        if (((pmu >> shift) & 0x3) != BMI160_PMU_NORMAL) {
+            value = 0;
+        }
+        sim_bmi160_set_axis(s, BMI160_REG_DATA_GYR + 2 * axis, value);
+    }
+    s->sample++;
+}
+/******************************************************************************/
+static void sim_bmi160_command(sim_bmi160_t *s, uint8_t cmd)
+{
+    switch (cmd) {
+    case BMI160_CMD_ACC_NORMAL:
+        s->regs[BMI160_REG_PMU_STATUS] &= ~(0x3 << BMI160_PMU_ACC_SHIFT);
+        s->regs[BMI160_REG_PMU_STATUS] |= BMI160_PMU_NORMAL << BMI160_PMU_ACC_SHIFT;
+        break;
+    case BMI160_CMD_GYR_NORMAL:
+        s->regs[BMI160_REG_PMU_STATUS] &= ~(0x3 << BMI160_PMU_GYR_SHIFT);
+        s->regs[BMI160_REG_PMU_STATUS] |= BMI160_PMU_NORMAL << BMI160_PMU_GYR_SHIFT;
+        break;
+    case BMI160_CMD_SOFTRESET:
+        sim_bmi160_reset(s);
+        break;
+    default:
+        break;
+    }
+}
+/******************************************************************************/
+static int sim_bmi160_write(sim_i2c_device_t *dev, const uint8_t *data, unsigned int len)
+{
+    sim_bmi160_t *s = dev->ctx;
+    s->ptr = data[0] & 0x7F;
+    for (unsigned int i = 1; i < len; i++) {
+        if (s->ptr == BMI160_REG_CMD) {
+            sim_bmi160_command(s, data[i]);     // CMD always reads back as 0
+        } else {
+            s->regs[s->ptr] = data[i];
+        }
+        s->ptr = (s->ptr + 1) & 0x7F;
+    }
+    return 0;
+}
+/******************************************************************************/
+static int sim_bmi160_read(sim_i2c_device_t *dev, uint8_t *data, unsigned int len)
+{
+    sim_bmi160_t *s = dev->ctx;
+    // A burst starting at the data registers reads a fresh, consistent sample
+    if (s->ptr == BMI160_REG_DATA_GYR || s->ptr == BMI160_REG_DATA_ACC) {
+        sim_bmi160_update_data(s);
+    }
+    for (unsigned int i = 0; i < len; i++) {
+        data[i] = s->regs[s->ptr];
+        s->ptr = (s->ptr + 1) & 0x7F;
+    }
+    return 0;
+}
+/******************************************************************************/
+// Time of the next data ready pulse, at the accelerometer ODR
+static uint64_t sim_bmi160_drdy_next(sim_event_source_t *src)
+{
+    sim_bmi160_t *s = &sim_bmi160;
+    (void)src;
+    uint8_t pmu = s->regs[BMI160_REG_PMU_STATUS];
+    if (s->int1_port < 0 || ((pmu >> BMI160_PMU_ACC_SHIFT) & 0x3) != BMI160_PMU_NORMAL ||
+        !(s->regs[BMI160_REG_INT_EN_1] & BMI160_INT_EN_1_DRDY) ||
+        !(s->regs[BMI160_REG_INT_OUT_CTRL] & BMI160_INT1_OUTPUT_EN) ||
+        !(s->regs[BMI160_REG_INT_MAP_1] & BMI160_INT_MAP_1_INT1_DRDY)) {
+        return SIM_NEVER;
+    }
+    // ODR code n gives 100 Hz * 2^(n - 8), valid codes are 1 to 12
+    unsigned int odr = s->regs[BMI160_REG_ACC_CONF] & 0xF;
+    odr = (odr < 1) ? 1 : (odr > 12) ? 12 : odr;
+    uint64_t period = (odr <= 8) ? (10000000ULL << (8 - odr)) : (10000000ULL >> (odr - 8));
+    return (s->drdy_ns / period + 1) * period;
+}
+/******************************************************************************/
+// Pulses INT1
+static void sim_bmi160_drdy_fire(sim_event_source_t *src)
+{
+    sim_bmi160_t *s = &sim_bmi160;
+    (void)src;
+    uint32_t active = (s->regs[BMI160_REG_INT_OUT_CTRL] & BMI160_INT1_LVL) ? s->int1_mask : 0;
+    s->drdy_ns = sim_time_ns();
+    sim_gpio_drive(s->int1_port, s->int1_mask, active);
+    sim_gpio_drive(s->int1_port, s->int1_mask, ~active);
+}
+/******************************************************************************/
+void sim_bmi160_int1(int port, uint32_t mask)
+{
+    uint32_t idle = (sim_bmi160.regs[BMI160_REG_INT_OUT_CTRL] & BMI160_INT1_LVL) ? 0 : mask;
+    sim_bmi160.int1_port = port;
+    sim_bmi160.int1_mask = mask;
+    sim_gpio_drive(port, mask, idle);
+    sim_bmi160_drdy.next_ns = sim_bmi160_drdy_next;
+    sim_bmi160_drdy.fire = sim_bmi160_drdy_fire;
+    sim_event_register(&sim_bmi160_drdy);
+}
+/******************************************************************************/
+void sim_bmi160_attach(int idx, uint8_t addr)
+{
+    sim_bmi160_reset(&sim_bmi160);
+    sim_bmi160_dev.addr = addr;
+    sim_bmi160_dev.write = sim_bmi160_write;
+    sim_bmi160_dev.read = sim_bmi160_read;
+    sim_bmi160_dev.ctx = &sim_bmi160;
+    sim_i2c_attach(idx, &sim_bmi160_dev);
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <time.h>
+#include "mxc_device.h"
+#include "mxc_delay.h"
+#include "nvic_table.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Globals *****/
+uint32_t SystemCoreClock = SIM_CORE_CLOCK;
+uint32_t sim_primask = 0;
+CoreDebug_Type sim_core_debug;
+
+static DWT_Type sim_dwt_regs;
+static mxc_gcr_regs_t sim_gcr_regs;
+static uint64_t sim_start_ns = 0;      // Host time at sim_init()
+static uint64_t sim_offset_ns = 0;     // Time added by sim_clock_advance()
+static uint32_t sim_rand_state = 1;    // xorshift32 state, never 0
+
+static const sim_timing_t sim_timing_datasheet = {
+    .flash_prog_ns = SIM_FLASH_PROG_NS,
+    .flash_page_erase_ns = SIM_FLASH_PAGE_ERASE_NS,
+    .flash_mass_erase_ns = SIM_FLASH_MASS_ERASE_NS,
+    .gpio_access_ns = SIM_GPIO_ACCESS_NS,
+    .i2c_overhead_ns = SIM_I2C_OVERHEAD_NS,
+    .spi_overhead_ns = SIM_SPI_OVERHEAD_NS,
+    .qspi_page_prog_ns = SIM_QSPI_PAGE_PROG_NS,
+    .qspi_sector_erase_ns = SIM_QSPI_SECTOR_ERASE_NS,
+    .qspi_block32_erase_ns = SIM_QSPI_BLOCK32_ERASE_NS,
+    .qspi_block64_erase_ns = SIM_QSPI_BLOCK64_ERASE_NS,
+    .qspi_status_write_ns = SIM_QSPI_STATUS_WRITE_NS,
+};
+
+sim_timing_t sim_timing = sim_timing_datasheet;
+
+/***** Functions *****/
+static uint64_t sim_host_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+/******************************************************************************/
+uint64_t sim_time_ns(void)
+{
+    return (sim_host_ns() - sim_start_ns) + sim_offset_ns;
+}
+/******************************************************************************/
+void sim_clock_advance(uint64_t ns)
+{
+    sim_offset_ns += ns;
+}
+/******************************************************************************/
+void sim_seed(uint32_t seed)
+{
+    sim_rand_state = (seed != 0) ? seed : 1;
+}
+/******************************************************************************/
+uint32_t sim_rand(void)
+{
+    uint32_t x = sim_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim_rand_state = x;
+    return x;
+}
+/******************************************************************************/
+int sim_chance(uint32_t ppm)
+{
+    return ppm != 0 && (sim_rand() % 1000000UL) < ppm;
+}
+/******************************************************************************/
+void sim_timing_get(sim_timing_t *timing)
+{
+    *timing = sim_timing;
+}
+/******************************************************************************/
+void sim_timing_set(const sim_timing_t *timing)
+{
+    sim_timing = (timing != NULL) ? *timing : sim_timing_datasheet;
+}
+/******************************************************************************/
+DWT_Type *sim_dwt(void)
+{
+    if ((sim_core_debug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) &&
+        (sim_dwt_regs.CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        sim_dwt_regs.CYCCNT = (uint32_t)(sim_time_ns() / (1000000000ULL / SystemCoreClock));
+    }
+    return &sim_dwt_regs;
+}
+/******************************************************************************/
+mxc_gcr_regs_t *sim_gcr(void)
+{
+    // The cache flush completes immediately
+    sim_gcr_regs.sysctrl &= ~MXC_F_GCR_SYSCTRL_ICC0_FLUSH;
+    return &sim_gcr_regs;
+}
+/******************************************************************************/
+int MXC_Delay(uint32_t us)
+{
+    sim_clock_advance((uint64_t)us * 1000ULL);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void sim_init(void)
+{
+    sim_start_ns = sim_host_ns();
+    sim_offset_ns = 0;
+    sim_flash_init();
+    sim_bmi160_attach(2, 0x69);    // BMI160 on I2C2 of the EvKit
+    sim_bmi160_int1(2, 1UL << 7);  // Its INT1 on the interrupt input pin, P2.7
+    sim_is25lp128_attach(0, 0);    // IS25LP128 on QSPI0, slave select 0
+}
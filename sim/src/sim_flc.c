@@ -0,0 +1,199 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "flc_regs.h"
+#include "flc_reva_regs.h"
+#include "mxc_errors.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+#define SIM_FLASH ((uint8_t *)MXC_FLASH_MEM_BASE)
+
+/***** Globals *****/
+mxc_flc_regs_t sim_flc0;
+
+static int sim_flash_off = 0;           // Power was lost in a torn operation
+static int sim_flash_tear_armed = 0;    // A torn operation is pending
+static uint32_t sim_flash_tear_ops = 0; // Operations left before the torn one
+static uint32_t sim_flash_tear_bytes = 0;
+static uint32_t sim_flash_flip_ppm = 0; // Bit flip probability per program operation
+
+/***** Functions *****/
+void sim_flash_init(void)
+{
+    // Map the array at its target address so drivers can read it through the memory map
+    void *mem = mmap((void *)MXC_FLASH_MEM_BASE, MXC_FLASH_MEM_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mem != (void *)MXC_FLASH_MEM_BASE) {
+        perror("sim: cannot map flash array");
+        exit(1);
+    }
+    sim_flash_reset();
+}
+/******************************************************************************/
+void sim_flash_reset(void)
+{
+    memset(SIM_FLASH, 0xFF, MXC_FLASH_MEM_SIZE);
+    sim_flash_off = 0;
+    sim_flash_tear_armed = 0;
+    sim_flash_flip_ppm = 0;
+}
+/******************************************************************************/
+void sim_flash_flip_bit(uint32_t addr, unsigned int bit)
+{
+    long offset = (long)(addr & (MXC_FLASH_MEM_SIZE - 1));
+    SIM_FLASH[offset] ^= (uint8_t)(1U << (bit & 0x7));
+}
+/******************************************************************************/
+void sim_flash_bitflip_rate(uint32_t ppm)
+{
+    sim_flash_flip_ppm = ppm;
+}
+/******************************************************************************/
+void sim_flash_tear(uint32_t ops, uint32_t bytes)
+{
+    sim_flash_tear_armed = 1;
+    sim_flash_tear_ops = ops;
+    sim_flash_tear_bytes = bytes;
+}
+/******************************************************************************/
+int sim_flash_power_lost(void)
+{
+    return sim_flash_off;
+}
+/******************************************************************************/
+void sim_flash_power_cycle(void)
+{
+    sim_flash_off = 0;
+}
+/******************************************************************************/
+// Starts a program or erase operation of len bytes. Returns the number of
+// bytes that reach the array, less than len if power fails during it.
+static uint32_t sim_flash_begin(uint32_t len, uint32_t ns)
+{
+    if (sim_flash_tear_armed && sim_flash_tear_ops-- == 0) {
+        sim_flash_tear_armed = 0;
+        sim_flash_off = 1;
+        uint32_t done = (sim_flash_tear_bytes < len) ? sim_flash_tear_bytes : len;
+        sim_clock_advance((uint64_t)ns * done / len);
+        return done;
+    }
+    sim_clock_advance(ns);
+    return len;
+}
+/******************************************************************************/
+// Converts a bus or physical address to an offset in the array, -1 if out of range
+static long sim_flash_offset(uint32_t addr)
+{
+    // The controller decodes only the offset bits, so both forms are accepted
+    if (addr >= MXC_FLASH_MEM_BASE) {
+        addr -= MXC_FLASH_MEM_BASE;
+    }
+    if (addr >= MXC_FLASH_MEM_SIZE) {
+        return -1;
+    }
+    return (long)addr;
+}
+/******************************************************************************/
+// Programming can only clear bits; setting a bit needs an erase
+static int sim_flash_program(long offset, const void *data, unsigned int len)
+{
+    const uint8_t *src = data;
+    unsigned int done = sim_flash_begin(len, sim_timing.flash_prog_ns);
+    for (unsigned int i = 0; i < done; i++) {
+        SIM_FLASH[offset + i] &= src[i];
+    }
+    if (done < len) {
+        return E_BAD_STATE;
+    }
+    // A weak cell can read back wrong after programming
+    if (sim_chance(sim_flash_flip_ppm)) {
+        uint32_t bit = sim_rand() % (len * 8);
+        SIM_FLASH[offset + bit / 8] ^= (uint8_t)(1U << (bit % 8));
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Erases len bytes at offset, the torn part of an interrupted erase keeps its data
+static int sim_flash_erase(long offset, uint32_t len, uint32_t ns)
+{
+    uint32_t done = sim_flash_begin(len, ns);
+    memset(SIM_FLASH + offset, 0xFF, done);
+    return (done < len) ? E_BAD_STATE : E_NO_ERROR;
+}
+/******************************************************************************/
+void MXC_FLC_Com_Read(int address, void *buffer, int len)
+{
+    memcpy(buffer, (const void *)(uintptr_t)(uint32_t)address, len);
+}
+/******************************************************************************/
+int MXC_FLC_RevA_MassErase(mxc_flc_reva_regs_t *flc)
+{
+    (void)flc;
+    if (sim_flash_off) {
+        return E_BAD_STATE;
+    }
+    return sim_flash_erase(0, MXC_FLASH_MEM_SIZE, sim_timing.flash_mass_erase_ns);
+}
+/******************************************************************************/
+int MXC_FLC_RevA_PageErase(mxc_flc_reva_regs_t *flc, uint32_t addr)
+{
+    long offset = sim_flash_offset(addr);
+    (void)flc;
+    if (offset < 0) {
+        return E_BAD_PARAM;
+    }
+    if (sim_flash_off) {
+        return E_BAD_STATE;
+    }
+    offset &= ~(long)(MXC_FLASH_PAGE_SIZE - 1);
+    return sim_flash_erase(offset, MXC_FLASH_PAGE_SIZE, sim_timing.flash_page_erase_ns);
+}
+/******************************************************************************/
+int MXC_FLC_Write32(uint32_t address, uint32_t data)
+{
+    long offset = sim_flash_offset(address);
+    if (offset < 0 || (address & 0x3)) {
+        return E_BAD_PARAM;
+    }
+    if (sim_flash_off) {
+        return E_BAD_STATE;
+    }
+    return sim_flash_program(offset, &data, sizeof(data));
+}
+/******************************************************************************/
+int MXC_FLC_Write128(uint32_t address, uint32_t *data)
+{
+    long offset = sim_flash_offset(address);
+    if (offset < 0 || (address & 0xF)) {
+        return E_BAD_PARAM;
+    }
+    if (sim_flash_off) {
+        return E_BAD_STATE;
+    }
+    return sim_flash_program(offset, data, 4 * sizeof(uint32_t));
+}
@@ -0,0 +1,220 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "gpio.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Globals *****/
+mxc_gpio_regs_t sim_gpio_regs[SIM_GPIO_PORTS];
+
+static uint32_t sim_gpio_stuck_mask[SIM_GPIO_PORTS];    // Pins held by sim_gpio_stuck()
+static uint32_t sim_gpio_stuck_level[SIM_GPIO_PORTS];   // Level of the held pins
+static uint32_t sim_gpio_ext_mask[SIM_GPIO_PORTS];      // Pins driven by sim_gpio_drive()
+static uint32_t sim_gpio_ext_level[SIM_GPIO_PORTS];     // Level of the driven pins
+static uint32_t sim_gpio_rise[SIM_GPIO_PORTS];          // Pins flagging rising edges
+static uint32_t sim_gpio_fall[SIM_GPIO_PORTS];          // Pins flagging falling edges
+static struct {
+    mxc_gpio_callback_fn fn;
+    void *cbdata;
+} sim_gpio_callbacks[SIM_GPIO_PORTS][32];               // Set with MXC_GPIO_RegisterCallback()
+
+/***** Functions *****/
+// Recomputes the level of every pin of a port and flags edges
+static void sim_gpio_settle(mxc_gpio_regs_t *port)
+{
+    uint32_t old = port->in;
+    uint32_t level = port->in;
+    int idx = MXC_GPIO_GET_IDX(port);
+    // Drivers outside the chip set the level of their input pins
+    level = (level & ~sim_gpio_ext_mask[idx]) | (sim_gpio_ext_level[idx] & sim_gpio_ext_mask[idx]);
+    port->driven |= sim_gpio_ext_mask[idx];
+    // Outputs drive their wire
+    level = (level & ~port->outen) | (port->out & port->outen);
+    port->driven |= port->outen;
+    // Inputs that were never driven float to their pull
+    uint32_t floating = ~port->driven;
+    level = (level & ~floating) | (port->pullup & floating);
+    // Open drain bus targets pull their lines low
+    level &= ~sim_i2c_held(idx, old, level);
+    // A held pin wins over any driver
+    level = (level & ~sim_gpio_stuck_mask[idx]) | (sim_gpio_stuck_level[idx] & sim_gpio_stuck_mask[idx]);
+    port->in = level;
+
+    port->intfl |= ((~old & level) & sim_gpio_rise[idx]) | ((old & ~level) & sim_gpio_fall[idx]);
+    if (port->intfl & port->inten) {
+        sim_irq_set_pending(MXC_GPIO_GET_IRQ(idx));
+    }
+}
+/******************************************************************************/
+// Register access from the core: recomputes the levels and takes bus time
+static void sim_gpio_update(mxc_gpio_regs_t *port)
+{
+    sim_gpio_settle(port);
+    sim_clock_advance(sim_timing.gpio_access_ns);
+}
+/******************************************************************************/
+void sim_gpio_drive(int port, uint32_t mask, uint32_t level)
+{
+    sim_gpio_ext_mask[port] |= mask;
+    sim_gpio_ext_level[port] = (sim_gpio_ext_level[port] & ~mask) | (level & mask);
+    sim_gpio_settle(&sim_gpio_regs[port]);
+}
+/******************************************************************************/
+void sim_gpio_refresh(int port)
+{
+    sim_gpio_settle(&sim_gpio_regs[port]);
+}
+/******************************************************************************/
+void sim_gpio_stuck(int port, uint32_t mask, uint32_t level)
+{
+    sim_gpio_stuck_mask[port] |= mask;
+    sim_gpio_stuck_level[port] = (sim_gpio_stuck_level[port] & ~mask) | (level & mask);
+    sim_gpio_update(&sim_gpio_regs[port]);
+}
+/******************************************************************************/
+void sim_gpio_release(int port, uint32_t mask)
+{
+    sim_gpio_stuck_mask[port] &= ~mask;
+    sim_gpio_update(&sim_gpio_regs[port]);
+}
+/******************************************************************************/
+int MXC_GPIO_Config(const mxc_gpio_cfg_t *cfg)
+{
+    mxc_gpio_regs_t *port = cfg->port;
+    if (port == NULL) {
+        return E_NULL_PTR;
+    }
+    if (cfg->func == MXC_GPIO_FUNC_OUT) {
+        port->outen |= cfg->mask;
+    } else {
+        port->outen &= ~cfg->mask;
+    }
+    if (cfg->pad == MXC_GPIO_PAD_PULL_UP || cfg->pad == MXC_GPIO_PAD_WEAK_PULL_UP) {
+        port->pullup |= cfg->mask;
+    } else {
+        port->pullup &= ~cfg->mask;
+    }
+    sim_gpio_update(port);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+uint32_t MXC_GPIO_InGet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_clock_advance(sim_timing.gpio_access_ns);
+    return port->in & mask;
+}
+/******************************************************************************/
+void MXC_GPIO_OutSet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    port->out |= mask;
+    sim_gpio_update(port);
+}
+/******************************************************************************/
+void MXC_GPIO_OutClr(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    port->out &= ~mask;
+    sim_gpio_update(port);
+}
+/******************************************************************************/
+uint32_t MXC_GPIO_OutGet(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    sim_clock_advance(sim_timing.gpio_access_ns);
+    return port->out & mask;
+}
+/******************************************************************************/
+void MXC_GPIO_OutPut(mxc_gpio_regs_t *port, uint32_t mask, uint32_t val)
+{
+    port->out = (port->out & ~mask) | (val & mask);
+    sim_gpio_update(port);
+}
+/******************************************************************************/
+void MXC_GPIO_OutToggle(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    port->out ^= mask;
+    sim_gpio_update(port);
+}
+/******************************************************************************/
+int MXC_GPIO_IntConfig(const mxc_gpio_cfg_t *cfg, mxc_gpio_int_pol_t pol)
+{
+    int idx = MXC_GPIO_GET_IDX(cfg->port);
+    // Level interrupts are not modelled
+    if (pol != MXC_GPIO_INT_RISING && pol != MXC_GPIO_INT_FALLING && pol != MXC_GPIO_INT_BOTH) {
+        return E_NOT_SUPPORTED;
+    }
+    sim_gpio_rise[idx] &= ~cfg->mask;
+    sim_gpio_fall[idx] &= ~cfg->mask;
+    if (pol != MXC_GPIO_INT_FALLING) {
+        sim_gpio_rise[idx] |= cfg->mask;
+    }
+    if (pol != MXC_GPIO_INT_RISING) {
+        sim_gpio_fall[idx] |= cfg->mask;
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void MXC_GPIO_EnableInt(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    port->inten |= mask;
+}
+/******************************************************************************/
+void MXC_GPIO_DisableInt(mxc_gpio_regs_t *port, uint32_t mask)
+{
+    port->inten &= ~mask;
+}
+/******************************************************************************/
+uint32_t MXC_GPIO_GetFlags(mxc_gpio_regs_t *port)
+{
+    // Polling the flags is how a busy loop sees edges, so let events happen
+    sim_clock_advance(sim_timing.gpio_access_ns);
+    sim_irq_dispatch();
+    return port->intfl;
+}
+/******************************************************************************/
+void MXC_GPIO_ClearFlags(mxc_gpio_regs_t *port, uint32_t flags)
+{
+    port->intfl &= ~flags;
+}
+/******************************************************************************/
+void MXC_GPIO_RegisterCallback(const mxc_gpio_cfg_t *cfg, mxc_gpio_callback_fn callback,
+                               void *cbdata)
+{
+    int idx = MXC_GPIO_GET_IDX(cfg->port);
+    for (int pin = 0; pin < 32; pin++) {
+        if (cfg->mask & (1UL << pin)) {
+            sim_gpio_callbacks[idx][pin].fn = callback;
+            sim_gpio_callbacks[idx][pin].cbdata = cbdata;
+        }
+    }
+}
+/******************************************************************************/
+void MXC_GPIO_Handler(unsigned int port)
+{
+    mxc_gpio_regs_t *regs = MXC_GPIO_GET_GPIO(port);
+    uint32_t flags = regs->intfl & regs->inten;
+    regs->intfl &= ~flags;
+    for (int pin = 0; pin < 32; pin++) {
+        if ((flags & (1UL << pin)) && sim_gpio_callbacks[port][pin].fn != NULL) {
+            sim_gpio_callbacks[port][pin].fn(sim_gpio_callbacks[port][pin].cbdata);
+        }
+    }
+}
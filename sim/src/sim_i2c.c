@@ -0,0 +1,565 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stddef.h>
+#include <string.h>
+#include "i2c.h"
+#include "gpio.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+#define SIM_I2C_BYTE_BITS 9     // 8 data bits and the acknowledge bit
+#define SIM_I2C_COND_BITS 1     // START, repeated START or STOP condition
+#define SIM_I2C_PORT 0          // GPIO port of the SCL and SDA pins of every instance
+
+typedef struct {
+    int initialized;            // MXC_I2C_Init() was called
+    unsigned int freq;          // Bus frequency in Hz
+    sim_i2c_device_t *devices;  // Attached device models
+    sim_i2c_fault_t fault;      // Fault injected in the next transactions
+    uint32_t fault_count;       // Number of transactions left to fail
+    sim_i2c_fault_t rate_fault; // Fault injected at random
+    uint32_t rate_ppm;          // Probability of rate_fault per transaction
+    sim_i2c_stats_t stats;      // Bus counters
+    sim_event_source_t done;    // End of the asynchronous transaction
+    mxc_i2c_req_t *async_req;   // Asynchronous transaction in progress
+    uint32_t async_flags;       // Flags it ends with
+    uint64_t async_end_ns;      // Time it ends, SIM_NEVER once signalled
+    uint32_t sda_hold;          // SCL pulses until the target releases SDA, 0 if it does not hold it
+    int target;                 // Initialized in target mode
+    uint8_t target_addr;        // Address answered in target mode
+    mxc_i2c_slave_handler_t slave_cb;   // Armed by MXC_I2C_SlaveTransactionAsync()
+    uint32_t slave_events;      // Target events waiting for MXC_I2C_AsyncHandler()
+    uint8_t rx_fifo[MXC_I2C_FIFO_DEPTH];    // Bytes written by the master, oldest first
+    uint8_t tx_fifo[MXC_I2C_FIFO_DEPTH];    // Bytes for the master to read, oldest first
+    unsigned int rx_count;      // Bytes in rx_fifo
+    unsigned int tx_count;      // Bytes in tx_fifo
+    unsigned int rx_thresh;     // RX_THRESH is raised at this RX FIFO level or above
+    unsigned int tx_thresh;     // TX_THRESH is raised at this TX FIFO level or below
+} sim_i2c_bus_t;
+
+typedef struct {
+    uint32_t scl;               // SCL pin mask on SIM_I2C_PORT
+    uint32_t sda;               // SDA pin mask on SIM_I2C_PORT
+} sim_i2c_pins_t;
+
+/***** Globals *****/
+mxc_i2c_regs_t sim_i2c_regs[SIM_I2C_INSTANCES];
+static sim_i2c_bus_t sim_i2c_bus[SIM_I2C_INSTANCES];
+static const sim_i2c_pins_t sim_i2c_pins[SIM_I2C_INSTANCES] = {
+    { 1UL << 10, 1UL << 11 },   // I2C0 on P0.10 and P0.11
+    { 1UL << 16, 1UL << 17 },   // I2C1 on P0.16 and P0.17
+    { 1UL << 30, 1UL << 31 }    // I2C2 on P0.30 and P0.31
+};
+
+/***** Functions *****/
+static sim_i2c_bus_t *sim_i2c_get_bus(mxc_i2c_regs_t *i2c)
+{
+    int idx = MXC_I2C_GET_IDX(i2c);
+    if (idx < 0 || idx >= SIM_I2C_INSTANCES) {
+        return NULL;
+    }
+    return &sim_i2c_bus[idx];
+}
+/******************************************************************************/
+void sim_i2c_attach(int idx, sim_i2c_device_t *dev)
+{
+    dev->next = sim_i2c_bus[idx].devices;
+    sim_i2c_bus[idx].devices = dev;
+}
+/******************************************************************************/
+void sim_i2c_detach(int idx, sim_i2c_device_t *dev)
+{
+    sim_i2c_device_t **link = &sim_i2c_bus[idx].devices;
+    while (*link != NULL && *link != dev) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) {
+        *link = dev->next;
+    }
+}
+/******************************************************************************/
+int MXC_I2C_Init(mxc_i2c_regs_t *i2c, int masterMode, unsigned int slaveAddr)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL || (!masterMode && slaveAddr > 0x7F)) {
+        return E_BAD_PARAM;
+    }
+    bus->initialized = 1;
+    bus->target = !masterMode;
+    bus->target_addr = (uint8_t)slaveAddr;
+    bus->slave_cb = NULL;
+    bus->slave_events = 0;
+    bus->rx_count = 0;
+    bus->tx_count = 0;
+    bus->rx_thresh = MXC_I2C_FIFO_DEPTH;
+    bus->tx_thresh = 0;
+    bus->freq = MXC_I2C_STD_MODE;
+    bus->async_req = NULL;
+    bus->async_end_ns = SIM_NEVER;
+    // The pins go back to the controller, and the board pulls both lines up
+    int idx = (int)(bus - sim_i2c_bus);
+    uint32_t pins = sim_i2c_pins[idx].scl | sim_i2c_pins[idx].sda;
+    sim_gpio_regs[SIM_I2C_PORT].outen &= ~pins;
+    sim_gpio_drive(SIM_I2C_PORT, pins, pins);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_I2C_Shutdown(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    bus->initialized = 0;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_I2C_SetFrequency(mxc_i2c_regs_t *i2c, unsigned int hz)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL || hz == 0 || hz > MXC_I2C_FASTPLUS_SPEED) {
+        return E_BAD_PARAM;
+    }
+    bus->freq = hz;
+    return (int)hz;
+}
+/******************************************************************************/
+unsigned int MXC_I2C_GetFrequency(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    return (bus != NULL) ? bus->freq : 0;
+}
+/******************************************************************************/
+void sim_i2c_inject(int idx, sim_i2c_fault_t fault, uint32_t count)
+{
+    sim_i2c_bus[idx].fault = fault;
+    sim_i2c_bus[idx].fault_count = (fault != SIM_I2C_FAULT_NONE) ? count : 0;
+}
+/******************************************************************************/
+void sim_i2c_fault_rate(int idx, sim_i2c_fault_t fault, uint32_t ppm)
+{
+    sim_i2c_bus[idx].rate_fault = fault;
+    sim_i2c_bus[idx].rate_ppm = (fault != SIM_I2C_FAULT_NONE) ? ppm : 0;
+}
+/******************************************************************************/
+void sim_i2c_get_stats(int idx, sim_i2c_stats_t *stats, int clear)
+{
+    *stats = sim_i2c_bus[idx].stats;
+    if (clear) {
+        memset(&sim_i2c_bus[idx].stats, 0, sizeof(sim_i2c_stats_t));
+    }
+}
+/******************************************************************************/
+void sim_i2c_hold_sda(int idx, uint32_t clocks)
+{
+    sim_i2c_bus[idx].sda_hold = clocks;
+    sim_gpio_refresh(SIM_I2C_PORT);
+}
+/******************************************************************************/
+uint32_t sim_i2c_held(int port, uint32_t old, uint32_t level)
+{
+    uint32_t held = 0;
+    if (port != SIM_I2C_PORT) {
+        return 0;
+    }
+    for (int idx = 0; idx < SIM_I2C_INSTANCES; idx++) {
+        sim_i2c_bus_t *bus = &sim_i2c_bus[idx];
+        // Each SCL pulse clocks out one more bit of the byte the target is sending
+        if (bus->sda_hold != 0 && bus->sda_hold != SIM_I2C_HOLD_FOREVER &&
+            !(old & sim_i2c_pins[idx].scl) && (level & sim_i2c_pins[idx].scl)) {
+            bus->sda_hold--;
+        }
+        if (bus->sda_hold != 0) {
+            held |= sim_i2c_pins[idx].sda;
+        }
+    }
+    return held;
+}
+/******************************************************************************/
+// Picks the fault for the next transaction, if any. A data NACK needs a write
+// phase, so it stays pending over read-only transactions.
+static sim_i2c_fault_t sim_i2c_next_fault(sim_i2c_bus_t *bus, const mxc_i2c_req_t *req)
+{
+    sim_i2c_fault_t fault = SIM_I2C_FAULT_NONE;
+    if (bus->fault_count > 0) {
+        fault = bus->fault;
+    } else if (sim_chance(bus->rate_ppm)) {
+        fault = bus->rate_fault;
+    }
+    if (fault == SIM_I2C_FAULT_DATA_NACK && req->tx_len == 0) {
+        return SIM_I2C_FAULT_NONE;
+    }
+    if (fault != SIM_I2C_FAULT_NONE && bus->fault_count > 0) {
+        bus->fault_count--;
+    }
+    return fault;
+}
+/******************************************************************************/
+// Returns the time the bus needs for the given number of bits
+static uint64_t sim_i2c_busy(sim_i2c_bus_t *bus, uint32_t bits)
+{
+    uint64_t ns = sim_timing.i2c_overhead_ns + (uint64_t)bits * 1000000000ULL / bus->freq;
+    bus->stats.busy_ns += ns;
+    return ns;
+}
+/******************************************************************************/
+// Ends a transaction: sets the flags, runs the callback and returns the result
+static int sim_i2c_finish(mxc_i2c_req_t *req, uint32_t flags)
+{
+    int err = (flags & (MXC_F_I2C_INTFL0_ARB_ERR | MXC_F_I2C_INTFL0_ADDR_NACK_ERR |
+                        MXC_F_I2C_INTFL0_DATA_ERR)) ?
+                  E_COMM_ERR :
+                  E_NO_ERROR;
+    req->i2c->intfl0 |= flags;
+    if (req->callback != NULL) {
+        req->callback(req, err);
+    }
+    return err;
+}
+/******************************************************************************/
+// Runs a transaction against the device models. Returns the flags it ends
+// with and the bus time it takes in *ns.
+static uint32_t sim_i2c_transfer(sim_i2c_bus_t *bus, mxc_i2c_req_t *req, uint64_t *ns)
+{
+    bus->stats.transactions++;
+
+    // Bits on the wire: START and address of each phase, its data bytes, then
+    // STOP. A read-only transaction has no write phase.
+    uint32_t tx_bits = (req->tx_len > 0 || req->rx_len == 0) ?
+                           SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS * (1 + req->tx_len) :
+                           0;
+    uint32_t rx_bits = (req->rx_len > 0) ?
+                           SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS * (1 + req->rx_len) :
+                           0;
+
+    // A line held low stops the controller at START: it sees the bus as
+    // taken by another master
+    const sim_i2c_pins_t *pins = &sim_i2c_pins[bus - sim_i2c_bus];
+    if ((sim_gpio_regs[SIM_I2C_PORT].in & (pins->scl | pins->sda)) != (pins->scl | pins->sda)) {
+        bus->stats.faults++;
+        *ns = sim_i2c_busy(bus, SIM_I2C_COND_BITS);
+        return MXC_F_I2C_INTFL0_ARB_ERR;
+    }
+
+    sim_i2c_device_t *dev = bus->devices;
+    while (dev != NULL && dev->addr != req->addr) {
+        dev = dev->next;
+    }
+    sim_i2c_fault_t fault = sim_i2c_next_fault(bus, req);
+    if (fault != SIM_I2C_FAULT_NONE) {
+        bus->stats.faults++;
+    }
+
+    if (dev == NULL || fault == SIM_I2C_FAULT_ADDR_NACK) {
+        *ns = sim_i2c_busy(bus, SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS + SIM_I2C_COND_BITS);
+        return MXC_F_I2C_INTFL0_ADDR_NACK_ERR | MXC_F_I2C_INTFL0_STOP;
+    }
+    if (fault == SIM_I2C_FAULT_ARB_LOST) {
+        // The other master wins at a random bit and this one releases the bus
+        // without sending STOP
+        *ns = sim_i2c_busy(bus, 1 + sim_rand() % (tx_bits + rx_bits));
+        return MXC_F_I2C_INTFL0_ARB_ERR;
+    }
+    if (fault == SIM_I2C_FAULT_DATA_NACK) {
+        // The target takes the bytes before the one it NACKs
+        unsigned int taken = sim_rand() % req->tx_len;
+        if (taken > 0) {
+            dev->write(dev, req->tx_buf, taken);
+        }
+        bus->stats.bytes += taken;
+        *ns = sim_i2c_busy(bus, SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS * (2 + taken) +
+                                    SIM_I2C_COND_BITS);
+        return MXC_F_I2C_INTFL0_ADDR_ACK | MXC_F_I2C_INTFL0_DATA_ERR | MXC_F_I2C_INTFL0_STOP;
+    }
+
+    *ns = sim_i2c_busy(bus, tx_bits + rx_bits + SIM_I2C_COND_BITS);
+    if (req->tx_len > 0 && dev->write(dev, req->tx_buf, req->tx_len) != 0) {
+        return MXC_F_I2C_INTFL0_ADDR_ACK | MXC_F_I2C_INTFL0_DATA_ERR | MXC_F_I2C_INTFL0_STOP;
+    }
+    if (req->rx_len > 0 && dev->read(dev, req->rx_buf, req->rx_len) != 0) {
+        return MXC_F_I2C_INTFL0_ADDR_ACK | MXC_F_I2C_INTFL0_DATA_ERR | MXC_F_I2C_INTFL0_STOP;
+    }
+    bus->stats.bytes += req->tx_len + req->rx_len;
+    return MXC_F_I2C_INTFL0_ADDR_ACK | MXC_F_I2C_INTFL0_DONE | MXC_F_I2C_INTFL0_STOP;
+}
+/******************************************************************************/
+int MXC_I2C_MasterTransaction(mxc_i2c_req_t *req)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(req->i2c);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    if (!bus->initialized) {
+        return E_UNINITIALIZED;
+    }
+    if (bus->async_req != NULL) {
+        return E_BUSY;
+    }
+    uint64_t ns;
+    uint32_t flags = sim_i2c_transfer(bus, req, &ns);
+    sim_clock_advance(ns);
+    return sim_i2c_finish(req, flags);
+}
+/******************************************************************************/
+static uint64_t sim_i2c_done_next(sim_event_source_t *src)
+{
+    sim_i2c_bus_t *bus = (sim_i2c_bus_t *)((char *)src - offsetof(sim_i2c_bus_t, done));
+    return bus->async_end_ns;
+}
+/******************************************************************************/
+// The bus time of the transaction has passed: raise the I2C interrupt
+static void sim_i2c_done_fire(sim_event_source_t *src)
+{
+    sim_i2c_bus_t *bus = (sim_i2c_bus_t *)((char *)src - offsetof(sim_i2c_bus_t, done));
+    bus->async_end_ns = SIM_NEVER;
+    sim_irq_set_pending(MXC_I2C_GET_IRQ((int)(bus - sim_i2c_bus)));
+}
+/******************************************************************************/
+int MXC_I2C_MasterTransactionAsync(mxc_i2c_req_t *req)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(req->i2c);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    if (!bus->initialized) {
+        return E_UNINITIALIZED;
+    }
+    if (bus->async_req != NULL) {
+        return E_BUSY;
+    }
+    // The models see the transfer now; the core sees it end after the bus time
+    uint64_t ns;
+    bus->async_flags = sim_i2c_transfer(bus, req, &ns);
+    bus->async_req = req;
+    bus->async_end_ns = sim_time_ns() + ns;
+    bus->done.next_ns = sim_i2c_done_next;
+    bus->done.fire = sim_i2c_done_fire;
+    sim_event_register(&bus->done);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void MXC_I2C_AsyncHandler(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus != NULL && bus->target) {
+        // Target events in the order they happened, the end of the transaction
+        // disarms the target before its callback runs
+        while (bus->slave_events != 0) {
+            mxc_i2c_slave_event_t event = (mxc_i2c_slave_event_t)__builtin_ctz(bus->slave_events);
+            mxc_i2c_slave_handler_t cb = bus->slave_cb;
+            bus->slave_events &= ~(1UL << event);
+            if (event == MXC_I2C_EVT_TRANS_COMP) {
+                bus->slave_cb = NULL;
+            }
+            if (cb != NULL) {
+                cb(i2c, event, NULL);
+            }
+        }
+        return;
+    }
+    if (bus == NULL || bus->async_req == NULL || bus->async_end_ns != SIM_NEVER) {
+        return;     // Nothing finished
+    }
+    mxc_i2c_req_t *req = bus->async_req;
+    bus->async_req = NULL;
+    sim_i2c_finish(req, bus->async_flags);
+}
+/******************************************************************************/
+void MXC_I2C_GetFlags(mxc_i2c_regs_t *i2c, unsigned int *flags0, unsigned int *flags1)
+{
+    *flags0 = i2c->intfl0;
+    *flags1 = i2c->intfl1;
+}
+/******************************************************************************/
+void MXC_I2C_ClearFlags(mxc_i2c_regs_t *i2c, unsigned int flags0, unsigned int flags1)
+{
+    i2c->intfl0 &= ~flags0;
+    i2c->intfl1 &= ~flags1;
+}
+/******************************************************************************/
+int MXC_I2C_SlaveTransactionAsync(mxc_i2c_regs_t *i2c, mxc_i2c_slave_handler_t callback)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL || callback == NULL) {
+        return E_BAD_PARAM;
+    }
+    if (!bus->initialized || !bus->target) {
+        return E_BAD_STATE;
+    }
+    if (bus->slave_cb != NULL) {
+        return E_BUSY;
+    }
+    bus->slave_cb = callback;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_I2C_SetRXThreshold(mxc_i2c_regs_t *i2c, unsigned int numBytes)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL || numBytes == 0 || numBytes > MXC_I2C_FIFO_DEPTH) {
+        return E_BAD_PARAM;
+    }
+    bus->rx_thresh = numBytes;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_I2C_SetTXThreshold(mxc_i2c_regs_t *i2c, unsigned int numBytes)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL || numBytes >= MXC_I2C_FIFO_DEPTH) {
+        return E_BAD_PARAM;
+    }
+    bus->tx_thresh = numBytes;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_I2C_ReadRXFIFO(mxc_i2c_regs_t *i2c, volatile unsigned char *bytes, unsigned int len)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    unsigned int n = (len < bus->rx_count) ? len : bus->rx_count;
+    for (unsigned int i = 0; i < n; i++) {
+        bytes[i] = bus->rx_fifo[i];
+    }
+    memmove(bus->rx_fifo, &bus->rx_fifo[n], bus->rx_count - n);
+    bus->rx_count -= n;
+    return (int)n;
+}
+/******************************************************************************/
+int MXC_I2C_WriteTXFIFO(mxc_i2c_regs_t *i2c, volatile unsigned char *bytes, unsigned int len)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    unsigned int n = MXC_I2C_FIFO_DEPTH - bus->tx_count;
+    n = (len < n) ? len : n;
+    for (unsigned int i = 0; i < n; i++) {
+        bus->tx_fifo[bus->tx_count++] = bytes[i];
+    }
+    return (int)n;
+}
+/******************************************************************************/
+int MXC_I2C_GetRXFIFOAvailable(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    return (bus != NULL) ? (int)bus->rx_count : E_BAD_PARAM;
+}
+/******************************************************************************/
+int MXC_I2C_GetTXFIFOAvailable(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    return (bus != NULL) ? (int)(MXC_I2C_FIFO_DEPTH - bus->tx_count) : E_BAD_PARAM;
+}
+/******************************************************************************/
+void MXC_I2C_ClearRXFIFO(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus != NULL) {
+        bus->rx_count = 0;
+    }
+}
+/******************************************************************************/
+void MXC_I2C_ClearTXFIFO(mxc_i2c_regs_t *i2c)
+{
+    sim_i2c_bus_t *bus = sim_i2c_get_bus(i2c);
+    if (bus != NULL) {
+        bus->tx_count = 0;
+    }
+}
+/******************************************************************************/
+// Raises a target event and lets the core take the interrupt; SCL is
+// stretched meanwhile, so the master waits for the handler
+static void sim_i2c_target_event(sim_i2c_bus_t *bus, mxc_i2c_slave_event_t event)
+{
+    bus->slave_events |= 1UL << event;
+    sim_irq_set_pending(MXC_I2C_GET_IRQ((int)(bus - sim_i2c_bus)));
+    sim_irq_dispatch();
+}
+/******************************************************************************/
+// Moves bits of the external master's transaction over the bus
+static void sim_i2c_host_bits(sim_i2c_bus_t *bus, unsigned int hz, uint32_t bits)
+{
+    uint64_t ns = (uint64_t)bits * 1000000000ULL / hz;
+    bus->stats.busy_ns += ns;
+    sim_clock_advance(ns);
+}
+/******************************************************************************/
+int sim_i2c_host_transfer(int idx, unsigned int hz, uint8_t addr, const uint8_t *tx,
+                          unsigned int tx_len, uint8_t *rx, unsigned int rx_len)
+{
+    sim_i2c_bus_t *bus = &sim_i2c_bus[idx];
+    int err = E_NO_ERROR;
+
+    bus->stats.transactions++;
+    sim_i2c_host_bits(bus, hz, SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS);
+    if (!bus->initialized || !bus->target || bus->target_addr != addr || bus->slave_cb == NULL) {
+        sim_i2c_host_bits(bus, hz, SIM_I2C_COND_BITS);     // STOP after the address NACK
+        return E_COMM_ERR;
+    }
+
+    if (tx_len > 0 || rx_len == 0) {
+        sim_i2c_target_event(bus, MXC_I2C_EVT_MASTER_WR);
+        for (unsigned int i = 0; i < tx_len; i++) {
+            sim_i2c_host_bits(bus, hz, SIM_I2C_BYTE_BITS);
+            if (bus->rx_count == MXC_I2C_FIFO_DEPTH) {
+                sim_i2c_target_event(bus, MXC_I2C_EVT_OVERFLOW);
+                err = E_COMM_ERR;   // NACKed, the master stops
+                break;
+            }
+            bus->rx_fifo[bus->rx_count++] = tx[i];
+            bus->stats.bytes++;
+            if (bus->rx_count >= bus->rx_thresh) {
+                sim_i2c_target_event(bus, MXC_I2C_EVT_RX_THRESH);
+            }
+        }
+    }
+    if (err == E_NO_ERROR && rx_len > 0) {
+        if (tx_len > 0) {
+            sim_i2c_host_bits(bus, hz, SIM_I2C_COND_BITS + SIM_I2C_BYTE_BITS);     // Repeated START
+        }
+        sim_i2c_target_event(bus, MXC_I2C_EVT_MASTER_RD);
+        for (unsigned int i = 0; i < rx_len; i++) {
+            if (bus->tx_count == 0) {
+                sim_i2c_target_event(bus, MXC_I2C_EVT_UNDERFLOW);
+            }
+            if (bus->tx_count == 0) {
+                rx[i] = 0xFF;       // Nobody drives SDA, the pull-up does
+            } else {
+                rx[i] = bus->tx_fifo[0];
+                memmove(bus->tx_fifo, &bus->tx_fifo[1], --bus->tx_count);
+            }
+            sim_i2c_host_bits(bus, hz, SIM_I2C_BYTE_BITS);
+            bus->stats.bytes++;
+            if (bus->tx_count <= bus->tx_thresh) {
+                sim_i2c_target_event(bus, MXC_I2C_EVT_TX_THRESH);
+            }
+        }
+    }
+    sim_i2c_host_bits(bus, hz, SIM_I2C_COND_BITS);
+    sim_i2c_target_event(bus, MXC_I2C_EVT_TRANS_COMP);
+    return err;
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "mxc_device.h"
+#include "nvic_table.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Globals *****/
+static void (*sim_vectors[SIM_IRQ_COUNT])(void);    // Handlers set with MXC_NVIC_SetVector()
+static uint8_t sim_irq_enabled[SIM_IRQ_COUNT];
+static volatile uint8_t sim_irq_pending[SIM_IRQ_COUNT];
+static sim_event_source_t *sim_sources;             // Registered event sources
+static uint64_t sim_sleep_total_ns;                 // Time spent in sim_wfi()
+static int sim_irq_active;                          // A handler is running
+
+/***** Functions *****/
+void MXC_NVIC_SetVector(int irqn, void (*irq_callback)(void))
+{
+    if (irqn >= 0 && irqn < SIM_IRQ_COUNT) {
+        sim_vectors[irqn] = irq_callback;
+    }
+}
+/******************************************************************************/
+void NVIC_EnableIRQ(IRQn_Type irqn)
+{
+    sim_irq_enabled[irqn] = 1;
+}
+/******************************************************************************/
+void NVIC_DisableIRQ(IRQn_Type irqn)
+{
+    sim_irq_enabled[irqn] = 0;
+}
+/******************************************************************************/
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn)
+{
+    return sim_irq_pending[irqn];
+}
+/******************************************************************************/
+void NVIC_ClearPendingIRQ(IRQn_Type irqn)
+{
+    sim_irq_pending[irqn] = 0;
+}
+/******************************************************************************/
+void sim_irq_set_pending(int irqn)
+{
+    sim_irq_pending[irqn] = 1;
+}
+/******************************************************************************/
+void sim_event_register(sim_event_source_t *src)
+{
+    for (sim_event_source_t *s = sim_sources; s != NULL; s = s->next) {
+        if (s == src) {
+            return;
+        }
+    }
+    src->next = sim_sources;
+    sim_sources = src;
+}
+/******************************************************************************/
+// Fires every source whose event time has passed
+static void sim_events_poll(void)
+{
+    uint64_t now = sim_time_ns();
+    for (sim_event_source_t *s = sim_sources; s != NULL; s = s->next) {
+        if (s->next_ns(s) <= now) {
+            s->fire(s);
+        }
+    }
+}
+/******************************************************************************/
+// Returns non-zero if an enabled interrupt is pending, which wakes the core
+static int sim_irq_wake_pending(void)
+{
+    for (int i = 0; i < SIM_IRQ_COUNT; i++) {
+        if (sim_irq_pending[i] && sim_irq_enabled[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+/******************************************************************************/
+void sim_irq_dispatch(void)
+{
+    sim_events_poll();
+    if (sim_primask != 0 || sim_irq_active) {
+        return;     // Masked, or already in a handler: no nesting
+    }
+    sim_irq_active = 1;
+    for (int i = 0; i < SIM_IRQ_COUNT; i++) {
+        if (sim_irq_pending[i] && sim_irq_enabled[i] && sim_vectors[i] != NULL) {
+            sim_irq_pending[i] = 0;
+            sim_vectors[i]();
+            i = -1;     // Rescan, the handler may have raised more
+        }
+    }
+    sim_irq_active = 0;
+}
+/******************************************************************************/
+void sim_wfi(void)
+{
+    (void)sim_wfi_until(SIM_NEVER);
+}
+/******************************************************************************/
+int sim_wfi_until(uint64_t deadline_ns)
+{
+    // WFI wakes on a pending enabled interrupt even when PRIMASK masks it
+    sim_events_poll();
+    while (!sim_irq_wake_pending()) {
+        uint64_t next = deadline_ns;
+        for (sim_event_source_t *s = sim_sources; s != NULL; s = s->next) {
+            uint64_t t = s->next_ns(s);
+            next = (t < next) ? t : next;
+        }
+        if (next == SIM_NEVER) {
+            return 0;   // Nothing can wake the core, do not hang
+        }
+        uint64_t now = sim_time_ns();
+        if (next > now) {
+            sim_clock_advance(next - now);
+            sim_sleep_total_ns += next - now;
+        }
+        sim_events_poll();
+        if (sim_time_ns() >= deadline_ns) {
+            break;
+        }
+    }
+    sim_irq_dispatch();
+    return 1;
+}
+/******************************************************************************/
+uint64_t sim_sleep_ns(void)
+{
+    return sim_sleep_total_ns;
+}
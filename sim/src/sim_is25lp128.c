@@ -0,0 +1,277 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spi.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+#define IS25_SIZE 0x1000000UL       // 128 Mbit
+#define IS25_PAGE_SIZE 256
+
+#define IS25_CMD_WRSR 0x01
+#define IS25_CMD_PP 0x02
+#define IS25_CMD_READ 0x03
+#define IS25_CMD_WRDI 0x04
+#define IS25_CMD_RDSR 0x05
+#define IS25_CMD_WREN 0x06
+#define IS25_CMD_FAST_READ 0x0B
+#define IS25_CMD_SER 0x20
+#define IS25_CMD_PPQ 0x32
+#define IS25_CMD_BER32 0x52
+#define IS25_CMD_FRQO 0x6B
+#define IS25_CMD_RDJDID 0x9F
+#define IS25_CMD_SER_ALT 0xD7
+#define IS25_CMD_BER64 0xD8
+
+#define IS25_SR_WIP 0x01
+#define IS25_SR_WEL 0x02
+#define IS25_SR_QE 0x40
+#define IS25_SR_WRITABLE 0xFC       // SRWD, QE and BP3:0
+
+typedef struct {
+    uint8_t *mem;                   // Array
+    uint8_t status;                 // Non-volatile status bits, WIP and WEL are derived
+    int wel;                        // Write enable latch
+    uint64_t busy_until;            // Simulated time when the running operation ends
+    uint8_t cmd;                    // Instruction of the current selection
+    uint32_t pos;                   // Bytes shifted since select
+    uint32_t addr;                  // Address shifted in after the instruction
+    uint8_t sr_data;                // Status byte shifted in by WRSR
+    uint8_t page[IS25_PAGE_SIZE];   // Page buffer of a program instruction
+    int page_valid;                 // Data reached the page buffer
+} sim_is25_t;
+
+/***** Globals *****/
+static sim_is25_t sim_is25;
+static sim_spi_device_t sim_is25_dev;
+static const uint8_t sim_is25_id[3] = { 0x9D, 0x60, 0x18 };   // ISSI, serial flash, 128 Mbit
+
+/***** Functions *****/
+static int sim_is25_busy(const sim_is25_t *f)
+{
+    return sim_time_ns() < f->busy_until;
+}
+/******************************************************************************/
+static void sim_is25_select(sim_spi_device_t *dev)
+{
+    sim_is25_t *f = dev->ctx;
+    f->pos = 0;
+    f->addr = 0;
+    f->page_valid = 0;
+    memset(f->page, 0xFF, sizeof(f->page));
+}
+/******************************************************************************/
+// Returns non-zero if a 24-bit address follows the instruction
+static int sim_is25_has_addr(uint8_t cmd)
+{
+    switch (cmd) {
+    case IS25_CMD_READ:
+    case IS25_CMD_FAST_READ:
+    case IS25_CMD_FRQO:
+    case IS25_CMD_PP:
+    case IS25_CMD_PPQ:
+    case IS25_CMD_SER:
+    case IS25_CMD_SER_ALT:
+    case IS25_CMD_BER32:
+    case IS25_CMD_BER64:
+        return 1;
+    default:
+        return 0;
+    }
+}
+/******************************************************************************/
+// Position of the first data byte after the instruction, address and dummy bytes
+static uint32_t sim_is25_data_start(uint8_t cmd)
+{
+    if (cmd == IS25_CMD_FAST_READ || cmd == IS25_CMD_FRQO) {
+        return 5;                   // 8 dummy clocks on one line
+    }
+    return sim_is25_has_addr(cmd) ? 4 : 1;
+}
+/******************************************************************************/
+// Shifts one byte through the chip and returns the byte it drives
+static uint8_t sim_is25_byte(sim_is25_t *f, uint8_t in, int width)
+{
+    uint32_t pos = f->pos++;
+    if (pos == 0) {
+        f->cmd = in;
+        return 0xFF;
+    }
+    // While a program or erase runs only the status register can be read
+    if (sim_is25_busy(f) && f->cmd != IS25_CMD_RDSR) {
+        return 0xFF;
+    }
+    uint32_t start = sim_is25_data_start(f->cmd);
+    if (pos < 4 && sim_is25_has_addr(f->cmd)) {
+        f->addr = (f->addr << 8) | in;
+        return 0xFF;
+    }
+    if (pos < start) {
+        return 0xFF;                // Dummy byte
+    }
+    uint32_t offset = pos - start;
+    int quad_ok = (width == SPI_WIDTH_QUAD) && (f->status & IS25_SR_QE);
+
+    switch (f->cmd) {
+    case IS25_CMD_RDJDID:
+        return sim_is25_id[offset % sizeof(sim_is25_id)];
+    case IS25_CMD_RDSR:
+        return f->status | (f->wel ? IS25_SR_WEL : 0) | (sim_is25_busy(f) ? IS25_SR_WIP : 0);
+    case IS25_CMD_WRSR:
+        if (offset == 0) {
+            f->sr_data = in;
+            f->page_valid = 1;
+        }
+        return 0xFF;
+    case IS25_CMD_READ:
+    case IS25_CMD_FAST_READ:
+        return f->mem[(f->addr + offset) & (IS25_SIZE - 1)];
+    case IS25_CMD_FRQO:
+        // Data comes out on four lines, and only once QE is set
+        return quad_ok ? f->mem[(f->addr + offset) & (IS25_SIZE - 1)] : 0xFF;
+    case IS25_CMD_PP:
+    case IS25_CMD_PPQ:
+        if (f->cmd == IS25_CMD_PPQ && !quad_ok) {
+            return 0xFF;
+        }
+        // The column wraps inside the page
+        f->page[(f->addr + offset) & (IS25_PAGE_SIZE - 1)] = in;
+        f->page_valid = 1;
+        return 0xFF;
+    default:
+        return 0xFF;
+    }
+}
+/******************************************************************************/
+static void sim_is25_xfer(sim_spi_device_t *dev, const uint8_t *tx, uint8_t *rx, unsigned int len,
+                          int width)
+{
+    sim_is25_t *f = dev->ctx;
+    for (unsigned int i = 0; i < len; i++) {
+        rx[i] = sim_is25_byte(f, (tx != NULL) ? tx[i] : 0xFF, width);
+    }
+}
+/******************************************************************************/
+// Starts an erase of size bytes around the latched address
+static void sim_is25_erase(sim_is25_t *f, uint32_t size, uint32_t ns)
+{
+    memset(f->mem + (f->addr & (IS25_SIZE - 1) & ~(size - 1)), 0xFF, size);
+    f->busy_until = sim_time_ns() + ns;
+}
+/******************************************************************************/
+// Instructions that write take effect when the chip is deselected
+static void sim_is25_deselect(sim_spi_device_t *dev)
+{
+    sim_is25_t *f = dev->ctx;
+    if (f->pos == 0 || sim_is25_busy(f)) {
+        return;
+    }
+    switch (f->cmd) {
+    case IS25_CMD_WREN:
+        f->wel = 1;
+        return;
+    case IS25_CMD_WRDI:
+        f->wel = 0;
+        return;
+    default:
+        break;
+    }
+    if (!f->wel) {
+        return;
+    }
+    switch (f->cmd) {
+    case IS25_CMD_WRSR:
+        if (!f->page_valid) {
+            return;
+        }
+        f->status = f->sr_data & IS25_SR_WRITABLE;
+        f->busy_until = sim_time_ns() + sim_timing.qspi_status_write_ns;
+        break;
+    case IS25_CMD_PP:
+    case IS25_CMD_PPQ:
+        if (f->pos < 4) {
+            return;
+        }
+        if (f->page_valid) {
+            // Programming can only clear bits
+            uint8_t *page = f->mem + (f->addr & (IS25_SIZE - 1) & ~(IS25_PAGE_SIZE - 1));
+            for (int i = 0; i < IS25_PAGE_SIZE; i++) {
+                page[i] &= f->page[i];
+            }
+        }
+        f->busy_until = sim_time_ns() + sim_timing.qspi_page_prog_ns;
+        break;
+    case IS25_CMD_SER:
+    case IS25_CMD_SER_ALT:
+        if (f->pos < 4) {
+            return;
+        }
+        sim_is25_erase(f, 0x1000, sim_timing.qspi_sector_erase_ns);
+        break;
+    case IS25_CMD_BER32:
+        if (f->pos < 4) {
+            return;
+        }
+        sim_is25_erase(f, 0x8000, sim_timing.qspi_block32_erase_ns);
+        break;
+    case IS25_CMD_BER64:
+        if (f->pos < 4) {
+            return;
+        }
+        sim_is25_erase(f, 0x10000, sim_timing.qspi_block64_erase_ns);
+        break;
+    default:
+        return;     // Reads leave the latch set
+    }
+    f->wel = 0;
+}
+/******************************************************************************/
+void sim_is25lp128_attach(int idx, int ss)
+{
+    if (sim_is25.mem == NULL) {
+        sim_is25.mem = malloc(IS25_SIZE);
+        if (sim_is25.mem == NULL) {
+            perror("sim: cannot allocate serial flash array");
+            exit(1);
+        }
+    }
+    memset(sim_is25.mem, 0xFF, IS25_SIZE);
+    sim_is25.status = 0;
+    sim_is25.wel = 0;
+    sim_is25.busy_until = 0;
+
+    sim_is25_dev.ss = ss;
+    sim_is25_dev.select = sim_is25_select;
+    sim_is25_dev.xfer = sim_is25_xfer;
+    sim_is25_dev.deselect = sim_is25_deselect;
+    sim_is25_dev.ctx = &sim_is25;
+    sim_spi_attach(idx, &sim_is25_dev);
+}
+/******************************************************************************/
+uint8_t *sim_is25lp128_array(void)
+{
+    return sim_is25.mem;
+}
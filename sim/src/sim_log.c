@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "mxc_device.h"
+#include "uart.h"
+#include "log.h"
+#include "sim.h"
+
+/***** Definitions *****/
+#define SIM_LOG_RECORD_MAX (LOG_HEADER_SIZE + LOG_MAX_ARGS * sizeof(uint32_t))
+
+/***** Globals *****/
+mxc_uart_regs_t sim_uart_regs[SIM_UART_INSTANCES];
+
+static uint8_t sim_log_rec[SIM_LOG_RECORD_MAX];    // Record being reassembled
+static size_t sim_log_fill = 0;
+
+/***** Functions *****/
+int MXC_UART_Write(mxc_uart_regs_t *uart, uint8_t *byte, int *len)
+{
+    (void)uart;
+    fwrite(byte, 1, (size_t)*len, stdout);
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Prints one complete record
+static void sim_log_print(const uint8_t *rec)
+{
+    static const char level_name[] = "EWID";
+    uint32_t args[LOG_MAX_ARGS] = { 0 };
+    uint32_t fmt_id, ts;
+    unsigned int level = rec[1] >> 4;
+    unsigned int nargs = rec[1] & 0xF;
+    char text[256];
+
+    memcpy(&fmt_id, &rec[4], sizeof(fmt_id));
+    memcpy(&ts, &rec[8], sizeof(ts));
+    memcpy(args, &rec[LOG_HEADER_SIZE], nargs * sizeof(uint32_t));
+
+    // Every argument was stored as a uint32_t, so passing them all is safe
+    snprintf(text, sizeof(text), log_fmt_string(fmt_id), args[0], args[1], args[2], args[3],
+             args[4], args[5], args[6], args[7]);
+    // Drop the newline of the original printf style format, one record per line
+    size_t n = strlen(text);
+    while (n > 0 && text[n - 1] == '\n') {
+        text[--n] = '\0';
+    }
+    printf("  [%c %10u us] %s\n", level_name[level & 0x3], (unsigned)(ts / (SystemCoreClock / 1000000)),
+           text);
+}
+/******************************************************************************/
+void sim_log_text_sink(const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (sim_log_fill == 0 && data[i] != LOG_SYNC) {
+            continue;   // Resynchronise on the next record
+        }
+        sim_log_rec[sim_log_fill++] = data[i];
+        if (sim_log_fill == 2 && (sim_log_rec[1] & 0xF) > LOG_MAX_ARGS) {
+            sim_log_fill = 0;   // Not a record header
+            continue;
+        }
+        if (sim_log_fill >= LOG_HEADER_SIZE) {
+            size_t need = LOG_HEADER_SIZE + (sim_log_rec[1] & 0xF) * sizeof(uint32_t);
+            if (sim_log_fill == need) {
+                sim_log_print(sim_log_rec);
+                sim_log_fill = 0;
+            }
+        }
+    }
+}
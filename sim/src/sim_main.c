@@ -0,0 +1,129 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "log.h"
+#include "test_runner.h"
+#include "i2c1.h"
+#include "memstat.h"
+
+/***** Functions *****/
+static void sim_usage(const char *prog)
+{
+    printf("usage: %s [-l] [-b] [-m] [-f filter] [-n repeat] [-s seed] [-r trace [-x speedup]]\n",
+           prog);
+    printf("  -l         list the selected test cases and exit\n");
+    printf("  -b         write log records in binary, for tools/log_decode.py\n");
+    printf("  -m         print the stack, pool and heap high-water marks after the run\n");
+    printf("  -f filter  comma separated subsystem.name patterns, '*' wildcard\n");
+    printf("  -n repeat  run every selected case this many times\n");
+    printf("  -s seed    seed of the random fault injection\n");
+    printf("  -r trace   replay a drivers/bustrace trace instead of running test cases\n");
+    printf("  -x speedup divide the recorded idle time, 0 leaves it out (default 1)\n");
+}
+/******************************************************************************/
+// Replays a trace file against the models and prints the comparison
+static int sim_replay_file(const char *path, uint32_t speedup)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *trace = malloc(size > 0 ? size : 1);
+    if (trace == NULL || fread(trace, 1, size, f) != (size_t)size) {
+        fclose(f);
+        free(trace);
+        printf("%s: cannot read the trace\n", path);
+        return 2;
+    }
+    fclose(f);
+
+    sim_replay_result_t result;
+    i2c_init();
+    int err = sim_replay(trace, (uint32_t)size, speedup, &result);
+    free(trace);
+    log_drain();
+    sim_replay_print(&result);
+    if (err != E_NO_ERROR) {
+        printf("%s: replay failed, error %d\n", path, err);
+        return 2;
+    }
+    return (result.mismatches == 0) ? 0 : 1;
+}
+/******************************************************************************/
+int main(int argc, char **argv)
+{
+    const char *filter = "";
+    uint32_t repeat = 1;
+    int list = 0;
+    int binary_log = 0;
+    int report = 0;
+    const char *replay = NULL;
+    uint32_t speedup = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0) {
+            list = 1;
+        } else if (strcmp(argv[i], "-b") == 0) {
+            binary_log = 1;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            report = 1;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            repeat = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc) {
+            speedup = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            sim_seed((uint32_t)strtoul(argv[++i], NULL, 0));
+        } else {
+            sim_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    sim_init();
+    log_init(binary_log ? NULL : sim_log_text_sink);   // NULL: raw records on the console
+    if (replay != NULL) {
+        return sim_replay_file(replay, speedup);
+    }
+    if (list) {
+        test_list(filter);
+        return 0;
+    }
+    memstat_stack_paint();
+    int failed = test_run(filter, repeat);
+    if (report) {
+        log_drain();
+        memstat_report();
+    }
+    return (failed == 0) ? 0 : 1;
+}
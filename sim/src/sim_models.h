@@ -0,0 +1,109 @@
+/**
+ * @file       sim_models.h
+ * @brief      Host simulator internals.
+ * @details    Declarations shared between the peripheral models. Not for use
+ *             by drivers or tests.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef __SIM_MODELS_H__
+#define __SIM_MODELS_H__
+
+/***** Includes *****/
+#include "sim.h"
+
+/***** Definitions *****/
+#define SIM_NEVER UINT64_MAX        // No event scheduled
+
+/**
+ * @brief      Source of timed events, e.g. a timer compare or a sensor's data
+ *             ready output. next_ns() returns the simulated time of the next
+ *             event or SIM_NEVER; fire() is called once that time is reached.
+ */
+typedef struct sim_event_source {
+    uint64_t (*next_ns)(struct sim_event_source *src);
+    void (*fire)(struct sim_event_source *src);
+    struct sim_event_source *next;      // Next registered source
+} sim_event_source_t;
+
+/***** Globals *****/
+extern sim_timing_t sim_timing;     // Current model latencies
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Maps the simulated flash array at MXC_FLASH_MEM_BASE.
+ */
+void sim_flash_init(void);
+/**
+ * @brief      Draws a random event.
+ * @param      ppm  Probability in parts per million.
+ * @return     Non-zero if the event happens.
+ */
+int sim_chance(uint32_t ppm);
+/**
+ * @brief      Adds an event source, polled by sim_wfi() and sim_irq_dispatch().
+ * @param      src  Source, must stay valid for the program lifetime.
+ */
+void sim_event_register(sim_event_source_t *src);
+/**
+ * @brief      sim_wfi() that also wakes at a deadline, for the RTOS model's
+ *             idle task.
+ * @param      deadline_ns  Simulated time to wake at the latest, SIM_NEVER for none.
+ * @return     0 if no event is scheduled and there is no deadline, so
+ *             nothing can wake the core; 1 otherwise.
+ */
+int sim_wfi_until(uint64_t deadline_ns);
+/**
+ * @brief      Marks an interrupt pending, as a peripheral would.
+ * @param      irqn Interrupt number.
+ */
+void sim_irq_set_pending(int irqn);
+/**
+ * @brief      Drives input pins from outside the chip, without using bus time.
+ * @param      port Port index.
+ * @param      mask Pins to drive.
+ * @param      level    Level of each driven pin.
+ */
+void sim_gpio_drive(int port, uint32_t mask, uint32_t level);
+/**
+ * @brief      Recomputes the pin levels of a port after a model changed what
+ *             it holds.
+ * @param      port Port index.
+ */
+void sim_gpio_refresh(int port);
+/**
+ * @brief      Returns the pins of a GPIO port that I2C targets hold low.
+ *
+ * Called by the GPIO model whenever the levels of a port change, so a target
+ * holding SDA can count the SCL pulses it sees.
+ *
+ * @param      port Port index.
+ * @param      old  Pin levels before the change.
+ * @param      level    Pin levels after the change, before the targets hold theirs.
+ * @return     Mask of the pins held low.
+ */
+uint32_t sim_i2c_held(int port, uint32_t old, uint32_t level);
+
+#endif
@@ -0,0 +1,272 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* drivers/osal on host threads. The model is a single core: every task is a
+ * thread, but only the one holding sim_osal_cpu and named by sim_osal_current
+ * runs. A task gives the core away when it blocks, yields or ends, to the
+ * next ready task in round robin order. When no task is ready the blocking
+ * one idles for all of them, sleeping the simulated clock to the next event
+ * or wait deadline, so interrupt handlers run and give the semaphores the
+ * tasks wait for. Interrupts never switch tasks on their own; the woken task
+ * runs at the next block or yield of the current one. */
+
+/***** Includes *****/
+#include <pthread.h>
+#include "osal.h"
+#include "sim.h"
+#include "sim_models.h"
+
+#if OSAL_RTOS
+
+/***** Definitions *****/
+typedef struct {
+    pthread_t thread;
+    osal_task_fn_t fn;
+    void *arg;
+    const char *name;
+    const volatile void *wait;      // Mutex or semaphore blocked on, NULL when ready
+    uint64_t deadline_ns;           // End of the wait, SIM_NEVER without a timeout
+    int done;                       // fn returned
+} sim_osal_task_t;
+
+/***** Globals *****/
+static pthread_mutex_t sim_osal_cpu = PTHREAD_MUTEX_INITIALIZER;   // Held by the running task
+static pthread_cond_t sim_osal_wake = PTHREAD_COND_INITIALIZER;    // sim_osal_current changed
+static sim_osal_task_t sim_osal_tasks[OSAL_MAX_TASKS];
+static int sim_osal_count;                      // Tasks created since the last osal_start()
+static int sim_osal_live;                       // Of those, the ones still running
+static sim_osal_task_t *sim_osal_current;       // Task that has the core
+static __thread sim_osal_task_t *sim_osal_self; // Task of the calling thread, NULL outside tasks
+
+/***** Functions *****/
+static int sim_osal_ready(const sim_osal_task_t *t)
+{
+    return !t->done && (t->wait == NULL || sim_time_ns() >= t->deadline_ns);
+}
+/******************************************************************************/
+// Next ready task after self in round robin order, self last; NULL if none
+static sim_osal_task_t *sim_osal_pick(sim_osal_task_t *self)
+{
+    int first = (int)(self - sim_osal_tasks);
+    for (int i = 1; i <= sim_osal_count; i++) {
+        sim_osal_task_t *t = &sim_osal_tasks[(first + i) % sim_osal_count];
+        if (sim_osal_ready(t)) {
+            return t;
+        }
+    }
+    return NULL;
+}
+/******************************************************************************/
+// Hands the core to next and waits until some task hands it back
+static void sim_osal_switch(sim_osal_task_t *self, sim_osal_task_t *next)
+{
+    sim_osal_current = next;
+    pthread_cond_broadcast(&sim_osal_wake);
+    while (sim_osal_current != self) {
+        pthread_cond_wait(&sim_osal_wake, &sim_osal_cpu);
+    }
+}
+/******************************************************************************/
+// One step of a wait for obj: runs another task if one is ready, otherwise
+// sleeps to the next interrupt or deadline. The caller checks obj again.
+static int sim_osal_block(const volatile void *obj, uint64_t deadline_ns)
+{
+    sim_osal_task_t *self = sim_osal_self;
+    if (sim_time_ns() >= deadline_ns) {
+        return E_TIME_OUT;
+    }
+    uint64_t until = deadline_ns;
+    if (self != NULL) {
+        self->wait = obj;
+        self->deadline_ns = deadline_ns;
+        sim_osal_task_t *next = sim_osal_pick(self);
+        if (next != NULL && next != self) {
+            sim_osal_switch(self, next);
+            self->wait = NULL;
+            return E_NO_ERROR;
+        }
+        // Idle, until the first task whose wait expires
+        for (int i = 0; i < sim_osal_count; i++) {
+            sim_osal_task_t *t = &sim_osal_tasks[i];
+            if (!t->done && t->wait != NULL && t->deadline_ns < until) {
+                until = t->deadline_ns;
+            }
+        }
+        self->wait = NULL;
+    }
+    if (!sim_wfi_until(until)) {
+        return E_TIME_OUT;      // Nothing is left that could end the wait
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Makes the tasks blocked on obj ready
+static void sim_osal_wake_waiters(const volatile void *obj)
+{
+    for (int i = 0; i < sim_osal_count; i++) {
+        if (sim_osal_tasks[i].wait == obj) {
+            sim_osal_tasks[i].wait = NULL;
+        }
+    }
+}
+/******************************************************************************/
+int osal_running(void)
+{
+    return sim_osal_self != NULL;
+}
+/******************************************************************************/
+void osal_mutex_lock(osal_mutex_t *m)
+{
+    if (!osal_running()) {
+        return;
+    }
+    while (m->locked) {
+        if (sim_osal_block(m, SIM_NEVER) != E_NO_ERROR) {
+            break;      // Every task waits, a deadlock; let the test see it
+        }
+    }
+    m->locked = 1;
+}
+/******************************************************************************/
+void osal_mutex_unlock(osal_mutex_t *m)
+{
+    if (!osal_running()) {
+        return;
+    }
+    m->locked = 0;
+    sim_osal_wake_waiters(m);
+}
+/******************************************************************************/
+void osal_sem_init(osal_sem_t *s, uint32_t initial)
+{
+    s->count = initial;
+}
+/******************************************************************************/
+int osal_sem_take(osal_sem_t *s, uint32_t timeout_ms)
+{
+    uint64_t deadline_ns = SIM_NEVER;
+    if (timeout_ms != OSAL_WAIT_FOREVER) {
+        deadline_ns = sim_time_ns() + (uint64_t)timeout_ms * 1000000;
+    }
+    while (s->count == 0) {
+        if (sim_osal_block(s, deadline_ns) != E_NO_ERROR) {
+            return E_TIME_OUT;
+        }
+    }
+    s->count--;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void osal_sem_give(osal_sem_t *s)
+{
+    s->count++;
+    sim_osal_wake_waiters(s);
+}
+/******************************************************************************/
+void osal_sem_give_isr(osal_sem_t *s)
+{
+    osal_sem_give(s);
+}
+/******************************************************************************/
+static void *sim_osal_entry(void *arg)
+{
+    sim_osal_task_t *t = arg;
+    pthread_mutex_lock(&sim_osal_cpu);
+    while (sim_osal_current != t) {
+        pthread_cond_wait(&sim_osal_wake, &sim_osal_cpu);
+    }
+    sim_osal_self = t;
+    t->fn(t->arg);
+    t->done = 1;
+    sim_osal_live--;
+
+    // A ready task gets the core, else a blocked one to idle for the rest
+    sim_osal_task_t *next = sim_osal_pick(t);
+    for (int i = 0; next == NULL && i < sim_osal_count; i++) {
+        if (!sim_osal_tasks[i].done) {
+            next = &sim_osal_tasks[i];
+        }
+    }
+    sim_osal_current = next;    // NULL once every task has ended
+    pthread_cond_broadcast(&sim_osal_wake);
+    pthread_mutex_unlock(&sim_osal_cpu);
+    return NULL;
+}
+/******************************************************************************/
+int osal_task_create(osal_task_fn_t fn, void *arg, const char *name)
+{
+    if (sim_osal_count >= OSAL_MAX_TASKS) {
+        return E_NONE_AVAIL;
+    }
+    sim_osal_task_t *t = &sim_osal_tasks[sim_osal_count];
+    t->fn = fn;
+    t->arg = arg;
+    t->name = name;
+    t->wait = NULL;
+    t->deadline_ns = SIM_NEVER;
+    t->done = 0;
+    if (pthread_create(&t->thread, NULL, sim_osal_entry, t) != 0) {
+        return E_NONE_AVAIL;
+    }
+    sim_osal_count++;
+    sim_osal_live++;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+void osal_start(void)
+{
+    if (sim_osal_self != NULL || sim_osal_count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&sim_osal_cpu);
+    sim_osal_current = &sim_osal_tasks[0];
+    pthread_cond_broadcast(&sim_osal_wake);
+    while (sim_osal_live > 0) {
+        pthread_cond_wait(&sim_osal_wake, &sim_osal_cpu);
+    }
+    pthread_mutex_unlock(&sim_osal_cpu);
+
+    for (int i = 0; i < sim_osal_count; i++) {
+        pthread_join(sim_osal_tasks[i].thread, NULL);
+    }
+    sim_osal_count = 0;
+}
+/******************************************************************************/
+void osal_yield(void)
+{
+    sim_osal_task_t *self = sim_osal_self;
+    if (self == NULL) {
+        return;
+    }
+    sim_irq_dispatch();
+    sim_osal_task_t *next = sim_osal_pick(self);
+    if (next != NULL && next != self) {
+        sim_osal_switch(self, next);
+    }
+}
+/******************************************************************************/
+void osal_delay_ms(uint32_t ms)
+{
+    osal_sem_t never = { 0 };
+    (void)osal_sem_take(&never, ms);
+}
+
+#endif
@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "bustrace.h"
+#include "cycles.h"
+#include "flash.h"
+#include "i2c1.h"
+#include "pool.h"
+
+/***** Definitions *****/
+typedef struct {
+    const bustrace_rec_t *rec;      // Record being replayed, NULL between records
+    const uint8_t *payload;         // Its payload
+    uint32_t mismatches;            // Bytes written that differ from the trace
+} sim_replay_t;
+
+_Static_assert(SIM_REPLAY_OPS == BUSTRACE_OP_COUNT, "SIM_REPLAY_OPS out of step with bustrace.h");
+
+/***** Globals *****/
+static sim_replay_t sim_replay_state;
+static sim_i2c_device_t sim_replay_dev[SIM_REPLAY_I2C_ADDRS];
+static uint8_t sim_replay_buf[UINT16_MAX + 1];  // Data of the replayed operation
+
+/***** Functions *****/
+// Write phase: the register address, then the data of a write
+static int sim_replay_write(sim_i2c_device_t *dev, const uint8_t *data, unsigned int len)
+{
+    sim_replay_t *r = dev->ctx;
+    const bustrace_rec_t *rec = r->rec;
+    if (rec == NULL || (rec->target >> 8) != dev->addr) {
+        r->mismatches++;
+        return 1;
+    }
+    if (rec->result != E_NO_ERROR) {
+        return 1;               // Fails the way it failed in the trace
+    }
+    uint32_t payload = (rec->op == BUSTRACE_I2C_WRITE) ? bustrace_payload_len(rec) : 0;
+    if (len != 1 + payload || data[0] != (rec->target & 0xFF) ||
+        memcmp(&data[1], r->payload, payload) != 0) {
+        r->mismatches++;
+    }
+    return 0;
+}
+/******************************************************************************/
+// Read phase: the bytes the target returned in the trace
+static int sim_replay_read(sim_i2c_device_t *dev, uint8_t *data, unsigned int len)
+{
+    sim_replay_t *r = dev->ctx;
+    const bustrace_rec_t *rec = r->rec;
+    if (rec == NULL || rec->result != E_NO_ERROR) {
+        return 1;
+    }
+    memset(data, 0xFF, len);
+    if (rec->op != BUSTRACE_I2C_READ) {
+        r->mismatches++;
+        return 0;
+    }
+    uint32_t payload = bustrace_payload_len(rec);
+    memcpy(data, r->payload, (len < payload) ? len : payload);
+    return 0;
+}
+/******************************************************************************/
+// Attaches a replay target for every I2C address in the trace
+static int sim_replay_attach(const uint8_t *trace, uint32_t size, int idx, unsigned int *count)
+{
+    const bustrace_rec_t *rec;
+    uint32_t pos = 0;
+    *count = 0;
+    while ((rec = bustrace_next(trace, size, &pos)) != NULL) {
+        if (rec->op != BUSTRACE_I2C_WRITE && rec->op != BUSTRACE_I2C_READ) {
+            continue;
+        }
+        uint8_t addr = (uint8_t)(rec->target >> 8);
+        unsigned int i = 0;
+        while (i < *count && sim_replay_dev[i].addr != addr) {
+            i++;
+        }
+        if (i < *count) {
+            continue;
+        }
+        if (*count == SIM_REPLAY_I2C_ADDRS) {
+            return E_NO_DEVICE;
+        }
+        sim_i2c_device_t *dev = &sim_replay_dev[(*count)++];
+        memset(dev, 0, sizeof(*dev));
+        dev->addr = addr;
+        dev->write = sim_replay_write;
+        dev->read = sim_replay_read;
+        dev->ctx = &sim_replay_state;
+        sim_i2c_attach(idx, dev);
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Issues one record through the driver, returns its result
+static int sim_replay_issue(const bustrace_rec_t *rec, const uint8_t *payload)
+{
+    uint8_t addr = (uint8_t)(rec->target >> 8);
+    uint8_t reg = (uint8_t)rec->target;
+    uint32_t stored = bustrace_payload_len(rec);
+    int err;
+
+    switch (rec->op) {
+    case BUSTRACE_I2C_WRITE:
+        memcpy(sim_replay_buf, payload, stored);
+        return i2c_write_register(addr, reg, sim_replay_buf, (uint8_t)rec->len);
+    case BUSTRACE_I2C_READ:
+        err = i2c_read_register(addr, reg, sim_replay_buf, (uint8_t)rec->len);
+        if (err == E_NO_ERROR && memcmp(sim_replay_buf, payload, stored) != 0) {
+            sim_replay_state.mismatches++;
+        }
+        return err;
+    case BUSTRACE_FLASH_READ: {
+        uint8_t *data = Flash_Read(rec->target, rec->len);
+        if (data == NULL) {
+            return E_NONE_AVAIL;
+        }
+        pool_free(data);
+        return E_NO_ERROR;
+    }
+    case BUSTRACE_FLASH_WRITE:
+        memcpy(sim_replay_buf, payload, stored);
+        memset(sim_replay_buf + stored, 0xFF, rec->len - stored);
+        return Flash_WriteBuffer(rec->target, sim_replay_buf, rec->len);
+    case BUSTRACE_FLASH_ERASE:
+        return Flash_PageErase(rec->target);
+    default:
+        return E_BAD_PARAM;
+    }
+}
+/******************************************************************************/
+int sim_replay(const uint8_t *trace, uint32_t size, uint32_t speedup, sim_replay_result_t *result)
+{
+    const bustrace_header_t *hdr = (const bustrace_header_t *)trace;
+    memset(result, 0, sizeof(*result));
+    if (size < sizeof(*hdr) || hdr->magic != BUSTRACE_MAGIC || hdr->clock_hz == 0) {
+        return E_BAD_PARAM;
+    }
+    result->dropped = hdr->dropped;
+
+    int idx = MXC_I2C_GET_IDX(I2C_MASTER);
+    unsigned int devices;
+    int err = sim_replay_attach(trace, size, idx, &devices);
+
+    const bustrace_rec_t *rec;
+    uint32_t pos = 0;
+    uint64_t start_ns = sim_time_ns();
+    memset(&sim_replay_state, 0, sizeof(sim_replay_state));
+    while (err == E_NO_ERROR && (rec = bustrace_next(trace, size, &pos)) != NULL) {
+        uint64_t gap_ns = (uint64_t)rec->gap * 1000000000ULL / hdr->clock_hz;
+        if (speedup != 0) {
+            sim_clock_advance(gap_ns / speedup);
+        }
+        result->recorded_ns += gap_ns + (uint64_t)rec->cycles * 1000000000ULL / hdr->clock_hz;
+
+        sim_replay_state.rec = rec;
+        sim_replay_state.payload = (const uint8_t *)(rec + 1);
+        uint32_t begin = cycles_now();
+        int ret = sim_replay_issue(rec, sim_replay_state.payload);
+        uint32_t cycles = cycles_now() - begin;
+        sim_replay_state.rec = NULL;
+
+        if (ret != rec->result) {
+            result->mismatches++;
+        }
+        // The trace's cycles are at its clock, the replay's at the simulated one
+        sim_replay_op_t *op = &result->ops[rec->op];
+        op->count++;
+        op->recorded_cycles += (uint64_t)rec->cycles * SystemCoreClock / hdr->clock_hz;
+        op->replayed_cycles += cycles;
+        result->records++;
+    }
+    if (err == E_NO_ERROR && hdr->records != result->records) {
+        err = E_BAD_PARAM;      // Stopped at a malformed record
+    }
+    result->replayed_ns = sim_time_ns() - start_ns;
+    result->mismatches += sim_replay_state.mismatches;
+
+    for (unsigned int i = 0; i < devices; i++) {
+        sim_i2c_detach(idx, &sim_replay_dev[i]);
+    }
+    return err;
+}
+/******************************************************************************/
+void sim_replay_print(const sim_replay_result_t *result)
+{
+    static const char *const op_name[SIM_REPLAY_OPS] = {
+        NULL, "i2c_write", "i2c_read", "flash_read", "flash_write", "flash_erase"
+    };
+
+    printf("replay: %u records, %u mismatches, %u dropped while recording\n",
+           (unsigned)result->records, (unsigned)result->mismatches, (unsigned)result->dropped);
+    printf("  %-12s %8s %14s %14s %8s\n", "operation", "count", "recorded us", "replayed us",
+           "change");
+    for (int i = 1; i < BUSTRACE_OP_COUNT; i++) {
+        const sim_replay_op_t *op = &result->ops[i];
+        if (op->count == 0) {
+            continue;
+        }
+        double change = (op->recorded_cycles != 0) ?
+                            100.0 * ((double)op->replayed_cycles - (double)op->recorded_cycles) /
+                                (double)op->recorded_cycles :
+                            0.0;
+        printf("  %-12s %8u %14.1f %14.1f %+7.1f%%\n", op_name[i], (unsigned)op->count,
+               op->recorded_cycles * 1e6 / SystemCoreClock,
+               op->replayed_cycles * 1e6 / SystemCoreClock, change);
+    }
+    printf("  session %.1f us recorded, %.1f us replayed\n", result->recorded_ns / 1e3,
+           result->replayed_ns / 1e3);
+}
@@ -0,0 +1,220 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stddef.h>
+#include "spi.h"
+#include "mxc_errors.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+typedef struct {
+    int initialized;            // MXC_SPI_Init() was called
+    unsigned int freq;          // SCK frequency in Hz
+    mxc_spi_width_t width;      // Width of the next transactions
+    mxc_spi_mode_t mode;        // Clock polarity and phase
+    sim_spi_device_t *devices;  // Attached device models
+    sim_spi_device_t *selected; // Device whose slave select is asserted
+} sim_spi_bus_t;
+
+/***** Globals *****/
+mxc_spi_regs_t sim_spi_regs[SIM_SPI_INSTANCES];
+static sim_spi_bus_t sim_spi_bus[SIM_SPI_INSTANCES];
+
+/***** Functions *****/
+static sim_spi_bus_t *sim_spi_get_bus(mxc_spi_regs_t *spi)
+{
+    int idx = MXC_SPI_GET_IDX(spi);
+    if (idx < 0 || idx >= SIM_SPI_INSTANCES) {
+        return NULL;
+    }
+    return &sim_spi_bus[idx];
+}
+/******************************************************************************/
+void sim_spi_attach(int idx, sim_spi_device_t *dev)
+{
+    dev->next = sim_spi_bus[idx].devices;
+    sim_spi_bus[idx].devices = dev;
+}
+/******************************************************************************/
+int MXC_SPI_Init(mxc_spi_regs_t *spi, int masterMode, int quadModeUsed, int numSlaves,
+                 unsigned ssPolarity, unsigned int hz)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    (void)numSlaves;
+    (void)ssPolarity;
+    if (bus == NULL || !masterMode || (quadModeUsed && spi != MXC_SPI0)) {
+        return E_BAD_PARAM;
+    }
+    if (hz == 0 || hz > SIM_SPI_MAX_FREQ) {
+        return E_BAD_PARAM;
+    }
+    bus->initialized = 1;
+    bus->freq = hz;
+    bus->width = SPI_WIDTH_STANDARD;
+    bus->mode = SPI_MODE_0;
+    bus->selected = NULL;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_SPI_Shutdown(mxc_spi_regs_t *spi)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    if (bus->selected != NULL) {
+        bus->selected->deselect(bus->selected);
+        bus->selected = NULL;
+    }
+    bus->initialized = 0;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_SPI_SetFrequency(mxc_spi_regs_t *spi, unsigned int hz)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    if (bus == NULL || hz == 0 || hz > SIM_SPI_MAX_FREQ) {
+        return E_BAD_PARAM;
+    }
+    bus->freq = hz;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+unsigned int MXC_SPI_GetFrequency(mxc_spi_regs_t *spi)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    return (bus != NULL) ? bus->freq : 0;
+}
+/******************************************************************************/
+int MXC_SPI_SetDataSize(mxc_spi_regs_t *spi, int dataSize)
+{
+    // Only byte transfers are modelled
+    return (sim_spi_get_bus(spi) != NULL && dataSize == 8) ? E_NO_ERROR : E_BAD_PARAM;
+}
+/******************************************************************************/
+int MXC_SPI_SetWidth(mxc_spi_regs_t *spi, mxc_spi_width_t spiWidth)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    if (bus == NULL || spiWidth == SPI_WIDTH_3WIRE ||
+        (spiWidth != SPI_WIDTH_STANDARD && spi != MXC_SPI0)) {
+        return E_BAD_PARAM;
+    }
+    bus->width = spiWidth;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+mxc_spi_width_t MXC_SPI_GetWidth(mxc_spi_regs_t *spi)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    return (bus != NULL) ? bus->width : SPI_WIDTH_STANDARD;
+}
+/******************************************************************************/
+int MXC_SPI_SetMode(mxc_spi_regs_t *spi, mxc_spi_mode_t spiMode)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    if (bus == NULL || spiMode > SPI_MODE_3) {
+        return E_BAD_PARAM;
+    }
+    bus->mode = spiMode;
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+mxc_spi_mode_t MXC_SPI_GetMode(mxc_spi_regs_t *spi)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(spi);
+    return (bus != NULL) ? bus->mode : SPI_MODE_0;
+}
+/******************************************************************************/
+int MXC_SPI_MasterTransaction(mxc_spi_req_t *req)
+{
+    sim_spi_bus_t *bus = sim_spi_get_bus(req->spi);
+    if (bus == NULL) {
+        return E_BAD_PARAM;
+    }
+    if (!bus->initialized) {
+        return E_UNINITIALIZED;
+    }
+    // Dual and quad lines are half duplex: a transaction either sends or receives
+    if (bus->width != SPI_WIDTH_STANDARD && req->txData != NULL && req->rxData != NULL) {
+        return E_BAD_PARAM;
+    }
+    uint32_t tx_len = (req->txData != NULL) ? req->txLen : 0;
+    uint32_t rx_len = (req->rxData != NULL) ? req->rxLen : 0;
+    uint32_t len = (tx_len > rx_len) ? tx_len : rx_len;
+
+    if (bus->selected == NULL) {
+        sim_spi_device_t *dev = bus->devices;
+        while (dev != NULL && dev->ss != req->ssIdx) {
+            dev = dev->next;
+        }
+        bus->selected = dev;
+        if (dev != NULL) {
+            dev->select(dev);
+        }
+    }
+
+    uint8_t tx[64];
+    uint8_t rx[64];
+    for (uint32_t done = 0; done < len;) {
+        uint32_t n = (len - done < sizeof(tx)) ? len - done : sizeof(tx);
+        for (uint32_t i = 0; i < n; i++) {
+            tx[i] = (done + i < tx_len) ? req->txData[done + i] : 0xFF;
+            rx[i] = 0xFF;   // MISO floats high when nothing drives it
+        }
+        if (bus->selected != NULL) {
+            bus->selected->xfer(bus->selected, (tx_len > 0) ? tx : NULL, rx, n, bus->width);
+        }
+        for (uint32_t i = 0; i < n && done + i < rx_len; i++) {
+            req->rxData[done + i] = rx[i];
+        }
+        done += n;
+    }
+
+    // Clocks per byte: 8 on one line, 4 on two, 2 on four
+    uint32_t clocks = (bus->width == SPI_WIDTH_QUAD) ? 2 : (bus->width == SPI_WIDTH_DUAL) ? 4 : 8;
+    sim_clock_advance(sim_timing.spi_overhead_ns +
+                      (uint64_t)len * clocks * 1000000000ULL / bus->freq);
+
+    req->txCnt = tx_len;
+    req->rxCnt = rx_len;
+    if (req->ssDeassert && bus->selected != NULL) {
+        bus->selected->deselect(bus->selected);
+    }
+    if (req->ssDeassert) {
+        bus->selected = NULL;
+    }
+    if (req->completeCB != NULL) {
+        req->completeCB(req, E_NO_ERROR);
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+int MXC_SPI_MasterTransactionDMA(mxc_spi_req_t *req)
+{
+    // The model moves the data at once and completes the request before returning
+    return MXC_SPI_MasterTransaction(req);
+}
+/******************************************************************************/
+void MXC_DMA_Handler(void)
+{
+}
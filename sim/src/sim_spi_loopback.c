@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <string.h>
+#include "spi.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+typedef struct {
+    int idx;                        // SPI instance the device is attached to
+    int attached;                   // On the bus
+    sim_spi_loopback_t stats;       // What the device saw
+} sim_loopback_t;
+
+/***** Globals *****/
+static sim_loopback_t sim_loopback[SIM_SPI_LOOPBACK_MAX];
+static sim_spi_device_t sim_loopback_dev[SIM_SPI_LOOPBACK_MAX];
+
+/***** Functions *****/
+static void sim_loopback_select(sim_spi_device_t *dev)
+{
+    sim_loopback_t *lb = dev->ctx;
+    mxc_spi_regs_t *spi = &sim_spi_regs[lb->idx];
+    // The frame is shifted with the clock and mode the bus has when it starts
+    lb->stats.hz = MXC_SPI_GetFrequency(spi);
+    lb->stats.mode = MXC_SPI_GetMode(spi);
+}
+/******************************************************************************/
+static void sim_loopback_xfer(sim_spi_device_t *dev, const uint8_t *tx, uint8_t *rx,
+                              unsigned int len, int width)
+{
+    sim_loopback_t *lb = dev->ctx;
+    (void)width;
+    // MISO is wired to MOSI
+    if (tx != NULL) {
+        memcpy(rx, tx, len);
+    }
+    lb->stats.bytes += len;
+}
+/******************************************************************************/
+static void sim_loopback_deselect(sim_spi_device_t *dev)
+{
+    sim_loopback_t *lb = dev->ctx;
+    lb->stats.frames++;
+}
+/******************************************************************************/
+void sim_spi_loopback_attach(int idx, int ss)
+{
+    sim_loopback_t *lb = &sim_loopback[ss];
+    if (lb->attached) {
+        return;
+    }
+    lb->idx = idx;
+    lb->attached = 1;
+    sim_loopback_dev[ss].ss = ss;
+    sim_loopback_dev[ss].select = sim_loopback_select;
+    sim_loopback_dev[ss].xfer = sim_loopback_xfer;
+    sim_loopback_dev[ss].deselect = sim_loopback_deselect;
+    sim_loopback_dev[ss].ctx = lb;
+    sim_spi_attach(idx, &sim_loopback_dev[ss]);
+}
+/******************************************************************************/
+void sim_spi_loopback_get(int ss, sim_spi_loopback_t *stats, int clear)
+{
+    *stats = sim_loopback[ss].stats;
+    if (clear) {
+        memset(&sim_loopback[ss].stats, 0, sizeof(sim_loopback[ss].stats));
+    }
+}
@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "wut.h"
+#include "lp.h"
+#include "sim.h"
+#include "sim_models.h"
+
+/***** Definitions *****/
+/**
+ * @brief      Wakeup timer state. The count is derived from the simulated
+ *             time elapsed since it was last set.
+ */
+typedef struct {
+    int enabled;                // Counting
+    uint32_t pres;              // Prescaler shift
+    uint32_t base_count;        // Count at base_ns
+    uint64_t base_ns;           // Time the count was last set or started
+    uint32_t cmp;               // Compare value
+    int armed;                  // Compare interrupt still to come
+    uint32_t intfl;             // Interrupt flag
+} sim_wut_t;
+
+/***** Globals *****/
+static sim_wut_t sim_wut;
+static sim_event_source_t sim_wut_source;
+
+/***** Functions *****/
+// Whole counts in a span of simulated time
+static uint64_t sim_wut_ticks(uint64_t ns)
+{
+    return ns * SIM_WUT_CLOCK / (1000000000ULL << sim_wut.pres);
+}
+/******************************************************************************/
+// Time from a whole count to the count that is ticks later
+static uint64_t sim_wut_span_ns(uint64_t ticks)
+{
+    return (ticks * (1000000000ULL << sim_wut.pres) + SIM_WUT_CLOCK - 1) / SIM_WUT_CLOCK;
+}
+/******************************************************************************/
+uint32_t MXC_WUT_GetCount(void)
+{
+    if (!sim_wut.enabled) {
+        return sim_wut.base_count;
+    }
+    return sim_wut.base_count + (uint32_t)sim_wut_ticks(sim_time_ns() - sim_wut.base_ns);
+}
+/******************************************************************************/
+// Time of the next compare match, counting forward from now (wrapping)
+static uint64_t sim_wut_next_ns(sim_event_source_t *src)
+{
+    (void)src;
+    if (!sim_wut.enabled || !sim_wut.armed) {
+        return SIM_NEVER;
+    }
+    uint64_t ticks = (uint32_t)(sim_wut.cmp - sim_wut.base_count);
+    if (ticks == 0) {
+        ticks = 1ULL << 32;     // Already at the compare value: next match after a wrap
+    }
+    return sim_wut.base_ns + sim_wut_span_ns(ticks);
+}
+/******************************************************************************/
+static void sim_wut_fire(sim_event_source_t *src)
+{
+    (void)src;
+    sim_wut.armed = 0;
+    sim_wut.intfl = 1;
+    sim_irq_set_pending(WUT_IRQn);
+}
+/******************************************************************************/
+// Restarts the count from its current value at the current time
+static void sim_wut_rebase(uint32_t count)
+{
+    sim_wut.base_count = count;
+    sim_wut.base_ns = sim_time_ns();
+}
+/******************************************************************************/
+void MXC_WUT_Init(mxc_wut_pres_t pres)
+{
+    sim_wut.enabled = 0;
+    sim_wut.pres = pres;
+    sim_wut.armed = 0;
+    sim_wut.intfl = 0;
+    sim_wut_rebase(0);
+    sim_wut_source.next_ns = sim_wut_next_ns;
+    sim_wut_source.fire = sim_wut_fire;
+    sim_event_register(&sim_wut_source);
+}
+/******************************************************************************/
+void MXC_WUT_Shutdown(void)
+{
+    MXC_WUT_Disable();
+}
+/******************************************************************************/
+void MXC_WUT_Enable(void)
+{
+    if (!sim_wut.enabled) {
+        sim_wut_rebase(sim_wut.base_count);
+        sim_wut.enabled = 1;
+    }
+}
+/******************************************************************************/
+void MXC_WUT_Disable(void)
+{
+    if (sim_wut.enabled) {
+        sim_wut_rebase(MXC_WUT_GetCount());
+        sim_wut.enabled = 0;
+    }
+}
+/******************************************************************************/
+void MXC_WUT_Config(const mxc_wut_cfg_t *cfg)
+{
+    MXC_WUT_SetCompare(cfg->cmp_cnt);
+}
+/******************************************************************************/
+uint32_t MXC_WUT_GetCompare(void)
+{
+    return sim_wut.cmp;
+}
+/******************************************************************************/
+void MXC_WUT_IntClear(void)
+{
+    sim_wut.intfl = 0;
+}
+/******************************************************************************/
+uint32_t MXC_WUT_IntStatus(void)
+{
+    return sim_wut.intfl;
+}
+/******************************************************************************/
+void MXC_WUT_SetCompare(uint32_t cmp_cnt)
+{
+    // Move the base to the last whole count, so the next match is counted
+    // from there without losing the partial count
+    if (sim_wut.enabled) {
+        uint64_t ticks = sim_wut_ticks(sim_time_ns() - sim_wut.base_ns);
+        sim_wut.base_count += (uint32_t)ticks;
+        sim_wut.base_ns += sim_wut_span_ns(ticks);
+    }
+    sim_wut.cmp = cmp_cnt;
+    sim_wut.armed = 1;
+}
+/******************************************************************************/
+void MXC_WUT_SetCount(uint32_t cnt)
+{
+    sim_wut_rebase(cnt);
+}
+/******************************************************************************/
+void MXC_LP_EnterSleepMode(void)
+{
+    sim_wfi();
+}
+/******************************************************************************/
+void MXC_LP_EnableWUTAlarmWakeup(void)
+{
+}
+/******************************************************************************/
+void MXC_LP_EnableGPIOWakeup(mxc_gpio_cfg_t *wu_pins)
+{
+    (void)wu_pins;
+}
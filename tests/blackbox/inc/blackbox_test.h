@@ -0,0 +1,79 @@
+/**
+ * @file       blackbox_test.h
+ * @brief      Crash black box test cases.
+ * @details    Checks the ring order and wrap, its survival across
+ *             blackbox_init(), a dump to flash and the append cost.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BLACKBOX_TEST_H__
+#define __BLACKBOX_TEST_H__
+
+/***** Includes *****/
+#include "blackbox.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define BLACKBOX_TEST_WRAP 5            // Events recorded past a full ring
+#define BLACKBOX_BENCH_EVENTS 1000      // blackbox_event() calls timed by the benchmark
+#define BLACKBOX_BENCH_MAX_CYCLES 48    // Allowed average cost of one append
+
+/***** Function Prototypes *****/
+#if BLACKBOX_ENABLE
+/**
+ * @brief      Records more events than the ring holds and checks that the
+ *             newest ones are kept in order with their sequence numbers.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blackbox_ring(void);
+/**
+ * @brief      Calls blackbox_init() again and checks that the ring is kept
+ *             and a boot event is added.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blackbox_warm(void);
+/**
+ * @brief      Times blackbox_event() and checks the average cost per event.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blackbox_bench(void);
+#endif
+/**
+ * @brief      Dumps the ring with a made up exception frame, checks the saved
+ *             header and events, then erases the page. On the target the case
+ *             leaves a dump that is already in flash alone.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blackbox_dump(void);
+#if BLACKBOX_ENABLE
+/**
+ * @brief      Calls blackbox_init() as after a reset that skipped the dump and
+ *             checks that the ring is saved with BLACKBOX_CAUSE_RESET, once,
+ *             then erases the page. Leaves a dump already in flash alone.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blackbox_reset(void);
+#endif
+
+#endif
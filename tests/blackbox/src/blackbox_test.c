@@ -0,0 +1,181 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include "blackbox_test.h"
+#include "blackbox.h"
+#include "mxc_errors.h"
+#include "cycles.h"
+#include "test_runner.h"
+
+#if BLACKBOX_ENABLE
+/******************************************************************************/
+// Returns the newest entry
+static const blackbox_entry_t *blackbox_test_last(void)
+{
+    return &blackbox_ring[(blackbox_head - 1) & (BLACKBOX_ENTRIES - 1)];
+}
+/******************************************************************************/
+int test_blackbox_ring(void)
+{
+    blackbox_init();
+    uint32_t head = blackbox_head;
+    uint32_t total = BLACKBOX_ENTRIES + BLACKBOX_TEST_WRAP;
+
+    for (uint32_t i = 0; i < total; i++) {
+        blackbox_event(BLACKBOX_EV_USER, i, ~i);
+    }
+    if (blackbox_head != head + total) {
+        printf("blackbox: head %u, expected %u\n", (unsigned)blackbox_head,
+               (unsigned)(head + total));
+        return 1;
+    }
+    // The first BLACKBOX_TEST_WRAP events were overwritten
+    for (uint32_t i = BLACKBOX_TEST_WRAP; i < total; i++) {
+        uint32_t seq = head + i;
+        const blackbox_entry_t *e = &blackbox_ring[seq & (BLACKBOX_ENTRIES - 1)];
+        if ((e->id & 0xFFFF) != BLACKBOX_EV_USER || (e->id >> 16) != (seq & 0xFFFF) ||
+            e->a != i || e->b != ~i) {
+            printf("blackbox: event %u reads id 0x%08x a %u\n", (unsigned)i, (unsigned)e->id,
+                   (unsigned)e->a);
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(blackbox, test_blackbox_ring, 100)
+/******************************************************************************/
+int test_blackbox_warm(void)
+{
+    blackbox_init();
+    uint32_t head = blackbox_head;
+    if (blackbox_init() != 1 || blackbox_head != head + 1) {
+        return 1;
+    }
+    const blackbox_entry_t *e = blackbox_test_last();
+    if ((e->id & 0xFFFF) != BLACKBOX_EV_BOOT || e->a != 1) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(blackbox, test_blackbox_warm, 100)
+/******************************************************************************/
+int test_blackbox_bench(void)
+{
+    blackbox_init();
+    uint32_t start = cycles_now();
+    for (uint32_t i = 0; i < BLACKBOX_BENCH_EVENTS; i++) {
+        blackbox_event(BLACKBOX_EV_USER, i, 0);
+    }
+    uint32_t cycles = cycles_now() - start;
+
+    printf("blackbox: %d events recorded in %u cycles, %u per event\n", BLACKBOX_BENCH_EVENTS,
+           (unsigned)cycles, (unsigned)(cycles / BLACKBOX_BENCH_EVENTS));
+    return (cycles / BLACKBOX_BENCH_EVENTS > BLACKBOX_BENCH_MAX_CYCLES) ? 1 : 0;
+}
+TEST_REGISTER(blackbox, test_blackbox_bench, 100)
+#endif
+/******************************************************************************/
+int test_blackbox_dump(void)
+{
+    // Exception frame: r0-r3, r12, lr, pc, psr
+    const uint32_t frame[8] = { 0, 1, 2, 3, 12, 0x10000101, 0x10000200, 0x01000000 };
+
+#ifndef HOST_SIM
+    if (blackbox_saved() != NULL) {
+        printf("blackbox: crash dump in flash, not overwritten\n");
+        return 0;
+    }
+#endif
+    blackbox_init();
+    for (uint32_t i = 0; i < 3; i++) {
+        blackbox_event(BLACKBOX_EV_USER + 1, 0xA0 + i, i);
+    }
+    uint32_t head = blackbox_head;
+
+    uint32_t start = cycles_now();
+    if (blackbox_dump(BLACKBOX_CAUSE_REQUEST, frame) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t cycles = cycles_now() - start;
+
+    const blackbox_dump_t *d = blackbox_saved();
+    if (d == NULL || d->cause != BLACKBOX_CAUSE_REQUEST || d->head != head ||
+        d->lr != frame[5] || d->pc != frame[6] || d->psr != frame[7]) {
+        return 1;
+    }
+    if (d->count != ((head < BLACKBOX_ENTRIES) ? head : BLACKBOX_ENTRIES)) {
+        return 1;
+    }
+#if BLACKBOX_ENABLE
+    // Oldest first, so the events above are the last three
+    const blackbox_entry_t *e = (const blackbox_entry_t *)((const uint8_t *)d + BLACKBOX_DUMP_HEADER);
+    for (uint32_t i = 0; i < 3; i++) {
+        const blackbox_entry_t *s = &e[d->count - 3 + i];
+        if ((s->id & 0xFFFF) != BLACKBOX_EV_USER + 1 || s->a != 0xA0 + i || s->b != i) {
+            return 1;
+        }
+    }
+#endif
+    printf("blackbox: %u events dumped in %u us\n", (unsigned)d->count,
+           (unsigned)cycles_to_us(cycles));
+
+    if (blackbox_clear() != E_NO_ERROR || blackbox_saved() != NULL) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(blackbox, test_blackbox_dump, 1000)
+#if BLACKBOX_ENABLE
+/******************************************************************************/
+int test_blackbox_reset(void)
+{
+    if (blackbox_saved() != NULL) {
+        printf("blackbox: crash dump in flash, not overwritten\n");
+        return 0;
+    }
+    blackbox_init();
+    blackbox_event(BLACKBOX_EV_USER + 2, 0xB0, 0);
+    uint32_t head = blackbox_head;
+
+    blackbox_booted = 0;        // As the startup code leaves it after a reset
+    if (blackbox_init() != 1) {
+        return 1;
+    }
+    const blackbox_dump_t *d = blackbox_saved();
+    if (d == NULL || d->cause != BLACKBOX_CAUSE_RESET || d->head != head) {
+        return 1;
+    }
+    // Only the first call after the reset saves the ring
+    blackbox_event(BLACKBOX_EV_USER + 2, 0xB1, 0);
+    blackbox_init();
+    if (blackbox_saved()->head != head) {
+        return 1;
+    }
+
+    if (blackbox_clear() != E_NO_ERROR || blackbox_saved() != NULL) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(blackbox, test_blackbox_reset, 1000)
+#endif
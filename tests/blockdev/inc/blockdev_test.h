@@ -0,0 +1,63 @@
+/**
+ * @file       blockdev_test.h
+ * @brief      testing the block device interface.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the internal flash and QSPI flash block devices.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BLOCKDEV_TEST_H__
+#define __BLOCKDEV_TEST_H__
+
+/***** Includes *****/
+#include "blockdev.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define BLOCKDEV_TEST_BLOCK 0x2000  // Scratch bytes at the end of every device, erase aligned
+#define BLOCKDEV_TEST_LEN 0x1000    // Bytes programmed and read by the tests
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes both devices and checks their geometry.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blockdev_init(void);
+/**
+ * @brief      Erases, programs and reads back the scratch area of both devices.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blockdev_program_read(void);
+/**
+ * @brief      Checks unaligned and out of range requests are refused.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blockdev_bounds(void);
+/**
+ * @brief      Times erase, program and read on both devices and prints them side by side.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_blockdev_bench(void);
+
+#endif
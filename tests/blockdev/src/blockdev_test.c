@@ -0,0 +1,145 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "blockdev_test.h"
+#include "blockdev.h"
+#include "test_runner.h"
+#include "cycles.h"
+
+/***** Globals *****/
+static const blockdev_t *const blockdev_test_devs[] = { &blockdev_flc, &blockdev_qspi };
+static uint8_t blockdev_test_ref[BLOCKDEV_TEST_LEN];
+static uint8_t blockdev_test_buf[BLOCKDEV_TEST_LEN];
+
+/***** Functions *****/
+static uint32_t blockdev_test_offset(const blockdev_t *bd)
+{
+    return bd->geometry.size - BLOCKDEV_TEST_BLOCK;
+}
+/******************************************************************************/
+int test_blockdev_init(void)
+{
+    blockdev_geometry_t geo;
+
+    for (size_t i = 0; i < sizeof(blockdev_test_devs) / sizeof(blockdev_test_devs[0]); i++) {
+        const blockdev_t *bd = blockdev_test_devs[i];
+        if (blockdev_init(bd) != E_NO_ERROR) {
+            return 1;
+        }
+        blockdev_geometry(bd, &geo);
+        if (geo.size == 0 || geo.read_size == 0 || geo.prog_size == 0 ||
+            geo.erase_size % geo.prog_size != 0 || geo.size % geo.erase_size != 0 ||
+            BLOCKDEV_TEST_BLOCK % geo.erase_size != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(blockdev, test_blockdev_init, 100)
+/******************************************************************************/
+int test_blockdev_program_read(void)
+{
+    for (uint32_t i = 0; i < BLOCKDEV_TEST_LEN; i++) {
+        blockdev_test_ref[i] = (uint8_t)(i * 7 + 3);
+    }
+    for (size_t i = 0; i < sizeof(blockdev_test_devs) / sizeof(blockdev_test_devs[0]); i++) {
+        const blockdev_t *bd = blockdev_test_devs[i];
+        uint32_t offset = blockdev_test_offset(bd);
+
+        if (blockdev_erase(bd, offset, BLOCKDEV_TEST_BLOCK) != E_NO_ERROR ||
+            blockdev_read(bd, offset, blockdev_test_buf, BLOCKDEV_TEST_LEN) != E_NO_ERROR) {
+            return 1;
+        }
+        for (uint32_t j = 0; j < BLOCKDEV_TEST_LEN; j++) {
+            if (blockdev_test_buf[j] != 0xFF) {
+                return 1;
+            }
+        }
+        if (blockdev_program(bd, offset, blockdev_test_ref, BLOCKDEV_TEST_LEN) != E_NO_ERROR ||
+            blockdev_sync(bd) != E_NO_ERROR ||
+            blockdev_read(bd, offset, blockdev_test_buf, BLOCKDEV_TEST_LEN) != E_NO_ERROR) {
+            return 1;
+        }
+        if (memcmp(blockdev_test_buf, blockdev_test_ref, BLOCKDEV_TEST_LEN) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(blockdev, test_blockdev_program_read, 1000)
+/******************************************************************************/
+int test_blockdev_bounds(void)
+{
+    const blockdev_t *bd = &blockdev_flc;
+    const uint32_t end = bd->geometry.size;
+    uint8_t data[16] = { 0 };
+
+    if (blockdev_program(bd, 4, data, bd->geometry.prog_size) != E_BAD_PARAM ||
+        blockdev_program(bd, 0, data, 4) != E_BAD_PARAM ||
+        blockdev_erase(bd, bd->geometry.erase_size / 2, bd->geometry.erase_size) != E_BAD_PARAM ||
+        blockdev_read(bd, end - 1, data, 2) != E_BAD_PARAM ||
+        blockdev_read(bd, end, data, 1) != E_BAD_PARAM) {
+        return 1;
+    }
+    bd = &blockdev_qspi;
+    if (blockdev_erase(bd, 0, bd->geometry.erase_size + 1) != E_BAD_PARAM ||
+        blockdev_erase(bd, bd->geometry.size, bd->geometry.erase_size) != E_BAD_PARAM) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(blockdev, test_blockdev_bounds, 100)
+/******************************************************************************/
+int test_blockdev_bench(void)
+{
+    for (size_t i = 0; i < sizeof(blockdev_test_devs) / sizeof(blockdev_test_devs[0]); i++) {
+        const blockdev_t *bd = blockdev_test_devs[i];
+        uint32_t offset = blockdev_test_offset(bd);
+
+        uint32_t start = cycles_now();
+        if (blockdev_erase(bd, offset, BLOCKDEV_TEST_BLOCK) != E_NO_ERROR) {
+            return 1;
+        }
+        uint32_t erase_us = cycles_to_us(cycles_now() - start);
+
+        start = cycles_now();
+        if (blockdev_program(bd, offset, blockdev_test_ref, BLOCKDEV_TEST_LEN) != E_NO_ERROR ||
+            blockdev_sync(bd) != E_NO_ERROR) {
+            return 1;
+        }
+        uint32_t prog_us = cycles_to_us(cycles_now() - start);
+
+        start = cycles_now();
+        if (blockdev_read(bd, offset, blockdev_test_buf, BLOCKDEV_TEST_LEN) != E_NO_ERROR) {
+            return 1;
+        }
+        uint32_t read_us = cycles_to_us(cycles_now() - start);
+
+        printf("blockdev %-4s: erase %u bytes %u us, program %u bytes %u us, read %u us\n",
+               bd->name, (unsigned)BLOCKDEV_TEST_BLOCK, (unsigned)erase_us,
+               (unsigned)BLOCKDEV_TEST_LEN, (unsigned)prog_us, (unsigned)read_us);
+    }
+    return 0;
+}
+TEST_REGISTER(blockdev, test_blockdev_bench, 2000)
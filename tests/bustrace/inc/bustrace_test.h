@@ -0,0 +1,76 @@
+/**
+ * @file       bustrace_test.h
+ * @brief      Bus trace test cases.
+ * @details    Checks what the I2C and flash drivers record and, in the
+ *             simulator, that a recorded session replays against the models
+ *             with the same results and timing.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __BUSTRACE_TEST_H__
+#define __BUSTRACE_TEST_H__
+
+/***** Includes *****/
+#include "bustrace.h"
+#include "test_runner.h"
+#include "flash_layout.h"
+
+/***** Definitions *****/
+#define BUSTRACE_TEST_ADDR FLASH_SCRATCH_BASE
+#define BUSTRACE_TEST_BUF 4096          // Trace buffer of the test cases
+#define BUSTRACE_TEST_SAMPLES 20        // IMU samples in the replayed session
+#define BUSTRACE_TEST_IDLE_US 5000      // Idle time between the samples
+#define BUSTRACE_TEST_TOLERANCE 20      // Percent a replayed duration may differ
+
+/***** Function Prototypes *****/
+#if BUSTRACE_ENABLE
+/**
+ * @brief      Records an I2C read and write and a flash erase, write and read,
+ *             and checks the records.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_bustrace_record(void);
+/**
+ * @brief      Records into a buffer too small for the session and checks that
+ *             the records that did not fit are counted and the rest parse.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_bustrace_overflow(void);
+#ifdef HOST_SIM
+/**
+ * @brief      Records an IMU logging session and replays it at recorded speed
+ *             and with the idle time left out.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_bustrace_replay(void);
+/**
+ * @brief      Replays a session against slower flash and checks that the
+ *             replay shows the flash operations slowed down and I2C unchanged.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_bustrace_regression(void);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,245 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "bustrace_test.h"
+#include "bustrace.h"
+#include "flash.h"
+#include "i2c1.h"
+#include "pool.h"
+#include "test_runner.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+#if BUSTRACE_ENABLE
+/***** Globals *****/
+static uint8_t bustrace_test_buf[BUSTRACE_TEST_BUF] __attribute__((aligned(4)));
+
+/***** Functions *****/
+// Checks one record
+static int bustrace_test_check(const bustrace_rec_t *rec, uint8_t op, uint32_t target,
+                               uint32_t len)
+{
+    if (rec == NULL || rec->op != op || rec->target != target || rec->len != len ||
+        rec->result != E_NO_ERROR) {
+        printf("bustrace: expected op %u target 0x%08x len %u, got op %u target 0x%08x len %u\n",
+               op, (unsigned)target, (unsigned)len, rec ? rec->op : 0,
+               rec ? (unsigned)rec->target : 0, rec ? rec->len : 0);
+        return 1;
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_bustrace_record(void)
+{
+    const uint8_t data[32] = { 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE };
+    uint8_t map;
+
+    if (i2c_init() != 0 || bustrace_start(bustrace_test_buf, sizeof(bustrace_test_buf)) != 0) {
+        return 1;
+    }
+    // Writes back the value read, so the sensor setup is left as it was
+    int err = i2c_read_register(BMI160_I2C_ADDR, BMI160_INT_MAP_1_REG, &map, 1);
+    err |= i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_MAP_1_REG, &map, 1);
+    err |= Flash_PageErase(BUSTRACE_TEST_ADDR);
+    err |= Flash_WriteBuffer(BUSTRACE_TEST_ADDR, data, sizeof(data));
+    uint8_t *read = Flash_Read(BUSTRACE_TEST_ADDR, 16);
+    pool_free(read);
+    uint32_t size = bustrace_stop();
+    if (err != E_NO_ERROR || read == NULL) {
+        return 1;
+    }
+    // Not recorded once stopped
+    i2c_read_register(BMI160_I2C_ADDR, BMI160_INT_MAP_1_REG, &map, 1);
+
+    const bustrace_header_t *hdr = (const bustrace_header_t *)bustrace_test_buf;
+    if (hdr->records != 5 || hdr->dropped != 0 || hdr->clock_hz != SystemCoreClock) {
+        return 1;
+    }
+    uint32_t target = (BMI160_I2C_ADDR << 8) | BMI160_INT_MAP_1_REG;
+    uint32_t pos = 0;
+    const bustrace_rec_t *rec = bustrace_next(bustrace_test_buf, size, &pos);
+    if (bustrace_test_check(rec, BUSTRACE_I2C_READ, target, 1) ||
+        *(const uint8_t *)(rec + 1) != map) {
+        return 1;
+    }
+    rec = bustrace_next(bustrace_test_buf, size, &pos);
+    if (bustrace_test_check(rec, BUSTRACE_I2C_WRITE, target, 1) ||
+        *(const uint8_t *)(rec + 1) != map) {
+        return 1;
+    }
+    rec = bustrace_next(bustrace_test_buf, size, &pos);
+    if (bustrace_test_check(rec, BUSTRACE_FLASH_ERASE, BUSTRACE_TEST_ADDR, 0)) {
+        return 1;
+    }
+    rec = bustrace_next(bustrace_test_buf, size, &pos);
+    if (bustrace_test_check(rec, BUSTRACE_FLASH_WRITE, BUSTRACE_TEST_ADDR, sizeof(data)) ||
+        memcmp(rec + 1, data, sizeof(data)) != 0) {
+        return 1;
+    }
+    rec = bustrace_next(bustrace_test_buf, size, &pos);
+    if (bustrace_test_check(rec, BUSTRACE_FLASH_READ, BUSTRACE_TEST_ADDR, 16)) {
+        return 1;
+    }
+    if (bustrace_next(bustrace_test_buf, size, &pos) != NULL || pos != size) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(bustrace, test_bustrace_record, 200)
+/******************************************************************************/
+int test_bustrace_overflow(void)
+{
+    const uint8_t data[16] = { 0 };
+    // Room for the header and one write of 16 bytes
+    uint32_t room = sizeof(bustrace_header_t) + sizeof(bustrace_rec_t) + sizeof(data);
+
+    if (Flash_PageErase(BUSTRACE_TEST_ADDR) != E_NO_ERROR ||
+        bustrace_start(bustrace_test_buf, room) != E_NO_ERROR) {
+        return 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        Flash_WriteBuffer(BUSTRACE_TEST_ADDR + i * sizeof(data), data, sizeof(data));
+    }
+    uint32_t size = bustrace_stop();
+
+    const bustrace_header_t *hdr = (const bustrace_header_t *)bustrace_test_buf;
+    uint32_t pos = 0;
+    if (size != room || hdr->records != 1 || hdr->dropped != 2) {
+        return 1;
+    }
+    if (bustrace_next(bustrace_test_buf, size, &pos) == NULL ||
+        bustrace_next(bustrace_test_buf, size, &pos) != NULL) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(bustrace, test_bustrace_overflow, 200)
+#ifdef HOST_SIM
+/******************************************************************************/
+// IMU logging: a sample read every BUSTRACE_TEST_IDLE_US, every fifth stored
+static uint32_t bustrace_test_session(void)
+{
+    uint8_t sample[2 * BMI160_SAMPLE_AXES];
+
+    if (i2c_init() != 0 || bustrace_start(bustrace_test_buf, sizeof(bustrace_test_buf)) != 0) {
+        return 0;
+    }
+    int err = Flash_PageErase(BUSTRACE_TEST_ADDR);
+    for (int i = 0; i < BUSTRACE_TEST_SAMPLES; i++) {
+        sim_clock_advance(BUSTRACE_TEST_IDLE_US * 1000ULL);
+        err |= i2c_read_register(BMI160_I2C_ADDR, BMI160_DATA_REG, sample, sizeof(sample));
+        if (i % 5 == 4) {
+            err |= Flash_WriteBuffer(BUSTRACE_TEST_ADDR + i * sizeof(sample), sample,
+                                     sizeof(sample));
+        }
+    }
+    uint32_t size = bustrace_stop();
+    return (err == E_NO_ERROR) ? size : 0;
+}
+/******************************************************************************/
+// Checks that the replayed time of an operation is recorded * percent / 100
+static int bustrace_test_ratio(const sim_replay_op_t *op, uint32_t percent)
+{
+    uint64_t expect = op->recorded_cycles * percent / 100;
+    uint64_t slack = expect * BUSTRACE_TEST_TOLERANCE / 100;
+    if (op->count == 0 || op->replayed_cycles + slack < expect ||
+        op->replayed_cycles > expect + slack) {
+        printf("bustrace: %u operations replayed in %llu cycles, expected %llu\n",
+               (unsigned)op->count, (unsigned long long)op->replayed_cycles,
+               (unsigned long long)expect);
+        return 1;
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_bustrace_replay(void)
+{
+    sim_replay_result_t result;
+    uint32_t size = bustrace_test_session();
+    if (size == 0) {
+        return 1;
+    }
+
+    // At recorded speed the session takes as long as it did
+    if (sim_replay(bustrace_test_buf, size, 1, &result) != E_NO_ERROR) {
+        return 1;
+    }
+    sim_replay_print(&result);
+    if (result.records != 1 + BUSTRACE_TEST_SAMPLES + BUSTRACE_TEST_SAMPLES / 5 ||
+        result.mismatches != 0) {
+        return 1;
+    }
+    for (int op = BUSTRACE_I2C_READ; op <= BUSTRACE_FLASH_ERASE; op++) {
+        if (op != BUSTRACE_FLASH_READ && bustrace_test_ratio(&result.ops[op], 100)) {
+            return 1;
+        }
+    }
+    uint64_t recorded_ns = result.recorded_ns;
+    if (result.replayed_ns * 100 < recorded_ns * (100 - BUSTRACE_TEST_TOLERANCE)) {
+        return 1;
+    }
+
+    // Without the idle time only the bus and flash time is left
+    if (sim_replay(bustrace_test_buf, size, 0, &result) != E_NO_ERROR || result.mismatches != 0) {
+        return 1;
+    }
+    uint64_t idle_ns = BUSTRACE_TEST_SAMPLES * BUSTRACE_TEST_IDLE_US * 1000ULL;
+    if (result.replayed_ns + idle_ns / 2 > recorded_ns) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(bustrace, test_bustrace_replay, 2000)
+/******************************************************************************/
+int test_bustrace_regression(void)
+{
+    sim_timing_t timing;
+    sim_replay_result_t result;
+    uint32_t size = bustrace_test_session();
+    if (size == 0) {
+        return 1;
+    }
+
+    // The same session on flash that programs and erases at half the speed
+    sim_timing_get(&timing);
+    timing.flash_prog_ns *= 2;
+    timing.flash_page_erase_ns *= 2;
+    sim_timing_set(&timing);
+    int err = sim_replay(bustrace_test_buf, size, 0, &result);
+    sim_timing_set(NULL);
+    if (err != E_NO_ERROR || result.mismatches != 0) {
+        return 1;
+    }
+    sim_replay_print(&result);
+    if (bustrace_test_ratio(&result.ops[BUSTRACE_I2C_READ], 100) ||
+        bustrace_test_ratio(&result.ops[BUSTRACE_FLASH_WRITE], 200) ||
+        bustrace_test_ratio(&result.ops[BUSTRACE_FLASH_ERASE], 200)) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(bustrace, test_bustrace_regression, 2000)
+#endif
+#endif
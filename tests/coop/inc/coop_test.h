@@ -0,0 +1,87 @@
+/**
+ * @file       coop_test.h
+ * @brief      testing the cooperative tasks.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the cooperative tasks and the asynchronous driver calls
+ *             they wait for, and for the sensor logging demo.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __COOP_TEST_H__
+#define __COOP_TEST_H__
+
+/***** Includes *****/
+#include "coop.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define COOP_SWITCH_YIELDS 10000    // Yields per task in test_coop_switch()
+#define COOP_DEMO_MS 1000           // Time each demo variant runs for
+#define COOP_DEMO_LOG 16            // Samples per flash log write
+#define COOP_DEMO_WINDOW 32         // Samples per inference
+#define COOP_DEMO_INFER_US 20000    // Time the stub inference takes
+#define COOP_DEMO_SLICES 10         // Parts the inference task splits it into
+#define COOP_DEMO_RING 64           // Samples buffered between the stages
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Checks that yielding tasks take turns and resume where they left off.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_yield(void);
+/**
+ * @brief      Checks waiting for events, counted signals and COOP_SLEEP().
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_wait(void);
+/**
+ * @brief      Signals an event while the scheduler queue is full and checks
+ *             the waiting task still wakes.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_queue_full(void);
+/**
+ * @brief      Checks that an asynchronous I2C read returns the same data as a
+ *             blocking one and that the core sleeps during it.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_i2c(void);
+/**
+ * @brief      Writes flash in steps from two tasks and checks the contents.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_flash(void);
+/**
+ * @brief      Measures the cost of switching between tasks.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_switch(void);
+/**
+ * @brief      Runs the sensor, flash log and inference demo blocking and as
+ *             tasks, and reports samples missed and CPU use of both.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_coop_demo(void);
+
+#endif
@@ -0,0 +1,553 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "coop_test.h"
+#include "coop.h"
+#include "i2c1.h"
+#include "flash.h"
+#include "cycles.h"
+#include "log.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+/***** Definitions *****/
+#define COOP_TEST_FLASH_ADDR (MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE - MXC_FLASH_PAGE_SIZE)
+#define COOP_TEST_FLASH_LEN 100     // Bytes written by each task of test_coop_flash()
+
+/**
+ * @brief      State of the tasks of test_coop_yield() and test_coop_switch().
+ */
+typedef struct {
+    char tag;                   // Written to the trace on every turn
+    uint32_t turns;             // Turns to take
+    uint32_t i;
+    char *trace;                // Shared trace of turns
+    int *pos;                   // Shared write position in the trace
+} coop_test_turns_t;
+
+/**
+ * @brief      State of the task of test_coop_wait().
+ */
+typedef struct {
+    coop_event_t ev;            // Signalled by the test
+    int step;                   // Waits passed
+    uint32_t slept;             // Ticks COOP_SLEEP() took
+    uint32_t start;
+} coop_test_waiter_t;
+
+/**
+ * @brief      State of the task of test_coop_i2c().
+ */
+typedef struct {
+    coop_event_t done;          // Read finished
+    uint8_t buf[1];
+    int start_err;              // Result of starting the read
+    int busy_err;               // Result of starting a second read meanwhile
+    int blocking_err;           // Result of a blocking read meanwhile
+} coop_test_reader_t;
+
+/**
+ * @brief      State of a task of test_coop_flash().
+ */
+typedef struct {
+    flash_job_t job;
+    const uint8_t *data;
+    uint32_t address;
+    uint32_t steps;             // Steps the write took
+    int err;
+} coop_test_writer_t;
+
+/**
+ * @brief      State of the demo, shared by its tasks.
+ */
+typedef struct {
+    coop_event_t drdy;          // BMI160 data ready edges
+    coop_event_t i2c;           // Sample read finished
+    uint8_t raw[BMI160_SAMPLE_AXES * 2];
+    int16_t ring[COOP_DEMO_RING][BMI160_SAMPLE_AXES];
+    uint32_t samples;           // Samples read
+    uint32_t logged;            // Samples written to flash
+    uint32_t inferred;          // Samples covered by inference
+    uint32_t windows;           // Inferences run
+    uint32_t errors;            // Failed reads and writes
+    uint32_t slice;             // Part of the current inference
+    uint32_t flash_addr;        // Next log address
+    flash_job_t job;
+    int stop;                   // Demo time is up
+} coop_demo_t;
+
+/***** Functions *****/
+static int coop_test_turn(coop_task_t *t)
+{
+    coop_test_turns_t *s = t->ctx;
+    COOP_BEGIN(t);
+    for (s->i = 0; s->i < s->turns; s->i++) {
+        if (s->trace != NULL) {
+            s->trace[(*s->pos)++] = s->tag;
+        }
+        COOP_YIELD(t);
+    }
+    COOP_END(t);
+}
+/******************************************************************************/
+// Runs the scheduler until a task has finished, sleeping while nothing is ready
+static void coop_test_finish(const coop_task_t *t)
+{
+    for (;;) {
+        sched_run_once();
+        if (t->state == COOP_DONE) {
+            break;
+        }
+        sched_idle();
+    }
+}
+/******************************************************************************/
+int test_coop_yield(void)
+{
+    char trace[8] = { 0 };
+    int pos = 0;
+    coop_test_turns_t a = { 'a', 3, 0, trace, &pos };
+    coop_test_turns_t b = { 'b', 3, 0, trace, &pos };
+    coop_task_t ta, tb;
+
+    sched_init();
+    coop_init();
+    coop_start(&ta, coop_test_turn, &a);
+    coop_start(&tb, coop_test_turn, &b);
+    while (sched_run_once() > 0) {
+    }
+    if (strcmp(trace, "ababab") != 0 || ta.state != COOP_DONE || tb.state != COOP_DONE) {
+        return 1;
+    }
+    // Three turns and the return from the end
+    if (ta.resumes != 4 || tb.resumes != 4) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(coop, test_coop_yield, 100)
+/******************************************************************************/
+static int coop_test_wait_task(coop_task_t *t)
+{
+    coop_test_waiter_t *w = t->ctx;
+    COOP_BEGIN(t);
+    COOP_WAIT(t, &w->ev);
+    w->step++;
+    COOP_WAIT(t, &w->ev);
+    w->step++;
+    COOP_WAIT(t, &w->ev);
+    w->step++;
+    w->start = sched_now();
+    COOP_SLEEP(t, SCHED_MS(5));
+    w->slept = sched_now() - w->start;
+    w->step++;
+    COOP_END(t);
+}
+/******************************************************************************/
+int test_coop_wait(void)
+{
+    coop_test_waiter_t w;
+    coop_task_t t;
+
+    memset(&w, 0, sizeof(w));
+    sched_init();
+    coop_init();
+    coop_event_init(&w.ev);
+    coop_start(&t, coop_test_wait_task, &w);
+
+    // Two signals before the task runs are both kept
+    coop_signal(&w.ev, E_NO_ERROR);
+    coop_signal(&w.ev, E_NO_ERROR);
+    while (sched_run_once() > 0) {
+    }
+    if (w.step != 2 || t.state != COOP_WAITING) {
+        return 1;
+    }
+    coop_signal(&w.ev, E_BAD_STATE);
+    coop_test_finish(&t);
+    if (w.step != 4 || w.ev.result != E_BAD_STATE || w.slept < SCHED_MS(5) ||
+        w.slept > SCHED_MS(6)) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(coop, test_coop_wait, 100)
+/******************************************************************************/
+// Work item that only takes up a queue slot
+static void coop_test_nop(void *arg)
+{
+    (void)arg;
+}
+/******************************************************************************/
+int test_coop_queue_full(void)
+{
+    coop_test_waiter_t w;
+    coop_task_t t;
+
+    memset(&w, 0, sizeof(w));
+    sched_init();
+    coop_init();
+    coop_event_init(&w.ev);
+    coop_start(&t, coop_test_wait_task, &w);
+    while (sched_run_once() > 0) {
+    }
+    // The signal arrives while other work fills the queue and still wakes the task
+    for (int i = 0; i < SCHED_QUEUE_LEN; i++) {
+        if (sched_post(coop_test_nop, NULL) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    coop_signal(&w.ev, E_NO_ERROR);
+    while (sched_run_once() > 0) {
+    }
+    return (w.step != 1 || t.state != COOP_WAITING);
+}
+TEST_REGISTER(coop, test_coop_queue_full, 100)
+/******************************************************************************/
+static int coop_test_read_task(coop_task_t *t)
+{
+    coop_test_reader_t *r = t->ctx;
+    COOP_BEGIN(t);
+    r->start_err = i2c_read_register_async(BMI160_I2C_ADDR, 0x00, r->buf, sizeof(r->buf), &r->done);
+    r->busy_err = i2c_read_register_async(BMI160_I2C_ADDR, 0x00, r->buf, sizeof(r->buf), &r->done);
+    r->blocking_err = i2c_read_register(BMI160_I2C_ADDR, 0x00, r->buf, sizeof(r->buf));
+    COOP_WAIT(t, &r->done);
+    COOP_END(t);
+}
+/******************************************************************************/
+int test_coop_i2c(void)
+{
+    coop_test_reader_t r;
+    coop_task_t t;
+    uint8_t chip_id = 0;
+    sched_stats_t st;
+
+    memset(&r, 0, sizeof(r));
+    if (i2c_init() != 0 || i2c_read_register(BMI160_I2C_ADDR, 0x00, &chip_id, 1) != E_NO_ERROR) {
+        return 1;
+    }
+    sched_init();
+    coop_init();
+    coop_event_init(&r.done);
+    coop_start(&t, coop_test_read_task, &r);
+    coop_test_finish(&t);
+    sched_get_stats(&st, 0);
+    log_drain();
+
+    if (r.start_err != E_NO_ERROR || r.busy_err != E_BUSY || r.blocking_err != E_BUSY ||
+        r.done.result != E_NO_ERROR || r.buf[0] != chip_id) {
+        return 1;
+    }
+#if SCHED_STATS
+    // The transfer ends in the I2C interrupt, the core sleeps until then
+    if (st.wakeups < 1 || st.asleep == 0) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(coop, test_coop_i2c, 100)
+/******************************************************************************/
+static int coop_test_write_task(coop_task_t *t)
+{
+    coop_test_writer_t *w = t->ctx;
+    COOP_BEGIN(t);
+    Flash_WriteStart(&w->job, w->address, w->data, COOP_TEST_FLASH_LEN);
+    do {
+        w->err = Flash_WriteStep(&w->job);
+        w->steps++;
+        COOP_YIELD(t);
+    } while (w->err > 0);
+    COOP_END(t);
+}
+/******************************************************************************/
+int test_coop_flash(void)
+{
+    uint8_t data[2][COOP_TEST_FLASH_LEN];
+    coop_test_writer_t w[2];
+    coop_task_t t[2];
+
+    for (int i = 0; i < COOP_TEST_FLASH_LEN; i++) {
+        data[0][i] = (uint8_t)i;
+        data[1][i] = (uint8_t)(0xA5 ^ i);
+    }
+    if (Flash_PageErase(COOP_TEST_FLASH_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    sched_init();
+    coop_init();
+    for (int i = 0; i < 2; i++) {
+        memset(&w[i], 0, sizeof(w[i]));
+        w[i].data = data[i];
+        w[i].address = COOP_TEST_FLASH_ADDR + 3 + i * 256;  // Unaligned start
+        coop_start(&t[i], coop_test_write_task, &w[i]);
+    }
+    while (sched_run_once() > 0) {
+    }
+    for (int i = 0; i < 2; i++) {
+        // 13 bytes up to the first line boundary, then lines of 16
+        if (w[i].err != 0 || w[i].steps != 1 + (COOP_TEST_FLASH_LEN - 13 + 15) / 16 ||
+            memcmp((const void *)(uintptr_t)w[i].address, data[i], COOP_TEST_FLASH_LEN) != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(coop, test_coop_flash, 1000)
+/******************************************************************************/
+int test_coop_switch(void)
+{
+    coop_test_turns_t a = { 'a', COOP_SWITCH_YIELDS, 0, NULL, NULL };
+    coop_test_turns_t b = { 'b', COOP_SWITCH_YIELDS, 0, NULL, NULL };
+    coop_task_t ta, tb;
+    coop_stats_t st;
+
+    sched_init();
+    coop_init();
+    coop_start(&ta, coop_test_turn, &a);
+    coop_start(&tb, coop_test_turn, &b);
+    uint32_t start = cycles_now();
+    while (sched_run_once() > 0) {
+    }
+    uint32_t total = cycles_now() - start;
+    coop_get_stats(&st, 0);
+
+    if (st.resumes != 2 * (COOP_SWITCH_YIELDS + 1)) {
+        return 1;
+    }
+    printf("coop: %u task switches, %u cycles per switch, %u with the scheduler queue\n",
+           (unsigned)st.resumes, (unsigned)(st.cycles / st.resumes),
+           (unsigned)(total / st.resumes));
+    return 0;
+}
+TEST_REGISTER(coop, test_coop_switch, 1000)
+/******************************************************************************/
+// Stub inference: on the host takes as long as a slice of a small network
+static void coop_demo_compute(uint32_t us)
+{
+#ifdef HOST_SIM
+    sim_clock_advance((uint64_t)us * 1000);
+#else
+    MXC_Delay(us);
+#endif
+}
+/******************************************************************************/
+// Stores the sample in raw into the ring
+static void coop_demo_store(coop_demo_t *d)
+{
+    int16_t *sample = d->ring[d->samples % COOP_DEMO_RING];
+    for (int i = 0; i < BMI160_SAMPLE_AXES; i++) {
+        sample[i] = (int16_t)(d->raw[2 * i] | (d->raw[2 * i + 1] << 8));
+    }
+    d->samples++;
+}
+/******************************************************************************/
+// Log record of COOP_DEMO_LOG samples starting at sample first
+static const uint8_t *coop_demo_record(coop_demo_t *d, uint32_t first)
+{
+    return (const uint8_t *)d->ring[first % COOP_DEMO_RING];
+}
+/******************************************************************************/
+static int coop_demo_sensor(coop_task_t *t)
+{
+    coop_demo_t *d = t->ctx;
+    COOP_BEGIN(t);
+    for (;;) {
+        COOP_WAIT(t, &d->drdy);
+        if (i2c_read_register_async(BMI160_I2C_ADDR, BMI160_DATA_REG, d->raw, sizeof(d->raw),
+                                    &d->i2c) != E_NO_ERROR) {
+            d->errors++;
+            continue;
+        }
+        COOP_WAIT(t, &d->i2c);
+        if (d->i2c.result != E_NO_ERROR) {
+            d->errors++;
+            continue;
+        }
+        coop_demo_store(d);
+        log_drain();    // Every read logs, keep the ring from overflowing
+    }
+    COOP_END(t);
+}
+/******************************************************************************/
+static int coop_demo_logger(coop_task_t *t)
+{
+    coop_demo_t *d = t->ctx;
+    COOP_BEGIN(t);
+    for (;;) {
+        COOP_WAIT_UNTIL(t, d->samples - d->logged >= COOP_DEMO_LOG);
+        Flash_WriteStart(&d->job, d->flash_addr, coop_demo_record(d, d->logged),
+                         COOP_DEMO_LOG * sizeof(d->ring[0]));
+        while (Flash_WriteStep(&d->job) > 0) {
+            COOP_YIELD(t);
+        }
+        d->flash_addr += COOP_DEMO_LOG * sizeof(d->ring[0]);
+        d->logged += COOP_DEMO_LOG;
+    }
+    COOP_END(t);
+}
+/******************************************************************************/
+static int coop_demo_infer(coop_task_t *t)
+{
+    coop_demo_t *d = t->ctx;
+    COOP_BEGIN(t);
+    for (;;) {
+        COOP_WAIT_UNTIL(t, d->samples - d->inferred >= COOP_DEMO_WINDOW);
+        for (d->slice = 0; d->slice < COOP_DEMO_SLICES; d->slice++) {
+            coop_demo_compute(COOP_DEMO_INFER_US / COOP_DEMO_SLICES);
+            COOP_YIELD(t);
+        }
+        d->inferred += COOP_DEMO_WINDOW;
+        d->windows++;
+    }
+    COOP_END(t);
+}
+/******************************************************************************/
+static int coop_demo_timer(coop_task_t *t)
+{
+    coop_demo_t *d = t->ctx;
+    COOP_BEGIN(t);
+    COOP_SLEEP(t, SCHED_MS(COOP_DEMO_MS));
+    d->stop = 1;
+    COOP_END(t);
+}
+/******************************************************************************/
+// The same work as one blocking loop: poll for data ready, then read, log and
+// infer in turn
+static void coop_demo_blocking(coop_demo_t *d)
+{
+    mxc_gpio_cfg_t cfg = { BMI160_INT1_PORT, BMI160_INT1_PIN, MXC_GPIO_FUNC_IN, MXC_GPIO_PAD_NONE,
+                           MXC_GPIO_VSSEL_VDDIO, MXC_GPIO_DRVSTR_0 };
+    MXC_GPIO_Config(&cfg);
+    MXC_GPIO_IntConfig(&cfg, MXC_GPIO_INT_RISING);
+    MXC_GPIO_ClearFlags(BMI160_INT1_PORT, BMI160_INT1_PIN);
+
+    uint32_t end = sched_now() + SCHED_MS(COOP_DEMO_MS);
+    while ((int32_t)(sched_now() - end) < 0) {
+        if (!(MXC_GPIO_GetFlags(BMI160_INT1_PORT) & BMI160_INT1_PIN)) {
+            continue;
+        }
+        MXC_GPIO_ClearFlags(BMI160_INT1_PORT, BMI160_INT1_PIN);
+        if (i2c_read_register(BMI160_I2C_ADDR, BMI160_DATA_REG, d->raw, sizeof(d->raw)) !=
+            E_NO_ERROR) {
+            d->errors++;
+            continue;
+        }
+        coop_demo_store(d);
+        log_drain();
+        if (d->samples - d->logged >= COOP_DEMO_LOG) {
+            if (Flash_WriteBuffer(d->flash_addr, coop_demo_record(d, d->logged),
+                                  COOP_DEMO_LOG * sizeof(d->ring[0])) != E_NO_ERROR) {
+                d->errors++;
+            }
+            d->flash_addr += COOP_DEMO_LOG * sizeof(d->ring[0]);
+            d->logged += COOP_DEMO_LOG;
+        }
+        if (d->samples - d->inferred >= COOP_DEMO_WINDOW) {
+            coop_demo_compute(COOP_DEMO_INFER_US);
+            d->inferred += COOP_DEMO_WINDOW;
+            d->windows++;
+        }
+    }
+}
+/******************************************************************************/
+// Prints the outcome of one variant; awake is in units of 0.01 %
+static void coop_demo_report(const char *what, const coop_demo_t *d, uint32_t awake,
+                             uint32_t wakeups)
+{
+    uint32_t expected = COOP_DEMO_MS / 10;      // 100 Hz data ready
+    uint32_t missed = (d->samples < expected) ? expected - d->samples : 0;
+    printf("coop: %-8s %u samples, %u missed, %u windows, %u logged, CPU awake %u.%02u%%, "
+           "%u wakeups/s\n",
+           what, (unsigned)d->samples, (unsigned)missed, (unsigned)d->windows,
+           (unsigned)d->logged, (unsigned)(awake / 100), (unsigned)(awake % 100),
+           (unsigned)wakeups);
+}
+/******************************************************************************/
+int test_coop_demo(void)
+{
+    static coop_demo_t blocking, tasks;
+    coop_task_t sensor, logger, infer, timer;
+    sched_stats_t st;
+    struct bmi160_dev dev;
+    dev.chip_id = BMI160_I2C_ADDR;
+    dev.delay_ms = NULL;
+
+    if (i2c_init() != 0 || set_accelerometer_normal_mode(&dev) != 0 ||
+        set_gyroscope_Normal_mode(&dev) != 0 || bmi160_enable_data_ready() != E_NO_ERROR ||
+        Flash_PageErase(COOP_TEST_FLASH_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    sched_init();
+    coop_init();
+    log_drain();
+
+    // Blocking: the core never sleeps, and misses data ready during inference
+    memset(&blocking, 0, sizeof(blocking));
+    blocking.flash_addr = COOP_TEST_FLASH_ADDR;
+    coop_demo_blocking(&blocking);
+
+    // Tasks: the same stages, the core sleeps whenever all of them wait
+    memset(&tasks, 0, sizeof(tasks));
+    tasks.flash_addr = COOP_TEST_FLASH_ADDR + MXC_FLASH_PAGE_SIZE / 2;
+    coop_event_init(&tasks.drdy);
+    coop_event_init(&tasks.i2c);
+    if (coop_gpio_event(BMI160_INT1_PORT, BMI160_INT1_PIN, &tasks.drdy) != E_NO_ERROR) {
+        return 1;
+    }
+    coop_start(&sensor, coop_demo_sensor, &tasks);
+    coop_start(&logger, coop_demo_logger, &tasks);
+    coop_start(&infer, coop_demo_infer, &tasks);
+    coop_start(&timer, coop_demo_timer, &tasks);
+    sched_get_stats(NULL, 1);
+    coop_get_stats(NULL, 1);
+    coop_test_finish(&timer);
+    sched_get_stats(&st, 0);
+
+    // Stop the pulses and unhook the pin before the next case
+    uint8_t off = 0;
+    i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_EN_1_REG, &off, 1);
+    sched_init();
+    coop_init();
+    log_drain();
+
+    coop_demo_report("blocking", &blocking, 10000, 0);
+#if SCHED_STATS
+    coop_demo_report("tasks", &tasks,
+                     (uint32_t)((uint64_t)(st.elapsed - st.asleep) * 10000 / st.elapsed),
+                     (uint32_t)((uint64_t)st.wakeups * SCHED_TICK_HZ / st.elapsed));
+#else
+    coop_demo_report("tasks", &tasks, 0, 0);
+#endif
+    printf("coop: resumes sensor %u, logger %u, infer %u\n", (unsigned)sensor.resumes,
+           (unsigned)logger.resumes, (unsigned)infer.resumes);
+
+    // Tasks keep up with every sample, the blocking loop loses some
+    if (blocking.errors != 0 || tasks.errors != 0 ||
+        tasks.samples < COOP_DEMO_MS / 10 - 2 || tasks.samples <= blocking.samples) {
+        return 1;
+    }    return 0;
+}
+TEST_REGISTER(coop, test_coop_demo, 5000)
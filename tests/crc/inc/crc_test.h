@@ -0,0 +1,64 @@
+/**
+ * @file       crc_test.h
+ * @brief      testing the CRC-32 driver.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the software CRC-32 and the flash region checksum.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __CRC_TEST_H__
+#define __CRC_TEST_H__
+
+/***** Includes *****/
+#include "crc32.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define CRC_TEST_LEN 1000           // Bytes checksummed by test_crc32_flash()
+#define CRC_BENCH_LEN 0x10000       // Bytes checksummed by the benchmark
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Checks the CRC of "123456789" and of the empty string.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_crc32_check(void);
+/**
+ * @brief      Checks a CRC computed in uneven pieces equals the CRC of the whole.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_crc32_chain(void);
+/**
+ * @brief      Checksums an unaligned flash range with crc32_flash() in two
+ *             pieces and compares it with the software CRC.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_crc32_flash(void);
+/**
+ * @brief      Times crc32_flash() and the software CRC over the same flash range.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_crc32_bench_flash(void);
+
+#endif
@@ -0,0 +1,101 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "crc_test.h"
+#include "crc32.h"
+#include "test_runner.h"
+#include "cycles.h"
+
+/***** Functions *****/
+int test_crc32_check(void)
+{
+    if (crc32(0, "123456789", 9) != CRC32_CHECK || crc32(0, "", 0) != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(crc, test_crc32_check, 100)
+/******************************************************************************/
+int test_crc32_chain(void)
+{
+    uint8_t data[CRC_TEST_LEN];
+    for (int i = 0; i < CRC_TEST_LEN; i++) {
+        data[i] = (uint8_t)(i * 13 + 7);
+    }
+    uint32_t whole = crc32(0, data, sizeof(data));
+    uint32_t crc = 0;
+    for (size_t i = 0; i < sizeof(data); i += 37) {
+        size_t n = (sizeof(data) - i < 37) ? sizeof(data) - i : 37;
+        crc = crc32(crc, data + i, n);
+    }
+    return crc != whole;
+}
+TEST_REGISTER(crc, test_crc32_chain, 100)
+/******************************************************************************/
+int test_crc32_flash(void)
+{
+    const uint32_t addr = MXC_FLASH_MEM_BASE + 3;
+    uint32_t crc = 0;
+
+    if (crc32_init() != E_NO_ERROR) {
+        return 1;
+    }
+    if (crc32_flash(addr, 101, &crc) != E_NO_ERROR ||
+        crc32_flash(addr + 101, CRC_TEST_LEN - 101, &crc) != E_NO_ERROR) {
+        return 1;
+    }
+    if (crc != crc32(0, (const void *)(uintptr_t)addr, CRC_TEST_LEN)) {
+        return 1;
+    }
+    // Ranges leaving the main array are refused
+    if (crc32_flash(MXC_FLASH_MEM_BASE - 1, 2, &crc) != E_BAD_PARAM ||
+        crc32_flash(MXC_FLASH_MEM_BASE + MXC_FLASH_MEM_SIZE - 1, 2, &crc) != E_BAD_PARAM) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(crc, test_crc32_flash, 100)
+/******************************************************************************/
+int test_crc32_bench_flash(void)
+{
+    uint32_t crc = 0;
+
+    uint32_t start = cycles_now();
+    if (crc32_flash(MXC_FLASH_MEM_BASE, CRC_BENCH_LEN, &crc) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t region_cycles = cycles_now() - start;
+
+    start = cycles_now();
+    uint32_t sw = crc32(0, (const void *)(uintptr_t)MXC_FLASH_MEM_BASE, CRC_BENCH_LEN);
+    uint32_t sw_cycles = cycles_now() - start;
+    if (sw != crc) {
+        return 1;
+    }
+    printf("crc32: %u bytes, crc32_flash() (%s) %u cycles, software %u cycles\n",
+           (unsigned)CRC_BENCH_LEN, crc32_hw_enabled() ? "peripheral" : "software",
+           (unsigned)region_cycles, (unsigned)sw_cycles);
+    return 0;
+}
+TEST_REGISTER(crc, test_crc32_bench_flash, 100)
@@ -0,0 +1,71 @@
+/**
+ * @file       dsp_test.h
+ * @brief      testing the IMU preprocessing kernels.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing and benchmarking the fixed-point DSP kernels.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __DSP_TEST_H__
+#define __DSP_TEST_H__
+
+/***** Includes *****/
+#include "dsp.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define DSP_TEST_RATE 800           // Sample rate the filters are designed for, Hz
+#define DSP_BENCH_FRAMES 256        // Frames per kernel run in test_dsp_bench()
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Checks bias removal, scaling and saturation.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_dsp_scale_offset(void);
+/**
+ * @brief      Checks that the biquad low-pass passes DC exactly and removes
+ *             a signal at half the sample rate.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_dsp_biquad(void);
+/**
+ * @brief      Checks that the Q31 one-pole low-pass reaches its input at a
+ *             very low cutoff.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_dsp_lowpass(void);
+/**
+ * @brief      Checks averaging and rounding of the decimator, with groups
+ *             spanning calls.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_dsp_decimate(void);
+/**
+ * @brief      Prints the cycles per sample of every kernel.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_dsp_bench(void);
+
+#endif
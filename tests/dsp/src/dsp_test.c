@@ -0,0 +1,185 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "dsp_test.h"
+#include "dsp.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "mxc_errors.h"
+
+/***** Globals *****/
+static q15_t dsp_test_buf[DSP_BENCH_FRAMES * DSP_AXES];
+
+/***** Functions *****/
+// Fills frames with the same value on every axis
+static void dsp_test_fill(q15_t *buf, uint32_t frames, q15_t value)
+{
+    for (uint32_t n = 0; n < frames * DSP_AXES; n++) {
+        buf[n] = value;
+    }
+}
+/******************************************************************************/
+int test_dsp_scale_offset(void)
+{
+    const dsp_cal_t cal = { { 100, -100, 0, 0, 32767, -32768 },
+                            { 16384, 16384, 32767, -32768, 16384, 16384 },
+                            1 };
+    q15_t frame[DSP_AXES] = { 1100, -1100, 1000, 1000, -32768, 32767 };
+    // x2 gain: 0.5 * 2^1 = 1, 1 * 2 = 2 (saturates), -1 * 2 = -2
+    const q15_t expect[DSP_AXES] = { 1000, -1000, 1999, -2000, -32768, 32767 };
+
+    dsp_scale_offset_q15(frame, frame, 1, &cal);
+    return (memcmp(frame, expect, sizeof(frame)) != 0) ? 1 : 0;
+}
+TEST_REGISTER(dsp, test_dsp_scale_offset, 100)
+/******************************************************************************/
+int test_dsp_biquad(void)
+{
+    static dsp_biquad_t f;
+    q15_t *buf = dsp_test_buf;
+
+    if (dsp_biquad_lowpass(&f, DSP_TEST_RATE / 2, DSP_TEST_RATE) != E_BAD_PARAM ||
+        dsp_biquad_lowpass(&f, 20, DSP_TEST_RATE) != E_NO_ERROR) {
+        return 1;
+    }
+    // A step settles at the input value
+    dsp_test_fill(buf, DSP_BENCH_FRAMES, 10000);
+    dsp_biquad_q15(&f, buf, buf, DSP_BENCH_FRAMES);
+    for (int c = 0; c < DSP_AXES; c++) {
+        q15_t last = buf[(DSP_BENCH_FRAMES - 1) * DSP_AXES + c];
+        if (last < 9999 || last > 10001) {
+            return 1;
+        }
+    }
+    // A full scale tone at half the sample rate is gone
+    for (uint32_t n = 0; n < DSP_BENCH_FRAMES * DSP_AXES; n++) {
+        buf[n] = ((n / DSP_AXES) & 1) ? -30000 : 30000;
+    }
+    dsp_biquad_lowpass(&f, 20, DSP_TEST_RATE);
+    dsp_biquad_q15(&f, buf, buf, DSP_BENCH_FRAMES);
+    for (uint32_t n = DSP_BENCH_FRAMES / 2 * DSP_AXES; n < DSP_BENCH_FRAMES * DSP_AXES; n++) {
+        if (buf[n] > 30 || buf[n] < -30) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(dsp, test_dsp_biquad, 100)
+/******************************************************************************/
+int test_dsp_lowpass(void)
+{
+    static dsp_lowpass_t f;
+    q15_t *buf = dsp_test_buf;
+
+    // alpha is about 0.004 here, a Q15 state would stop 256 LSB short
+    if (dsp_lowpass_init(&f, 1, 1600) != E_NO_ERROR) {
+        return 1;
+    }
+    for (int i = 0; i < 12; i++) {
+        dsp_test_fill(buf, DSP_BENCH_FRAMES, 1000);
+        dsp_lowpass_q31(&f, buf, buf, DSP_BENCH_FRAMES);
+    }
+    for (int c = 0; c < DSP_AXES; c++) {
+        if (buf[(DSP_BENCH_FRAMES - 1) * DSP_AXES + c] != 1000) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(dsp, test_dsp_lowpass, 100)
+/******************************************************************************/
+int test_dsp_decimate(void)
+{
+    dsp_decimator_t d;
+    q15_t in[5 * DSP_AXES];
+    q15_t out[2 * DSP_AXES];
+
+    if (dsp_decimate_init(&d, 0) != E_BAD_PARAM || dsp_decimate_init(&d, 4) != E_NO_ERROR) {
+        return 1;
+    }
+    // Axis c of frame n is (n + 1) * (c - 2): the first group averages 2.5 * (c - 2)
+    for (int n = 0; n < 5; n++) {
+        for (int c = 0; c < DSP_AXES; c++) {
+            in[n * DSP_AXES + c] = (q15_t)((n + 1) * (c - 2));
+        }
+    }
+    if (dsp_decimate_q15(&d, in, out, 3) != 0 ||
+        dsp_decimate_q15(&d, &in[3 * DSP_AXES], out, 2) != 1) {
+        return 1;
+    }
+    const q15_t expect[DSP_AXES] = { -5, -2, 0, 3, 5, 8 };     // Halves round up
+    if (memcmp(out, expect, sizeof(expect)) != 0 || d.count != 1) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(dsp, test_dsp_decimate, 100)
+/******************************************************************************/
+// Prints cycles per sample of one kernel run, with two decimals
+static void dsp_test_report(const char *name, uint32_t cycles)
+{
+    uint32_t per100 = (uint32_t)((uint64_t)cycles * 100 / (DSP_BENCH_FRAMES * DSP_AXES));
+    printf("dsp %-13s %u.%02u cycles/sample\n", name, (unsigned)(per100 / 100),
+           (unsigned)(per100 % 100));
+}
+/******************************************************************************/
+int test_dsp_bench(void)
+{
+    static const dsp_cal_t cal = { { 10, -20, 30, -40, 50, -60 },
+                                   { 20000, 20000, 20000, 30000, 30000, 30000 },
+                                   0 };
+    static dsp_biquad_t biquad;
+    static dsp_lowpass_t lowpass;
+    static q15_t out[DSP_BENCH_FRAMES * DSP_AXES];
+    dsp_decimator_t dec;
+    uint32_t start;
+
+    for (uint32_t n = 0; n < DSP_BENCH_FRAMES * DSP_AXES; n++) {
+        dsp_test_buf[n] = (q15_t)(n * 2654435761u >> 16);
+    }
+    dsp_biquad_lowpass(&biquad, 50, DSP_TEST_RATE);
+    dsp_lowpass_init(&lowpass, 50, DSP_TEST_RATE);
+    dsp_decimate_init(&dec, 4);
+    printf("dsp: %d frames of %d axes, %s\n", DSP_BENCH_FRAMES, DSP_AXES,
+           DSP_SIMD ? "dual 16-bit SIMD" : "portable C");
+
+    start = cycles_now();
+    dsp_scale_offset_q15(dsp_test_buf, out, DSP_BENCH_FRAMES, &cal);
+    dsp_test_report("scale_offset", cycles_now() - start);
+
+    start = cycles_now();
+    dsp_biquad_q15(&biquad, dsp_test_buf, out, DSP_BENCH_FRAMES);
+    dsp_test_report("biquad", cycles_now() - start);
+
+    start = cycles_now();
+    dsp_lowpass_q31(&lowpass, dsp_test_buf, out, DSP_BENCH_FRAMES);
+    dsp_test_report("lowpass_q31", cycles_now() - start);
+
+    start = cycles_now();
+    uint32_t frames = dsp_decimate_q15(&dec, dsp_test_buf, out, DSP_BENCH_FRAMES);
+    dsp_test_report("decimate", cycles_now() - start);
+
+    return (frames == DSP_BENCH_FRAMES / 4) ? 0 : 1;
+}
+TEST_REGISTER(dsp, test_dsp_bench, 1000)
@@ -0,0 +1,94 @@
+/**
+ * @file       flash_test.h
+ * @brief      testing flash driver.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the internal flash driver.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __FLASH_TEST_H__
+#define __FLASH_TEST_H__
+
+/***** Includes *****/
+#include "flash.h"
+#include "test_runner.h"
+#include "flash_layout.h"
+
+/***** Definitions *****/
+// Scratch page used by the tests: the last page of the main flash array
+#define FLASH_TEST_ADDR FLASH_SCRATCH_BASE
+#define FLASH_TEST_PATTERN0 0x0123456789ABCDEFULL
+#define FLASH_TEST_PATTERN1 0xFEDCBA9876543210ULL
+#define FLASH_TEST_PATTERN2 0x5A5A5A5AA5A5A5A5ULL
+#define FLASH_ERASED_WORD 0xFFFFFFFFUL
+#define FLASH_BENCH_WORDS 1024      // 64-bit words written by test_flash_bench_write()
+#define FLASH_TEST_TORN_BYTES 8     // Bytes that reach the array in the torn write test
+#define FLASH_TEST_READ_BYTES (POOL_LARGE_SIZE + 64)  // Read by test_flash_read_into()
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Erases the scratch page and checks every word reads back erased.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_page_erase(void);
+/**
+ * @brief      Writes a pattern to the scratch page and checks it through the memory map.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_write(void);
+/**
+ * @brief      Reads the pattern back with Flash_Read() and checks the byte order.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_read(void);
+/**
+ * @brief      Reads more than POOL_LARGE_SIZE bytes with Flash_ReadInto(),
+ *             which Flash_Read() refuses, and checks the byte order.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_read_into(void);
+/**
+ * @brief      Times a page erase and a write of most of the page and prints the throughput.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_bench_write(void);
+#ifdef HOST_SIM
+/**
+ * @brief      Cuts power during a write and checks the error and the partial line.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_torn_write(void);
+/**
+ * @brief      Cuts power during a page erase and checks the error and the unerased half.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_torn_erase(void);
+/**
+ * @brief      Flips a bit of an erased word and checks it reads back flipped.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_flash_bit_flip(void);
+#endif
+
+#endif
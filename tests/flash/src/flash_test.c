@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include "flash_test.h"
+#include "flash.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "ramfunc.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+/***** Globals *****/
+static uint64_t flash_bench_buf[FLASH_BENCH_WORDS + 1];  // Zero terminated for Flash_Write()
+static uint8_t flash_read_buf[FLASH_TEST_READ_BYTES];
+
+
+/******************************************************************************/
+int test_flash_page_erase(void)
+{
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    // Every word of the page must read back as erased
+    volatile uint32_t *word = (volatile uint32_t *)FLASH_TEST_ADDR;
+    for (uint32_t i = 0; i < MXC_FLASH_PAGE_SIZE / sizeof(uint32_t); i++) {
+        if (word[i] != FLASH_ERASED_WORD) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(flash, test_flash_page_erase, 100)
+/******************************************************************************/
+int test_flash_write(void)
+{
+    // Flash_Write() takes a zero terminated buffer and programs all but the
+    // last element before the terminator
+    uint64_t buffer[] = { FLASH_TEST_PATTERN0, FLASH_TEST_PATTERN1, FLASH_TEST_PATTERN2, 0 };
+
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    if (Flash_Write(FLASH_TEST_ADDR, buffer) != E_NO_ERROR) {
+        return 1;
+    }
+    if (memcmp((const void *)FLASH_TEST_ADDR, buffer, 2 * sizeof(uint64_t)) != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(flash, test_flash_write, 100)
+/******************************************************************************/
+int test_flash_read(void)
+{
+    const int len = 2 * sizeof(uint64_t);
+    const uint8_t *mapped = (const uint8_t *)FLASH_TEST_ADDR;
+
+    uint8_t *data = Flash_Read(FLASH_TEST_ADDR, len);
+    if (data == NULL) {
+        return 1;
+    }
+    // Flash_Read() returns the bytes in reverse order
+    int result = 0;
+    for (int i = 0; i < len; i++) {
+        if (data[i] != mapped[len - i - 1]) {
+            result = 1;
+            break;
+        }
+    }
+    pool_free(data);
+    return result;
+}
+TEST_REGISTER(flash, test_flash_read, 100)
+/******************************************************************************/
+int test_flash_read_into(void)
+{
+    const uint8_t *mapped = (const uint8_t *)FLASH_TEST_ADDR;
+
+    // Longer than any pool block, so only Flash_ReadInto() can read it
+    uint8_t *data = Flash_Read(FLASH_TEST_ADDR, FLASH_TEST_READ_BYTES);
+    if (data != NULL) {
+        pool_free(data);
+        return 1;
+    }
+    if (Flash_ReadInto(FLASH_TEST_ADDR, NULL, FLASH_TEST_READ_BYTES) != E_BAD_PARAM) {
+        return 1;
+    }
+    if (Flash_ReadInto(FLASH_TEST_ADDR, flash_read_buf, FLASH_TEST_READ_BYTES) != E_NO_ERROR) {
+        return 1;
+    }
+    // Same reverse byte order as Flash_Read()
+    for (int i = 0; i < FLASH_TEST_READ_BYTES; i++) {
+        if (flash_read_buf[i] != mapped[FLASH_TEST_READ_BYTES - i - 1]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(flash, test_flash_read_into, 100)
+/******************************************************************************/
+int test_flash_bench_write(void)
+{
+    for (int i = 0; i < FLASH_BENCH_WORDS; i++) {
+        flash_bench_buf[i] = FLASH_TEST_PATTERN0 ^ (uint64_t)i;
+    }
+    flash_bench_buf[FLASH_BENCH_WORDS] = 0;
+
+    uint32_t start = cycles_now();
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t erase_cycles = cycles_now() - start;
+
+    // Flash_Write() stops one element before the terminator
+    const uint32_t len = (FLASH_BENCH_WORDS - 1) * sizeof(uint64_t);
+    start = cycles_now();
+    if (Flash_Write(FLASH_TEST_ADDR, flash_bench_buf) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t write_cycles = cycles_now() - start;
+    uint32_t erase_us = cycles_to_us(erase_cycles);
+    uint32_t write_us = cycles_to_us(write_cycles);
+    if (write_us == 0) {
+        write_us = 1;
+    }
+    if (memcmp((const void *)FLASH_TEST_ADDR, flash_bench_buf, len) != 0) {
+        return 1;
+    }
+    printf("flash: page erase %u us, write %u bytes in %u us, %u bytes/s\n", (unsigned)erase_us,
+           (unsigned)len, (unsigned)write_us, (unsigned)((uint64_t)len * 1000000 / write_us));
+    // Compare builds with RAMFUNC_ENABLE=0 and 1 for the gain of running from SRAM
+    printf("flash: erase %u cycles, write %u cycles, code in %s (%u bytes in SRAM)\n",
+           (unsigned)erase_cycles, (unsigned)write_cycles, ramfunc_size() ? "SRAM" : "flash",
+           (unsigned)ramfunc_size());
+    return 0;
+}
+TEST_REGISTER(flash, test_flash_bench_write, 200)
+#ifdef HOST_SIM
+/******************************************************************************/
+int test_flash_torn_write(void)
+{
+    uint64_t buffer[] = { FLASH_TEST_PATTERN0, FLASH_TEST_PATTERN1, FLASH_TEST_PATTERN2, 0 };
+    const uint8_t *mapped = (const uint8_t *)FLASH_TEST_ADDR;
+    int result = 0;
+
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    // Power fails half way through the 128-bit program operation
+    sim_flash_tear(0, FLASH_TEST_TORN_BYTES);
+    if (Flash_Write(FLASH_TEST_ADDR, buffer) == E_NO_ERROR || !sim_flash_power_lost()) {
+        result = 1;
+    }
+    // The flash is unusable until power returns
+    if (Flash_PageErase(FLASH_TEST_ADDR) == E_NO_ERROR) {
+        result = 1;
+    }
+    sim_flash_power_cycle();
+
+    // The torn line holds the first bytes of the pattern and erased cells after them
+    if (memcmp(mapped, buffer, FLASH_TEST_TORN_BYTES) != 0) {
+        result = 1;
+    }
+    for (int i = FLASH_TEST_TORN_BYTES; i < 2 * (int)sizeof(uint64_t); i++) {
+        if (mapped[i] != 0xFF) {
+            result = 1;
+        }
+    }
+    return result;
+}
+TEST_REGISTER(flash, test_flash_torn_write, 100)
+/******************************************************************************/
+int test_flash_torn_erase(void)
+{
+    uint64_t buffer[] = { FLASH_TEST_PATTERN0, FLASH_TEST_PATTERN1, FLASH_TEST_PATTERN2, 0 };
+    int result = 0;
+
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR ||
+        Flash_Write(FLASH_TEST_ADDR + MXC_FLASH_PAGE_SIZE / 2, buffer) != E_NO_ERROR) {
+        return 1;
+    }
+    // Power fails when half of the page is erased, the pattern in the second half survives
+    sim_flash_tear(0, MXC_FLASH_PAGE_SIZE / 2);
+    if (Flash_PageErase(FLASH_TEST_ADDR) == E_NO_ERROR) {
+        result = 1;
+    }
+    sim_flash_power_cycle();
+    if (memcmp((const void *)(FLASH_TEST_ADDR + MXC_FLASH_PAGE_SIZE / 2), buffer,
+               2 * sizeof(uint64_t)) != 0) {
+        result = 1;
+    }
+    // Erasing again recovers the page
+    if (test_flash_page_erase() != 0) {
+        result = 1;
+    }
+    return result;
+}
+TEST_REGISTER(flash, test_flash_torn_erase, 100)
+/******************************************************************************/
+int test_flash_bit_flip(void)
+{
+    volatile uint32_t *word = (volatile uint32_t *)FLASH_TEST_ADDR;
+
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR) {
+        return 1;
+    }
+    // A retention error is visible through the memory map and cleared by erase
+    sim_flash_flip_bit(FLASH_TEST_ADDR, 3);
+    if (word[0] != (FLASH_ERASED_WORD & ~(1UL << 3))) {
+        return 1;
+    }
+    return test_flash_page_erase();
+}
+TEST_REGISTER(flash, test_flash_bit_flip, 100)
+#endif
@@ -28,10 +28,11 @@
 
 /* Define to prevent redundant inclusion */
 #ifndef __test_gpio__
-#define __test_gpio_
+#define __test_gpio__
 
 /***** Includes *****/
 #include "gpio1.h"
+#include "test_runner.h"
 
 /***** Definitions *****/
 #define PORT 0	//GPIO PORT 0
@@ -39,10 +40,11 @@
 #define PIN3 3	//GPIO PIN 3
 #define VALUE0 0
 #define VALUE1 1
-#define PASS 1
-#define FAIL 0
+#define TOGGLE_COUNT 4	//Number of set/get steps in the toggle test
+#define GPIO_BENCH_TOGGLES 1000	//Number of writes timed by the toggle benchmark
+#define PASS TEST_PASS
+#define FAIL 1
 
-/***** Function Prototypes *****/
 /***** Function Prototypes *****/
 /**
  * @brief      Sets the GPIO pin to a specific value.
@@ -51,17 +53,18 @@
 int test_gpio_set(void);
 /**
  * @brief      Gets the current value of the GPIO pin.
- * @return     Returns the value of the GPIO pin.
+ * @return     Returns PASS if the value read matches the value set, otherwise returns FAIL.
  */
 int test_gpio_get(void);
 /**
- * @brief      Toggles the value of the GPIO pin.
+ * @brief      Toggles the value of the GPIO pin TOGGLE_COUNT times, checking every step.
  * @return     Returns PASS if the operation is successful, otherwise returns FAIL.
  */
 int test_gpio_toggle(void);
 /**
- * @brief      Main function to test GPIO functionality.
+ * @brief      Times GPIO_BENCH_TOGGLES pin writes and prints the cycles per write.
+ * @return     Returns PASS if the pin holds the last value written, otherwise returns FAIL.
  */
-void test_gpio(void);
+int test_gpio_bench_toggle(void);
 
 #endif
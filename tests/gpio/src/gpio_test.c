@@ -20,8 +20,12 @@
  ******************************************************************************/
 
 /***** Includes *****/
+#include <stdio.h>
 #include "gpio_test.h"
 #include "gpio1.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "ramfunc.h"
 
 
 /******************************************************************************/
@@ -37,6 +41,7 @@ int test_gpio_set(void)
 		return FAIL;
 	}
 }
+TEST_REGISTER(gpio, test_gpio_set, 100)
 /******************************************************************************/
 int test_gpio_get(void)
 {
@@ -50,72 +55,44 @@ int test_gpio_get(void)
 		return FAIL;
 	}
 }
+TEST_REGISTER(gpio, test_gpio_get, 100)
 /******************************************************************************/
 int test_gpio_toggle(void)
 {
-	int c=0;
-	gpio_set(PORT,PIN2,VALUE0);
-	if(gpio_get(PORT,PIN2)==VALUE0)
-	{
-		c++;
-	}
-	else
+	uint8_t value = VALUE0;
+	for(int i = 0; i < TOGGLE_COUNT; i++)
 	{
-		return FAIL;
-	}
-
-	gpio_set(PORT,PIN2,VALUE1);
-	if(gpio_get(PORT,PIN2)==VALUE1)
-	{
-		return c++;
-	}
-	else
-	{
-		return FAIL;
-	}
-	
-	gpio_set(PORT,PIN2,VALUE0);
-	if(gpio_get(PORT,PIN2)==VALUE0)
-	{
-		return c++;
-	}
-	else
-	{
-		return FAIL;
-	}
-
-	gpio_set(PORT,PIN2,VALUE1);
-	if(gpio_get(PORT,PIN2)==VALUE1)
-	{
-		return c++;
-	}
-	else
-	{
-		return FAIL;
-	}
-	if(c == 4)
-	{
-		return PASS;
-	}
-	else
-	{
-		return FAIL;
+		gpio_set(PORT,PIN2,value);
+		if(gpio_get(PORT,PIN2)!=value)
+		{
+			return FAIL;
+		}
+		value = (value == VALUE0) ? VALUE1 : VALUE0;	// Toggle for the next step
 	}
+	return PASS;
 }
+TEST_REGISTER(gpio, test_gpio_toggle, 100)
+
 /******************************************************************************/
-void test_gpio(void)
+/******************************************************************************/
+int test_gpio_bench_toggle(void)
 {
-	int a = test_gpio_set();
-	int b = test_gpio_get();
-	int c = test_gpio_toggle();
-	if(a == PASS && b == PASS && c == PASS)
+	uint8_t value = VALUE0;
+	uint32_t start = cycles_now();
+	for(int i = 0; i < GPIO_BENCH_TOGGLES; i++)
 	{
-		printf("All Test cases of GPIO PASSED!\n");
+		gpio_set(PORT,PIN2,value);
+		value ^= VALUE1;
 	}
-	else
+	uint32_t cycles = cycles_now() - start;
+	if(gpio_get(PORT,PIN2)==value)	// The last write left the previous value
 	{
-		printf("Test cases of GPIO FAILED!\n");
+		return FAIL;
 	}
+	// Compare builds with RAMFUNC_ENABLE=0 and 1 for the gain of running from SRAM
+	printf("gpio: toggle %u cycles, code in %s (%u bytes in SRAM)\n",
+	       (unsigned)(cycles / GPIO_BENCH_TOGGLES), ramfunc_size() ? "SRAM" : "flash",
+	       (unsigned)ramfunc_size());
+	return PASS;
 }
-
-/******************************************************************************/
+TEST_REGISTER(gpio, test_gpio_bench_toggle, 100)
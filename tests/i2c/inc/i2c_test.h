@@ -1,7 +1,8 @@
 /**
- * @file       I2C1.h
- * @brief      I2C drivers.
- * @details    This driver can be used to access the I2C pins.
+ * @file       i2c_test.h
+ * @brief      testing i2c driver.
+ * @details    This header contains the function prototypes for testing the
+ *             I2C driver and the BMI160 sensor connected to it.
  */
 
 /******************************************************************************
@@ -26,38 +27,24 @@
  ******************************************************************************/
  
 /* Define to prevent redundant inclusion */
-#ifndef I2C_H
-#define I2C_H
+#ifndef __I2C_TEST_H__
+#define __I2C_TEST_H__
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /***** Includes *****/
-#include <stdint.h>           // Standard integer types
-#include <stddef.h>	      // Standard definitions
-#include <stdio.h>            // Standard input/output functions 	
-#include <string.h>           // String handling functions
-#include "board.h"            // Board-specific definitions
-#include "mxc_device.h"       // Device-specific definitions
-#include "mxc_delay.h"        // Delay functions
-#include "nvic_table.h"       // NVIC (Interrupt Controller) definitions
-#include "mxc_errors.h"       // Error codes
-#include "i2c1.h"              // Include Maxim's I2C header
-#include "i2c.h"
+#include "i2c1.h"              // I2C driver under test
+#include "i2c_target.h"        // Target mode driver under test
+#include "test_runner.h"
 
 /***** Definitions *****/
-#ifdef BOARD_EVKIT_V1
-#define I2C_MASTER MXC_I2C2   // Define I2C2 as the master if using EVKIT_V1 board
-#define I2C_SCL_PIN 30        // SCL pin number for I2C2
-#define I2C_SDA_PIN 31        // SDA pin number for I2C2
-#else
-#define I2C_MASTER MXC_I2C1   // Define I2C1 as the master otherwise
-#define I2C_SCL_PIN 16        // SCL pin number for I2C1
-#define I2C_SDA_PIN 17        // SDA pin number for I2C1
-#endif
-
-#define I2C_FREQ 100000       // I2C frequency set to 100kHz
+#define I2C_BENCH_READS 100     // Register reads timed by test_i2c_bench_read()
+#define I2C_BENCH_READ_LEN 6    // Bytes per read, one accelerometer sample
+#define I2C_BENCH_REG 0x12      // BMI160 ACC_X_L, start of the accelerometer data
+#define I2C_TARGET_BENCH_READS 50   // Result reads per bus speed in test_i2c_target_bench()
+#define I2C_TARGET_TORN_READS 20    // Result reads racing publishes in test_i2c_target_atomic()
 
 /***** Function Prototypes *****/
 /**
@@ -95,13 +82,73 @@ int test_i2c_Gyro_mode(void);
 * @return    Returns 0 if the operation is successful, otherwise returns 1.
 */
 int test_bmi160_soft_reset(void);
-/**
- * @brief      Main function to test I2C functionality.
- */
-void test_i2c(void);
+/*
+* @brief     Times repeated burst reads of the accelerometer data and prints the throughput.
+* @return    Returns 0 if every read succeeded, otherwise returns 1.
+*/
+int test_i2c_bench_read(void);
+#ifdef HOST_SIM
+/*
+* @brief     Checks that an injected address NACK fails the read with ADDR_NACK_ERR set.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_addr_nack_fault(void);
+/*
+* @brief     Checks that an injected data NACK fails the write with DATA_ERR set.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_data_nack_fault(void);
+/*
+* @brief     Checks that an injected arbitration loss fails the read with ARB_ERR set.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_arb_lost_fault(void);
+/*
+* @brief     Checks that a register read takes the bus time of its bits at the bus frequency.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_read_timing(void);
+/*
+* @brief     Checks that NACKs and an arbitration loss within the retry budget are retried away.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_retry(void);
+/*
+* @brief     Holds SDA for every possible number of clocks, checks that each read
+*            recovers the bus and prints the recovery time.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_stuck_recovery(void);
+/*
+* @brief     Checks that a bus that cannot be freed fails the read quickly.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_stuck_unrecoverable(void);
+/*
+* @brief     Has a simulated host read and write the target's register map.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_target_regs(void);
+/*
+* @brief     Publishes a result block and has the host read it back.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_target_result(void);
+/*
+* @brief     Publishes results from the BMI160 data ready interrupt while the
+*            host reads, and checks that no read mixes two results.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_target_atomic(void);
+/*
+* @brief     Prints the sustained result read throughput at 400 kHz and 1 MHz.
+* @return    Returns 0 if the operation is successful, otherwise returns 1.
+*/
+int test_i2c_target_bench(void);
+#endif
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // I2C_H
+#endif // __I2C_TEST_H__
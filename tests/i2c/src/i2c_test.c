@@ -22,6 +22,12 @@
 /***** Includes *****/
 #include "i2c_test.h"
 #include "i2c1.h"
+#include "test_runner.h"
+#include "log.h"
+#include "cycles.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
 
 
 /******************************************************************************/
@@ -34,7 +40,7 @@ int test_i2c_init(void)
 		return 1;
 	}
 }
-
+TEST_REGISTER(i2c, test_i2c_init, 100)
 /******************************************************************************/
 int test_i2c_scan(void)
 {
@@ -46,6 +52,7 @@ int test_i2c_scan(void)
 	}
 
 }
+TEST_REGISTER(i2c, test_i2c_scan, 30000)
 /******************************************************************************/
 int test_i2c_write(void) {
     uint8_t reg_addr = 0x40;
@@ -70,6 +77,7 @@ int test_i2c_write(void) {
         return 1; // Test failed
     }
 }
+TEST_REGISTER(i2c, test_i2c_write, 100)
 /******************************************************************************/
 int test_i2c_read(void) {
     uint8_t read_buff;
@@ -81,17 +89,18 @@ int test_i2c_read(void) {
     if (result == E_NO_ERROR) {
         // Compare the read value with the expected value
         if (read_buff == expected_value) {
-            printf("Test passed: Read value 0x%02X matches expected value 0x%02X\n", read_buff, expected_value);
+            LOG_INFO("Test passed: Read value 0x%02X matches expected value 0x%02X", read_buff, expected_value);
             return 0; // Test passed
         } else {
-            printf("Test failed: Read value 0x%02X does not match expected value 0x%02X\n", read_buff, expected_value);
+            LOG_ERROR("Test failed: Read value 0x%02X does not match expected value 0x%02X", read_buff, expected_value);
             return 1; // Test failed
         }
     } else {
-        printf("I2C read failed with error code: %d\n", result);
+        LOG_ERROR("I2C read failed with error code: %d", result);
         return 1; // Test failed due to I2C error
     }
 }
+TEST_REGISTER(i2c, test_i2c_read, 100)
 /******************************************************************************/
 int test_i2c_Accelerometer_normal_mode(void){
     struct bmi160_dev dev;
@@ -115,6 +124,7 @@ int test_i2c_Accelerometer_normal_mode(void){
     }
 
 }
+TEST_REGISTER(i2c, test_i2c_Accelerometer_normal_mode, 100)
 /******************************************************************************/
 int test_i2c_Gyro_mode(void){
     struct bmi160_dev dev;
@@ -138,43 +148,476 @@ int test_i2c_Gyro_mode(void){
     }
 
 }
+TEST_REGISTER(i2c, test_i2c_Gyro_mode, 100)
 /******************************************************************************/
 int test_bmi160_soft_reset(void) {
     // Perform soft reset
     int result = bmi160_softi_reset();
     if (result != E_NO_ERROR) {
-        printf("Soft reset failed, test aborted.\n");
+        LOG_ERROR("Soft reset failed, test aborted.");
         return result;
     }
 
     // Check soft reset verification
     result = check_bmi160_reset();
     if (result == E_NO_ERROR) {
-        printf("BMI160 soft reset test passed.\n");
+        LOG_INFO("BMI160 soft reset test passed.");
     } else {
-        printf("BMI160 soft reset test failed.\n");
+        LOG_ERROR("BMI160 soft reset test failed.");
     }
 
     return result;
 }
+TEST_REGISTER(i2c, test_bmi160_soft_reset, 500)
 /******************************************************************************/
-void test_i2c(void)
+int test_i2c_bench_read(void)
 {
-	int a = test_i2c_init();
-	int b = test_i2c_scan();
-	int c = test_i2c_write();
-	int d = test_i2c_read();
-	int e = test_i2c_Accelerometer_normal_mode();
-	int f = test_i2c_Gyro_mode();
-	 int g = test_bmi160_soft_reset();
-	if(a == 0 && b == 0 && c == 0 && d == 0 && e == 0 && f == 0 && g == 0)
-	{
-		printf("All Test cases of I2C PASSED!\n");
-	}
-	else
-	{
-		printf("Test cases of I2C FAILED!\n");
-	}
+    uint8_t data[I2C_BENCH_READ_LEN];
+    uint32_t start = cycles_now();
+
+    for (int i = 0; i < I2C_BENCH_READS; i++) {
+        if (i2c_read_register(BMI160_I2C_ADDR, I2C_BENCH_REG, data, sizeof(data)) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    uint32_t us = cycles_to_us(cycles_now() - start);
+    if (us == 0) {
+        us = 1;
+    }
+    printf("i2c read: %d x %d bytes at %u Hz, %u us per read, %u bytes/s\n", I2C_BENCH_READS,
+           I2C_BENCH_READ_LEN, MXC_I2C_GetFrequency(I2C_MASTER), (unsigned)(us / I2C_BENCH_READS),
+           (unsigned)((uint64_t)I2C_BENCH_READS * I2C_BENCH_READ_LEN * 1000000 / us));
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_bench_read, 1000)
+#ifdef HOST_SIM
+/******************************************************************************/
+// Runs a register read with a fault injected into every attempt and checks
+// the error and the flag
+static int i2c_check_fault(sim_i2c_fault_t fault, unsigned int flag)
+{
+    uint8_t value = 0;
+    unsigned int flags0, flags1;
+    int err;
+
+    MXC_I2C_ClearFlags(I2C_MASTER, 0xFFFFFFFF, 0xFFFFFFFF);
+    sim_i2c_inject(MXC_I2C_GET_IDX(I2C_MASTER), fault, I2C_RETRIES + 1);
+    if (fault == SIM_I2C_FAULT_DATA_NACK) {
+        err = i2c_write_register(BMI160_I2C_ADDR, 0x40, &value, 1);
+    } else {
+        err = i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1);
+    }
+    MXC_I2C_GetFlags(I2C_MASTER, &flags0, &flags1);
+    if (err != E_COMM_ERR || !(flags0 & flag)) {
+        return 1;
+    }
+    // The fault is gone, the bus works again
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+        return 1;
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_i2c_addr_nack_fault(void)
+{
+    return i2c_check_fault(SIM_I2C_FAULT_ADDR_NACK, MXC_F_I2C_INTFL0_ADDR_NACK_ERR);
+}
+TEST_REGISTER(i2c, test_i2c_addr_nack_fault, 100)
+/******************************************************************************/
+int test_i2c_data_nack_fault(void)
+{
+    return i2c_check_fault(SIM_I2C_FAULT_DATA_NACK, MXC_F_I2C_INTFL0_DATA_ERR);
+}
+TEST_REGISTER(i2c, test_i2c_data_nack_fault, 100)
+/******************************************************************************/
+int test_i2c_arb_lost_fault(void)
+{
+    return i2c_check_fault(SIM_I2C_FAULT_ARB_LOST, MXC_F_I2C_INTFL0_ARB_ERR);
+}
+TEST_REGISTER(i2c, test_i2c_arb_lost_fault, 100)
+/******************************************************************************/
+int test_i2c_read_timing(void)
+{
+    // A one byte register read is two transactions: START, address, register,
+    // STOP, then START, address, data, STOP
+    const uint64_t bits = (1 + 9 + 9 + 1) + (1 + 9 + 9 + 1);
+    uint8_t value;
+    sim_timing_t timing;
+
+    sim_timing_get(&timing);
+    uint64_t expected = 2 * timing.i2c_overhead_ns + bits * 1000000000ULL / MXC_I2C_GetFrequency(I2C_MASTER);
+    uint64_t start = sim_time_ns();
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR) {
+        return 1;
+    }
+    uint64_t elapsed = sim_time_ns() - start;
+    // Host time spent in the call adds to the modelled bus time
+    if (elapsed < expected || elapsed > expected + expected / 10) {
+        LOG_ERROR("I2C read took %u ns, expected %u ns", (unsigned)elapsed, (unsigned)expected);
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_read_timing, 100)
+/******************************************************************************/
+int test_i2c_retry(void)
+{
+    int idx = MXC_I2C_GET_IDX(I2C_MASTER);
+    uint8_t value = 0;
+    i2c_bus_stats_t stats;
+
+    // Faults shorter than the retry budget never reach the caller
+    i2c_get_bus_stats(&stats, 1);
+    sim_i2c_inject(idx, SIM_I2C_FAULT_ADDR_NACK, I2C_RETRIES);
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+        return 1;
+    }
+    // Writes back the accelerometer configuration it already has
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x40, &value, 1) != E_NO_ERROR) {
+        return 1;
+    }
+    sim_i2c_inject(idx, SIM_I2C_FAULT_ARB_LOST, 1);
+    if (i2c_write_register(BMI160_I2C_ADDR, 0x40, &value, 1) != E_NO_ERROR) {
+        return 1;
+    }
+    i2c_get_bus_stats(&stats, 1);
+    if (stats.retries != I2C_RETRIES + 1 || stats.nacks != I2C_RETRIES || stats.arb_lost != 1 ||
+        stats.stuck != 0 || stats.recoveries != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_retry, 100)
+/******************************************************************************/
+int test_i2c_stuck_recovery(void)
+{
+    int idx = MXC_I2C_GET_IDX(I2C_MASTER);
+    uint8_t value = 0;
+    i2c_bus_stats_t stats;
+    uint64_t worst_ns = 0;
+
+    uint64_t start = sim_time_ns();
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR) {
+        return 1;
+    }
+    uint64_t clean_ns = sim_time_ns() - start;
+
+    // The target can be anywhere in its byte when it is reset
+    i2c_get_bus_stats(&stats, 1);
+    for (uint32_t clocks = 1; clocks <= I2C_RECOVER_CLOCKS; clocks++) {
+        sim_i2c_hold_sda(idx, clocks);
+        start = sim_time_ns();
+        value = 0;
+        if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+            return 1;
+        }
+        if (sim_time_ns() - start > worst_ns) {
+            worst_ns = sim_time_ns() - start;
+        }
+    }
+    i2c_get_bus_stats(&stats, 1);
+    printf("i2c stuck SDA: %u of %u recovered, read with recovery %u us worst "
+           "(recovery %u us, clean read %u us)\n",
+           (unsigned)stats.recoveries, I2C_RECOVER_CLOCKS, (unsigned)(worst_ns / 1000),
+           (unsigned)cycles_to_us(stats.recover_cycles), (unsigned)(clean_ns / 1000));
+    if (stats.recoveries != I2C_RECOVER_CLOCKS || stats.stuck != I2C_RECOVER_CLOCKS ||
+        stats.recovery_failures != 0) {
+        return 1;
+    }
+    // Well under the seconds a board reset costs
+    return (worst_ns > 2000000ULL);
 }
+TEST_REGISTER(i2c, test_i2c_stuck_recovery, 100)
+/******************************************************************************/
+int test_i2c_stuck_unrecoverable(void)
+{
+    int idx = MXC_I2C_GET_IDX(I2C_MASTER);
+    uint8_t value = 0;
+    i2c_bus_stats_t stats;
 
+    // A target that never lets go, then a shorted clock line: the read fails
+    // fast instead of retrying forever
+    i2c_get_bus_stats(&stats, 1);
+    sim_i2c_hold_sda(idx, SIM_I2C_HOLD_FOREVER);
+    uint64_t start = sim_time_ns();
+    int err = i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1);
+    uint64_t fail_ns = sim_time_ns() - start;
+    sim_i2c_hold_sda(idx, 0);
+    if (err != E_COMM_ERR || fail_ns > 2000000ULL) {
+        return 1;
+    }
+    sim_gpio_stuck(0, 1UL << I2C_SCL_PIN, 0);
+    err = i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1);
+    sim_gpio_release(0, 1UL << I2C_SCL_PIN);
+    if (err != E_COMM_ERR) {
+        return 1;
+    }
+    i2c_get_bus_stats(&stats, 1);
+    if (stats.recovery_failures != 2 || stats.recoveries != 0) {
+        return 1;
+    }
+    // Released lines work again without any reset
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_stuck_unrecoverable, 100)
 /******************************************************************************/
+// Register map served in the target tests: a read-only ID and a writable
+// control block
+static uint8_t target_id[2] = { 0xA5, 0x01 };
+static uint8_t target_ctrl[4];
+static uint8_t target_written_reg;
+static uint8_t target_written_len;
+
+static void i2c_test_target_written(uint8_t reg, uint8_t len)
+{
+    target_written_reg = reg;
+    target_written_len = len;
+}
+
+static const i2c_target_region_t target_test_map[] = {
+    { 0x00, sizeof(target_id), 0, target_id, NULL },
+    { 0x10, sizeof(target_ctrl), 1, target_ctrl, i2c_test_target_written },
+};
+/******************************************************************************/
+// One transaction of the simulated host
+static int i2c_test_host(unsigned int hz, const uint8_t *tx, unsigned int tx_len, uint8_t *rx,
+                         unsigned int rx_len)
+{
+    return sim_i2c_host_transfer(MXC_I2C_GET_IDX(I2C_TARGET), hz, I2C_TARGET_ADDR, tx, tx_len, rx,
+                                 rx_len);
+}
+/******************************************************************************/
+// Checks a result block read by the host: its bytes follow from its sequence number
+static int i2c_test_result_ok(const uint8_t *buf, uint16_t *seq)
+{
+    uint16_t s = buf[0] | (buf[1] << 8);
+    uint16_t len = buf[2] | (buf[3] << 8);
+    for (unsigned int i = 0; i < len; i++) {
+        if (buf[I2C_TARGET_RESULT_HEADER + i] != (uint8_t)(s * 7 + i)) {
+            return 0;
+        }
+    }
+    *seq = s;
+    return 1;
+}
+/******************************************************************************/
+// Builds and publishes result block number seq, the way i2c_test_result_ok() expects it
+static int i2c_test_publish(uint16_t seq, uint16_t len)
+{
+    uint8_t *buf = i2c_target_result_begin();
+    if (buf == NULL) {
+        return E_BUSY;
+    }
+    for (unsigned int i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seq * 7 + i);
+    }
+    return i2c_target_result_publish(len);
+}
+/******************************************************************************/
+int test_i2c_target_regs(void)
+{
+    const uint8_t write_ctrl[] = { 0x10, 1, 2, 3, 4 };
+    const uint8_t write_id[] = { 0x00, 0x55 };
+    uint8_t reg;
+    uint8_t rx[4];
+    i2c_target_stats_t stats;
+
+    if (i2c_target_init(target_test_map, 2) != E_NO_ERROR) {
+        return 1;
+    }
+    // Writes land in writable registers only
+    if (i2c_test_host(MXC_I2C_FAST_SPEED, write_ctrl, sizeof(write_ctrl), NULL, 0) != 0 ||
+        memcmp(target_ctrl, &write_ctrl[1], 4) != 0 || target_written_reg != 0x10 ||
+        target_written_len != 4) {
+        return 1;
+    }
+    if (i2c_test_host(MXC_I2C_FAST_SPEED, write_id, sizeof(write_id), NULL, 0) != 0 ||
+        target_id[0] != 0xA5) {
+        return 1;
+    }
+    // Register address write, repeated START, read; unmapped registers read 0xFF
+    reg = 0x12;
+    if (i2c_test_host(MXC_I2C_FAST_SPEED, &reg, 1, rx, 3) != 0 || rx[0] != 3 || rx[1] != 4 ||
+        rx[2] != 0xFF) {
+        return 1;
+    }
+    // A plain read goes on after the last byte read, not after the bytes
+    // fetched ahead into the FIFO
+    reg = 0x00;
+    if (i2c_test_host(MXC_I2C_FAST_SPEED, &reg, 1, rx, 1) != 0 || rx[0] != 0xA5 ||
+        i2c_test_host(MXC_I2C_FAST_SPEED, NULL, 0, rx, 1) != 0 || rx[0] != 0x01) {
+        return 1;
+    }
+    // Another address is not answered
+    if (sim_i2c_host_transfer(MXC_I2C_GET_IDX(I2C_TARGET), MXC_I2C_FAST_SPEED, I2C_TARGET_ADDR + 1,
+                              &reg, 1, NULL, 0) != E_COMM_ERR) {
+        return 1;
+    }
+    i2c_target_get_stats(&stats, 1);
+    if (stats.transactions != 5 || stats.bytes_read != 5 || stats.bytes_written != 9 ||
+        stats.underflows != 0 || stats.overflows != 0) {
+        return 1;
+    }
+    // Regions must not overlap each other or the result register
+    const i2c_target_region_t bad[] = { { 0x00, 2, 0, target_id, NULL },
+                                        { 0x01, 2, 0, target_id, NULL } };
+    const i2c_target_region_t high = { 0xEF, 2, 0, target_id, NULL };
+    if (i2c_target_init(bad, 2) != E_BAD_PARAM || i2c_target_init(&high, 1) != E_BAD_PARAM) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_target_regs, 100)
+/******************************************************************************/
+int test_i2c_target_result(void)
+{
+    static uint8_t rx[I2C_TARGET_RESULT_HEADER + I2C_TARGET_RESULT_MAX];
+    const uint8_t reg = I2C_TARGET_RESULT_REG;
+    uint16_t seq = 0;
+
+    if (i2c_target_init(target_test_map, 2) != E_NO_ERROR) {
+        return 1;
+    }
+    // Nothing published yet: an empty result
+    if (i2c_test_host(MXC_I2C_FAST_SPEED, &reg, 1, rx, I2C_TARGET_RESULT_HEADER) != 0 ||
+        rx[0] != 0 || rx[2] != 0) {
+        return 1;
+    }
+    if (i2c_target_result_publish(8) != E_BAD_STATE || i2c_target_result_begin() == NULL ||
+        i2c_target_result_publish(I2C_TARGET_RESULT_MAX + 1) != E_BAD_PARAM) {
+        return 1;
+    }
+    if (i2c_test_publish(1, 200) != E_NO_ERROR ||
+        i2c_test_host(MXC_I2C_FAST_SPEED, &reg, 1, rx, I2C_TARGET_RESULT_HEADER + 200) != 0 ||
+        !i2c_test_result_ok(rx, &seq) || seq != 1 || rx[2] != 200) {
+        return 1;
+    }
+    // The register address stays on the result, reading again gives the newest
+    if (i2c_test_publish(2, I2C_TARGET_RESULT_MAX) != E_NO_ERROR ||
+        i2c_test_host(MXC_I2C_FAST_SPEED, NULL, 0, rx, sizeof(rx)) != 0 ||
+        !i2c_test_result_ok(rx, &seq) || seq != 2) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_target_result, 100)
+/******************************************************************************/
+// Publishes a new result at every BMI160 data ready pulse
+static uint16_t target_isr_seq;
+static uint32_t target_isr_busy;
+
+static void i2c_test_target_publish_isr(void *cbdata)
+{
+    (void)cbdata;
+    if (i2c_test_publish(target_isr_seq + 1, I2C_TARGET_RESULT_MAX) == E_NO_ERROR) {
+        target_isr_seq++;
+    } else {
+        target_isr_busy++;
+    }
+}
+
+static void i2c_test_gpio_irq(void)
+{
+    MXC_GPIO_Handler(MXC_GPIO_GET_IDX(BMI160_INT1_PORT));
+}
+/******************************************************************************/
+int test_i2c_target_atomic(void)
+{
+    static uint8_t rx[I2C_TARGET_RESULT_HEADER + I2C_TARGET_RESULT_MAX];
+    const uint8_t reg = I2C_TARGET_RESULT_REG;
+    struct bmi160_dev dev;
+    uint16_t seq = 0;
+    uint16_t last = 0;
+    uint32_t changes = 0;
+    int ok = 1;
+
+    dev.chip_id = BMI160_I2C_ADDR;
+    dev.delay_ms = NULL;
+    target_isr_seq = 0;
+    target_isr_busy = 0;
+    if (i2c_target_init(target_test_map, 2) != E_NO_ERROR ||
+        set_accelerometer_normal_mode(&dev) != E_NO_ERROR) {
+        return 1;
+    }
+    mxc_gpio_cfg_t cfg = { BMI160_INT1_PORT, BMI160_INT1_PIN, MXC_GPIO_FUNC_IN, MXC_GPIO_PAD_NONE,
+                           MXC_GPIO_VSSEL_VDDIO, MXC_GPIO_DRVSTR_0 };
+    IRQn_Type irq = MXC_GPIO_GET_IRQ(MXC_GPIO_GET_IDX(BMI160_INT1_PORT));
+    MXC_GPIO_Config(&cfg);
+    MXC_GPIO_RegisterCallback(&cfg, i2c_test_target_publish_isr, NULL);
+    MXC_GPIO_IntConfig(&cfg, MXC_GPIO_INT_RISING);
+    MXC_GPIO_ClearFlags(BMI160_INT1_PORT, BMI160_INT1_PIN);
+    MXC_GPIO_EnableInt(BMI160_INT1_PORT, BMI160_INT1_PIN);
+    MXC_NVIC_SetVector(irq, i2c_test_gpio_irq);
+    NVIC_EnableIRQ(irq);
+    if (bmi160_enable_data_ready() != E_NO_ERROR) {
+        ok = 0;
+    }
+
+    // At 100 kHz every read spans about two 100 Hz data ready pulses
+    for (int i = 0; ok && i < I2C_TARGET_TORN_READS; i++) {
+        if (i2c_test_host(MXC_I2C_STD_MODE, &reg, 1, rx, sizeof(rx)) != 0 ||
+            !i2c_test_result_ok(rx, &seq) || seq < last) {
+            ok = 0;
+        }
+        changes += (seq != last);
+        last = seq;
+    }
+
+    uint8_t off = 0;
+    i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_EN_1_REG, &off, 1);
+    MXC_GPIO_DisableInt(BMI160_INT1_PORT, BMI160_INT1_PIN);
+    NVIC_DisableIRQ(irq);
+    log_drain();
+    printf("i2c target: %d reads, %u results published during them, %u new results seen, "
+           "%u publishes deferred\n",
+           I2C_TARGET_TORN_READS, (unsigned)target_isr_seq, (unsigned)changes,
+           (unsigned)target_isr_busy);
+    // Publishes raced the reads, some had to wait for one to end, yet every
+    // read was whole and most saw a newer result than the one before
+    return !(ok && target_isr_busy > 0 && changes > I2C_TARGET_TORN_READS / 2);
+}
+TEST_REGISTER(i2c, test_i2c_target_atomic, 2000)
+/******************************************************************************/
+int test_i2c_target_bench(void)
+{
+    static const unsigned int speeds[] = { MXC_I2C_FAST_SPEED, MXC_I2C_FASTPLUS_SPEED };
+    static uint8_t rx[I2C_TARGET_RESULT_HEADER + I2C_TARGET_RESULT_MAX];
+    const uint8_t reg = I2C_TARGET_RESULT_REG;
+    i2c_target_stats_t stats;
+    uint16_t seq;
+
+    if (i2c_target_init(target_test_map, 2) != E_NO_ERROR ||
+        i2c_test_publish(1, I2C_TARGET_RESULT_MAX) != E_NO_ERROR) {
+        return 1;
+    }
+    for (unsigned int s = 0; s < sizeof(speeds) / sizeof(speeds[0]); s++) {
+        i2c_target_get_stats(&stats, 1);
+        uint64_t start = sim_time_ns();
+        for (int i = 0; i < I2C_TARGET_BENCH_READS; i++) {
+            if (i2c_test_host(speeds[s], &reg, 1, rx, sizeof(rx)) != 0 ||
+                !i2c_test_result_ok(rx, &seq)) {
+                return 1;
+            }
+        }
+        uint64_t ns = sim_time_ns() - start;
+        i2c_target_get_stats(&stats, 1);
+
+        uint32_t payload = (uint32_t)(I2C_TARGET_BENCH_READS * I2C_TARGET_RESULT_MAX);
+        uint32_t rate = (uint32_t)((uint64_t)payload * 1000000000ULL / ns);
+        uint32_t wire = speeds[s] / 9;      // Bytes/s the bus moves at most
+        printf("i2c target at %u kHz: %u result bytes/s (%u%% of the %u bytes/s bus limit), "
+               "%u interrupts per %u byte read, %u underflows\n",
+               speeds[s] / 1000, (unsigned)rate, (unsigned)((uint64_t)rate * 100 / wire),
+               (unsigned)wire, (unsigned)(stats.interrupts / I2C_TARGET_BENCH_READS),
+               (unsigned)sizeof(rx), (unsigned)stats.underflows);
+        if (stats.underflows != 0 || (uint64_t)rate * 100 < (uint64_t)wire * 90) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(i2c, test_i2c_target_bench, 1000)
+#endif
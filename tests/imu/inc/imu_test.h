@@ -0,0 +1,105 @@
+/**
+ * @file       imu_test.h
+ * @brief      testing the IMU window pipeline.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the BMI160 to CNN input pipeline.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __IMU_TEST_H__
+#define __IMU_TEST_H__
+
+/***** Includes *****/
+#include "imu_window.h"
+#include "imu_log.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define IMU_BENCH_WINDOWS 16        // Windows run through test_imu_bench()
+#define IMU_BENCH_INFER_US 2000     // Time the host stub inference stage takes
+#define IMU_LOG_TEST_FRAMES 2000    // Frames written by the logger tests
+#define IMU_LOG_BENCH_HZ 800        // Sample rate test_imu_log_bench() logs at
+#define IMU_LOG_BENCH_FRAMES 3200   // Four seconds at IMU_LOG_BENCH_HZ
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Checks rounding and saturation of the int8 conversion.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_quantize(void);
+/**
+ * @brief      Checks the channel-major layout and the overlap of consecutive windows.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_window(void);
+/**
+ * @brief      Checks that a window completed during inference is dropped
+ *             without holding up acquisition.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_drop(void);
+/**
+ * @brief      Fills a window from the BMI160 and runs inference on it.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_acquire(void);
+/**
+ * @brief      Runs the pipeline from the BMI160 to a stub inference stage and
+ *             prints the sustained window rate and the end-to-end latency.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_bench(void);
+#ifdef HOST_SIM
+/**
+ * @brief      Logs frames, including full scale jumps, and reads them back.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_log_roundtrip(void);
+/**
+ * @brief      Seeks to times within, between, before and after the logged
+ *             frames, and checks that a corrupted page is detected.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_log_seek(void);
+/**
+ * @brief      Fills the log and checks that further frames are refused and counted.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_log_full(void);
+/**
+ * @brief      Cuts power while a log page programs and checks the page is
+ *             marked spoilt and every later page still reads back.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_log_spoilt(void);
+/**
+ * @brief      Logs IMU_LOG_BENCH_FRAMES frames at IMU_LOG_BENCH_HZ and prints
+ *             the compression ratio, the sustained record rate and the share
+ *             of the flash program bandwidth the log needs.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_imu_log_bench(void);
+#endif
+
+#endif
@@ -0,0 +1,540 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "imu_test.h"
+#include "imu_window.h"
+#include "i2c1.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "log.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+/***** Definitions *****/
+/**
+ * @brief      What the recording inference stage saw.
+ */
+typedef struct {
+    uint32_t calls;             // Windows received
+    uint32_t seq;               // Number of the last window
+    imu_window_t last;          // Copy of the last window
+} imu_test_record_t;
+
+/***** Functions *****/
+// Inference stage that keeps a copy of the window
+static void imu_test_record(const imu_window_t *win, uint32_t seq, void *ctx)
+{
+    imu_test_record_t *rec = ctx;
+    rec->calls++;
+    rec->seq = seq;
+    rec->last = *win;
+}
+/******************************************************************************/
+// Pushes sample n of a ramp: channel c reads (n + c) % 100 after quantisation
+static void imu_test_push(uint32_t n)
+{
+    int16_t sample[IMU_CHANNELS];
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        int32_t value = (int32_t)((n + c) % 100);
+        sample[c] = (int16_t)(value << ((c < 3) ? IMU_GYR_SHIFT : IMU_ACC_SHIFT));
+    }
+    imu_window_push(sample);
+}
+/******************************************************************************/
+// Checks that a window holds ramp samples first to first + IMU_WINDOW_LEN - 1
+static int imu_test_check(const imu_window_t *win, uint32_t first)
+{
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        for (uint32_t i = 0; i < IMU_WINDOW_LEN; i++) {
+            if (win->data[c][i] != (int8_t)((first + i + c) % 100)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_imu_quantize(void)
+{
+    if (imu_quantize(0x0100, 8) != 1 || imu_quantize(0x017F, 8) != 1 ||
+        imu_quantize(0x0180, 8) != 2 || imu_quantize(-0x0100, 8) != -1 ||
+        imu_quantize(-0x0181, 8) != -2 || imu_quantize(32767, 8) != 127 ||
+        imu_quantize(-32768, 8) != -128 || imu_quantize(200, 0) != 127 ||
+        imu_quantize(-5, 0) != -5) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_quantize, 100)
+/******************************************************************************/
+int test_imu_window(void)
+{
+    static imu_test_record_t rec;
+    uint32_t n = 0;
+
+    memset(&rec, 0, sizeof(rec));
+    imu_window_init(imu_test_record, &rec);
+    while (n < IMU_WINDOW_LEN - 1) {
+        imu_test_push(n++);
+    }
+    if (imu_window_poll() != 0) {
+        return 1;       // One sample short of a window
+    }
+    imu_test_push(n++);
+    if (imu_window_poll() != 1 || rec.seq != 0 || imu_test_check(&rec.last, 0) != 0) {
+        return 1;
+    }
+    // The next window shares all but IMU_WINDOW_STRIDE samples with the first
+    for (int i = 0; i < IMU_WINDOW_STRIDE; i++) {
+        imu_test_push(n++);
+    }
+    if (imu_window_poll() != 1 || rec.seq != 1 ||
+        imu_test_check(&rec.last, IMU_WINDOW_STRIDE) != 0 || imu_window_poll() != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_window, 100)
+/******************************************************************************/
+int test_imu_drop(void)
+{
+    static imu_test_record_t rec;
+    imu_window_stats_t stats;
+    uint32_t n = 0;
+
+    memset(&rec, 0, sizeof(rec));
+    imu_window_init(imu_test_record, &rec);
+    // Three windows complete before inference gets to run
+    while (n < IMU_WINDOW_LEN + 2 * IMU_WINDOW_STRIDE) {
+        imu_test_push(n++);
+    }
+    imu_window_get_stats(&stats, 0);
+    if (stats.windows != 1 || stats.dropped != 2 || stats.samples != n) {
+        return 1;
+    }
+    // The waiting window is the first one, the dropped ones are gone
+    if (imu_window_poll() != 1 || rec.seq != 0 || imu_test_check(&rec.last, 0) != 0) {
+        return 1;
+    }
+    // Acquisition kept sliding, so the next window follows on seamlessly
+    for (int i = 0; i < IMU_WINDOW_STRIDE; i++) {
+        imu_test_push(n++);
+    }
+    if (imu_window_poll() != 1 || rec.seq != 3 ||
+        imu_test_check(&rec.last, 3 * IMU_WINDOW_STRIDE) != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_drop, 100)
+/******************************************************************************/
+// Puts both BMI160 sensors in normal mode
+static int imu_test_sensor_on(void)
+{
+    struct bmi160_dev dev;
+    dev.chip_id = BMI160_I2C_ADDR;
+    dev.delay_ms = NULL;
+
+    if (i2c_init() != 0 || set_accelerometer_normal_mode(&dev) != 0 ||
+        set_gyroscope_Normal_mode(&dev) != 0) {
+        return 1;
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_imu_acquire(void)
+{
+    static imu_test_record_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    if (imu_test_sensor_on() != 0) {
+        return 1;
+    }
+    imu_window_init(imu_test_record, &rec);
+    for (int i = 0; i < IMU_WINDOW_LEN; i++) {
+        if (imu_window_acquire() != E_NO_ERROR) {
+            return 1;
+        }
+        log_drain();    // Every read logs, keep the ring from overflowing
+    }
+    if (imu_window_poll() != 1 || rec.calls != 1) {
+        return 1;
+    }
+#ifdef HOST_SIM
+    // The model moves every axis through its full range
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        int8_t lo = 127, hi = -128;
+        for (int i = 0; i < IMU_WINDOW_LEN; i++) {
+            lo = (rec.last.data[c][i] < lo) ? rec.last.data[c][i] : lo;
+            hi = (rec.last.data[c][i] > hi) ? rec.last.data[c][i] : hi;
+        }
+        if (hi - lo < 100) {
+            return 1;
+        }
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_acquire, 1000)
+/******************************************************************************/
+// Stub inference stage: touches the whole window, and on the host takes as
+// long as a small network would on the accelerator
+static void imu_test_infer(const imu_window_t *win, uint32_t seq, void *ctx)
+{
+    uint32_t *sum = ctx;
+    const int8_t *p = &win->data[0][0];
+    for (uint32_t i = 0; i < sizeof(*win); i++) {
+        *sum += (uint32_t)p[i];
+    }
+    (void)seq;
+#ifdef HOST_SIM
+    sim_clock_advance((uint64_t)IMU_BENCH_INFER_US * 1000);
+#endif
+}
+/******************************************************************************/
+int test_imu_bench(void)
+{
+    imu_window_stats_t stats;
+    uint32_t sum = 0;
+
+    if (imu_test_sensor_on() != 0) {
+        return 1;
+    }
+    imu_window_init(imu_test_infer, &sum);
+    uint32_t start = cycles_now();
+    do {
+        if (imu_window_acquire() != E_NO_ERROR) {
+            return 1;
+        }
+        imu_window_poll();
+        log_drain();    // Idle work of the main loop
+        imu_window_get_stats(&stats, 0);
+    } while (stats.windows + stats.dropped < IMU_BENCH_WINDOWS);
+    uint32_t us = cycles_to_us(cycles_now() - start);
+    if (us == 0) {
+        us = 1;
+    }
+
+    printf("imu: %u windows of %d x %d in %u us, %u samples/s, %u.%02u windows/s, "
+           "%u dropped\n",
+           (unsigned)stats.windows, IMU_WINDOW_LEN, IMU_CHANNELS, (unsigned)us,
+           (unsigned)((uint64_t)stats.samples * 1000000 / us),
+           (unsigned)((uint64_t)stats.windows * 1000000 / us),
+           (unsigned)((uint64_t)stats.windows * 100000000 / us % 100),
+           (unsigned)stats.dropped);
+    printf("imu: latency from last sample to inference done avg %u us, max %u us\n",
+           (unsigned)cycles_to_us((uint32_t)(stats.latency_total / stats.windows)),
+           (unsigned)cycles_to_us(stats.latency_max));
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_bench, 10000)
+#ifdef HOST_SIM
+// The log cases are simulator only: imu_log_start() erases the log region,
+// which on the target would lose the recorded session at every boot
+/******************************************************************************/
+// Synthetic frame n at IMU_LOG_BENCH_HZ: slow triangle motion on every axis,
+// a little sensor noise and +-1 us of timestamp jitter
+static void imu_test_frame(imu_log_frame_t *f, uint32_t n, uint32_t *seed)
+{
+    uint32_t x = *seed;
+    f->t = 1000000 + n * (1000000 / IMU_LOG_BENCH_HZ);
+    for (int c = 0; c < IMU_CHANNELS; c++) {
+        uint32_t period = 400 + 60 * c;
+        int32_t phase = (int32_t)((n + 37 * c) % period);
+        int32_t tri = (phase < (int32_t)period / 2) ? phase : (int32_t)period - phase;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        f->axis[c] = (int16_t)(tri * 16 - 1600 + (int32_t)(x % 17) - 8);
+    }
+    f->t += x % 3;
+    f->t -= 1;
+    *seed = x;
+}
+/******************************************************************************/
+// Logs IMU_LOG_TEST_FRAMES synthetic frames
+static int imu_test_log_fill(void)
+{
+    uint32_t seed = 1;
+    imu_log_frame_t f;
+
+    if (imu_log_start() != E_NO_ERROR) {
+        return 1;
+    }
+    for (uint32_t n = 0; n < IMU_LOG_TEST_FRAMES; n++) {
+        imu_test_frame(&f, n, &seed);
+        if (imu_log_append(&f) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    return (imu_log_flush() != E_NO_ERROR);
+}
+/******************************************************************************/
+int test_imu_log_roundtrip(void)
+{
+    static imu_log_frame_t frames[IMU_LOG_TEST_FRAMES];
+    imu_log_reader_t r;
+    imu_log_frame_t f;
+    imu_log_stats_t stats;
+    uint32_t seed = 7;
+
+    if (imu_log_start() != E_NO_ERROR) {
+        return 1;
+    }
+    for (uint32_t n = 0; n < IMU_LOG_TEST_FRAMES; n++) {
+        imu_test_frame(&frames[n], n, &seed);
+        if (n % 500 == 250) {
+            // Full scale steps and a stalled clock
+            for (int c = 0; c < IMU_CHANNELS; c++) {
+                frames[n].axis[c] = (c & 1) ? 32767 : -32768;
+            }
+            frames[n].t = frames[n - 1].t;
+        }
+        if (imu_log_append(&frames[n]) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    if (imu_log_flush() != E_NO_ERROR) {
+        return 1;
+    }
+    imu_log_get_stats(&stats, 0);
+    if (stats.records != IMU_LOG_TEST_FRAMES || stats.pages < 2 ||
+        imu_log_pages() != stats.pages || stats.dropped != 0) {
+        return 1;
+    }
+    if (imu_log_seek(&r, 0) != E_NO_ERROR) {
+        return 1;
+    }
+    for (uint32_t n = 0; n < IMU_LOG_TEST_FRAMES; n++) {
+        if (imu_log_read(&r, &f) != 1 || memcmp(&f, &frames[n], sizeof(f)) != 0) {
+            return 1;
+        }
+    }
+    return (imu_log_read(&r, &f) != 0);
+}
+TEST_REGISTER(imu, test_imu_log_roundtrip, 1000)
+/******************************************************************************/
+int test_imu_log_seek(void)
+{
+    static imu_log_frame_t frames[IMU_LOG_TEST_FRAMES];
+    imu_log_reader_t r;
+    imu_log_frame_t f;
+    uint32_t seed = 1;
+
+    if (imu_test_log_fill() != 0) {
+        return 1;
+    }
+    for (uint32_t n = 0; n < IMU_LOG_TEST_FRAMES; n++) {
+        imu_test_frame(&frames[n], n, &seed);
+    }
+    // Exact times, every page boundary included
+    for (uint32_t n = 0; n < IMU_LOG_TEST_FRAMES; n += 7) {
+        if (imu_log_seek(&r, frames[n].t) != E_NO_ERROR || imu_log_read(&r, &f) != 1 ||
+            memcmp(&f, &frames[n], sizeof(f)) != 0 || imu_log_read(&r, &f) != 1 ||
+            f.t != frames[n + 1].t) {
+            return 1;
+        }
+    }
+    // Between two frames, before the first and after the last
+    if (imu_log_seek(&r, frames[1000].t + 1) != E_NO_ERROR || imu_log_read(&r, &f) != 1 ||
+        f.t != frames[1001].t) {
+        return 1;
+    }
+    if (imu_log_seek(&r, 5) != E_NO_ERROR || imu_log_read(&r, &f) != 1 || f.t != frames[0].t) {
+        return 1;
+    }
+    if (imu_log_seek(&r, frames[IMU_LOG_TEST_FRAMES - 1].t + 1) != E_NONE_AVAIL) {
+        return 1;
+    }
+    // A flipped bit in the second page fails its CRC
+    const imu_log_index_t *index = (const imu_log_index_t *)FLASH_LOG_BASE;
+    sim_flash_flip_bit(FLASH_LOG_BASE + MXC_FLASH_PAGE_SIZE + IMU_LOG_PAGE_SIZE + 3, 2);
+    if (imu_log_seek(&r, index[1].t_first) != E_BAD_STATE ||
+        imu_log_seek(&r, index[2].t_first) != E_NO_ERROR) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_log_seek, 1000)
+/******************************************************************************/
+int test_imu_log_full(void)
+{
+    imu_log_frame_t f;
+    imu_log_stats_t stats;
+    imu_log_reader_t r;
+    uint32_t seed = 3;
+    uint32_t n = 0;
+    int err;
+
+    if (imu_log_start() != E_NO_ERROR) {
+        return 1;
+    }
+    do {
+        imu_test_frame(&f, n++, &seed);
+        err = imu_log_append(&f);
+    } while (err == E_NO_ERROR);
+    if (err != E_OVERFLOW || imu_log_append(&f) != E_OVERFLOW) {
+        return 1;
+    }
+    imu_log_get_stats(&stats, 0);
+    if (stats.dropped != 2 || stats.records != n - 1 || stats.pages != IMU_LOG_PAGES ||
+        imu_log_pages() != IMU_LOG_PAGES) {
+        return 1;
+    }
+    // Everything that was accepted reads back
+    uint32_t count = 0;
+    if (imu_log_seek(&r, 0) != E_NO_ERROR) {
+        return 1;
+    }
+    while (imu_log_read(&r, &f) == 1) {
+        count++;
+    }
+    return (count != stats.records);
+}
+TEST_REGISTER(imu, test_imu_log_full, 2000)
+/******************************************************************************/
+int test_imu_log_spoilt(void)
+{
+    const imu_log_index_t *index = (const imu_log_index_t *)FLASH_LOG_BASE;
+    imu_log_frame_t f, prev;
+    imu_log_stats_t stats;
+    imu_log_reader_t r;
+    uint32_t seed = 5;
+    uint32_t n = 0;
+    uint32_t t_lost = 0;
+    int err = E_NO_ERROR;
+
+    if (imu_log_start() != E_NO_ERROR) {
+        return 1;
+    }
+    do {
+        imu_test_frame(&f, n++, &seed);
+        if (imu_log_append(&f) != E_NO_ERROR) {
+            return 1;
+        }
+        imu_log_get_stats(&stats, 0);
+    } while (stats.pages < 2);
+    // Power fails while the third page programs, taking its index entry too
+    sim_flash_tear(0, 0);
+    while (err == E_NO_ERROR) {
+        t_lost = f.t;
+        imu_test_frame(&f, n++, &seed);
+        err = imu_log_append(&f);
+    }
+    if (!sim_flash_power_lost()) {
+        return 1;
+    }
+    sim_flash_power_cycle();
+    for (; n < IMU_LOG_TEST_FRAMES; n++) {
+        imu_test_frame(&f, n, &seed);
+        if (imu_log_append(&f) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    if (imu_log_flush() != E_NO_ERROR) {
+        return 1;
+    }
+
+    // The hole is marked once the next page is indexed, and every page after
+    // it still reads back
+    imu_log_get_stats(&stats, 0);
+    if (index[2].count != 0 || imu_log_pages() != stats.pages + 1) {
+        return 1;
+    }
+    uint32_t count = 0;
+    if (imu_log_seek(&r, 0) != E_NO_ERROR) {
+        return 1;
+    }
+    while (imu_log_read(&r, &f) == 1) {
+        if (count > 0 && f.t <= prev.t) {
+            return 1;
+        }
+        prev = f;
+        count++;
+    }
+    if (count != stats.records - (stats.dropped - 1)) {     // One append refused outright
+        return 1;
+    }
+    // A time in the lost page finds the first frame after it
+    if (imu_log_seek(&r, t_lost) != E_NO_ERROR || imu_log_read(&r, &f) != 1 ||
+        f.t <= t_lost || f.t < index[3].t_first) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_log_spoilt, 2000)
+/******************************************************************************/
+int test_imu_log_bench(void)
+{
+    imu_log_frame_t f;
+    imu_log_stats_t stats;
+    uint32_t seed = 1;
+    uint32_t busy = 0;
+
+    if (imu_log_start() != E_NO_ERROR) {
+        return 1;
+    }
+    for (uint32_t n = 0; n < IMU_LOG_BENCH_FRAMES; n++) {
+        imu_test_frame(&f, n, &seed);
+        uint32_t start = cycles_now();
+        if (imu_log_append(&f) != E_NO_ERROR) {
+            return 1;
+        }
+        busy += cycles_now() - start;
+    }
+    uint32_t start = cycles_now();
+    if (imu_log_flush() != E_NO_ERROR) {
+        return 1;
+    }
+    busy += cycles_now() - start;
+    imu_log_get_stats(&stats, 0);
+
+    uint32_t us = cycles_to_us(busy);
+    uint32_t span_us = IMU_LOG_BENCH_FRAMES * (1000000 / IMU_LOG_BENCH_HZ);
+    if (us == 0) {
+        us = 1;
+    }
+    printf("imu log: %u records in %u pages, %u bytes raw, %u bytes in flash, ratio %u.%02u, "
+           "%u.%02u bytes per record\n",
+           (unsigned)stats.records, (unsigned)stats.pages, (unsigned)stats.raw_bytes,
+           (unsigned)stats.flash_bytes, (unsigned)(stats.raw_bytes / stats.flash_bytes),
+           (unsigned)((uint64_t)stats.raw_bytes * 100 / stats.flash_bytes % 100),
+           (unsigned)(stats.flash_bytes / stats.records),
+           (unsigned)((uint64_t)stats.flash_bytes * 100 / stats.records % 100));
+    printf("imu log: sustained %u records/s; logging %u Hz keeps the core busy %u.%02u%% "
+           "(flash programming %u us of every second)\n",
+           (unsigned)((uint64_t)stats.records * 1000000 / us), IMU_LOG_BENCH_HZ,
+           (unsigned)((uint64_t)us * 100 / span_us),
+           (unsigned)((uint64_t)us * 10000 / span_us % 100),
+           (unsigned)((uint64_t)cycles_to_us(stats.write_cycles) * 1000000 / span_us));
+    // The log has to keep up with the sensor with room to spare
+    if (stats.records != IMU_LOG_BENCH_FRAMES || stats.raw_bytes < 2 * stats.flash_bytes ||
+        (uint64_t)us * 10 > span_us) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(imu, test_imu_log_bench, 2000)
+#endif
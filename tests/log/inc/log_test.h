@@ -0,0 +1,58 @@
+/**
+ * @file       log_test.h
+ * @brief      testing the deferred logger.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the binary log ring buffer.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef __LOG_TEST_H__
+#define __LOG_TEST_H__
+
+/***** Includes *****/
+#include "log.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define LOG_TEST_CAPTURE_SIZE (2 * LOG_BUFFER_SIZE)  // Bytes kept by the capture sink
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Writes records and checks their binary layout after draining.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_log_record(void);
+/**
+ * @brief      Overfills the ring and checks the drop count and drop record.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_log_overflow(void);
+/**
+ * @brief      Measures the cost of one log site with two arguments.
+ * @return     Returns 0.
+ */
+int test_log_bench_write(void);
+
+#endif
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "log_test.h"
+#include "log.h"
+#include "cycles.h"
+#include "test_runner.h"
+
+/***** Globals *****/
+static uint8_t log_capture[LOG_TEST_CAPTURE_SIZE];
+static size_t log_capture_len = 0;
+
+/***** Functions *****/
+// Sink that keeps the drained bytes for inspection
+static void log_capture_sink(const uint8_t *data, size_t len)
+{
+    if (log_capture_len + len > sizeof(log_capture)) {
+        len = sizeof(log_capture) - log_capture_len;
+    }
+    memcpy(&log_capture[log_capture_len], data, len);
+    log_capture_len += len;
+}
+/******************************************************************************/
+// Flushes pending records to the normal sink and starts capturing
+static log_sink_t log_capture_start(void)
+{
+    log_drain();
+    log_capture_len = 0;
+    return log_set_sink(log_capture_sink);
+}
+/******************************************************************************/
+int test_log_record(void)
+{
+    log_sink_t old = log_capture_start();
+    LOG_INFO("test record %u %d", 7, -2);
+    LOG_ERROR("no arguments");
+    log_drain();
+    log_set_sink(old);
+
+    uint32_t value;
+    const uint8_t *rec = log_capture;
+    if (log_capture_len != (LOG_HEADER_SIZE + 8) + LOG_HEADER_SIZE) {
+        return 1;
+    }
+    if (rec[0] != LOG_SYNC || rec[1] != ((LOG_LEVEL_INFO << 4) | 2)) {
+        return 1;
+    }
+    memcpy(&value, &rec[4], sizeof(value));
+    if (strcmp(log_fmt_string(value), "test record %u %d") != 0) {
+        return 1;
+    }
+    memcpy(&value, &rec[LOG_HEADER_SIZE + 4], sizeof(value));
+    if ((int32_t)value != -2) {
+        return 1;
+    }
+    // Second record follows with the next sequence number
+    rec += LOG_HEADER_SIZE + 8;
+    if (rec[0] != LOG_SYNC || rec[1] != (LOG_LEVEL_ERROR << 4) ||
+        (uint16_t)(rec[2] | (rec[3] << 8)) != (uint16_t)(log_capture[2] | (log_capture[3] << 8)) + 1) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(log, test_log_record, 100)
+/******************************************************************************/
+int test_log_overflow(void)
+{
+    const uint32_t rec_len = LOG_HEADER_SIZE + sizeof(uint32_t);
+    const uint32_t fit = LOG_BUFFER_SIZE / rec_len;
+    uint32_t dropped = log_dropped();
+
+    log_sink_t old = log_capture_start();
+    for (uint32_t i = 0; i < fit + 3; i++) {
+        LOG_DEBUG("overflow %u", i);
+    }
+    if (log_dropped() - dropped != 3) {
+        log_set_sink(old);
+        return 1;
+    }
+    log_drain();
+    LOG_DEBUG("after overflow");    // Preceded by the drop record
+    log_drain();
+    log_set_sink(old);
+
+    const uint8_t *rec = &log_capture[fit * rec_len];
+    uint32_t fmt_id, count;
+    memcpy(&fmt_id, &rec[4], sizeof(fmt_id));
+    memcpy(&count, &rec[LOG_HEADER_SIZE], sizeof(count));
+    if (fmt_id != LOG_ID_DROPPED || count != 3) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(log, test_log_overflow, 100)
+/******************************************************************************/
+int test_log_bench_write(void)
+{
+    const uint32_t n = 64;
+    log_sink_t old = log_capture_start();
+    uint32_t start = cycles_now();
+    for (uint32_t i = 0; i < n; i++) {
+        LOG_DEBUG("bench %u %u", i, n);
+    }
+    uint32_t log_cycles = cycles_now() - start;
+    log_drain();
+    log_set_sink(old);
+
+    printf("log: %u cycles per record with 2 arguments\n", (unsigned)(log_cycles / n));
+    return 0;
+}
+TEST_REGISTER(log, test_log_bench_write, 100)
+
+/******************************************************************************/
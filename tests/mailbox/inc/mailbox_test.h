@@ -0,0 +1,70 @@
+/**
+ * @file       mailbox_test.h
+ * @brief      Inter-core mailbox test cases.
+ * @details    Checks the ring's ordering, full and empty handling and line
+ *             layout, runs a producer and a consumer thread against each
+ *             other, and measures the Arm core time per IMU sample with and
+ *             without the acquisition offloaded.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __MAILBOX_TEST_H__
+#define __MAILBOX_TEST_H__
+
+/***** Includes *****/
+#include "mailbox.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define MAILBOX_TEST_FRAMES 100000      // Frames passed between the two threads
+#define MAILBOX_BENCH_FRAMES 200        // IMU samples per side of the benchmark
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Fills, overflows, drains and wraps a ring on one thread and
+ *             checks the order, the counters, the doorbells and the layout.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_mailbox_ring(void);
+#ifdef HOST_SIM
+/**
+ * @brief      A producer thread pushes MAILBOX_TEST_FRAMES frames while the
+ *             test consumes them, sleeping on the doorbell when the ring is
+ *             empty. Every frame must arrive once and in order.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_mailbox_threads(void);
+/**
+ * @brief      Arm core time per IMU sample: read over I2C by the Arm core
+ *             with imu_window_acquire(), against taken from the mailbox with
+ *             mailbox_acq_drain() while a producer thread stands in for the
+ *             RISC-V core. Both are timed with sim_time_ns(), which counts
+ *             the modelled bus time of the I2C reads. Prints both and the
+ *             saving.
+ * @return     Returns 0 if offloading saves Arm core time, otherwise returns 1.
+ */
+int test_mailbox_bench(void);
+#endif
+
+#endif
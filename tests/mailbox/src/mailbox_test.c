@@ -0,0 +1,281 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "mailbox_test.h"
+#include "mailbox.h"
+#include "test_runner.h"
+#ifdef HOST_SIM
+#include <pthread.h>
+#include <time.h>
+#include "i2c1.h"
+#include "imu_window.h"
+#include "sim.h"
+#endif
+
+/***** Globals *****/
+static mailbox_t mailbox_test_ring;
+static volatile uint32_t mailbox_test_rings;   // Doorbells seen
+
+/***** Functions *****/
+static void mailbox_test_count_doorbell(void)
+{
+    mailbox_test_rings++;
+}
+/******************************************************************************/
+static void mailbox_test_fill(mailbox_frame_t *frame, uint32_t seq)
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->seq = seq;
+    frame->type = MAILBOX_FRAME_IMU;
+    frame->len = MAILBOX_PAYLOAD;
+    for (int i = 0; i < MAILBOX_PAYLOAD; i++) {
+        frame->data[i] = (uint8_t)(seq + i);
+    }
+}
+/******************************************************************************/
+static int mailbox_test_check(const mailbox_frame_t *frame, uint32_t seq)
+{
+    mailbox_frame_t expected;
+    mailbox_test_fill(&expected, seq);
+    return memcmp(frame, &expected, sizeof(expected)) != 0;
+}
+/******************************************************************************/
+int test_mailbox_ring(void)
+{
+    mailbox_t *mb = &mailbox_test_ring;
+    mailbox_frame_t frame;
+    mailbox_stats_t stats;
+    uint32_t seq = 0, next = 0;
+
+    // Each side's index on its own line, frames on line boundaries
+    if (offsetof(mailbox_t, tail) - offsetof(mailbox_t, head) < MAILBOX_LINE ||
+        offsetof(mailbox_t, slot) % MAILBOX_LINE != 0) {
+        return 1;
+    }
+
+    mailbox_init(mb);
+    mailbox_test_rings = 0;
+    mailbox_set_doorbell(mailbox_test_count_doorbell);
+    if (mailbox_pop(mb, &frame) != E_NONE_AVAIL) {
+        return 1;
+    }
+    // Only the push into an empty ring rings the doorbell
+    for (int i = 0; i < MAILBOX_SLOTS; i++) {
+        mailbox_test_fill(&frame, seq);
+        if (mailbox_push(mb, &frame) != E_NO_ERROR) {
+            return 1;
+        }
+        seq++;
+    }
+    mailbox_test_fill(&frame, seq);
+    if (mailbox_push(mb, &frame) != E_BUSY || mailbox_count(mb) != MAILBOX_SLOTS ||
+        mailbox_test_rings != 1) {
+        return 1;
+    }
+    // Drain, then run the indices around the ring a few times
+    for (int i = 0; i < 3 * MAILBOX_SLOTS; i++) {
+        if (mailbox_pop(mb, &frame) != E_NO_ERROR || mailbox_test_check(&frame, next)) {
+            return 1;
+        }
+        next++;
+        mailbox_test_fill(&frame, seq);
+        if (i >= MAILBOX_SLOTS && mailbox_push(mb, &frame) == E_NO_ERROR) {
+            seq++;
+        }
+        if (i == MAILBOX_SLOTS - 1) {
+            // Empty now; the next push rings again
+            mailbox_test_fill(&frame, seq);
+            if (mailbox_push(mb, &frame) != E_NO_ERROR) {
+                return 1;
+            }
+            seq++;
+        }
+    }
+    while (mailbox_pop(mb, &frame) == E_NO_ERROR) {
+        if (mailbox_test_check(&frame, next)) {
+            return 1;
+        }
+        next++;
+    }
+    mailbox_set_doorbell(NULL);
+    mailbox_get_stats(mb, &stats);
+    printf("mailbox: %u pushed, %u popped, %u dropped, %u doorbells\n", (unsigned)stats.pushed,
+           (unsigned)stats.popped, (unsigned)stats.dropped, (unsigned)stats.doorbells);
+    if (next != seq || stats.pushed != seq || stats.popped != seq || stats.dropped != 1 ||
+        stats.doorbells != mailbox_test_rings) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(mailbox, test_mailbox_ring, 100)
+#ifdef HOST_SIM
+/******************************************************************************/
+static pthread_mutex_t mailbox_test_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mailbox_test_bell = PTHREAD_COND_INITIALIZER;
+static const mailbox_frame_t *mailbox_test_frames;     // Frames the producer sends, NULL for numbered ones
+static uint32_t mailbox_test_count;                    // Frames the producer sends
+
+// Stands in for the SEMA interrupt: wakes the consumer
+static void mailbox_test_doorbell(void)
+{
+    pthread_mutex_lock(&mailbox_test_lock);
+    mailbox_test_rings++;
+    pthread_cond_signal(&mailbox_test_bell);
+    pthread_mutex_unlock(&mailbox_test_lock);
+}
+/******************************************************************************/
+// The RISC-V core: pushes its frames, waiting for room rather than dropping
+static void *mailbox_test_producer(void *arg)
+{
+    mailbox_t *mb = arg;
+    mailbox_frame_t frame;
+    mailbox_set_doorbell(mailbox_test_doorbell);
+    for (uint32_t seq = 0; seq < mailbox_test_count; seq++) {
+        if (mailbox_test_frames != NULL) {
+            frame = *mailbox_test_frames;
+            frame.seq = seq;
+        } else {
+            mailbox_test_fill(&frame, seq);
+        }
+        while (mailbox_count(mb) >= MAILBOX_SLOTS) {
+            struct timespec pause = { 0, 1000 };
+            nanosleep(&pause, NULL);
+        }
+        mailbox_push(mb, &frame);
+    }
+    mailbox_set_doorbell(NULL);
+    return NULL;
+}
+/******************************************************************************/
+// Sleeps until the doorbell rings after seen, as WFI would; 0 on a timeout
+static int mailbox_test_wait(uint32_t *seen)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 1;
+    int ok = 1;
+    pthread_mutex_lock(&mailbox_test_lock);
+    while (ok && mailbox_test_rings == *seen) {
+        ok = (pthread_cond_timedwait(&mailbox_test_bell, &mailbox_test_lock, &deadline) == 0);
+    }
+    *seen = mailbox_test_rings;
+    pthread_mutex_unlock(&mailbox_test_lock);
+    return ok || mailbox_count(&mailbox_test_ring) != 0;
+}
+/******************************************************************************/
+static int mailbox_test_start(pthread_t *thread, const mailbox_frame_t *frames, uint32_t count)
+{
+    mailbox_init(&mailbox_test_ring);
+    mailbox_test_rings = 0;
+    mailbox_test_frames = frames;
+    mailbox_test_count = count;
+    return pthread_create(thread, NULL, mailbox_test_producer, &mailbox_test_ring) == 0;
+}
+/******************************************************************************/
+int test_mailbox_threads(void)
+{
+    mailbox_t *mb = &mailbox_test_ring;
+    mailbox_frame_t frame;
+    mailbox_stats_t stats;
+    pthread_t producer;
+    uint32_t next = 0, seen = 0, errors = 0, waits = 0;
+
+    if (!mailbox_test_start(&producer, NULL, MAILBOX_TEST_FRAMES)) {
+        return 1;
+    }
+    while (next < MAILBOX_TEST_FRAMES) {
+        if (mailbox_pop(mb, &frame) == E_NO_ERROR) {
+            errors += (frame.seq != next || mailbox_test_check(&frame, next));
+            next++;
+        } else if (!mailbox_test_wait(&seen)) {
+            break;              // A push that should have rung did not
+        } else {
+            waits++;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    mailbox_get_stats(mb, &stats);
+    printf("mailbox: %u of %u frames in order, %u errors, %u doorbells, %u sleeps\n",
+           (unsigned)next, MAILBOX_TEST_FRAMES, (unsigned)errors, (unsigned)stats.doorbells,
+           (unsigned)waits);
+    return (next != MAILBOX_TEST_FRAMES || errors != 0 || stats.dropped != 0) ? 1 : 0;
+}
+TEST_REGISTER(mailbox, test_mailbox_threads, 5000)
+/******************************************************************************/
+int test_mailbox_bench(void)
+{
+    mailbox_frame_t sample_frame;
+    pthread_t producer;
+    uint32_t seen = 0, samples = 0;
+
+    if (i2c_init() != 0) {
+        return 1;
+    }
+    imu_window_init(NULL, NULL);
+
+    // Arm core acquires: it polls every I2C transfer itself
+    uint64_t start = sim_time_ns();
+    for (int i = 0; i < MAILBOX_BENCH_FRAMES; i++) {
+        if (imu_window_acquire() != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    uint64_t local_ns = sim_time_ns() - start;
+
+    // One real sample for the producer thread, which cannot use the bus model
+    mailbox_init(&mailbox_test_ring);
+    if (mailbox_acq_frame(&mailbox_test_ring, 0) != E_NO_ERROR ||
+        mailbox_pop(&mailbox_test_ring, &sample_frame) != E_NO_ERROR) {
+        return 1;
+    }
+
+    // RISC-V core acquires: the Arm core only drains, timed on the same
+    // simulated clock as above but only while it drains
+    if (!mailbox_test_start(&producer, &sample_frame, MAILBOX_BENCH_FRAMES)) {
+        return 1;
+    }
+    uint64_t offload_ns = 0;
+    while (samples < MAILBOX_BENCH_FRAMES) {
+        uint64_t t0 = sim_time_ns();
+        int n = mailbox_acq_drain(&mailbox_test_ring);
+        offload_ns += sim_time_ns() - t0;
+        samples += n;
+        if (n == 0 && !mailbox_test_wait(&seen)) {
+            break;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    uint32_t local_per = (uint32_t)(local_ns / MAILBOX_BENCH_FRAMES);
+    uint32_t offload_per = (uint32_t)(offload_ns / MAILBOX_BENCH_FRAMES);
+    printf("mailbox: Arm core time per IMU sample, acquired %u ns, from the mailbox %u ns, "
+           "%u.%u%% saved\n", (unsigned)local_per, (unsigned)offload_per,
+           (unsigned)((local_ns - offload_ns) * 100 / local_ns),
+           (unsigned)((local_ns - offload_ns) * 1000 / local_ns % 10));
+    return (samples != MAILBOX_BENCH_FRAMES || offload_ns >= local_ns) ? 1 : 0;
+}
+TEST_REGISTER(mailbox, test_mailbox_bench, 2000)
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file       memstat_test.h
+ * @brief      Stack and allocation high-water mark test cases.
+ * @details    Checks the stack high-water mark against a known frame and the
+ *             per call site counters of pool_alloc() and malloc().
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __MEMSTAT_TEST_H__
+#define __MEMSTAT_TEST_H__
+
+/***** Includes *****/
+#include "memstat.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define MEMSTAT_TEST_FRAME 2048         // Stack bytes used by the test's deep call
+#define MEMSTAT_TEST_SLACK 1024         // Stack a case may use on top of that
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Makes a call with a MEMSTAT_TEST_FRAME byte frame and checks
+ *             that the stack high-water mark covers it.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_memstat_stack(void);
+#if MEMSTAT_ENABLE
+/**
+ * @brief      Allocates and frees pool blocks from one call site and checks
+ *             its counters, high-water mark and failures.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_memstat_pool_site(void);
+#if MEMSTAT_HEAP
+/**
+ * @brief      Checks that a malloc() from the test is counted at its caller
+ *             and released by free().
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_memstat_heap(void);
+#endif
+#endif
+
+#endif
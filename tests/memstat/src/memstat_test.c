@@ -0,0 +1,161 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memstat_test.h"
+#include "memstat.h"
+#include "pool.h"
+#include "test_runner.h"
+
+/***** Functions *****/
+// Uses MEMSTAT_TEST_FRAME bytes of stack
+static uint32_t __attribute__((noinline)) memstat_test_deep(uint8_t seed)
+{
+    volatile uint8_t frame[MEMSTAT_TEST_FRAME];
+    uint32_t sum = 0;
+    for (int i = 0; i < MEMSTAT_TEST_FRAME; i++) {
+        frame[i] = (uint8_t)(seed + i);
+    }
+    for (int i = 0; i < MEMSTAT_TEST_FRAME; i += 64) {
+        sum += frame[i];
+    }
+    return sum;
+}
+/******************************************************************************/
+int test_memstat_stack(void)
+{
+    memstat_stack_t before, after;
+
+#ifdef HOST_SIM
+    memstat_stack_paint();      // On the target main() painted the stack at boot
+#endif
+    memstat_stack(&before);
+    memstat_test_deep(1);
+    memstat_stack(&after);
+
+    printf("memstat: stack %u bytes used before the call, %u after\n", (unsigned)before.used,
+           (unsigned)after.used);
+    if (after.size == 0 || after.used > after.size || after.used < MEMSTAT_TEST_FRAME) {
+        return 1;
+    }
+#ifdef HOST_SIM
+    // Measured from the frame that painted, so only the call is seen
+    if (after.used > MEMSTAT_TEST_FRAME + MEMSTAT_TEST_SLACK) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(memstat, test_memstat_stack, 100)
+#if MEMSTAT_ENABLE
+/******************************************************************************/
+// Finds the counters of a call site in this file
+static int memstat_test_site(memstat_kind_t kind, uint32_t line, memstat_site_t *site)
+{
+    static memstat_site_t sites[MEMSTAT_SITES];
+    int n = memstat_sites(sites, MEMSTAT_SITES);
+    for (int i = 0; i < n && i < MEMSTAT_SITES; i++) {
+        if (sites[i].kind == kind && sites[i].line == line && sites[i].file != NULL &&
+            strcmp(sites[i].file, __FILE__) == 0) {
+            *site = sites[i];
+            return 0;
+        }
+    }
+    return 1;
+}
+/******************************************************************************/
+int test_memstat_pool_site(void)
+{
+    void *block[3];
+    memstat_site_t site;
+
+    memstat_reset();
+    uint32_t line = __LINE__ + 2;
+    for (int i = 0; i < 3; i++) {
+        block[i] = pool_alloc(20 + i);
+    }
+    if (memstat_test_site(MEMSTAT_POOL, line, &site) != 0 || site.allocs != 3 ||
+        site.live != 3 || site.largest != 22 || site.bytes_live != 63) {
+        pool_free(block[0]);
+        pool_free(block[1]);
+        pool_free(block[2]);
+        return 1;
+    }
+    for (int i = 0; i < 3; i++) {
+        pool_free(block[i]);
+    }
+    if (memstat_test_site(MEMSTAT_POOL, line, &site) != 0 || site.live != 0 ||
+        site.high_water != 3 || site.bytes_high_water != 63) {
+        return 1;
+    }
+
+    // Larger than any class
+    void *none = pool_alloc(POOL_LARGE_SIZE + 1);
+    line = __LINE__ - 1;
+    if (none != NULL || memstat_test_site(MEMSTAT_POOL, line, &site) != 0 ||
+        site.failures != 1 || site.allocs != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(memstat, test_memstat_pool_site, 100)
+#if MEMSTAT_HEAP
+/******************************************************************************/
+// Sums the live heap blocks and bytes over every heap site
+static void memstat_test_heap_live(uint32_t *live, uint32_t *bytes)
+{
+    static memstat_site_t sites[MEMSTAT_SITES];
+    int n = memstat_sites(sites, MEMSTAT_SITES);
+    *live = 0;
+    *bytes = 0;
+    for (int i = 0; i < n && i < MEMSTAT_SITES; i++) {
+        if (sites[i].kind == MEMSTAT_HEAP_ALLOC) {
+            *live += sites[i].live;
+            *bytes += sites[i].bytes_live;
+        }
+    }
+}
+/******************************************************************************/
+int test_memstat_heap(void)
+{
+    uint32_t live0, bytes0, live1, bytes1, live2, bytes2;
+
+    memstat_test_heap_live(&live0, &bytes0);
+    uint8_t *volatile p = malloc(100);
+    if (p == NULL) {
+        return 1;
+    }
+    p[0] = 1;
+    memstat_test_heap_live(&live1, &bytes1);
+    free(p);
+    memstat_test_heap_live(&live2, &bytes2);
+
+    if (live1 != live0 + 1 || bytes1 != bytes0 + 100 || live2 != live0 || bytes2 != bytes0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(memstat, test_memstat_heap, 100)
+#endif
+#endif
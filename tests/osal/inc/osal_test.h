@@ -0,0 +1,75 @@
+/**
+ * @file       osal_test.h
+ * @brief      RTOS driver layer test cases.
+ * @details    Runs tasks on the simulator's single core model: mutual
+ *             exclusion, reader/writer ordering, the I2C driver shared by two
+ *             tasks, and the throughput of I2C reads overlapped with
+ *             computation against the bare-metal build's sequential run.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __OSAL_TEST_H__
+#define __OSAL_TEST_H__
+
+/***** Includes *****/
+#include "osal.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define OSAL_TEST_ROUNDS 100            // Lock and unlock rounds per task
+#define OSAL_TEST_I2C_READS 20          // Register reads per task
+#define OSAL_BENCH_READS 20             // I2C reads of the benchmark's bus task
+#define OSAL_BENCH_WORK 150             // Work units of its compute task
+#define OSAL_BENCH_WORK_NS 50000        // Core time of one work unit
+
+/***** Function Prototypes *****/
+#if OSAL_RTOS && defined(HOST_SIM)
+/**
+ * @brief      Two tasks update a counter with a yield between read and write,
+ *             inside a mutex, and no update may be lost.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_osal_mutex(void);
+/**
+ * @brief      Checks that a writer waits for the reader inside and that a
+ *             reader arriving later waits for the writer.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_osal_rwlock(void);
+/**
+ * @brief      Two tasks read the BMI160 chip ID through the I2C driver at
+ *             the same time; every read must succeed.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_osal_i2c_tasks(void);
+/**
+ * @brief      Runs OSAL_BENCH_READS I2C reads and OSAL_BENCH_WORK units of
+ *             computation one after the other, as the bare-metal build does,
+ *             then as two tasks, and prints the simulated time of both.
+ * @return     Returns 0 if the tasks finish first, otherwise returns 1.
+ */
+int test_osal_bench(void);
+#endif
+
+#endif
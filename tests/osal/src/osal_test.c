@@ -0,0 +1,217 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "osal_test.h"
+#include "osal.h"
+#include "i2c1.h"
+#include "test_runner.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+#if OSAL_RTOS && defined(HOST_SIM)
+
+/***** Globals *****/
+static osal_mutex_t osal_test_lock;
+static osal_rwlock_t osal_test_rw;
+static volatile uint32_t osal_test_counter;
+static volatile uint32_t osal_test_inside;      // Tasks between lock and unlock
+static volatile uint32_t osal_test_overlaps;    // Times two were inside at once
+static char osal_test_order[16];                // Enter and leave marks of the rwlock case
+static uint32_t osal_test_marks;
+static volatile uint32_t osal_test_errors;
+
+/***** Functions *****/
+// Read, yield, write: loses updates unless the mutex keeps the other task out
+static void osal_test_count_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < OSAL_TEST_ROUNDS; i++) {
+        osal_mutex_lock(&osal_test_lock);
+        if (++osal_test_inside > 1) {
+            osal_test_overlaps++;
+        }
+        uint32_t v = osal_test_counter;
+        osal_yield();
+        osal_test_counter = v + 1;
+        osal_test_inside--;
+        osal_mutex_unlock(&osal_test_lock);
+        osal_yield();
+    }
+}
+/******************************************************************************/
+int test_osal_mutex(void)
+{
+    osal_test_counter = 0;
+    osal_test_inside = 0;
+    osal_test_overlaps = 0;
+    if (osal_task_create(osal_test_count_task, NULL, "count0") != E_NO_ERROR ||
+        osal_task_create(osal_test_count_task, NULL, "count1") != E_NO_ERROR) {
+        return 1;
+    }
+    osal_start();
+
+    printf("osal: counter %u of %u, %u overlaps\n", (unsigned)osal_test_counter,
+           2 * OSAL_TEST_ROUNDS, (unsigned)osal_test_overlaps);
+    return (osal_test_counter != 2 * OSAL_TEST_ROUNDS || osal_test_overlaps != 0) ? 1 : 0;
+}
+TEST_REGISTER(osal, test_osal_mutex, 1000)
+/******************************************************************************/
+static void osal_test_mark(char c)
+{
+    if (osal_test_marks < sizeof(osal_test_order) - 1) {
+        osal_test_order[osal_test_marks++] = c;
+    }
+}
+/******************************************************************************/
+// Holds the lock over a few yields, marking entry with arg and leaving with
+// its capital
+static void osal_test_reader_task(void *arg)
+{
+    char c = (char)(uintptr_t)arg;
+    osal_read_lock(&osal_test_rw);
+    osal_test_mark(c);
+    for (int i = 0; i < 3; i++) {
+        osal_yield();
+    }
+    osal_test_mark(c - 'a' + 'A');
+    osal_read_unlock(&osal_test_rw);
+}
+/******************************************************************************/
+static void osal_test_writer_task(void *arg)
+{
+    (void)arg;
+    osal_write_lock(&osal_test_rw);
+    osal_test_mark('w');
+    for (int i = 0; i < 3; i++) {
+        osal_yield();
+    }
+    osal_test_mark('W');
+    osal_write_unlock(&osal_test_rw);
+}
+/******************************************************************************/
+int test_osal_rwlock(void)
+{
+    memset(osal_test_order, 0, sizeof(osal_test_order));
+    osal_test_marks = 0;
+    // Created in run order: a reader gets in, the writer waits for it, and the
+    // second reader arrives while the writer waits
+    if (osal_task_create(osal_test_reader_task, (void *)(uintptr_t)'a', "reader0") != E_NO_ERROR ||
+        osal_task_create(osal_test_writer_task, NULL, "writer") != E_NO_ERROR ||
+        osal_task_create(osal_test_reader_task, (void *)(uintptr_t)'b', "reader1") != E_NO_ERROR) {
+        return 1;
+    }
+    osal_start();
+
+    printf("osal: rwlock order %s\n", osal_test_order);
+    return (strcmp(osal_test_order, "aAwWbB") != 0) ? 1 : 0;
+}
+TEST_REGISTER(osal, test_osal_rwlock, 1000)
+/******************************************************************************/
+static void osal_test_i2c_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < OSAL_TEST_I2C_READS; i++) {
+        uint8_t value = 0;
+        if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+            osal_test_errors++;
+        }
+    }
+}
+/******************************************************************************/
+int test_osal_i2c_tasks(void)
+{
+    i2c_bus_stats_t stats;
+    osal_test_errors = 0;
+    if (i2c_init() != 0) {
+        return 1;
+    }
+    i2c_get_bus_stats(&stats, 1);
+    if (osal_task_create(osal_test_i2c_task, NULL, "i2c0") != E_NO_ERROR ||
+        osal_task_create(osal_test_i2c_task, NULL, "i2c1") != E_NO_ERROR) {
+        return 1;
+    }
+    osal_start();
+
+    i2c_get_bus_stats(&stats, 1);
+    printf("osal: %u reads from two tasks, %u errors, %u retries\n", 2 * OSAL_TEST_I2C_READS,
+           (unsigned)osal_test_errors, (unsigned)stats.retries);
+    return (osal_test_errors != 0 || stats.retries != 0) ? 1 : 0;
+}
+TEST_REGISTER(osal, test_osal_i2c_tasks, 1000)
+/******************************************************************************/
+// Stands in for processing: core time that needs no bus
+static void osal_bench_work(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < OSAL_BENCH_WORK; i++) {
+        sim_clock_advance(OSAL_BENCH_WORK_NS);
+        osal_yield();
+    }
+}
+/******************************************************************************/
+static void osal_bench_reads(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < OSAL_BENCH_READS; i++) {
+        uint8_t value = 0;
+        if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR || value != 0xD1) {
+            osal_test_errors++;
+        }
+    }
+}
+/******************************************************************************/
+int test_osal_bench(void)
+{
+    osal_test_errors = 0;
+    if (i2c_init() != 0) {
+        return 1;
+    }
+
+    // Bare metal: the core polls each transaction, then computes
+    uint64_t start = sim_time_ns();
+    osal_bench_reads(NULL);
+    osal_bench_work(NULL);
+    uint64_t bare_ns = sim_time_ns() - start;
+
+    // Tasks: the compute task runs while the bus task waits for its interrupts
+    start = sim_time_ns();
+    if (osal_task_create(osal_bench_reads, NULL, "bus") != E_NO_ERROR ||
+        osal_task_create(osal_bench_work, NULL, "work") != E_NO_ERROR) {
+        return 1;
+    }
+    osal_start();
+    uint64_t rtos_ns = sim_time_ns() - start;
+
+    printf("osal: %u reads + %u work units, bare metal %u us (%u reads/s), tasks %u us "
+           "(%u reads/s), speedup %u.%02ux\n",
+           OSAL_BENCH_READS, OSAL_BENCH_WORK, (unsigned)(bare_ns / 1000),
+           (unsigned)(OSAL_BENCH_READS * 1000000000ULL / bare_ns), (unsigned)(rtos_ns / 1000),
+           (unsigned)(OSAL_BENCH_READS * 1000000000ULL / rtos_ns), (unsigned)(bare_ns / rtos_ns),
+           (unsigned)(bare_ns * 100 / rtos_ns % 100));
+    return (osal_test_errors != 0 || rtos_ns >= bare_ns) ? 1 : 0;
+}
+TEST_REGISTER(osal, test_osal_bench, 1000)
+
+#endif
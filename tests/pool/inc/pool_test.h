@@ -0,0 +1,60 @@
+/**
+ * @file       pool_test.h
+ * @brief      testing the memory pools.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the fixed block pools and comparing them with malloc.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __POOL_TEST_H__
+#define __POOL_TEST_H__
+
+/***** Includes *****/
+#include "pool.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define POOL_BENCH_OPS 20000        // Allocations and releases of the randomised workload
+#define POOL_BENCH_LIVE 16          // Most blocks held at once by the workload
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Checks class selection, alignment, spilling into larger classes
+ *             and refusal of oversized and exhausted requests.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_pool_alloc(void);
+/**
+ * @brief      Checks the in-use count, high-water mark and failure counter.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_pool_stats(void);
+/**
+ * @brief      Runs the same randomised alloc/free workload on the pools and on
+ *             malloc and prints the cycles and memory overhead of both.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_pool_bench(void);
+
+#endif
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pool_test.h"
+#include "pool.h"
+#include "test_runner.h"
+#include "cycles.h"
+
+/***** Functions *****/
+// Blocks of one class in use right now
+static uint32_t pool_test_in_use(int cls)
+{
+    pool_stats_t stats;
+    pool_get_stats(cls, &stats, 0);
+    return stats.in_use;
+}
+/******************************************************************************/
+int test_pool_alloc(void)
+{
+    void *large[POOL_LARGE_COUNT];
+    uint32_t small = pool_test_in_use(0);
+    uint32_t medium = pool_test_in_use(1);
+    int result = 0;
+
+    // The smallest class that fits is used, blocks are 8 byte aligned
+    uint8_t *a = pool_alloc(1);
+    uint8_t *b = pool_alloc(POOL_SMALL_SIZE + 1);
+    if (a == NULL || b == NULL || ((uintptr_t)a & 7) || ((uintptr_t)b & 7) ||
+        pool_test_in_use(0) != small + 1 || pool_test_in_use(1) != medium + 1) {
+        result = 1;
+    }
+    memset(a, 0xAA, 1);
+    memset(b, 0xBB, POOL_SMALL_SIZE + 1);
+    pool_free(a);
+    pool_free(b);
+    pool_free(NULL);
+    if (pool_test_in_use(0) != small || pool_test_in_use(1) != medium) {
+        result = 1;
+    }
+
+    // A released block is handed out again first
+    if (pool_alloc(1) != a) {
+        result = 1;
+    }
+    pool_free(a);
+
+    if (pool_alloc(POOL_LARGE_SIZE + 1) != NULL) {
+        result = 1;
+    }
+    // The large class runs dry, nothing larger to spill into
+    int taken = 0;
+    while (taken < POOL_LARGE_COUNT && (large[taken] = pool_alloc(POOL_LARGE_SIZE)) != NULL) {
+        taken++;
+    }
+    if (pool_test_in_use(2) != POOL_LARGE_COUNT || pool_alloc(POOL_LARGE_SIZE) != NULL) {
+        result = 1;
+    }
+    while (taken > 0) {
+        pool_free(large[--taken]);
+    }
+    return result;
+}
+TEST_REGISTER(pool, test_pool_alloc, 100)
+/******************************************************************************/
+int test_pool_stats(void)
+{
+    void *blocks[POOL_SMALL_COUNT + 1];
+    pool_stats_t small, medium;
+
+    pool_get_stats(0, &small, 1);
+    pool_get_stats(1, &medium, 1);
+    uint32_t base = small.in_use;
+
+    // Filling the small class spills the extra request into the medium class
+    int n = 0;
+    for (; n < (int)(POOL_SMALL_COUNT - base) + 1; n++) {
+        if ((blocks[n] = pool_alloc(POOL_SMALL_SIZE)) == NULL) {
+            break;
+        }
+    }
+    pool_get_stats(0, &small, 0);
+    pool_get_stats(1, &medium, 0);
+    while (n > 0) {
+        pool_free(blocks[--n]);
+    }
+    if (small.in_use != POOL_SMALL_COUNT || small.high_water != POOL_SMALL_COUNT ||
+        small.failures != 1 || medium.allocs != 1) {
+        return 1;
+    }
+    pool_get_stats(0, &small, 1);
+    if (small.in_use != base || small.high_water != POOL_SMALL_COUNT) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(pool, test_pool_stats, 100)
+/******************************************************************************/
+// Runs the randomised workload on the pools (use_pool) or malloc. Reports the
+// alloc/free cycles and the widest address span of the live blocks, with the
+// bytes actually requested at that point; the gap is overhead and fragmentation.
+static int pool_test_workload(int use_pool, uint32_t *cycles, uint32_t *span,
+                              uint32_t *requested)
+{
+    void *live[POOL_BENCH_LIVE] = { NULL };
+    uint32_t sizes[POOL_BENCH_LIVE] = { 0 };
+    uint32_t seed = 0xC0FFEE;
+    int result = 0;
+
+    *cycles = 0;
+    *span = 0;
+    *requested = 0;
+    for (int op = 0; op < POOL_BENCH_OPS; op++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int slot = seed % POOL_BENCH_LIVE;
+        // Mostly small buffers, now and then a large one
+        uint32_t size = 1 + ((seed >> 16) % ((seed & 0x70) ? POOL_SMALL_SIZE : POOL_LARGE_SIZE));
+
+        uint32_t start = cycles_now();
+        if (live[slot] != NULL) {
+            use_pool ? pool_free(live[slot]) : free(live[slot]);
+            live[slot] = NULL;
+            sizes[slot] = 0;
+        } else {
+            live[slot] = use_pool ? pool_alloc(size) : malloc(size);
+            sizes[slot] = (live[slot] != NULL) ? size : 0;
+            // The pools may run dry by design, the heap should not
+            result |= (live[slot] == NULL && !use_pool);
+        }
+        *cycles += cycles_now() - start;
+
+        // Footprint: distance between the lowest and highest live byte
+        uintptr_t lo = UINTPTR_MAX, hi = 0;
+        uint32_t bytes = 0;
+        for (int i = 0; i < POOL_BENCH_LIVE; i++) {
+            if (live[i] != NULL) {
+                uintptr_t p = (uintptr_t)live[i];
+                lo = (p < lo) ? p : lo;
+                hi = (p + sizes[i] > hi) ? p + sizes[i] : hi;
+                bytes += sizes[i];
+            }
+        }
+        if (hi > lo && hi - lo > *span) {
+            *span = hi - lo;
+            *requested = bytes;
+        }
+    }
+    for (int i = 0; i < POOL_BENCH_LIVE; i++) {
+        use_pool ? pool_free(live[i]) : free(live[i]);
+    }
+    return result;
+}
+/******************************************************************************/
+int test_pool_bench(void)
+{
+    uint32_t pool_cycles, pool_span, pool_requested;
+    uint32_t malloc_cycles, malloc_span, malloc_requested;
+    pool_stats_t stats;
+    uint32_t pool_bytes = 0;
+
+    for (int i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_get_stats(i, &stats, 1);
+    }
+    if (pool_test_workload(1, &pool_cycles, &pool_span, &pool_requested) != 0 ||
+        pool_test_workload(0, &malloc_cycles, &malloc_span, &malloc_requested) != 0) {
+        return 1;
+    }
+    for (int i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_get_stats(i, &stats, 0);
+        pool_bytes += stats.size * stats.count;
+        printf("pool class %d: %u x %u bytes, high water %u, %u allocs, %u failures\n", i,
+               (unsigned)stats.count, (unsigned)stats.size, (unsigned)stats.high_water,
+               (unsigned)stats.allocs, (unsigned)stats.failures);
+    }
+    printf("pool: %d ops in %u cycles, peak span %u bytes for %u live bytes (%u bytes static)\n",
+           POOL_BENCH_OPS, (unsigned)pool_cycles, (unsigned)pool_span, (unsigned)pool_requested,
+           (unsigned)pool_bytes);
+    printf("malloc: %d ops in %u cycles, peak span %u bytes for %u live bytes\n", POOL_BENCH_OPS,
+           (unsigned)malloc_cycles, (unsigned)malloc_span, (unsigned)malloc_requested);
+    return 0;
+}
+TEST_REGISTER(pool, test_pool_bench, 1000)
@@ -0,0 +1,98 @@
+/**
+ * @file       qspi_test.h
+ * @brief      testing QSPI flash driver.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the external IS25LP128 flash driver.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+
+/* Define to prevent redundant inclusion */
+#ifndef __QSPI_TEST_H__
+#define __QSPI_TEST_H__
+
+/***** Includes *****/
+#include "qspi_flash.h"
+#include "qspi_cache.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+// Scratch block used by the tests: the last 64 KB block of the chip
+#define QSPI_TEST_ADDR (QSPI_FLASH_SIZE - QSPI_BLOCK64_SIZE)
+#define QSPI_TEST_LEN 1000          // Bytes programmed by the tests, spans several pages
+#define QSPI_TEST_OFFSET 0x35       // Start offset into the block, not page aligned
+#define QSPI_BENCH_LEN 0x8000       // Bytes read and programmed by the benchmarks
+#define QSPI_CACHE_TEST_LEN 0x1000  // Bytes read sequentially by the cache cases
+#define QSPI_CACHE_TEST_READ 4      // Bytes per read in the cache cases
+#define QSPI_CACHE_BENCH_READS 2000 // Random reads timed by test_qspi_cache_bench_random()
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes the flash and checks the JEDEC ID and the quad enable bit.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_init(void);
+/**
+ * @brief      Erases the scratch block, programs an unaligned pattern and reads it back.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_program_read(void);
+/**
+ * @brief      Reads the pattern back with DMA and compares it with the CPU read.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_read_dma(void);
+/**
+ * @brief      Erases sectors and 32 KB blocks and checks bad arguments are refused.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_erase(void);
+/**
+ * @brief      Times CPU and DMA reads and prints the throughput of both.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_bench_read(void);
+/**
+ * @brief      Times an erase and program of the scratch block and prints the throughput.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_bench_program(void);
+/**
+ * @brief      Reads a sector in small pieces through the cache and checks the
+ *             data, the read-ahead counters and that programs and erases
+ *             through the cache are seen by later reads.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_cache_read(void);
+/**
+ * @brief      Times random small reads with and without the cache.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_cache_bench_random(void);
+/**
+ * @brief      Times a sequential sector read in small pieces with and without the cache.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_qspi_cache_bench_seq(void);
+
+#endif
@@ -0,0 +1,331 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "qspi_test.h"
+#include "qspi_flash.h"
+#include "qspi_cache.h"
+#include "test_runner.h"
+#include "cycles.h"
+
+/***** Globals *****/
+static uint8_t qspi_test_buf[QSPI_BENCH_LEN];
+static uint8_t qspi_test_ref[QSPI_BENCH_LEN];
+
+/***** Functions *****/
+// Fills the reference buffer with a pattern that differs on every page
+static void qspi_fill_pattern(uint8_t *buf, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(i ^ (i >> 8) ^ 0xA5);
+    }
+}
+/******************************************************************************/
+// Checks that every byte of a range reads back erased
+static int qspi_check_erased(uint32_t addr, uint32_t len)
+{
+    while (len > 0) {
+        uint32_t n = (len < sizeof(qspi_test_buf)) ? len : sizeof(qspi_test_buf);
+        if (qspi_read(addr, qspi_test_buf, n) != E_NO_ERROR) {
+            return 1;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (qspi_test_buf[i] != 0xFF) {
+                return 1;
+            }
+        }
+        addr += n;
+        len -= n;
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_qspi_init(void)
+{
+    uint32_t id;
+    uint8_t status;
+
+    if (qspi_init() != E_NO_ERROR) {
+        return 1;
+    }
+    if (qspi_read_id(&id) != E_NO_ERROR || id != QSPI_JEDEC_ID) {
+        return 1;
+    }
+    if (qspi_read_status(&status) != E_NO_ERROR || !(status & QSPI_SR_QE) ||
+        (status & QSPI_SR_WIP)) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_init, 100)
+/******************************************************************************/
+int test_qspi_program_read(void)
+{
+    const uint32_t addr = QSPI_TEST_ADDR + QSPI_TEST_OFFSET;
+
+    if (qspi_erase(QSPI_TEST_ADDR, QSPI_BLOCK64_SIZE) != E_NO_ERROR) {
+        return 1;
+    }
+    if (qspi_check_erased(QSPI_TEST_ADDR, QSPI_BLOCK64_SIZE) != 0) {
+        return 1;
+    }
+    qspi_fill_pattern(qspi_test_ref, QSPI_TEST_LEN);
+    if (qspi_program(addr, qspi_test_ref, QSPI_TEST_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    if (qspi_read(addr, qspi_test_buf, QSPI_TEST_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    if (memcmp(qspi_test_buf, qspi_test_ref, QSPI_TEST_LEN) != 0) {
+        return 1;
+    }
+    // The bytes around the programmed range stay erased
+    if (qspi_check_erased(QSPI_TEST_ADDR, QSPI_TEST_OFFSET) != 0 ||
+        qspi_check_erased(addr + QSPI_TEST_LEN, QSPI_PAGE_SIZE) != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_program_read, 2000)
+/******************************************************************************/
+int test_qspi_read_dma(void)
+{
+    const uint32_t addr = QSPI_TEST_ADDR + QSPI_TEST_OFFSET;
+
+    memset(qspi_test_buf, 0, QSPI_TEST_LEN);
+    if (qspi_read_dma(addr, qspi_test_buf, QSPI_TEST_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    qspi_fill_pattern(qspi_test_ref, QSPI_TEST_LEN);
+    if (memcmp(qspi_test_buf, qspi_test_ref, QSPI_TEST_LEN) != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_read_dma, 100)
+/******************************************************************************/
+int test_qspi_erase(void)
+{
+    const uint8_t zero[QSPI_PAGE_SIZE] = { 0 };
+
+    // Dirty the first sector and the second 32 KB block, then erase both
+    if (qspi_program(QSPI_TEST_ADDR, zero, sizeof(zero)) != E_NO_ERROR ||
+        qspi_program(QSPI_TEST_ADDR + QSPI_BLOCK32_SIZE, zero, sizeof(zero)) != E_NO_ERROR) {
+        return 1;
+    }
+    if (qspi_erase(QSPI_TEST_ADDR, QSPI_SECTOR_SIZE) != E_NO_ERROR ||
+        qspi_check_erased(QSPI_TEST_ADDR, QSPI_SECTOR_SIZE) != 0) {
+        return 1;
+    }
+    if (qspi_erase_range(QSPI_TEST_ADDR + QSPI_BLOCK32_SIZE, QSPI_BLOCK32_SIZE) != E_NO_ERROR ||
+        qspi_check_erased(QSPI_TEST_ADDR + QSPI_BLOCK32_SIZE, QSPI_BLOCK32_SIZE) != 0) {
+        return 1;
+    }
+    // Unaligned, unsupported and out of range erases are refused
+    if (qspi_erase(QSPI_TEST_ADDR + QSPI_SECTOR_SIZE, QSPI_BLOCK64_SIZE) != E_BAD_PARAM ||
+        qspi_erase(QSPI_TEST_ADDR, 0x2000) != E_BAD_PARAM ||
+        qspi_erase_range(QSPI_TEST_ADDR, QSPI_BLOCK64_SIZE + QSPI_SECTOR_SIZE) != E_BAD_PARAM) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_erase, 2000)
+/******************************************************************************/
+int test_qspi_bench_read(void)
+{
+    uint32_t start = cycles_now();
+    if (qspi_read(QSPI_TEST_ADDR, qspi_test_buf, QSPI_BENCH_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t pio_us = cycles_to_us(cycles_now() - start);
+
+    start = cycles_now();
+    if (qspi_read_dma(QSPI_TEST_ADDR, qspi_test_ref, QSPI_BENCH_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t dma_us = cycles_to_us(cycles_now() - start);
+    if (memcmp(qspi_test_buf, qspi_test_ref, QSPI_BENCH_LEN) != 0) {
+        return 1;
+    }
+    if (pio_us == 0) {
+        pio_us = 1;
+    }
+    if (dma_us == 0) {
+        dma_us = 1;
+    }
+    printf("qspi read: %u bytes at %u Hz, cpu %u us %u KB/s, dma %u us %u KB/s\n",
+           (unsigned)QSPI_BENCH_LEN, MXC_SPI_GetFrequency(QSPI_SPI), (unsigned)pio_us,
+           (unsigned)((uint64_t)QSPI_BENCH_LEN * 1000000 / pio_us / 1024), (unsigned)dma_us,
+           (unsigned)((uint64_t)QSPI_BENCH_LEN * 1000000 / dma_us / 1024));
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_bench_read, 1000)
+/******************************************************************************/
+int test_qspi_bench_program(void)
+{
+    qspi_fill_pattern(qspi_test_ref, QSPI_BENCH_LEN);
+
+    uint32_t start = cycles_now();
+    if (qspi_erase_range(QSPI_TEST_ADDR, QSPI_BENCH_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t erase_us = cycles_to_us(cycles_now() - start);
+
+    start = cycles_now();
+    if (qspi_program(QSPI_TEST_ADDR, qspi_test_ref, QSPI_BENCH_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t prog_us = cycles_to_us(cycles_now() - start);
+    if (prog_us == 0) {
+        prog_us = 1;
+    }
+    if (qspi_read(QSPI_TEST_ADDR, qspi_test_buf, QSPI_BENCH_LEN) != E_NO_ERROR ||
+        memcmp(qspi_test_buf, qspi_test_ref, QSPI_BENCH_LEN) != 0) {
+        return 1;
+    }
+    printf("qspi: erase %u bytes in %u us, program %u bytes in %u us, %u KB/s\n",
+           (unsigned)QSPI_BENCH_LEN, (unsigned)erase_us, (unsigned)QSPI_BENCH_LEN,
+           (unsigned)prog_us, (unsigned)((uint64_t)QSPI_BENCH_LEN * 1000000 / prog_us / 1024));
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_bench_program, 2000)
+/******************************************************************************/
+int test_qspi_cache_read(void)
+{
+    const uint32_t lines = QSPI_CACHE_TEST_LEN / QSPI_CACHE_LINE_SIZE;
+    qspi_cache_stats_t stats;
+
+    qspi_cache_init();
+    qspi_fill_pattern(qspi_test_ref, QSPI_CACHE_TEST_LEN);
+    if (qspi_cache_erase(QSPI_TEST_ADDR, QSPI_SECTOR_SIZE) != E_NO_ERROR ||
+        qspi_cache_program(QSPI_TEST_ADDR, qspi_test_ref, QSPI_CACHE_TEST_LEN) != E_NO_ERROR) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < QSPI_CACHE_TEST_LEN; i += QSPI_CACHE_TEST_READ) {
+        if (qspi_cache_read(QSPI_TEST_ADDR + i, qspi_test_buf + i, QSPI_CACHE_TEST_READ) !=
+            E_NO_ERROR) {
+            return 1;
+        }
+    }
+    if (memcmp(qspi_test_buf, qspi_test_ref, QSPI_CACHE_TEST_LEN) != 0) {
+        return 1;
+    }
+    // Every line after the first is part of the stream, so most are read ahead
+    qspi_cache_get_stats(&stats, 1);
+    if (stats.hits + stats.misses != QSPI_CACHE_TEST_LEN / QSPI_CACHE_TEST_READ ||
+        stats.misses > 1 + lines / (1 + QSPI_CACHE_READAHEAD) + 1 ||
+        stats.readahead < lines - stats.misses) {
+        return 1;
+    }
+
+    // Programs and erases through the cache drop the stale lines
+    const uint8_t zero[QSPI_CACHE_TEST_READ] = { 0 };
+    uint8_t value[QSPI_CACHE_TEST_READ];
+    if (qspi_cache_program(QSPI_TEST_ADDR, zero, sizeof(zero)) != E_NO_ERROR ||
+        qspi_cache_read(QSPI_TEST_ADDR, value, sizeof(value)) != E_NO_ERROR ||
+        memcmp(value, zero, sizeof(zero)) != 0) {
+        return 1;
+    }
+    if (qspi_cache_erase(QSPI_TEST_ADDR, QSPI_SECTOR_SIZE) != E_NO_ERROR ||
+        qspi_cache_read(QSPI_TEST_ADDR + QSPI_CACHE_LINE_SIZE, value, sizeof(value)) !=
+            E_NO_ERROR ||
+        value[0] != 0xFF) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_cache_read, 1000)
+/******************************************************************************/
+// Times QSPI_CACHE_BENCH_READS reads at the same pseudo random addresses of a
+// window as large as the cache, through the cache or straight from the flash
+static uint32_t qspi_cache_random_us(int cached)
+{
+    uint32_t seed = 0x1234567;
+    uint8_t value[QSPI_CACHE_TEST_READ];
+    uint32_t start = cycles_now();
+
+    for (int i = 0; i < QSPI_CACHE_BENCH_READS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        uint32_t addr = QSPI_TEST_ADDR + (seed % (QSPI_CACHE_SIZE - QSPI_CACHE_TEST_READ));
+        int err = cached ? qspi_cache_read(addr, value, sizeof(value)) :
+                           qspi_read(addr, value, sizeof(value));
+        if (err != E_NO_ERROR) {
+            return 0;
+        }
+    }
+    uint32_t us = cycles_to_us(cycles_now() - start);
+    return (us != 0) ? us : 1;
+}
+/******************************************************************************/
+int test_qspi_cache_bench_random(void)
+{
+    qspi_cache_stats_t stats;
+
+    qspi_cache_init();
+    uint32_t direct_us = qspi_cache_random_us(0);
+    uint32_t cached_us = qspi_cache_random_us(1);
+    if (direct_us == 0 || cached_us == 0) {
+        return 1;
+    }
+    qspi_cache_get_stats(&stats, 1);
+    printf("qspi cache random: %d x %d bytes, direct %u us, cached %u us, %u hits %u misses\n",
+           QSPI_CACHE_BENCH_READS, QSPI_CACHE_TEST_READ, (unsigned)direct_us, (unsigned)cached_us,
+           (unsigned)stats.hits, (unsigned)stats.misses);
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_cache_bench_random, 1000)
+/******************************************************************************/
+int test_qspi_cache_bench_seq(void)
+{
+    qspi_cache_stats_t stats;
+    uint32_t start = cycles_now();
+
+    for (uint32_t i = 0; i < QSPI_CACHE_TEST_LEN; i += QSPI_CACHE_TEST_READ) {
+        if (qspi_read(QSPI_TEST_ADDR + i, qspi_test_ref + i, QSPI_CACHE_TEST_READ) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    uint32_t direct_us = cycles_to_us(cycles_now() - start);
+
+    qspi_cache_init();
+    start = cycles_now();
+    for (uint32_t i = 0; i < QSPI_CACHE_TEST_LEN; i += QSPI_CACHE_TEST_READ) {
+        if (qspi_cache_read(QSPI_TEST_ADDR + i, qspi_test_buf + i, QSPI_CACHE_TEST_READ) !=
+            E_NO_ERROR) {
+            return 1;
+        }
+    }
+    uint32_t cached_us = cycles_to_us(cycles_now() - start);
+    if (memcmp(qspi_test_buf, qspi_test_ref, QSPI_CACHE_TEST_LEN) != 0) {
+        return 1;
+    }
+    qspi_cache_get_stats(&stats, 1);
+    printf("qspi cache sequential: %u bytes in %d byte reads, direct %u us, cached %u us, "
+           "%u misses %u read ahead\n",
+           (unsigned)QSPI_CACHE_TEST_LEN, QSPI_CACHE_TEST_READ, (unsigned)direct_us,
+           (unsigned)cached_us, (unsigned)stats.misses, (unsigned)stats.readahead);
+    return 0;
+}
+TEST_REGISTER(qspi, test_qspi_cache_bench_seq, 1000)
@@ -0,0 +1,137 @@
+/**
+ * @file       test_runner.h
+ * @brief      Table driven test runner.
+ * @details    Test cases register themselves with a name, subsystem and
+ *             timeout. The runner executes the registered cases (optionally a
+ *             filtered subset, optionally repeated) and reports the result and
+ *             duration of every case.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __TEST_RUNNER_H__
+#define __TEST_RUNNER_H__
+
+/***** Includes *****/
+#include <stdint.h>
+#include <stddef.h>
+
+/***** Definitions *****/
+#define TEST_PASS 0     // Value returned by a test case that passed
+
+/**
+ * @brief      Outcome of the last run of a test case.
+ */
+typedef enum {
+    TEST_NOT_RUN = 0,
+    TEST_PASSED,
+    TEST_FAILED,
+    TEST_TIMEOUT
+} test_status_t;
+
+/**
+ * @brief      Test case function. Returns TEST_PASS (0) on success, any other
+ *             value is treated as a failure code.
+ */
+typedef int (*test_fn_t)(void);
+
+/**
+ * @brief      Registry entry of one test case.
+ */
+typedef struct test_case {
+    const char *subsystem;      // Subsystem the case belongs to, e.g. "gpio"
+    const char *name;           // Name of the case, e.g. "test_gpio_set"
+    uint32_t timeout_ms;        // Maximum allowed duration of one run
+    test_fn_t fn;               // Function implementing the case
+    test_status_t status;       // Status of the last run
+    int result;                 // Value returned by the last run
+    uint32_t last_us;           // Duration of the last run
+    uint32_t min_us;            // Shortest run
+    uint32_t max_us;            // Longest run
+    uint32_t total_us;          // Sum of all runs
+    uint32_t runs;              // Number of runs
+    uint32_t failures;          // Number of runs that failed or timed out
+    struct test_case *next;     // Next registered case
+} test_case_t;
+
+/**
+ * @brief      Registers a test case function with the runner.
+ *
+ * Place this after the definition of the test function. The case is added to
+ * the registry before main() runs, in definition order within a file.
+ *
+ * @param      subsys   Subsystem name (bare word, e.g. gpio).
+ * @param      func     Test function, int func(void).
+ * @param      timeout  Timeout in milliseconds.
+ */
+#define TEST_REGISTER(subsys, func, timeout)                                    \
+    static test_case_t test_case_##func = { #subsys, #func, (timeout), func,    \
+                                            TEST_NOT_RUN, 0, 0, 0, 0, 0, 0, 0,  \
+                                            NULL };                             \
+    static void __attribute__((constructor)) test_register_##func(void)         \
+    {                                                                           \
+        test_register(&test_case_##func);                                       \
+    }
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Adds a test case to the registry. Normally called via TEST_REGISTER.
+ * @param      tc   Test case to add. Must stay valid for the program lifetime.
+ */
+void test_register(test_case_t *tc);
+/**
+ * @brief      Returns the first registered test case, the rest follow via next.
+ */
+test_case_t *test_first(void);
+/**
+ * @brief      Checks if a test case is selected by a filter.
+ *
+ * The filter is a comma separated list of patterns matched against
+ * "subsystem.name". Patterns match by prefix, so "i2c" selects every I2C
+ * case, and '*' matches any run of characters, e.g. "*.bench_".
+ *
+ * @param      tc       Test case to check.
+ * @param      filter   Filter string. NULL or "" selects every case.
+ * @return     1 if the case is selected, 0 otherwise.
+ */
+int test_selected(const test_case_t *tc, const char *filter);
+/**
+ * @brief      Prints the selected test cases without running them.
+ * @param      filter   Filter string, see test_selected().
+ */
+void test_list(const char *filter);
+/**
+ * @brief      Runs the selected test cases.
+ *
+ * Every case is run @p repeat times in a row and the result and duration of
+ * each run is reported, followed by a min/avg/max summary when repeated.
+ * Timeouts are checked when a case returns; a run that took longer than its
+ * timeout is reported as TIMEOUT and counted as failed.
+ *
+ * @param      filter   Filter string, see test_selected().
+ * @param      repeat   Number of times to run each case (0 is treated as 1).
+ * @return     Number of cases that failed at least once.
+ */
+int test_run(const char *filter, uint32_t repeat);
+
+#endif
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "test_runner.h"
+#include "cycles.h"
+#include "log.h"
+
+/***** Globals *****/
+static test_case_t *test_head = NULL;  // First registered case
+static test_case_t *test_tail = NULL;  // Last registered case, new cases go after it
+
+/***** Functions *****/
+void test_register(test_case_t *tc)
+{
+    tc->next = NULL;
+    if (test_tail == NULL) {
+        test_head = tc;
+    } else {
+        test_tail->next = tc;
+    }
+    test_tail = tc;
+}
+/******************************************************************************/
+test_case_t *test_first(void)
+{
+    return test_head;
+}
+/******************************************************************************/
+// Matches "subsystem.name" against one pattern of length len. Patterns match
+// by prefix, as if they always ended in '*'.
+static int test_match(const char *subsys, const char *name, const char *pat, size_t len)
+{
+    char full[64];
+    snprintf(full, sizeof(full), "%s.%s", subsys, name);
+
+    const char *s = full;
+    const char *p = pat;
+    const char *end = pat + len;
+    const char *star = NULL;    // Position after the last '*' seen
+    const char *resume = NULL;  // Position in s to retry from after a mismatch
+
+    while (p < end) {
+        if (*p == '*') {
+            star = ++p;
+            resume = s;
+        } else if (*s != '\0' && *p == *s) {
+            p++;
+            s++;
+        } else if (star != NULL && *resume != '\0') {
+            p = star;
+            s = ++resume;
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+/******************************************************************************/
+int test_selected(const test_case_t *tc, const char *filter)
+{
+    if (filter == NULL || filter[0] == '\0') {
+        return 1;
+    }
+    // Walk the comma separated pattern list
+    while (*filter != '\0') {
+        const char *comma = strchr(filter, ',');
+        size_t len = (comma != NULL) ? (size_t)(comma - filter) : strlen(filter);
+        if (len > 0 && test_match(tc->subsystem, tc->name, filter, len)) {
+            return 1;
+        }
+        if (comma == NULL) {
+            break;
+        }
+        filter = comma + 1;
+    }
+    return 0;
+}
+/******************************************************************************/
+void test_list(const char *filter)
+{
+    for (test_case_t *tc = test_head; tc != NULL; tc = tc->next) {
+        if (test_selected(tc, filter)) {
+            printf("%s.%s (timeout %u ms)\n", tc->subsystem, tc->name,
+                   (unsigned)tc->timeout_ms);
+        }
+    }
+}
+/******************************************************************************/
+// Runs one case once and updates its statistics
+static void test_run_once(test_case_t *tc)
+{
+    uint32_t start = cycles_now();
+    int result = tc->fn();
+    uint32_t us = cycles_to_us(cycles_now() - start);
+
+    tc->result = result;
+    tc->last_us = us;
+    if (tc->runs == 0 || us < tc->min_us) {
+        tc->min_us = us;
+    }
+    if (us > tc->max_us) {
+        tc->max_us = us;
+    }
+    tc->total_us += us;
+    tc->runs++;
+
+    if (result != TEST_PASS) {
+        tc->status = TEST_FAILED;
+    } else if (tc->timeout_ms != 0 && us > tc->timeout_ms * 1000) {
+        tc->status = TEST_TIMEOUT;
+    } else {
+        tc->status = TEST_PASSED;
+    }
+    if (tc->status != TEST_PASSED) {
+        tc->failures++;
+    }
+}
+/******************************************************************************/
+int test_run(const char *filter, uint32_t repeat)
+{
+    static const char *const status_name[] = { "SKIP", "PASS", "FAIL", "TIMEOUT" };
+    int selected = 0;
+    int failed = 0;
+
+    if (repeat == 0) {
+        repeat = 1;
+    }
+    cycles_init();
+
+    for (test_case_t *tc = test_head; tc != NULL; tc = tc->next) {
+        if (!test_selected(tc, filter)) {
+            continue;
+        }
+        selected++;
+        tc->runs = 0;
+        tc->failures = 0;
+        tc->min_us = 0;
+        tc->max_us = 0;
+        tc->total_us = 0;
+
+        for (uint32_t i = 0; i < repeat; i++) {
+            printf("[ RUN     ] %s.%s\n", tc->subsystem, tc->name);
+            test_run_once(tc);
+            log_drain();        // Stream the case's log records before its result
+            printf("[ %-7s ] %s.%s (%u us)", status_name[tc->status], tc->subsystem,
+                   tc->name, (unsigned)tc->last_us);
+            if (tc->status == TEST_FAILED) {
+                printf(" result=%d", tc->result);
+            }
+            printf("\n");
+        }
+        if (repeat > 1) {
+            printf("[ SUMMARY ] %s.%s runs=%u failures=%u min=%u us avg=%u us max=%u us\n",
+                   tc->subsystem, tc->name, (unsigned)tc->runs, (unsigned)tc->failures,
+                   (unsigned)tc->min_us, (unsigned)(tc->total_us / tc->runs),
+                   (unsigned)tc->max_us);
+        }
+        if (tc->failures != 0) {
+            failed++;
+        }
+    }
+
+    printf("\n%d test case(s) run, %d passed, %d failed\n", selected, selected - failed, failed);
+    if (failed != 0) {
+        for (test_case_t *tc = test_head; tc != NULL; tc = tc->next) {
+            if (test_selected(tc, filter) && tc->failures != 0) {
+                printf("  FAILED: %s.%s\n", tc->subsystem, tc->name);
+            }
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file       sched_test.h
+ * @brief      testing the tickless scheduler.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the timers, work queue and sleep accounting of the scheduler.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __SCHED_TEST_H__
+#define __SCHED_TEST_H__
+
+/***** Includes *****/
+#include "sched.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define SCHED_BENCH_MS 1000         // Time test_sched_bench() samples the BMI160 for
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Runs a periodic and a one shot timer and checks that the core
+ *             slept in between.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_sched_timer(void);
+/**
+ * @brief      Checks that work items run in order and that a full queue refuses more.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_sched_post(void);
+/**
+ * @brief      Checks that sched_delay_ms() waits asleep for the requested time.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_sched_delay(void);
+/**
+ * @brief      Reads the BMI160 on its data ready interrupt and reports the
+ *             duty cycle and wakeups per second.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_sched_bench(void);
+
+#endif
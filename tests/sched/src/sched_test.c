@@ -0,0 +1,220 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include "sched_test.h"
+#include "sched.h"
+#include "i2c1.h"
+#include "mxc_errors.h"
+#include "log.h"
+
+/***** Definitions *****/
+/**
+ * @brief      Samples read by the data ready work item.
+ */
+typedef struct {
+    uint32_t count;             // Samples read
+    uint32_t errors;            // Failed reads
+} sched_test_samples_t;
+
+/***** Functions *****/
+// Timer and work function that counts its calls
+static void sched_test_count(void *arg)
+{
+    (*(uint32_t *)arg)++;
+}
+/******************************************************************************/
+// Work function that records the order it ran in
+static void sched_test_order(void *arg)
+{
+    static uint32_t next;
+    uint32_t *slot = arg;
+    *slot = next++;
+}
+/******************************************************************************/
+// Data ready work item: one burst read of the gyro and accelerometer
+static void sched_test_sample(void *arg)
+{
+    sched_test_samples_t *s = arg;
+    int16_t sample[BMI160_SAMPLE_AXES];
+
+    if (bmi160_read_sample(sample) == E_NO_ERROR) {
+        s->count++;
+    } else {
+        s->errors++;
+    }
+    log_drain();    // Every read logs, keep the ring from overflowing
+}
+/******************************************************************************/
+#if SCHED_STATS
+// Prints the duty cycle and wakeup rate of a run
+static void sched_test_report(const char *what, const sched_stats_t *st)
+{
+    uint32_t awake = st->elapsed - st->asleep;
+    printf("sched: %s: %u ms, awake %u.%02u%%, %u wakeups/s, %u work, %u timers\n", what,
+           (unsigned)((uint64_t)st->elapsed * 1000 / SCHED_TICK_HZ),
+           (unsigned)((uint64_t)awake * 100 / st->elapsed),
+           (unsigned)((uint64_t)awake * 10000 / st->elapsed % 100),
+           (unsigned)((uint64_t)st->wakeups * SCHED_TICK_HZ / st->elapsed), (unsigned)st->work,
+           (unsigned)st->timers);
+}
+#endif
+/******************************************************************************/
+int test_sched_timer(void)
+{
+    sched_timer_t periodic = { 0 };
+    sched_timer_t once = { 0 };
+    sched_timer_t end = { 0 };
+    uint32_t ticks = 0;
+    uint32_t fired = 0;
+    uint32_t done = 0;
+    sched_stats_t st;
+
+    sched_init();
+    sched_timer_start(&periodic, SCHED_MS(10), SCHED_MS(10), sched_test_count, &ticks);
+    sched_timer_start(&once, SCHED_MS(25), 0, sched_test_count, &fired);
+    sched_timer_start(&end, SCHED_MS(100) + 1, 0, sched_test_count, &done);
+    while (!done) {
+        sched_run_once();
+        sched_idle();
+    }
+    sched_run_once();
+    sched_timer_stop(&periodic);
+    sched_get_stats(&st, 0);
+
+    if (ticks != 10 || fired != 1 || once.active) {
+        return 1;
+    }
+#if SCHED_STATS
+    sched_test_report("timers", &st);
+    // One wakeup per expiry, and the core is mostly asleep
+    if (st.timers != 12 || st.wakeups < 11 || st.wakeups > 13 ||
+        st.asleep < st.elapsed / 2) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(sched, test_sched_timer, 1000)
+/******************************************************************************/
+int test_sched_post(void)
+{
+    uint32_t order[SCHED_QUEUE_LEN];
+    uint32_t count = 0;
+
+    sched_init();
+    for (int i = 0; i < SCHED_QUEUE_LEN; i++) {
+        if (sched_post(sched_test_order, &order[i]) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    if (sched_post(sched_test_count, &count) != E_OVERFLOW) {
+        return 1;
+    }
+    if (sched_run_once() != SCHED_QUEUE_LEN || sched_run_once() != 0 || count != 0) {
+        return 1;
+    }
+    for (int i = 1; i < SCHED_QUEUE_LEN; i++) {
+        if (order[i] != order[i - 1] + 1) {
+            return 1;
+        }
+    }
+#if SCHED_STATS
+    sched_stats_t st;
+    sched_get_stats(&st, 0);
+    if (st.work != SCHED_QUEUE_LEN || st.overruns != 1) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(sched, test_sched_post, 100)
+/******************************************************************************/
+int test_sched_delay(void)
+{
+    sched_init();
+    uint32_t start = sched_now();
+    sched_delay_ms(50);
+    uint32_t waited = sched_now() - start;
+
+    if (waited < SCHED_MS(50) || waited > SCHED_MS(51)) {
+        return 1;
+    }
+#if SCHED_STATS
+    sched_stats_t st;
+    sched_get_stats(&st, 0);
+    if (st.asleep < SCHED_MS(49)) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+TEST_REGISTER(sched, test_sched_delay, 1000)
+/******************************************************************************/
+int test_sched_bench(void)
+{
+    sched_test_samples_t samples = { 0 };
+    sched_timer_t end = { 0 };
+    uint32_t done = 0;
+    sched_stats_t st;
+    struct bmi160_dev dev;
+    dev.chip_id = BMI160_I2C_ADDR;
+    dev.delay_ms = NULL;
+
+    if (i2c_init() != 0 || set_accelerometer_normal_mode(&dev) != 0 ||
+        set_gyroscope_Normal_mode(&dev) != 0) {
+        return 1;
+    }
+    sched_init();
+    if (sched_gpio_event(BMI160_INT1_PORT, BMI160_INT1_PIN, sched_test_sample, &samples) !=
+            E_NO_ERROR ||
+        bmi160_enable_data_ready() != E_NO_ERROR) {
+        return 1;
+    }
+    log_drain();
+    sched_get_stats(NULL, 1);
+    sched_timer_start(&end, SCHED_MS(SCHED_BENCH_MS), 0, sched_test_count, &done);
+    while (!done) {
+        sched_run_once();
+        sched_idle();
+    }
+    sched_get_stats(&st, 0);
+
+    // Stop the pulses and unhook the pin before the next case
+    uint8_t off = 0;
+    i2c_write_register(BMI160_I2C_ADDR, BMI160_INT_EN_1_REG, &off, 1);
+    sched_init();
+    log_drain();
+
+    printf("sched: %u samples at data ready, %u errors\n", (unsigned)samples.count,
+           (unsigned)samples.errors);
+#if SCHED_STATS
+    sched_test_report("bmi160 100 Hz", &st);
+#endif
+    // 100 Hz output data rate
+    if (samples.errors != 0 || samples.count < SCHED_BENCH_MS / 10 - 2 ||
+        samples.count > SCHED_BENCH_MS / 10 + 1) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(sched, test_sched_bench, 5000)
@@ -0,0 +1,71 @@
+/**
+ * @file       spi_test.h
+ * @brief      SPI master test cases.
+ * @details    The host build attaches a loopback model (MISO wired to MOSI)
+ *             to every slave select of SPI1, so transfers check the bytes
+ *             received and the framing, clock and mode each device saw.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __SPI_TEST_H__
+#define __SPI_TEST_H__
+
+/***** Includes *****/
+#include "spi1.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define SPI_TEST_LEN 300            // Bytes moved by the transfer cases
+#define SPI_BENCH_FRAMES 32         // Slave select framed transfers per benchmark run
+#define SPI_BENCH_FRAME_LEN 64      // Bytes per benchmark transfer
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Initializes SPI1 and checks the clock it runs at.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_spi_init(void);
+#ifdef HOST_SIM
+/**
+ * @brief      Runs CPU and DMA transfers through the loopback and checks the
+ *             data, the framing and the device's clock and mode.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_spi_transfer(void);
+/**
+ * @brief      Runs a transaction list over three devices with different modes
+ *             and clocks, including a two phase frame, blocking and with a
+ *             completion event, and checks bad lists are refused.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_spi_list(void);
+/**
+ * @brief      Times SPI_BENCH_FRAMES transfers one call each and as one list
+ *             at several clocks and prints the throughput.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_spi_bench(void);
+#endif
+
+#endif
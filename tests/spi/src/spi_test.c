@@ -0,0 +1,238 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "spi_test.h"
+#include "spi1.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "sched.h"
+#include "coop.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+/***** Functions *****/
+int test_spi_init(void)
+{
+    if (spi_init() != E_NO_ERROR || MXC_SPI_GetFrequency(SPI_MASTER) != SPI_FREQ) {
+        return 1;
+    }
+    return spi_busy() ? 1 : 0;
+}
+TEST_REGISTER(spi, test_spi_init, 100)
+#ifdef HOST_SIM
+/******************************************************************************/
+static uint8_t spi_test_tx[SPI_BENCH_FRAMES * SPI_BENCH_FRAME_LEN];
+static uint8_t spi_test_rx[SPI_BENCH_FRAMES * SPI_BENCH_FRAME_LEN];
+
+// Devices on the loopback bus
+static const spi_device_t spi_dev_a = { 0, SPI_MODE_0, 1000000 };
+static const spi_device_t spi_dev_b = { 1, SPI_MODE_3, 10000000 };
+static const spi_device_t spi_dev_c = { 2, SPI_MODE_1, 25000000 };
+
+// Initializes SPI1, puts a loopback on every slave select and fills the send buffer
+static int spi_test_setup(void)
+{
+    sim_spi_loopback_t lb;
+    for (int ss = 0; ss < SPI_SS_COUNT; ss++) {
+        sim_spi_loopback_attach(MXC_SPI_GET_IDX(SPI_MASTER), ss);
+        sim_spi_loopback_get(ss, &lb, 1);
+    }
+    for (uint32_t i = 0; i < sizeof(spi_test_tx); i++) {
+        spi_test_tx[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    memset(spi_test_rx, 0, sizeof(spi_test_rx));
+    return spi_init();
+}
+/******************************************************************************/
+// Checks the frames and bytes a loopback saw, and the clock and mode of its last frame
+static int spi_test_seen(const spi_device_t *dev, uint32_t frames, uint32_t bytes)
+{
+    sim_spi_loopback_t lb;
+    sim_spi_loopback_get(dev->ss, &lb, 1);
+    return lb.frames == frames && lb.bytes == bytes && lb.hz == dev->hz &&
+           lb.mode == (int)dev->mode;
+}
+/******************************************************************************/
+int test_spi_transfer(void)
+{
+    if (spi_test_setup() != E_NO_ERROR) {
+        return 1;
+    }
+    // CPU, full duplex
+    if (spi_transfer(&spi_dev_b, spi_test_tx, spi_test_rx, SPI_TEST_LEN) != E_NO_ERROR ||
+        memcmp(spi_test_rx, spi_test_tx, SPI_TEST_LEN) != 0 ||
+        !spi_test_seen(&spi_dev_b, 1, SPI_TEST_LEN)) {
+        return 1;
+    }
+    // DMA, full duplex
+    memset(spi_test_rx, 0, SPI_TEST_LEN);
+    if (spi_transfer_dma(&spi_dev_c, spi_test_tx, spi_test_rx, SPI_TEST_LEN) != E_NO_ERROR ||
+        memcmp(spi_test_rx, spi_test_tx, SPI_TEST_LEN) != 0 ||
+        !spi_test_seen(&spi_dev_c, 1, SPI_TEST_LEN)) {
+        return 1;
+    }
+    // Receive only: MOSI idles high
+    if (spi_transfer_dma(&spi_dev_a, NULL, spi_test_rx, SPI_TEST_LEN) != E_NO_ERROR ||
+        !spi_test_seen(&spi_dev_a, 1, SPI_TEST_LEN)) {
+        return 1;
+    }
+    for (int i = 0; i < SPI_TEST_LEN; i++) {
+        if (spi_test_rx[i] != 0xFF) {
+            return 1;
+        }
+    }
+    if (spi_transfer(&spi_dev_a, NULL, NULL, SPI_TEST_LEN) != E_BAD_PARAM ||
+        spi_transfer(&spi_dev_a, spi_test_tx, NULL, 0) != E_BAD_PARAM) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(spi, test_spi_transfer, 100)
+/******************************************************************************/
+int test_spi_list(void)
+{
+    static const uint8_t cmd[2] = { 0x0B, 0x40 };
+    uint8_t *rx = spi_test_rx;
+    const uint8_t *tx = spi_test_tx;
+    // Device B gets a command phase and a data phase under one slave select
+    const spi_xfer_t list[] = {
+        { &spi_dev_a, tx, rx, 16, 0 },
+        { &spi_dev_b, cmd, NULL, sizeof(cmd), 1 },
+        { &spi_dev_b, NULL, rx + 16, 32, 0 },
+        { &spi_dev_c, tx + 48, rx + 48, 100, 0 },
+        { &spi_dev_a, tx + 148, rx + 148, 8, 0 },
+    };
+    const unsigned int count = sizeof(list) / sizeof(list[0]);
+
+    if (spi_test_setup() != E_NO_ERROR) {
+        return 1;
+    }
+    if (spi_run(list, count) != E_NO_ERROR || memcmp(rx, tx, 16) != 0 ||
+        memcmp(rx + 48, tx + 48, 108) != 0) {
+        return 1;
+    }
+    for (int i = 16; i < 48; i++) {
+        if (rx[i] != 0xFF) {
+            return 1;
+        }
+    }
+    if (!spi_test_seen(&spi_dev_a, 2, 24) || !spi_test_seen(&spi_dev_b, 1, 34) ||
+        !spi_test_seen(&spi_dev_c, 1, 100)) {
+        return 1;
+    }
+
+    // Same list, ended by the DMA interrupt and reported to an event
+    coop_event_t done;
+    sched_init();
+    coop_init();
+    coop_event_init(&done);
+    memset(spi_test_rx, 0, sizeof(spi_test_rx));
+    if (spi_run_async(list, count, &done) != E_NO_ERROR) {
+        return 1;
+    }
+    while (spi_busy()) {}
+    if (!coop_event_take(&done) || done.result != E_NO_ERROR || memcmp(rx, tx, 16) != 0 ||
+        !spi_test_seen(&spi_dev_c, 1, 100)) {
+        return 1;
+    }
+    while (sched_run_once() > 0) {}
+
+    // A held slave select must stay on one device and end inside the list
+    const spi_xfer_t cross[] = {
+        { &spi_dev_a, tx, rx, 4, 1 },
+        { &spi_dev_b, tx, rx, 4, 0 },
+    };
+    const spi_device_t bad_ss = { SPI_SS_COUNT, SPI_MODE_0, 1000000 };
+    const spi_xfer_t bad[] = { { &bad_ss, tx, rx, 4, 0 } };
+    if (spi_run(cross, 2) != E_BAD_PARAM || spi_run(cross, 1) != E_BAD_PARAM ||
+        spi_run(bad, 1) != E_BAD_PARAM || spi_run(list, 0) != E_BAD_PARAM) {
+        return 1;
+    }
+    return spi_busy() ? 1 : 0;
+}
+TEST_REGISTER(spi, test_spi_list, 100)
+/******************************************************************************/
+int test_spi_bench(void)
+{
+    static const unsigned int clocks[] = { 1000000, 5000000, 12500000, 25000000, 50000000 };
+    static spi_xfer_t list[SPI_BENCH_FRAMES];
+    const uint32_t bytes = SPI_BENCH_FRAMES * SPI_BENCH_FRAME_LEN;
+
+    if (spi_test_setup() != E_NO_ERROR) {
+        return 1;
+    }
+    for (unsigned int c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+        const spi_device_t dev = { 0, SPI_MODE_0, clocks[c] };
+        for (int i = 0; i < SPI_BENCH_FRAMES; i++) {
+            list[i].dev = &dev;
+            list[i].tx = &spi_test_tx[i * SPI_BENCH_FRAME_LEN];
+            list[i].rx = &spi_test_rx[i * SPI_BENCH_FRAME_LEN];
+            list[i].len = SPI_BENCH_FRAME_LEN;
+            list[i].cs_hold = 0;
+        }
+
+        // One call per transfer
+        memset(spi_test_rx, 0, bytes);
+        uint32_t start = cycles_now();
+        for (int i = 0; i < SPI_BENCH_FRAMES; i++) {
+            if (spi_transfer(&dev, list[i].tx, list[i].rx, SPI_BENCH_FRAME_LEN) != E_NO_ERROR) {
+                return 1;
+            }
+        }
+        uint32_t pio_us = cycles_to_us(cycles_now() - start);
+        if (memcmp(spi_test_rx, spi_test_tx, bytes) != 0) {
+            return 1;
+        }
+
+        // One list
+        memset(spi_test_rx, 0, bytes);
+        start = cycles_now();
+        if (spi_run(list, SPI_BENCH_FRAMES) != E_NO_ERROR) {
+            return 1;
+        }
+        uint32_t list_us = cycles_to_us(cycles_now() - start);
+        if (memcmp(spi_test_rx, spi_test_tx, bytes) != 0 ||
+            !spi_test_seen(&dev, 2 * SPI_BENCH_FRAMES, 2 * bytes)) {
+            return 1;
+        }
+
+        if (pio_us == 0) {
+            pio_us = 1;
+        }
+        if (list_us == 0) {
+            list_us = 1;
+        }
+        // Time the clock alone needs for the bytes
+        uint32_t wire_us = (uint32_t)((uint64_t)bytes * 8 * 1000000 / clocks[c]);
+        printf("spi: %u x %u bytes at %u Hz, calls %u us %u KB/s, list %u us %u KB/s (%u%% of SCK)\n",
+               (unsigned)SPI_BENCH_FRAMES, (unsigned)SPI_BENCH_FRAME_LEN, clocks[c],
+               (unsigned)pio_us, (unsigned)((uint64_t)bytes * 1000000 / pio_us / 1024),
+               (unsigned)list_us, (unsigned)((uint64_t)bytes * 1000000 / list_us / 1024),
+               (unsigned)((uint64_t)wire_us * 100 / list_us));
+    }
+    return 0;
+}
+TEST_REGISTER(spi, test_spi_bench, 1000)
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file       stats_test.h
+ * @brief      testing the driver performance counters.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing the counters kept by the flash, I2C and GPIO drivers.
+ */
+
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/ 
+
+/* Define to prevent redundant inclusion */
+#ifndef __STATS_TEST_H__
+#define __STATS_TEST_H__
+
+/***** Includes *****/
+#include "stats.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define STATS_TEST_BENCH_LOOPS 1000     // stats_record() calls timed by the benchmark
+
+/***** Function Prototypes *****/
+#if STATS_ENABLE
+/**
+ * @brief      Erases, writes and reads the scratch page and checks the flash counters.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_stats_flash(void);
+/**
+ * @brief      Reads a BMI160 register and checks the I2C counters, including a
+ *             failed read on the host simulator.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_stats_i2c(void);
+/**
+ * @brief      Sets a pin and an invalid port and checks the GPIO counters.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_stats_gpio(void);
+#endif
+/**
+ * @brief      Packs a snapshot and checks the binary record layout.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_stats_pack(void);
+/**
+ * @brief      Measures the cost of counting one operation.
+ * @return     Returns 0.
+ */
+int test_stats_bench_record(void);
+
+#endif
@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "stats_test.h"
+#include "flash.h"
+#include "flash_test.h"
+#include "gpio1.h"
+#include "i2c1.h"
+#include "cycles.h"
+#include "test_runner.h"
+#ifdef HOST_SIM
+#include "sim.h"
+#endif
+
+#if STATS_ENABLE
+/******************************************************************************/
+int test_stats_flash(void)
+{
+    uint64_t buffer[] = { FLASH_TEST_PATTERN0, FLASH_TEST_PATTERN1, FLASH_TEST_PATTERN2, 0 };
+    const uint32_t page = (FLASH_TEST_ADDR - MXC_FLASH_MEM_BASE) / MXC_FLASH_PAGE_SIZE;
+    stats_t snap;
+
+    stats_reset();
+    if (Flash_PageErase(FLASH_TEST_ADDR) != E_NO_ERROR ||
+        Flash_Write(FLASH_TEST_ADDR, buffer) != E_NO_ERROR) {
+        return 1;
+    }
+    uint8_t *data = Flash_Read(FLASH_TEST_ADDR, 2 * sizeof(uint64_t));
+    if (data == NULL) {
+        return 1;
+    }
+    pool_free(data);
+    stats_snapshot(&snap, 1);
+
+    const stats_op_t *erase = &snap.op[STATS_FLASH_ERASE];
+    const stats_op_t *write = &snap.op[STATS_FLASH_WRITE];
+    const stats_op_t *read = &snap.op[STATS_FLASH_READ];
+    if (erase->count != 1 || erase->errors != 0 || snap.page_erases[page] != 1) {
+        return 1;
+    }
+    if (erase->cycles == 0 || erase->max_cycles != erase->cycles) {
+        return 1;
+    }
+    if (write->count != 1 || write->bytes != 2 * sizeof(uint64_t)) {
+        return 1;
+    }
+    if (read->count != 1 || read->bytes != 2 * sizeof(uint64_t)) {
+        return 1;
+    }
+    // The snapshot cleared the counters
+    stats_snapshot(&snap, 0);
+    if (snap.op[STATS_FLASH_ERASE].count != 0 || snap.page_erases[page] != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(stats, test_stats_flash, 200)
+/******************************************************************************/
+int test_stats_i2c(void)
+{
+    uint8_t value;
+    stats_t snap;
+
+    stats_reset();
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) != E_NO_ERROR) {
+        return 1;
+    }
+#ifdef HOST_SIM
+    // Fails every attempt, so the read gives up after its retries
+    sim_i2c_inject(MXC_I2C_GET_IDX(I2C_MASTER), SIM_I2C_FAULT_ADDR_NACK, I2C_RETRIES + 1);
+    if (i2c_read_register(BMI160_I2C_ADDR, 0x00, &value, 1) == E_NO_ERROR) {
+        return 1;
+    }
+    const uint32_t failed = 1;
+    const uint32_t retries = I2C_RETRIES;
+#else
+    const uint32_t failed = 0;
+    const uint32_t retries = 0;
+#endif
+    stats_snapshot(&snap, 1);
+
+    const stats_op_t *read = &snap.op[STATS_I2C_READ];
+    if (read->count != 1 + failed || read->errors != failed || read->bytes != 1 ||
+        read->retries != retries) {
+        return 1;
+    }
+    if (read->cycles == 0 || snap.op[STATS_I2C_WRITE].count != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(stats, test_stats_i2c, 100)
+/******************************************************************************/
+int test_stats_gpio(void)
+{
+    stats_t snap;
+
+    stats_reset();
+    if (gpio_set(2, 0, 1) != 0 || gpio_set(2, 0, 0) != 0) {
+        return 1;
+    }
+    if (gpio_set(7, 0, 1) == 0) {   // No port 7
+        return 1;
+    }
+    stats_snapshot(&snap, 1);
+
+    const stats_op_t *set = &snap.op[STATS_GPIO_SET];
+    if (set->count != 3 || set->errors != 1 || snap.op[STATS_GPIO_GET].count != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(stats, test_stats_gpio, 100)
+#endif
+/******************************************************************************/
+int test_stats_pack(void)
+{
+    static uint8_t record[STATS_RECORD_SIZE];
+    stats_t snap;
+
+    stats_reset();
+    stats_record(STATS_I2C_WRITE, 0x01020304, 1, 0x11223344);
+    stats_retry(STATS_I2C_WRITE);
+    stats_page_erase(MXC_FLASH_MEM_BASE + MXC_FLASH_PAGE_SIZE);
+    stats_snapshot(&snap, 1);
+
+    if (stats_pack(&snap, record, sizeof(record) - 1) != 0) {
+        return 1;   // Too small
+    }
+    if (stats_pack(&snap, record, sizeof(record)) != STATS_RECORD_SIZE) {
+        return 1;
+    }
+    if (record[0] != STATS_RECORD_MAGIC || record[1] != STATS_RECORD_VERSION ||
+        record[2] != STATS_OP_COUNT || record[3] != STATS_FLASH_PAGES) {
+        return 1;
+    }
+    static const uint8_t expected[STATS_OP_RECORD_SIZE] = {
+        0x01, 0x00, 0x00, 0x00,                          // count
+        0x04, 0x03, 0x02, 0x01,                          // bytes
+        0x01, 0x00,                                      // errors
+        0x01, 0x00,                                      // retries
+        0x44, 0x33, 0x22, 0x11,                          // max_cycles
+        0x44, 0x33, 0x22, 0x11, 0x00, 0x00, 0x00, 0x00   // cycles
+    };
+    const uint8_t *op = &record[STATS_HEADER_SIZE + STATS_I2C_WRITE * STATS_OP_RECORD_SIZE];
+    if (memcmp(op, expected, sizeof(expected)) != 0) {
+        return 1;
+    }
+    const uint8_t *pages = &record[STATS_HEADER_SIZE + STATS_OP_COUNT * STATS_OP_RECORD_SIZE];
+    if (pages[0] != 0 || pages[2] != 1 || pages[3] != 0) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(stats, test_stats_pack, 100)
+/******************************************************************************/
+int test_stats_bench_record(void)
+{
+    uint32_t start = cycles_now();
+    for (int i = 0; i < STATS_TEST_BENCH_LOOPS; i++) {
+        stats_record(STATS_GPIO_GET, 0, 0, (uint32_t)i);
+    }
+    uint32_t cycles = cycles_now() - start;
+    stats_reset();
+
+    printf("stats: %d operations counted in %u cycles\n", STATS_TEST_BENCH_LOOPS,
+           (unsigned)cycles);
+    return 0;
+}
+TEST_REGISTER(stats, test_stats_bench_record, 100)
@@ -0,0 +1,62 @@
+/**
+ * @file       table_test.h
+ * @brief      Perfect hash lookup table test cases.
+ * @details    The tables come from tests/table/tables: a string keyed config
+ *             table and synthetic tables of 16 to 1024 keys for the benchmark.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __TABLE_TEST_H__
+#define __TABLE_TEST_H__
+
+/***** Includes *****/
+#include "table.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define TABLE_TEST_LINE 16          // Flash line a record must not cross
+#define TABLE_BENCH_LOOKUPS 20000   // Lookups timed per table and method
+#define TABLE_BENCH_MUL 2654435761UL    // Synthetic tables store key * TABLE_BENCH_MUL
+
+/***** Function Prototypes *****/
+/**
+ * @brief      Looks up every config key by name and checks the values, the
+ *             record layout and that unknown keys miss.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_table_config(void);
+/**
+ * @brief      Looks up every key of the synthetic tables and keys next to
+ *             them that the tables do not hold.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_table_synthetic(void);
+/**
+ * @brief      Times hashed and linear lookups across the table sizes and
+ *             prints the cycles per lookup.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_table_bench(void);
+
+#endif
@@ -0,0 +1,146 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include <string.h>
+#include "table_test.h"
+#include "table.h"
+#include "test_runner.h"
+#include "cycles.h"
+#include "config_defaults_table.h"
+#include "bench_16_table.h"
+#include "bench_64_table.h"
+#include "bench_256_table.h"
+#include "bench_1024_table.h"
+
+/***** Globals *****/
+static const table_t *const table_bench[] = {
+    &bench_16_table, &bench_64_table, &bench_256_table, &bench_1024_table
+};
+
+/***** Functions *****/
+// Returns the key of record i
+static uint32_t table_test_key(const table_t *t, uint32_t i)
+{
+    return *(const uint32_t *)((const uint8_t *)t->records + i * t->record_size);
+}
+/******************************************************************************/
+// The linear search the hashed lookup replaces
+static const void *table_test_linear(const table_t *t, uint32_t key)
+{
+    for (uint32_t i = 0; i < t->count; i++) {
+        const uint32_t *record = (const uint32_t *)((const uint8_t *)t->records + i * t->record_size);
+        if (*record == key) {
+            return record + 1;
+        }
+    }
+    return NULL;
+}
+/******************************************************************************/
+int test_table_config(void)
+{
+    static const struct {
+        const char *name;
+        int32_t value;
+    } expect[] = {
+        { "i2c.freq", 100000 }, { "i2c.retries", 3 }, { "spi.freq", 1000000 },
+        { "qspi.freq", 25000000 }, { "log.level", 3 }, { "imu.window_len", 128 },
+    };
+    const table_t *t = &config_defaults_table;
+
+    if (t->count != CONFIG_DEFAULTS_COUNT || t->record_size != sizeof(config_defaults_record_t) ||
+        ((uintptr_t)t->records % t->record_size) != 0 ||
+        TABLE_TEST_LINE % t->record_size != 0) {
+        return 1;
+    }
+    for (unsigned int i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        const config_defaults_value_t *v = config_defaults_lookup(table_key_str(expect[i].name));
+        if (v == NULL || v->value != expect[i].value || v->value < v->min || v->value > v->max) {
+            return 1;
+        }
+        // Read in place from the record, not from a copy
+        if (v != table_test_linear(t, table_key_str(expect[i].name))) {
+            return 1;
+        }
+    }
+    if (config_defaults_lookup(table_key_str("i2c.unknown")) != NULL ||
+        config_defaults_lookup(table_key_str("")) != NULL) {
+        return 1;
+    }
+    return 0;
+}
+TEST_REGISTER(table, test_table_config, 100)
+/******************************************************************************/
+int test_table_synthetic(void)
+{
+    for (unsigned int n = 0; n < sizeof(table_bench) / sizeof(table_bench[0]); n++) {
+        const table_t *t = table_bench[n];
+        for (uint32_t i = 0; i < t->count; i++) {
+            uint32_t key = table_test_key(t, i);
+            const uint32_t *v = table_lookup(t, key);
+            if (v == NULL || *v != (uint32_t)(key * TABLE_BENCH_MUL)) {
+                return 1;
+            }
+            // A neighbouring key misses unless the table holds it too
+            if (table_lookup(t, key + 1) != table_test_linear(t, key + 1)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(table, test_table_synthetic, 100)
+/******************************************************************************/
+int test_table_bench(void)
+{
+    volatile uint32_t sink = 0;     // Keeps the lookups from being optimized out
+
+    for (unsigned int n = 0; n < sizeof(table_bench) / sizeof(table_bench[0]); n++) {
+        const table_t *t = table_bench[n];
+
+        uint32_t start = cycles_now();
+        for (uint32_t i = 0; i < TABLE_BENCH_LOOKUPS; i++) {
+            const uint32_t *v = table_lookup(t, table_test_key(t, (i * 7) % t->count));
+            sink += (v != NULL) ? *v : 0;
+        }
+        uint32_t hash_cycles = cycles_now() - start;
+
+        start = cycles_now();
+        for (uint32_t i = 0; i < TABLE_BENCH_LOOKUPS; i++) {
+            const uint32_t *v = table_test_linear(t, table_test_key(t, (i * 7) % t->count));
+            sink += (v != NULL) ? *v : 0;
+        }
+        uint32_t linear_cycles = cycles_now() - start;
+
+        // Flash lines read per hit: a displacement and a record, against half
+        // the records on average
+        uint32_t linear_lines = (t->count * t->record_size / 2 + TABLE_TEST_LINE - 1) / TABLE_TEST_LINE;
+        printf("table: %4u keys, hash %u.%u cycles 2 lines, linear %u.%u cycles %u lines per lookup\n",
+               (unsigned)t->count, (unsigned)(hash_cycles / TABLE_BENCH_LOOKUPS),
+               (unsigned)(hash_cycles * 10 / TABLE_BENCH_LOOKUPS % 10),
+               (unsigned)(linear_cycles / TABLE_BENCH_LOOKUPS),
+               (unsigned)(linear_cycles * 10 / TABLE_BENCH_LOOKUPS % 10), (unsigned)linear_lines);
+    }
+    (void)sink;
+    return 0;
+}
+TEST_REGISTER(table, test_table_bench, 2000)
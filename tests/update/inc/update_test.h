@@ -0,0 +1,79 @@
+/**
+ * @file       update_test.h
+ * @brief      testing the firmware update pipeline.
+ * @details    This header contains the definitions and function prototypes for
+ *             testing image download, verification, resume and swap.
+ */
+
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/* Define to prevent redundant inclusion */
+#ifndef __UPDATE_TEST_H__
+#define __UPDATE_TEST_H__
+
+/***** Includes *****/
+#include "update.h"
+#include "test_runner.h"
+
+/***** Definitions *****/
+#define UPDATE_TEST_SIZE 20007      // Image size, ends in a partial line
+#define UPDATE_TEST_CHUNK 123       // Bytes per update_write(), as a serial link would deliver
+#define UPDATE_TEST_TEAR_OPS 700    // Flash operations before the simulated power loss
+#define UPDATE_BENCH_SIZE 0x10000   // Image size of the benchmark
+
+/***** Function Prototypes *****/
+#ifdef HOST_SIM
+/**
+ * @brief      Streams an image in small chunks, finishes it and checks the staging copy.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_stream(void);
+/**
+ * @brief      Checks a CRC mismatch, a short image and an overlong image are refused.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_refuse(void);
+/**
+ * @brief      Times a streamed download against programming the same bytes directly.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_bench(void);
+/**
+ * @brief      Cuts power in the middle of a download and checks it resumes.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_resume(void);
+/**
+ * @brief      Copies a verified image over the application, once with a power
+ *             loss in the middle that the boot stage recovers from, and
+ *             checks the result and that the boot stage page is untouched.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_swap(void);
+/**
+ * @brief      Flips a bit of a verified staging image and checks the swap refuses it.
+ * @return     Returns 0 if the operation is successful, otherwise returns 1.
+ */
+int test_update_swap_decayed(void);
+#endif
+
+#endif
@@ -0,0 +1,285 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ * (now owned by Analog Devices, Inc.),
+ * Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ * is proprietary to Analog Devices, Inc. and its licensors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+/***** Includes *****/
+#include <stdio.h>
+#include "update_test.h"
+#include "update.h"
+#include "test_runner.h"
+#include "cycles.h"
+#ifdef HOST_SIM
+#include "sim.h"
+
+/***** Functions *****/
+// Simulator only: the cases erase the journal and the staging area, which on
+// the target would throw away a download in progress at every boot
+// Byte i of the test image
+static uint8_t update_test_byte(uint32_t i)
+{
+    return (uint8_t)((i * 31) ^ (i >> 7) ^ 0x5A);
+}
+/******************************************************************************/
+// Fills buf with len image bytes starting at offset
+static void update_test_fill(uint8_t *buf, uint32_t offset, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = update_test_byte(offset + i);
+    }
+}
+/******************************************************************************/
+static uint32_t update_test_crc(uint32_t size)
+{
+    uint8_t buf[UPDATE_TEST_CHUNK];
+    uint32_t crc = 0;
+    for (uint32_t i = 0; i < size; i += sizeof(buf)) {
+        uint32_t n = (size - i < sizeof(buf)) ? size - i : sizeof(buf);
+        update_test_fill(buf, i, n);
+        crc = crc32(crc, buf, n);
+    }
+    return crc;
+}
+/******************************************************************************/
+// Streams image bytes [from, size) in UPDATE_TEST_CHUNK pieces
+static int update_test_stream(uint32_t from, uint32_t size)
+{
+    uint8_t buf[UPDATE_TEST_CHUNK];
+    for (uint32_t i = from; i < size; i += sizeof(buf)) {
+        uint32_t n = (size - i < sizeof(buf)) ? size - i : sizeof(buf);
+        update_test_fill(buf, i, n);
+        int err = update_write(buf, n);
+        if (err != E_NO_ERROR) {
+            return err;
+        }
+    }
+    return E_NO_ERROR;
+}
+/******************************************************************************/
+// Checks that a flash region holds the image
+static int update_test_check(uint32_t base, uint32_t size)
+{
+    const uint8_t *flash = (const uint8_t *)(uintptr_t)base;
+    for (uint32_t i = 0; i < size; i++) {
+        if (flash[i] != update_test_byte(i)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+/******************************************************************************/
+int test_update_stream(void)
+{
+    uint32_t offset;
+    int result = 1;
+
+    if (update_begin(UPDATE_TEST_SIZE, update_test_crc(UPDATE_TEST_SIZE), &offset) !=
+            E_NO_ERROR ||
+        offset != 0) {
+        return 1;
+    }
+    if (update_test_stream(0, UPDATE_TEST_SIZE) == E_NO_ERROR && update_finish() == E_NO_ERROR &&
+        update_pending() && update_test_check(FLASH_STAGING_BASE, UPDATE_TEST_SIZE) == 0) {
+        result = 0;
+    }
+    // Never leave a test image for the next boot to install
+    if (update_abort() != E_NO_ERROR || update_pending()) {
+        return 1;
+    }
+    return result;
+}
+TEST_REGISTER(update, test_update_stream, 2000)
+/******************************************************************************/
+int test_update_refuse(void)
+{
+    const uint32_t crc = update_test_crc(UPDATE_TEST_SIZE);
+    uint8_t extra = 0;
+    uint32_t offset;
+
+    // A wrong CRC drops the download
+    if (update_begin(UPDATE_TEST_SIZE, crc ^ 1, &offset) != E_NO_ERROR ||
+        update_test_stream(0, UPDATE_TEST_SIZE) != E_NO_ERROR ||
+        update_finish() != E_BAD_STATE || update_pending()) {
+        return 1;
+    }
+    // Missing bytes are not accepted as a complete image, extra bytes are refused
+    if (update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_NO_ERROR ||
+        update_test_stream(0, UPDATE_TEST_SIZE - 1) != E_NO_ERROR ||
+        update_finish() != E_UNDERFLOW || update_test_stream(UPDATE_TEST_SIZE - 1,
+                                                             UPDATE_TEST_SIZE) != E_NO_ERROR ||
+        update_write(&extra, 1) != E_OVERFLOW) {
+        return 1;
+    }
+    if (update_begin(FLASH_STAGING_SIZE + 1, crc, &offset) != E_BAD_PARAM ||
+        update_begin(0, crc, &offset) != E_BAD_PARAM) {
+        return 1;
+    }
+    return update_abort() != E_NO_ERROR;
+}
+TEST_REGISTER(update, test_update_refuse, 2000)
+/******************************************************************************/
+int test_update_bench(void)
+{
+    uint8_t buf[UPDATE_TEST_CHUNK];
+    uint32_t offset;
+
+    if (update_begin(UPDATE_BENCH_SIZE, update_test_crc(UPDATE_BENCH_SIZE), &offset) !=
+        E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t start = cycles_now();
+    if (update_test_stream(0, UPDATE_BENCH_SIZE) != E_NO_ERROR || update_finish() != E_NO_ERROR) {
+        return 1;
+    }
+    uint32_t stream_us = cycles_to_us(cycles_now() - start);
+
+    // The same bytes programmed without CRC, checks or journal
+    for (uint32_t page = 0; page < UPDATE_BENCH_SIZE; page += MXC_FLASH_PAGE_SIZE) {
+        if (Flash_PageErase(FLASH_STAGING_BASE + page) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    start = cycles_now();
+    for (uint32_t i = 0; i < UPDATE_BENCH_SIZE; i += sizeof(buf)) {
+        uint32_t n = (UPDATE_BENCH_SIZE - i < sizeof(buf)) ? UPDATE_BENCH_SIZE - i : sizeof(buf);
+        update_test_fill(buf, i, n);
+        if (Flash_WriteBuffer(FLASH_STAGING_BASE + i, buf, n) != E_NO_ERROR) {
+            return 1;
+        }
+    }
+    uint32_t raw_us = cycles_to_us(cycles_now() - start);
+    if (update_abort() != E_NO_ERROR) {
+        return 1;
+    }
+    if (stream_us == 0) {
+        stream_us = 1;
+    }
+    if (raw_us == 0) {
+        raw_us = 1;
+    }
+    printf("update: %u bytes streamed in %u us, %u bytes/s; Flash_WriteBuffer() of the same "
+           "chunks %u us, %u bytes/s\n",
+           (unsigned)UPDATE_BENCH_SIZE, (unsigned)stream_us,
+           (unsigned)((uint64_t)UPDATE_BENCH_SIZE * 1000000 / stream_us), (unsigned)raw_us,
+           (unsigned)((uint64_t)UPDATE_BENCH_SIZE * 1000000 / raw_us));
+    return 0;
+}
+TEST_REGISTER(update, test_update_bench, 5000)
+/******************************************************************************/
+int test_update_resume(void)
+{
+    const uint32_t crc = update_test_crc(UPDATE_TEST_SIZE);
+    uint32_t offset;
+
+    if (update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_NO_ERROR) {
+        return 1;
+    }
+    sim_flash_tear(UPDATE_TEST_TEAR_OPS, 5);
+    if (update_test_stream(0, UPDATE_TEST_SIZE) == E_NO_ERROR || !sim_flash_power_lost()) {
+        return 1;
+    }
+    sim_flash_power_cycle();
+
+    // The download continues at a checkpoint instead of the start
+    if (update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_NO_ERROR || offset == 0 ||
+        offset % UPDATE_CHECKPOINT != 0 || offset >= UPDATE_TEST_TEAR_OPS * UPDATE_LINE) {
+        return 1;
+    }
+    if (update_test_stream(offset, UPDATE_TEST_SIZE) != E_NO_ERROR ||
+        update_finish() != E_NO_ERROR ||
+        update_test_check(FLASH_STAGING_BASE, UPDATE_TEST_SIZE) != 0) {
+        return 1;
+    }
+    // Beginning the same image again finds it complete
+    if (update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_NO_ERROR || offset != UPDATE_TEST_SIZE ||
+        update_finish() != E_NO_ERROR) {
+        return 1;
+    }
+    return update_abort() != E_NO_ERROR;
+}
+TEST_REGISTER(update, test_update_resume, 2000)
+/******************************************************************************/
+int test_update_swap(void)
+{
+    const uint32_t crc = update_test_crc(UPDATE_TEST_SIZE);
+    uint32_t boot_crc = 0, boot_after = 0;
+    uint32_t offset;
+
+    // The drivers refuse to touch the boot stage page
+    if (Flash_PageErase(FLASH_BOOT_BASE) != E_BAD_PARAM ||
+        Flash_WriteBuffer(FLASH_APP_BASE - 4, (const uint8_t *)&offset, 8) != E_BAD_PARAM ||
+        crc32_flash(FLASH_BOOT_BASE, FLASH_BOOT_SIZE, &boot_crc) != E_NO_ERROR) {
+        return 1;
+    }
+    for (int torn = 1; torn >= 0; torn--) {
+        if (update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_NO_ERROR ||
+            update_test_stream(offset, UPDATE_TEST_SIZE) != E_NO_ERROR ||
+            update_finish() != E_NO_ERROR || Flash_PageErase(FLASH_APP_BASE) != E_NO_ERROR) {
+            return 1;
+        }
+        if (torn) {
+            // Lose power half way through the copy, the boot stage finishes it at the next boot
+            sim_flash_tear(MXC_FLASH_PAGE_SIZE / UPDATE_LINE + 100, 3);
+            if (update_swap() == E_NO_ERROR || !sim_flash_power_lost()) {
+                return 1;
+            }
+            sim_flash_power_cycle();
+            if (!update_pending() || update_begin(UPDATE_TEST_SIZE, crc, &offset) != E_BUSY ||
+                update_boot() != E_NO_ERROR) {
+                return 1;
+            }
+        } else if (update_swap() != E_NO_ERROR) {
+            return 1;
+        }
+        if (update_pending() || update_test_check(FLASH_APP_BASE, UPDATE_TEST_SIZE) != 0) {
+            return 1;
+        }
+    }
+    if (crc32_flash(FLASH_BOOT_BASE, FLASH_BOOT_SIZE, &boot_after) != E_NO_ERROR) {
+        return 1;
+    }
+    return boot_after != boot_crc;
+}
+TEST_REGISTER(update, test_update_swap, 2000)
+/******************************************************************************/
+int test_update_swap_decayed(void)
+{
+    uint32_t offset;
+
+    if (update_begin(UPDATE_TEST_SIZE, update_test_crc(UPDATE_TEST_SIZE), &offset) !=
+            E_NO_ERROR ||
+        update_test_stream(offset, UPDATE_TEST_SIZE) != E_NO_ERROR ||
+        update_finish() != E_NO_ERROR || Flash_PageErase(FLASH_APP_BASE) != E_NO_ERROR) {
+        return 1;
+    }
+    sim_flash_flip_bit(FLASH_STAGING_BASE + UPDATE_TEST_SIZE / 2, 3);
+    if (update_swap() != E_BAD_STATE || update_pending()) {
+        return 1;
+    }
+    // The application was left alone
+    const uint32_t *app = (const uint32_t *)(uintptr_t)FLASH_APP_BASE;
+    for (uint32_t i = 0; i < MXC_FLASH_PAGE_SIZE / sizeof(uint32_t); i++) {
+        if (app[i] != 0xFFFFFFFFUL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+TEST_REGISTER(update, test_update_swap_decayed, 2000)
+#endif
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+###############################################################################
+ #
+ # Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ # (now owned by Analog Devices, Inc.),
+ # Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ # is proprietary to Analog Devices, Inc. and its licensors.
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #     http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ #
+ ##############################################################################
+"""Decode a crash dump saved by blackbox_dump().
+
+The input is the crash dump page read back from flash, e.g. with OpenOCD:
+
+    dump_image blackbox.bin <FLASH_BLACKBOX_BASE> 8192
+    tools/blackbox_decode.py blackbox.bin
+
+The fault registers and the saved events are printed oldest first, with their
+time relative to the dump.
+"""
+
+import argparse
+import struct
+import sys
+
+BLACKBOX_MAGIC = 0x31584242
+BLACKBOX_HEADER = struct.Struct("<12I")
+BLACKBOX_ENTRY = struct.Struct("<4I")
+CORE_CLOCK_HZ = 100000000
+
+# blackbox_event_t and blackbox_cause_t in drivers/blackbox/inc/blackbox.h
+EVENTS = {1: "boot", 2: "flash_erase", 3: "flash_write", 4: "flash_error",
+          5: "i2c_retry", 6: "i2c_recover", 7: "spi_error"}
+EVENT_USER = 0x100
+CAUSES = {1: "hardfault", 2: "watchdog", 3: "reset", 4: "request"}
+
+
+def decode(data):
+    """Returns (header dict, [(timestamp, event, seq, a, b), ...])."""
+    if len(data) < BLACKBOX_HEADER.size:
+        sys.exit("input is shorter than a dump header")
+    fields = BLACKBOX_HEADER.unpack_from(data, 0)
+    names = ("magic", "cause", "head", "count", "timestamp", "pc", "lr", "psr",
+             "cfsr", "hfsr", "mmfar", "bfar")
+    header = dict(zip(names, fields))
+    if header["magic"] != BLACKBOX_MAGIC:
+        sys.exit("no crash dump in the input (bad magic)")
+    count = header["count"]
+    if BLACKBOX_HEADER.size + count * BLACKBOX_ENTRY.size > len(data):
+        sys.exit(f"dump holds {count} events but the input is truncated")
+    entries = []
+    for i in range(count):
+        timestamp, ident, a, b = BLACKBOX_ENTRY.unpack_from(
+            data, BLACKBOX_HEADER.size + i * BLACKBOX_ENTRY.size)
+        entries.append((timestamp, ident & 0xFFFF, ident >> 16, a, b))
+    return header, entries
+
+
+def event_name(event):
+    if event >= EVENT_USER:
+        return f"user+{event - EVENT_USER}"
+    return EVENTS.get(event, f"event{event}")
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="crash dump page, - for stdin")
+    args = parser.parse_args()
+
+    if args.dump == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+
+    header, entries = decode(data)
+    print(f"cause {CAUSES.get(header['cause'], header['cause'])}, "
+          f"{header['count']} of {header['head']} events saved")
+    print(f"  pc 0x{header['pc']:08x}  lr 0x{header['lr']:08x}  psr 0x{header['psr']:08x}")
+    print(f"  cfsr 0x{header['cfsr']:08x}  hfsr 0x{header['hfsr']:08x}"
+          f"  mmfar 0x{header['mmfar']:08x}  bfar 0x{header['bfar']:08x}")
+
+    us = 1000000 / CORE_CLOCK_HZ
+    print(f"  {'seq':>5} {'us before':>12} {'event':12} {'a':>10} {'b':>10}")
+    for timestamp, event, seq, a, b in entries:
+        # The cycle counter wraps, so the age is taken modulo 2^32
+        age = ((header["timestamp"] - timestamp) & 0xFFFFFFFF) * us
+        if event in (2, 3, 4):
+            args_text = f"0x{a:08x} {signed(b):>10}"
+        else:
+            args_text = f"{signed(a):>10} {signed(b):>10}"
+        print(f"  {seq:5} {age:12.1f} {event_name(event):12} {args_text}")
+
+
+if __name__ == "__main__":
+    main()
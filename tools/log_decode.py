@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+###############################################################################
+ #
+ # Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ # (now owned by Analog Devices, Inc.),
+ # Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ # is proprietary to Analog Devices, Inc. and its licensors.
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #     http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ #
+ ##############################################################################
+"""Decode binary log records written by drivers/log.
+
+The format strings are read from the log_fmt section of the ELF file the
+firmware was built from. Plain text in the stream (printf output sharing the
+console UART) is passed through unchanged.
+
+    tools/log_decode.py build/max78000.elf capture.bin
+    tools/log_decode.py build/max78000.elf /dev/ttyUSB0
+    sim/build/sim_tests -b | tools/log_decode.py sim/build/sim_tests
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_SYNC = 0xA5
+LOG_HEADER_SIZE = 12
+LOG_MAX_ARGS = 8
+LOG_ID_DROPPED = 0
+LEVELS = "EWID"
+CORE_CLOCK_HZ = 100000000
+
+# printf conversion: flags, width, precision, length modifier, conversion
+CONV = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXc%])")
+
+
+def read_fmt_section(path):
+    """Returns (data, name) of the log_fmt section of an ELF32/ELF64 file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        sys.exit(f"{path}: not an ELF file")
+    is64 = elf[4] == 2
+    end = "<" if elf[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", elf, 0x3A)
+        shdr = end + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", elf, 0x2E)
+        shdr = end + "IIIIIIIIII"
+    sections = [struct.unpack_from(shdr, elf, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+    for sec in sections:
+        name_off, offset, size = sec[0], sec[4], sec[5]
+        start = strtab[4] + name_off
+        name = elf[start:elf.index(b"\0", start)].decode()
+        if name in ("log_fmt", ".log_fmt"):
+            return elf[offset:offset + size]
+    sys.exit(f"{path}: no log_fmt section, was the firmware built with drivers/log?")
+
+
+def format_record(fmt, args):
+    """Applies a printf style format to raw uint32 arguments."""
+    it = iter(args)
+
+    def conv(m):
+        flags, width, prec, _, c = m.groups()
+        if c == "%":
+            return "%"
+        value = next(it, 0)
+        if c in "di" and value & 0x80000000:
+            value -= 1 << 32
+        if c == "c":
+            value = chr(value & 0xFF)
+        spec = "%" + flags + width + ("." + prec if prec else "") + ("d" if c in "iu" else c)
+        return spec % value
+
+    return CONV.sub(conv, fmt)
+
+
+def decode(stream, strings, out):
+    buf = b""
+    text = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        i = 0
+        while i < len(buf):
+            if buf[i] != LOG_SYNC:
+                text.append(buf[i])
+                i += 1
+                continue
+            if len(buf) - i < 2:
+                break
+            nargs = buf[i + 1] & 0xF
+            size = LOG_HEADER_SIZE + 4 * nargs
+            if nargs > LOG_MAX_ARGS:
+                i += 1
+                continue
+            if len(buf) - i < size:
+                break
+            if text:
+                out.write(text.decode(errors="replace"))
+                text.clear()
+            level = buf[i + 1] >> 4
+            seq, fmt_id, ts = struct.unpack_from("<HII", buf, i + 2)
+            args = struct.unpack_from("<%dI" % nargs, buf, i + LOG_HEADER_SIZE)
+            if fmt_id == LOG_ID_DROPPED:
+                fmt = "<%u log records dropped>"
+            elif 0 < fmt_id <= len(strings):
+                raw = strings[fmt_id - 1:]
+                fmt = raw[:raw.index(b"\0")].decode(errors="replace")
+            else:
+                fmt = "<unknown format id %d>" % fmt_id
+            msg = format_record(fmt, args).rstrip("\n")
+            out.write("  [%c %10u us #%u] %s\n" % (LEVELS[level & 3], ts // (CORE_CLOCK_HZ // 1000000),
+                                                   seq, msg))
+            i += size
+        buf = buf[i:]
+    if text:
+        out.write(text.decode(errors="replace"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="ELF file the firmware was built from")
+    parser.add_argument("input", nargs="?", default="-", help="capture file or serial device, '-' for stdin")
+    args = parser.parse_args()
+
+    strings = read_fmt_section(args.elf)
+    stream = sys.stdin.buffer if args.input == "-" else open(args.input, "rb", buffering=0)
+    decode(stream, strings, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
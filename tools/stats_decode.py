@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+###############################################################################
+ #
+ # Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ # (now owned by Analog Devices, Inc.),
+ # Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ # is proprietary to Analog Devices, Inc. and its licensors.
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #     http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ #
+ ##############################################################################
+"""Decode driver performance counter records packed by stats_pack().
+
+The input holds one or more records back to back, e.g. collected from a
+device fleet. Each record is printed as a table of the operation counters
+followed by the non-zero page erase counters.
+
+    tools/stats_decode.py stats.bin
+"""
+
+import argparse
+import struct
+import sys
+
+STATS_RECORD_MAGIC = 0x53
+STATS_RECORD_VERSION = 1
+STATS_HEADER = struct.Struct("<BBBBI")
+STATS_OP = struct.Struct("<IIHHIQ")
+CORE_CLOCK_HZ = 100000000
+
+# Order of stats_op_id_t in drivers/stats/inc/stats.h
+OPS = ["flash_read", "flash_write", "flash_erase", "i2c_write", "i2c_read",
+       "gpio_set", "gpio_get", "qspi_read", "qspi_program", "qspi_erase",
+       "spi_xfer"]
+
+
+def decode(data):
+    """Yields (timestamp, ops, page_erases) for every record in data."""
+    pos = 0
+    while pos + STATS_HEADER.size <= len(data):
+        magic, version, nops, npages, timestamp = STATS_HEADER.unpack_from(data, pos)
+        if magic != STATS_RECORD_MAGIC or version != STATS_RECORD_VERSION:
+            sys.exit(f"offset {pos}: not a version {STATS_RECORD_VERSION} stats record")
+        pos += STATS_HEADER.size
+        ops = []
+        for _ in range(nops):
+            ops.append(STATS_OP.unpack_from(data, pos))
+            pos += STATS_OP.size
+        pages = struct.unpack_from(f"<{npages}H", data, pos)
+        pos += 2 * npages
+        yield timestamp, ops, pages
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("records", help="file with packed records, - for stdin")
+    args = parser.parse_args()
+
+    if args.records == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.records, "rb") as f:
+            data = f.read()
+
+    us = 1000000 / CORE_CLOCK_HZ
+    for timestamp, ops, pages in decode(data):
+        print(f"snapshot at {timestamp * us:.0f} us")
+        print(f"  {'operation':12} {'count':>8} {'bytes':>10} {'errors':>6} {'retries':>7}"
+              f" {'avg us':>10} {'max us':>10}")
+        for i, (count, nbytes, errors, retries, max_cycles, cycles) in enumerate(ops):
+            name = OPS[i] if i < len(OPS) else f"op{i}"
+            avg = cycles / count * us if count else 0
+            print(f"  {name:12} {count:8} {nbytes:10} {errors:6} {retries:7}"
+                  f" {avg:10.1f} {max_cycles * us:10.1f}")
+        worn = [f"{page}:{count}" for page, count in enumerate(pages) if count]
+        if worn:
+            print("  page erases " + " ".join(worn))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+###############################################################################
+ #
+ # Copyright (C) 2022-2023 Maxim Integrated Products, Inc. All Rights Reserved.
+ # (now owned by Analog Devices, Inc.),
+ # Copyright (C) 2023 Analog Devices, Inc. All Rights Reserved. This software
+ # is proprietary to Analog Devices, Inc. and its licensors.
+ #
+ # Licensed under the Apache License, Version 2.0 (the "License");
+ # you may not use this file except in compliance with the License.
+ # You may obtain a copy of the License at
+ #
+ #     http://www.apache.org/licenses/LICENSE-2.0
+ #
+ # Unless required by applicable law or agreed to in writing, software
+ # distributed under the License is distributed on an "AS IS" BASIS,
+ # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ # See the License for the specific language governing permissions and
+ # limitations under the License.
+ #
+ ##############################################################################
+"""Generate a constant lookup table with a minimal perfect hash.
+
+Reads a JSON table spec and writes <name>_table.h and <name>_table.c, where
+<name> is the spec file name without .json. The records live in flash and are
+read in place by table_lookup() (drivers/table): one displacement read picks
+the slot, then one record read, a record never crossing a 16 byte flash line,
+answers the lookup.
+
+    tools/table_gen.py tests/table/tables/config_defaults.json build/tables
+
+Spec:
+
+    {
+      "fields": [["value", "int32_t"], ["min", "int32_t"], ["max", "int32_t"]],
+      "entries": [{"key": "i2c.freq", "value": 100000, "min": 0, "max": 1000000}]
+    }
+
+A key is an integer below 2^32 or a string, hashed with FNV-1a like
+table_key_str(). Fields are integer types of at most 4 bytes or float. In
+place of "entries", "synthetic": {"count": N, "seed": S} makes N random keys
+with a single uint32_t field holding key * 2654435761, for benchmarks.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+FIELD_SIZES = {
+    "uint8_t": 1, "int8_t": 1, "uint16_t": 2, "int16_t": 2,
+    "uint32_t": 4, "int32_t": 4, "float": 4,
+}
+FLASH_LINE = 16         # Bytes per flash line, records are laid out not to cross one
+BUCKET_SIZE = 3         # Average keys per displacement bucket
+MAX_DISP = 0xFFFF       # Displacements fit a uint16_t
+MASK32 = 0xFFFFFFFF
+
+
+def fmix32(h):
+    """MurmurHash3 finalizer, same as table_hash()."""
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & MASK32
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & MASK32
+    h ^= h >> 16
+    return h
+
+
+def reduce(h, n):
+    """Maps a hash to [0, n) like table_reduce()."""
+    return (h * n) >> 32
+
+
+def key_str(s):
+    """FNV-1a of a string, same as table_key_str()."""
+    h = 0x811C9DC5
+    for b in s.encode():
+        h = ((h ^ b) * 0x01000193) & MASK32
+    return h
+
+
+def build(keys):
+    """Returns (seed, displacements, slot of each key) for distinct keys."""
+    n = len(keys)
+    nb = max(1, (n + BUCKET_SIZE - 1) // BUCKET_SIZE)
+    for seed in range(1, 1000):
+        hashes = [fmix32(k ^ seed) for k in keys]
+        buckets = [[] for _ in range(nb)]
+        for h in hashes:
+            buckets[reduce(h, nb)].append(h)
+        disp = [0] * nb
+        used = [False] * n
+        slot_of = {}
+        ok = True
+        # Largest buckets first, while most slots are free
+        for b in sorted(range(nb), key=lambda b: -len(buckets[b])):
+            if not buckets[b]:
+                break
+            for d in range(MAX_DISP + 1):
+                slots = [reduce(fmix32(h ^ d), n) for h in buckets[b]]
+                if len(set(slots)) == len(slots) and not any(used[s] for s in slots):
+                    break
+            else:
+                ok = False
+                break
+            disp[b] = d
+            for h, s in zip(buckets[b], slots):
+                used[s] = True
+                slot_of[h] = s
+        if ok:
+            return seed, disp, [slot_of[h] for h in hashes]
+    raise ValueError("no perfect hash found")
+
+
+def layout(fields):
+    """Returns (value size, record size) with the C alignment rules."""
+    size = 0
+    align = 1
+    for name, ctype in fields:
+        if ctype not in FIELD_SIZES:
+            raise ValueError(f"field {name}: unsupported type {ctype}")
+        n = FIELD_SIZES[ctype]
+        size = (size + n - 1) // n * n + n
+        align = max(align, n)
+    size = (size + align - 1) // align * align
+    record = 8
+    while record < 4 + size:
+        record *= 2
+    return size, record
+
+
+def synthetic(count, seed):
+    """Returns count distinct random entries with value = key * 2654435761."""
+    x = seed & MASK32 or 1
+    seen = set()
+    entries = []
+    while len(entries) < count:
+        # xorshift32
+        x ^= (x << 13) & MASK32
+        x ^= x >> 17
+        x ^= (x << 5) & MASK32
+        if x not in seen:
+            seen.add(x)
+            entries.append({"key": x, "value": (x * 2654435761) & MASK32})
+    return entries
+
+
+def c_value(value, ctype):
+    if ctype == "float":
+        return repr(float(value)) + "f"
+    if isinstance(value, str):
+        return value
+    return str(int(value)) + ("u" if ctype.startswith("u") else "")
+
+
+def generate(spec, name, out_dir):
+    fields = spec.get("fields", [["value", "uint32_t"]])
+    if "synthetic" in spec:
+        entries = synthetic(spec["synthetic"]["count"], spec["synthetic"].get("seed", 1))
+    else:
+        entries = spec["entries"]
+    if not entries:
+        raise ValueError("table has no entries")
+
+    keys = []
+    labels = []
+    for e in entries:
+        k = e["key"]
+        if isinstance(k, str):
+            labels.append(k)
+            k = key_str(k)
+        else:
+            labels.append(None)
+            if not 0 <= k <= MASK32:
+                raise ValueError(f"key {k} out of range")
+        keys.append(k)
+    if len(set(keys)) != len(keys):
+        raise ValueError("duplicate keys, or two string keys with the same hash")
+
+    seed, disp, slots = build(keys)
+    value_size, record_size = layout(fields)
+    if record_size > FLASH_LINE:
+        print(f"table_gen: {name}: {record_size} byte records span "
+              f"{record_size // FLASH_LINE} flash lines", file=sys.stderr)
+    order = sorted(range(len(keys)), key=lambda i: slots[i])
+    guard = f"__{name.upper()}_TABLE_H__"
+    src = os.path.basename(spec.get("_path", name + ".json"))
+
+    h = []
+    h.append(f"/* Generated by tools/table_gen.py from {src}, do not edit */\n")
+    h.append(f"#ifndef {guard}")
+    h.append(f"#define {guard}\n")
+    h.append('#include <stdint.h>')
+    h.append('#include "table.h"\n')
+    h.append(f"#define {name.upper()}_COUNT {len(keys)}\n")
+    h.append("typedef struct {")
+    for fname, ctype in fields:
+        h.append(f"    {ctype} {fname};")
+    h.append(f"}} {name}_value_t;\n")
+    h.append("typedef struct {")
+    h.append("    uint32_t key;")
+    h.append(f"    {name}_value_t value;")
+    h.append(f"}} __attribute__((aligned({record_size}))) {name}_record_t;\n")
+    h.append(f"extern const table_t {name}_table;\n")
+    h.append(f"// Returns the value stored for key, NULL if the table does not hold it")
+    h.append(f"static inline const {name}_value_t *{name}_lookup(uint32_t key)")
+    h.append("{")
+    h.append(f"    return (const {name}_value_t *)table_lookup(&{name}_table, key);")
+    h.append("}\n")
+    h.append("#endif")
+
+    c = []
+    c.append(f"/* Generated by tools/table_gen.py from {src}, do not edit */\n")
+    c.append(f'#include "{name}_table.h"\n')
+    c.append(f"_Static_assert(sizeof({name}_record_t) == {record_size}, "
+             f'"{name}_record_t layout");\n')
+    c.append(f"static const uint16_t {name}_disp[{len(disp)}] = {{")
+    for i in range(0, len(disp), 12):
+        c.append("    " + ", ".join(str(d) for d in disp[i:i + 12]) + ",")
+    c.append("};\n")
+    c.append(f"static const {name}_record_t {name}_records[{len(keys)}] = {{")
+    for i in order:
+        e = entries[i]
+        vals = ", ".join(c_value(e[f], t) for f, t in fields)
+        comment = f"  // {labels[i]}" if labels[i] is not None else ""
+        c.append(f"    {{ 0x{keys[i]:08X}u, {{ {vals} }} }},{comment}")
+    c.append("};\n")
+    c.append(f"const table_t {name}_table = {{")
+    c.append(f"    0x{seed:08X}u, {len(keys)}, {len(disp)}, {record_size}, "
+             f"{name}_disp, {name}_records")
+    c.append("};")
+
+    os.makedirs(out_dir, exist_ok=True)
+    with open(os.path.join(out_dir, f"{name}_table.h"), "w") as f:
+        f.write("\n".join(h) + "\n")
+    with open(os.path.join(out_dir, f"{name}_table.c"), "w") as f:
+        f.write("\n".join(c) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("spec", help="JSON table spec")
+    parser.add_argument("out_dir", help="directory for <name>_table.h and <name>_table.c")
+    args = parser.parse_args()
+
+    name = os.path.splitext(os.path.basename(args.spec))[0]
+    with open(args.spec) as f:
+        spec = json.load(f)
+    spec["_path"] = args.spec
+    try:
+        generate(spec, name, args.out_dir)
+    except (ValueError, KeyError) as e:
+        sys.exit(f"table_gen: {args.spec}: {e}")
+
+
+if __name__ == "__main__":
+    main()